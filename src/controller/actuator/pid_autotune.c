@@ -0,0 +1,152 @@
+#include "controller/actuator/pid_autotune.h"
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "pid_autotune";
+
+// Допустимий розкид розмаху та періоду між останніми циклами (усталені коливання)
+#define AUTOTUNE_MAX_SPREAD 0.2f
+// Після стількох циклів без усталення експеримент припиняється
+#define AUTOTUNE_MAX_CYCLES 10
+
+static float spread(const float *v, int n) {
+    float lo = v[0], hi = v[0];
+    for (int i = 1; i < n; i++) {
+        if (v[i] < lo) lo = v[i];
+        if (v[i] > hi) hi = v[i];
+    }
+    return hi > 0.0f ? (hi - lo) / hi : 1.0f;
+}
+
+static void finish(pid_autotune_t *at) {
+    float a = 0.0f, p = 0.0f;
+    for (int i = 0; i < PID_AUTOTUNE_CYCLES; i++) {
+        a += at->amplitude[i];
+        p += at->period_s[i];
+    }
+    a /= 2.0f * PID_AUTOTUNE_CYCLES;  // Амплітуда - половина розмаху
+    p /= PID_AUTOTUNE_CYCLES;
+
+    // Описувальна функція реле з гістерезисом: Ku = 4d / (pi * sqrt(a^2 - eps^2))
+    float d = (at->cfg.output_high - at->cfg.output_low) / 2.0f;
+    float eps = at->cfg.hysteresis;
+    float a_eff = a > eps ? sqrtf(a * a - eps * eps) : 0.0f;
+
+    if (a_eff <= 0.0f || d <= 0.0f) {
+        ESP_LOGE(TAG, "Oscillation amplitude %.3f C does not exceed hysteresis %.3f C", a, eps);
+        at->status = PID_AUTOTUNE_FAILED;
+        return;
+    }
+
+    at->ku = 4.0f * d / ((float)M_PI * a_eff);
+    at->pu_s = p;
+
+    if (pid_autotune_compute_gains(at->ku, at->pu_s, at->cfg.rule, &at->kp, &at->ki, &at->kd) != ESP_OK) {
+        at->status = PID_AUTOTUNE_FAILED;
+        return;
+    }
+
+    at->status = PID_AUTOTUNE_DONE;
+    ESP_LOGI(TAG, "Done: a=%.3f C, Ku=%.2f %%/C, Pu=%.0f s -> %s: kp=%.3f ki=%.5f kd=%.2f",
+             a, at->ku, at->pu_s, pid_autotune_rule_to_string(at->cfg.rule), at->kp, at->ki, at->kd);
+}
+
+void pid_autotune_init(pid_autotune_t *at, const pid_autotune_config_t *cfg, float measured, int64_t now_us) {
+    memset(at, 0, sizeof(pid_autotune_t));
+    at->cfg = *cfg;
+    at->status = PID_AUTOTUNE_RUNNING;
+    at->start_us = now_us;
+    at->heating = measured < cfg->setpoint;
+    at->peak_max = measured;
+    at->peak_min = measured;
+
+    ESP_LOGI(TAG, "Relay test around %.2f C (hyst %.2f C, out %.0f/%.0f %%, rule %s)",
+             cfg->setpoint, cfg->hysteresis, cfg->output_high, cfg->output_low,
+             pid_autotune_rule_to_string(cfg->rule));
+}
+
+float pid_autotune_update(pid_autotune_t *at, float measured, int64_t now_us) {
+    if (at->status != PID_AUTOTUNE_RUNNING) return at->cfg.output_low;
+
+    if (now_us - at->start_us > at->cfg.timeout_us) {
+        ESP_LOGE(TAG, "Timeout after %d cycles", at->cycles);
+        at->status = PID_AUTOTUNE_FAILED;
+        return at->cfg.output_low;
+    }
+
+    if (measured > at->peak_max) at->peak_max = measured;
+    if (measured < at->peak_min) at->peak_min = measured;
+
+    if (at->heating && measured > at->cfg.setpoint + at->cfg.hysteresis) {
+        at->heating = false;
+    } else if (!at->heating && measured < at->cfg.setpoint - at->cfg.hysteresis) {
+        // Період - від увімкнення до увімкнення. Через інерцію мінімум настає вже після
+        // увімкнення, а максимум - після вимкнення, тож обидва потрапляють у це вікно.
+        at->heating = true;
+        if (at->last_on_us != 0) {
+            int slot = at->cycles % PID_AUTOTUNE_CYCLES;
+            at->amplitude[slot] = at->peak_max - at->peak_min;
+            at->period_s[slot] = (float)(now_us - at->last_on_us) / 1000000.0f;
+            at->cycles++;
+
+            ESP_LOGI(TAG, "Cycle %d: p-p %.3f C, period %.0f s", at->cycles, at->amplitude[slot], at->period_s[slot]);
+
+            if (at->cycles >= PID_AUTOTUNE_CYCLES &&
+                spread(at->amplitude, PID_AUTOTUNE_CYCLES) < AUTOTUNE_MAX_SPREAD &&
+                spread(at->period_s, PID_AUTOTUNE_CYCLES) < AUTOTUNE_MAX_SPREAD) {
+                finish(at);
+                return at->cfg.output_low;
+            }
+            if (at->cycles >= AUTOTUNE_MAX_CYCLES) {
+                ESP_LOGE(TAG, "Oscillation did not settle after %d cycles", at->cycles);
+                at->status = PID_AUTOTUNE_FAILED;
+                return at->cfg.output_low;
+            }
+        }
+        // Перше увімкнення лише синхронізує відлік: попередній напівперіод неповний
+        at->last_on_us = now_us;
+        at->peak_max = measured;
+        at->peak_min = measured;
+    }
+
+    return at->heating ? at->cfg.output_high : at->cfg.output_low;
+}
+
+esp_err_t pid_autotune_compute_gains(float ku, float pu_s, pid_tune_rule_t rule, float *kp, float *ki, float *kd) {
+    if (!(ku > 0.0f) || !(pu_s > 0.0f) || kp == NULL || ki == NULL || kd == NULL) return ESP_ERR_INVALID_ARG;
+
+    // Ti, Td у секундах; pid_compute: ki = Kp / Ti, kd = Kp * Td
+    float p, ti, td;
+    switch (rule) {
+        case PID_TUNE_RULE_ZN_PID:
+            p = 0.6f * ku;  ti = 0.5f * pu_s;  td = 0.125f * pu_s;
+            break;
+        case PID_TUNE_RULE_ZN_PI:
+            p = 0.45f * ku; ti = pu_s / 1.2f;  td = 0.0f;
+            break;
+        case PID_TUNE_RULE_TYREUS_LUYBEN:
+            p = ku / 2.2f;  ti = 2.2f * pu_s;  td = pu_s / 6.3f;
+            break;
+        case PID_TUNE_RULE_NO_OVERSHOOT:
+            p = 0.2f * ku;  ti = 0.5f * pu_s;  td = pu_s / 3.0f;
+            break;
+        default:
+            return ESP_ERR_INVALID_ARG;
+    }
+
+    *kp = p;
+    *ki = p / ti;
+    *kd = p * td;
+    return ESP_OK;
+}
+
+const char *pid_autotune_rule_to_string(pid_tune_rule_t rule) {
+    switch (rule) {
+        case PID_TUNE_RULE_ZN_PID: return "zn_pid";
+        case PID_TUNE_RULE_ZN_PI: return "zn_pi";
+        case PID_TUNE_RULE_TYREUS_LUYBEN: return "tyreus_luyben";
+        case PID_TUNE_RULE_NO_OVERSHOOT: return "no_overshoot";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,84 @@
+#ifndef PID_AUTOTUNE_H
+#define PID_AUTOTUNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Кількість останніх періодів коливань, за якими оцінюються Ku та Pu
+#define PID_AUTOTUNE_CYCLES 3
+
+/**
+ * @brief Правило перерахунку граничного коефіцієнта та періоду в коефіцієнти ПІД.
+ */
+typedef enum {
+    PID_TUNE_RULE_ZN_PID = 0,       // Циглер–Нікольс, ПІД: швидкий, помітне перерегулювання
+    PID_TUNE_RULE_ZN_PI,            // Циглер–Нікольс, ПІ
+    PID_TUNE_RULE_TYREUS_LUYBEN,    // Тюреус–Люйбен: повільніший, стійкіший для теплових об'єктів
+    PID_TUNE_RULE_NO_OVERSHOOT      // ПІД без перерегулювання (Kp = 0.2 Ku)
+} pid_tune_rule_t;
+
+typedef enum {
+    PID_AUTOTUNE_RUNNING = 0,
+    PID_AUTOTUNE_DONE,
+    PID_AUTOTUNE_FAILED
+} pid_autotune_status_t;
+
+typedef struct {
+    float setpoint;       // Температура, навколо якої розгойдується об'єкт, C
+    float hysteresis;     // Гістерезис реле, C (має перевищувати шум датчика)
+    float output_high;    // Вихід під час нагріву, %
+    float output_low;     // Вихід під час охолодження, %
+    int64_t timeout_us;   // Максимальна тривалість експерименту
+    pid_tune_rule_t rule;
+} pid_autotune_config_t;
+
+/**
+ * @brief Стан релейного експерименту Острема–Хеглунда.
+ */
+typedef struct {
+    pid_autotune_config_t cfg;
+    pid_autotune_status_t status;
+
+    bool heating;              // Поточний стан реле
+    int64_t start_us;
+    float peak_max;            // Екстремуми поточного періоду
+    float peak_min;
+    int64_t last_on_us;        // Момент попереднього увімкнення реле (0 - ще не було)
+    int cycles;                // Кількість завершених періодів
+
+    float amplitude[PID_AUTOTUNE_CYCLES]; // Розмах (max - min) останніх періодів
+    float period_s[PID_AUTOTUNE_CYCLES];  // Тривалість останніх періодів, с
+
+    /* Результат (дійсний при PID_AUTOTUNE_DONE) */
+    float ku;                  // Граничний коефіцієнт, %/C
+    float pu_s;                // Граничний період, с
+    float kp, ki, kd;          // Коефіцієнти у формі pid_compute (ki, kd на секунду)
+} pid_autotune_t;
+
+/**
+ * @brief Починає експеримент. Реле вмикається, якщо температура нижче уставки.
+ */
+void pid_autotune_init(pid_autotune_t *at, const pid_autotune_config_t *cfg, float measured, int64_t now_us);
+
+/**
+ * @brief Один крок експерименту. Викликати з періодом циклу керування.
+ *
+ * @return float Вихід для ШІМ, %: output_high або output_low
+ *         (output_low після завершення або помилки).
+ */
+float pid_autotune_update(pid_autotune_t *at, float measured, int64_t now_us);
+
+/**
+ * @brief Обчислює коефіцієнти ПІД з граничного коефіцієнта та періоду за вибраним правилом.
+ *
+ * @return esp_err_t ESP_ERR_INVALID_ARG для невідомого правила або недодатних Ku, Pu.
+ */
+esp_err_t pid_autotune_compute_gains(float ku, float pu_s, pid_tune_rule_t rule, float *kp, float *ki, float *kd);
+
+/**
+ * @brief Повертає назву правила (для API та журналу).
+ */
+const char *pid_autotune_rule_to_string(pid_tune_rule_t rule);
+
+#endif // PID_AUTOTUNE_H
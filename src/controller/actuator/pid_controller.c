@@ -2,6 +2,28 @@
 #include "esp_timer.h"
 #include <math.h>
 
+// Перерахунок сталих часу з коефіцієнтів: Ti = kp/ki, Td = kd/kp.
+// Стала слідкування антинасичення Tt = sqrt(Ti*Td) (Tt = Ti для ПІ-регулятора),
+// стала фільтра похідної Tf = Td/N.
+static void update_time_constants(pid_controller_t *pid)
+{
+    float ti = (pid->kp > 0.0f && pid->ki > 0.0f) ? pid->kp / pid->ki : 0.0f;
+    float td = (pid->kp > 0.0f && pid->kd > 0.0f) ? pid->kd / pid->kp : 0.0f;
+
+    // Без kp сталі не визначені: інтеграл лише обмежується межами виходу
+    pid->_tt_s = ti > 0.0f ? (td > 0.0f ? sqrtf(ti * td) : ti) : 0.0f;
+    pid->_tf_s = td > 0.0f ? td / pid->d_filter_n : 0.0f;
+
+#if TEMP_FIXED_POINT
+    pid->_kp_q16 = (int32_t)lroundf(pid->kp * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_ki_q16 = (int32_t)lroundf(pid->ki * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_kd_q16 = (int32_t)lroundf(pid->kd * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_b_q16 = (int32_t)lroundf(pid->setpoint_weight * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_tt_ms = (int32_t)lroundf(pid->_tt_s * 1000.0f);
+    pid->_tf_ms = (int32_t)lroundf(pid->_tf_s * 1000.0f);
+#endif
+}
+
 void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min, float out_max)
 {
     pid->kp = kp;
@@ -9,18 +31,158 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min
     pid->kd = kd;
     pid->out_min = out_min;
     pid->out_max = out_max;
-    
-    pid->_integral = 0.0f;
-    pid->_pre_error = 0.0f;
+    pid->setpoint_weight = PID_DEFAULT_SETPOINT_WEIGHT;
+    pid->d_filter_n = PID_DEFAULT_D_FILTER_N;
+
+#if TEMP_FIXED_POINT
+    pid->_out_min_q16 = (int32_t)lroundf(out_min * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_out_max_q16 = (int32_t)lroundf(out_max * (1 << PID_OUTPUT_Q16_SHIFT));
+#endif
+
+    pid_reset(pid);
+    update_time_constants(pid);
+}
+
+void pid_reset(pid_controller_t *pid)
+{
+    pid->_i_term = 0.0f;
+    pid->_prev_setpoint = 0.0f;
+    pid->_d_term = 0.0f;
+    pid->_prev_measured = 0.0f;
+    pid->_has_prev = false;
     pid->_last_time_us = esp_timer_get_time();
+
+#if TEMP_FIXED_POINT
+    pid->_i_term_q16 = 0;
+    pid->_i_rem = 0;
+    pid->_prev_setpoint_centi = 0;
+    pid->_d_term_q16 = 0;
+    pid->_prev_measured_centi = 0;
+#endif
+}
+
+void pid_set_tuning(pid_controller_t *pid, float kp, float ki, float kd)
+{
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    update_time_constants(pid);
+}
+
+void pid_set_weighting(pid_controller_t *pid, float setpoint_weight, float d_filter_n)
+{
+    if (setpoint_weight < 0.0f) setpoint_weight = 0.0f;
+    if (setpoint_weight > 1.0f) setpoint_weight = 1.0f;
+    if (!(d_filter_n > 0.0f)) d_filter_n = PID_DEFAULT_D_FILTER_N;
+
+    pid->setpoint_weight = setpoint_weight;
+    pid->d_filter_n = d_filter_n;
+    update_time_constants(pid);
+}
+
+void pid_set_output_limits(pid_controller_t *pid, float out_min, float out_max)
+{
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    if (pid->_i_term > out_max) pid->_i_term = out_max;
+    if (pid->_i_term < out_min) pid->_i_term = out_min;
+
+#if TEMP_FIXED_POINT
+    pid->_out_min_q16 = (int32_t)lroundf(out_min * (1 << PID_OUTPUT_Q16_SHIFT));
+    pid->_out_max_q16 = (int32_t)lroundf(out_max * (1 << PID_OUTPUT_Q16_SHIFT));
+    if (pid->_i_term_q16 > pid->_out_max_q16) pid->_i_term_q16 = pid->_out_max_q16;
+    if (pid->_i_term_q16 < pid->_out_min_q16) pid->_i_term_q16 = pid->_out_min_q16;
+#endif
+}
+
+#if TEMP_FIXED_POINT
+// Перехід від (соті частки градуса * мс) до (градус * с)
+#define CENTI_MS_PER_DEG_S 100000LL
+
+static int64_t clamp_q16(const pid_controller_t *pid, int64_t value)
+{
+    if (value > pid->_out_max_q16) return pid->_out_max_q16;
+    if (value < pid->_out_min_q16) return pid->_out_min_q16;
+    return value;
+}
+
+int32_t pid_compute_centi(pid_controller_t *pid, int32_t setpoint_centi, int32_t measured_centi, int32_t dt_ms)
+{
+    if (dt_ms <= 0 || dt_ms > 100000) {
+        dt_ms = 1000;
+    }
+
+    int32_t error = setpoint_centi - measured_centi;
+    int64_t p_out = (int64_t)pid->_kp_q16 * error / 100;
+
+    // Вага уставки: стрибок уставки переноситься в S з коефіцієнтом -(1-b)
+    if (pid->_has_prev && setpoint_centi != pid->_prev_setpoint_centi) {
+        int64_t unweighted_q16 = (1 << PID_OUTPUT_Q16_SHIFT) - pid->_b_q16;
+        int64_t dr = setpoint_centi - pid->_prev_setpoint_centi;
+        pid->_i_term_q16 -= (int64_t)pid->_kp_q16 * dr / 100 * unweighted_q16 / (1 << PID_OUTPUT_Q16_SHIFT);
+    }
+    pid->_prev_setpoint_centi = setpoint_centi;
+
+    // ki * (e / 100) * (dt / 1000); залишок ділення переноситься на наступний крок
+    int64_t acc = (int64_t)pid->_ki_q16 * error * dt_ms + pid->_i_rem;
+    pid->_i_term_q16 += acc / CENTI_MS_PER_DEG_S;
+    pid->_i_rem = acc % CENTI_MS_PER_DEG_S;
+
+    // Похідна вимірювання через фільтр: d = (Tf*d + kd * dy/100 * 1000) / (Tf + dt)
+    if (pid->_has_prev) {
+        int64_t dy = measured_centi - pid->_prev_measured_centi;
+        pid->_d_term_q16 = ((int64_t)pid->_tf_ms * pid->_d_term_q16 + (int64_t)pid->_kd_q16 * dy * 10) /
+                           ((int64_t)pid->_tf_ms + dt_ms);
+    } else {
+        pid->_d_term_q16 = 0;
+    }
+    pid->_prev_measured_centi = measured_centi;
+    pid->_has_prev = true;
+
+    int64_t unsat = p_out + pid->_i_term_q16 - pid->_d_term_q16;
+    int64_t output = clamp_q16(pid, unsat);
+
+    // Зворотний розрахунок: інтеграл підтягується до насиченого виходу зі сталою Tt
+    if (pid->_tt_ms > 0 && output != unsat) {
+        int64_t correction = output - unsat;
+        if (dt_ms < pid->_tt_ms) correction = correction * dt_ms / pid->_tt_ms;
+        pid->_i_term_q16 += correction;
+        pid->_i_rem = 0;
+    }
+    pid->_i_term_q16 = clamp_q16(pid, pid->_i_term_q16);
+
+    return (int32_t)output;
+}
+
+void pid_track_centi(pid_controller_t *pid, int32_t setpoint_centi, int32_t measured_centi, int32_t output_q16)
+{
+    int64_t p_out = (int64_t)pid->_kp_q16 * (setpoint_centi - measured_centi) / 100;
+
+    pid->_i_term_q16 = clamp_q16(pid, clamp_q16(pid, output_q16) - p_out);
+    pid->_i_rem = 0;
+    pid->_prev_setpoint_centi = setpoint_centi;
+    pid->_d_term_q16 = 0;
+    pid->_prev_measured_centi = measured_centi;
+    pid->_has_prev = true;
 }
+#endif
 
 float pid_compute(pid_controller_t *pid, float setpoint, float measured_value)
 {
     int64_t now_us = esp_timer_get_time();
-    float dt = (float)(now_us - pid->_last_time_us) / 1000000.0f;
+    int64_t elapsed_us = now_us - pid->_last_time_us;
     pid->_last_time_us = now_us;
 
+#if TEMP_FIXED_POINT
+    // Температури з цілочисельного конвеєра кратні 0.01 C і переносяться сюди без втрат
+    int32_t out_q16 = pid_compute_centi(pid,
+                                        (int32_t)lroundf(setpoint * 100.0f),
+                                        (int32_t)lroundf(measured_value * 100.0f),
+                                        (int32_t)(elapsed_us / 1000));
+    return (float)out_q16 / (float)(1 << PID_OUTPUT_Q16_SHIFT);
+#else
+    float dt = (float)elapsed_us / 1000000.0f;
+
     if (dt <= 0.0f || dt > 100.0f) {
         dt = 1.0f;
     }
@@ -29,20 +191,26 @@ float pid_compute(pid_controller_t *pid, float setpoint, float measured_value)
 
     float p_out = pid->kp * error;
 
-    pid->_integral += error * dt;
-    
-    if (pid->_integral > pid->out_max) {
-        pid->_integral = pid->out_max;
-    } else if (pid->_integral < pid->out_min) {
-        pid->_integral = pid->out_min;
+    // Вага уставки: стрибок уставки переноситься в S з коефіцієнтом -(1-b)
+    if (pid->_has_prev && setpoint != pid->_prev_setpoint) {
+        pid->_i_term -= pid->kp * (1.0f - pid->setpoint_weight) * (setpoint - pid->_prev_setpoint);
     }
-    
-    float i_out = pid->ki * pid->_integral;
+    pid->_prev_setpoint = setpoint;
+
+    pid->_i_term += pid->ki * error * dt;
 
-    float derivative = (error - pid->_pre_error) / dt;
-    float d_out = pid->kd * derivative;
+    // Похідна вимірювання, а не помилки: стрибок уставки не дає імпульсу на виході
+    if (pid->_has_prev) {
+        pid->_d_term = (pid->_tf_s * pid->_d_term + pid->kd * (measured_value - pid->_prev_measured)) /
+                       (pid->_tf_s + dt);
+    } else {
+        pid->_d_term = 0.0f;
+    }
+    pid->_prev_measured = measured_value;
+    pid->_has_prev = true;
 
-    float output = p_out + i_out + d_out;
+    float unsat = p_out + pid->_i_term - pid->_d_term;
+    float output = unsat;
 
     if (output > pid->out_max) {
         output = pid->out_max;
@@ -50,7 +218,46 @@ float pid_compute(pid_controller_t *pid, float setpoint, float measured_value)
         output = pid->out_min;
     }
 
-    pid->_pre_error = error;
+    // Зворотний розрахунок: інтеграл підтягується до насиченого виходу зі сталою Tt
+    if (pid->_tt_s > 0.0f) {
+        float gain = dt < pid->_tt_s ? dt / pid->_tt_s : 1.0f;
+        pid->_i_term += (output - unsat) * gain;
+    }
+
+    // Обмежується внесок інтегралу у вихід, а не сума помилки
+    if (pid->_i_term > pid->out_max) {
+        pid->_i_term = pid->out_max;
+    } else if (pid->_i_term < pid->out_min) {
+        pid->_i_term = pid->out_min;
+    }
 
     return output;
-}
\ No newline at end of file
+#endif
+}
+
+void pid_track(pid_controller_t *pid, float setpoint, float measured_value, float output)
+{
+    pid->_last_time_us = esp_timer_get_time();
+
+#if TEMP_FIXED_POINT
+    pid_track_centi(pid,
+                    (int32_t)lroundf(setpoint * 100.0f),
+                    (int32_t)lroundf(measured_value * 100.0f),
+                    (int32_t)lroundf(output * (1 << PID_OUTPUT_Q16_SHIFT)));
+#else
+    if (output > pid->out_max) output = pid->out_max;
+    if (output < pid->out_min) output = pid->out_min;
+
+    float p_out = pid->kp * (setpoint - measured_value);
+    pid->_i_term = output - p_out;
+    if (pid->_i_term > pid->out_max) {
+        pid->_i_term = pid->out_max;
+    } else if (pid->_i_term < pid->out_min) {
+        pid->_i_term = pid->out_min;
+    }
+    pid->_prev_setpoint = setpoint;
+    pid->_d_term = 0.0f;
+    pid->_prev_measured = measured_value;
+    pid->_has_prev = true;
+#endif
+}
@@ -2,9 +2,25 @@
 #define PID_CONTROLLER_H
 
 #include <stdint.h>
+#include <stdbool.h>
+#include "hw_config.h"
+
+// Формат виходу цілочисельного ПІД: відсотки у Q16.16
+#define PID_OUTPUT_Q16_SHIFT 16
+
+// Типові значення вагового коефіцієнта уставки та ділення фільтра похідної
+#define PID_DEFAULT_SETPOINT_WEIGHT 1.0f
+#define PID_DEFAULT_D_FILTER_N      10.0f
 
 /**
  * @brief Структура для зберігання стану та налаштувань ПІД-регулятора.
+ *
+ * Форма регулятора (ISA, з двома ступенями свободи):
+ *   u = kp * (b*r - y) + I - D
+ *   Реалізовано як u = kp * e + S - D, де S = I - kp*(1-b)*r: стрибок уставки змінює S
+ *   на -kp*(1-b)*dr, тож вихід реагує лише на b*dr. S обмежений межами виходу
+ *   (обмежується внесок у вихід, а не сума помилки), з антинасиченням зворотним розрахунком.
+ *   D: похідна вимірювання (не помилки), через фільтр першого порядку зі сталою Td/N
  */
 typedef struct {
     /* Коефіцієнти регулятора */
@@ -16,14 +32,40 @@ typedef struct {
     float out_min; // Мінімальне значення (напр. 0)
     float out_max; // Максимальне значення (напр. 100)
 
+    float setpoint_weight; // b: частка уставки в пропорційній складовій (0..1)
+    float d_filter_n;      // N: стала фільтра похідної Tf = Td / N
+
     /* Внутрішні змінні стану (не змінювати вручну) */
-    float _integral;      // Накопичена інтегральна сума
-    float _pre_error;     // Помилка на попередньому кроці
+    float _i_term;         // S: інтегральна складова з поправкою на вагу уставки, в одиницях виходу
+    float _prev_setpoint;  // Уставка на попередньому кроці
+    float _d_term;         // Відфільтрована диференціальна складова, в одиницях виходу
+    float _prev_measured;  // Вимірювання на попередньому кроці
+    bool _has_prev;        // Чи є попереднє вимірювання для похідної
+    float _tt_s;           // Стала слідкування антинасичення, с (0 - лише обмеження)
+    float _tf_s;           // Стала фільтра похідної, с
     int64_t _last_time_us; // Час останнього розрахунку в мікросекундах
+
+#if TEMP_FIXED_POINT
+    /* Стан цілочисельного шляху (TEMP_FIXED_POINT) */
+    int32_t _kp_q16;             // Коефіцієнти у Q16.16, відсоток на градус
+    int32_t _ki_q16;
+    int32_t _kd_q16;
+    int32_t _b_q16;              // Ваговий коефіцієнт уставки у Q16.16
+    int32_t _out_min_q16;        // Межі виходу у Q16.16
+    int32_t _out_max_q16;
+    int64_t _i_term_q16;         // S у Q16.16
+    int32_t _prev_setpoint_centi;
+    int64_t _i_rem;              // Залишок ділення при накопиченні інтегралу (без втрат)
+    int64_t _d_term_q16;         // Диференціальна складова у Q16.16
+    int32_t _prev_measured_centi;
+    int32_t _tt_ms;              // Стала слідкування, мс (0 - лише обмеження)
+    int32_t _tf_ms;              // Стала фільтра похідної, мс
+#endif
 } pid_controller_t;
 
 /**
  * @brief Ініціалізує ПІД-регулятор.
+ * Ваговий коефіцієнт уставки та фільтр похідної отримують типові значення.
  *
  * @param pid Вказівник на структуру pid_controller_t.
  * @param kp Пропорційний коефіцієнт.
@@ -34,6 +76,39 @@ typedef struct {
  */
 void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min, float out_max);
 
+/**
+ * @brief Скидає внутрішній стан регулятора (інтеграл, похідну, історію), зберігаючи налаштування.
+ *
+ * @param pid Вказівник на структуру pid_controller_t.
+ */
+void pid_reset(pid_controller_t *pid);
+
+/**
+ * @brief Змінює коефіцієнти без стрибка виходу.
+ *
+ * Інтегральна складова зберігається в одиницях виходу, тож нові ki не перемасштабовують
+ * накопичене значення (наприклад, після автоналаштування).
+ */
+void pid_set_tuning(pid_controller_t *pid, float kp, float ki, float kd);
+
+/**
+ * @brief Задає ваговий коефіцієнт уставки та ділення фільтра похідної.
+ *
+ * @param setpoint_weight b у [0, 1]: менше значення - м'якша реакція на стрибки уставки
+ *        (наприклад, передпрогрів адаптивного режиму) без впливу на відпрацювання збурень.
+ * @param d_filter_n N > 0: більше значення - менше фільтрування похідної.
+ */
+void pid_set_weighting(pid_controller_t *pid, float setpoint_weight, float d_filter_n);
+
+/**
+ * @brief Змінює межі виходу. Інтегральна складова обмежується новими межами.
+ *
+ * Використовується, коли до виходу регулятора додається прямий зв'язок ff:
+ * межі [min - ff, max - ff] тримають суму в допустимих межах, а антинасичення
+ * бачить фактичне насичення виконавчого механізму.
+ */
+void pid_set_output_limits(pid_controller_t *pid, float out_min, float out_max);
+
 /**
  * @brief Розраховує керуючий сигнал ПІД-регулятора.
  * 
@@ -46,4 +121,36 @@ void pid_init(pid_controller_t *pid, float kp, float ki, float kd, float out_min
  */
 float pid_compute(pid_controller_t *pid, float setpoint, float measured_value);
 
-#endif // PID_CONTROLLER_H
\ No newline at end of file
+/**
+ * @brief Безударне підхоплення: налаштовує стан так, щоб наступний вихід продовжував output.
+ *
+ * Викликається, коли виходом керує щось інше (інший режим, прогнозний планувальник,
+ * вимкнений обігрів з output = 0), і при передачі керування регулятору.
+ *
+ * @param output Фактично застосований вихід, %.
+ */
+void pid_track(pid_controller_t *pid, float setpoint, float measured_value, float output);
+
+#if TEMP_FIXED_POINT
+/**
+ * @brief Цілочисельний розрахунок ПІД (TEMP_FIXED_POINT).
+ *
+ * Детермінований: однакові вхідні дані та інтервали дають побітово однаковий результат.
+ *
+ * @param pid Вказівник на ініціалізовану структуру pid_controller_t.
+ * @param setpoint_centi Уставка, соті частки градуса.
+ * @param measured_centi Виміряна температура, соті частки градуса.
+ * @param dt_ms Інтервал з попереднього розрахунку, мс.
+ * @return int32_t Керуючий сигнал у відсотках Q16.16 в межах [out_min, out_max].
+ */
+int32_t pid_compute_centi(pid_controller_t *pid, int32_t setpoint_centi, int32_t measured_centi, int32_t dt_ms);
+
+/**
+ * @brief Цілочисельний варіант pid_track.
+ *
+ * @param output_q16 Фактично застосований вихід у відсотках Q16.16.
+ */
+void pid_track_centi(pid_controller_t *pid, int32_t setpoint_centi, int32_t measured_centi, int32_t output_q16);
+#endif
+
+#endif // PID_CONTROLLER_H
@@ -2,66 +2,393 @@
 #include "controller/actuator/relay_controller.h" 
 #include "model/settings_manager.h"
 #include "esp_log.h"
-#include <time.h> 
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 #include <inttypes.h>
 #include <math.h>
 
 static const char *TAG = "pwm_manager";
 
-static time_t s_cycle_start_time = 0;
+#define PWM_DEFAULT_CYCLE_MS 60000
+// Нижня межа періоду для твердотільного реле з перемиканням у нулі: 10 періодів мережі 50 Гц
+#define PWM_MIN_CYCLE_MS     200
+// Один період мережі 50 Гц: коротший імпульс SSR з перемиканням у нулі не відпрацює
+#define PWM_MIN_PULSE_MS     20
+// Після відсічки за перегрівом зона вмикається знову, лише коли радіатор охолоне на стільки нижче межі
+#define PWM_OVERHEAT_HYSTERESIS_C 2.0f
 
-void pwm_manager_update(float pid_output, float current_radiator_temp) {
-    const app_settings_t *cfg = settings_get();
+typedef enum {
+    PWM_PHASE_IDLE = 0,  // Таймер зупинено, реле вимкнене
+    PWM_PHASE_ON,
+    PWM_PHASE_OFF
+} pwm_phase_t;
 
-    float safe_max_temp = cfg->control.limits.rad_max;
-    int pwm_cycle_duration = cfg->control.pwm_cycle_s;
+// Який фронт запланований на таймері
+typedef enum {
+    PWM_EDGE_OFF = 0,    // Кінець імпульсу всередині періоду
+    PWM_EDGE_CYCLE       // Початок наступного періоду
+} pwm_edge_t;
+
+// Стан ШІМ однієї зони
+typedef struct {
+    uint8_t zone;
+    esp_timer_handle_t timer;          // NULL - канал не створено
+    float phase;                       // Зсув першого періоду, частка періоду
+    pwm_phase_t state;
+    pwm_edge_t next_edge;
+    int64_t cycle_start_us;            // Монотонний час початку поточного періоду
+    uint32_t cycle_ms;                 // Параметри поточного періоду
+    uint32_t on_ms;
+    uint32_t pending_cycle_ms;         // Завдання на наступний період
+    uint32_t pending_on_ms;
+    int32_t carry_in_ms;               // Борг заповнення на початку поточного періоду
+    int32_t carry_ms;                  // Борг заповнення, перенесений у наступний період
+    bool relay_on;                     // Останній виставлений каналом стан реле
+    int64_t last_off_us;               // Момент останнього вимкнення реле, INT64_MIN - не вмикалось
+    bool overheat;                     // Відсічка за перегрівом, чекає охолодження на гістерезис
+} pwm_channel_t;
+
+static pwm_channel_t s_channels[HEAT_ZONES_MAX];
+static SemaphoreHandle_t s_lock = NULL;
+
+// Мінімальні тривалості увімкнення та паузи реле (захист від зносу)
+static uint32_t s_min_on_ms = PWM_MIN_PULSE_MS;
+static uint32_t s_min_off_ms = PWM_MIN_PULSE_MS;
+
+static uint32_t get_cycle_ms(const app_settings_t *cfg) {
+    int64_t cycle_ms = cfg->control.pwm_cycle_ms > 0
+        ? (int64_t)cfg->control.pwm_cycle_ms
+        : (int64_t)cfg->control.pwm_cycle_s * 1000;
+
+    if (cycle_ms <= 0) cycle_ms = PWM_DEFAULT_CYCLE_MS;
+    if (cycle_ms < PWM_MIN_CYCLE_MS) cycle_ms = PWM_MIN_CYCLE_MS;
+    return (uint32_t)cycle_ms;
+}
+
+/**
+ * Мінімальна тривалість імпульсу чи паузи не коротша за період мережі і не довша
+ * за півперіоду ШІМ: інакше мінімуми разом не вмістилися б в один період.
+ */
+static uint32_t clamp_min_pulse(uint32_t min_ms, uint32_t cycle_ms) {
+    if (min_ms < PWM_MIN_PULSE_MS) min_ms = PWM_MIN_PULSE_MS;
+    if (min_ms > cycle_ms / 2) min_ms = cycle_ms / 2;
+    return min_ms;
+}
+
+static uint32_t duty_to_on_ms(float pid_output, uint32_t cycle_ms) {
+    if (pid_output < 0.0f) pid_output = 0.0f;
+    if (pid_output > 100.0f) pid_output = 100.0f;
+
+    return (uint32_t)lroundf((pid_output / 100.0f) * (float)cycle_ms);
+}
+
+/**
+ * Округлює бажаний час увімкнення до допустимого: 0, [min_on, cycle - min_off] або cycle.
+ * Обирається найближче допустиме значення, а різниця переноситься в наступні
+ * періоди як борг, тож середнє заповнення зберігається: короткі імпульси
+ * зливаються в один довший раз на кілька періодів. Викликається під s_lock.
+ */
+static uint32_t quantize_on_ms(int64_t want_ms, uint32_t cycle_ms) {
+    int64_t max_on = (int64_t)cycle_ms - s_min_off_ms;
+
+    if (want_ms <= 0) return 0;
+    if (want_ms >= cycle_ms) return cycle_ms;
+    if (want_ms < s_min_on_ms) {
+        return (want_ms * 2 < (int64_t)s_min_on_ms) ? 0 : s_min_on_ms;
+    }
+    if (want_ms > max_on) {
+        return ((want_ms - max_on) * 2 < (int64_t)cycle_ms - max_on) ? (uint32_t)max_on : cycle_ms;
+    }
+    return (uint32_t)want_ms;
+}
+
+// Обмежує борг одним періодом, щоб після довгої зміни потужності він не тягнувся годинами
+static int32_t clamp_carry(int64_t carry_ms, uint32_t cycle_ms) {
+    if (carry_ms > (int64_t)cycle_ms) return (int32_t)cycle_ms;
+    if (carry_ms < -(int64_t)cycle_ms) return -(int32_t)cycle_ms;
+    return (int32_t)carry_ms;
+}
+
+// Перемикає реле зони і запам'ятовує момент вимкнення для мінімальної паузи. Викликається під s_lock
+static void set_relay(pwm_channel_t *ch, bool on, int64_t now_us) {
+    if (ch->relay_on && !on) ch->last_off_us = now_us;
+    ch->relay_on = on;
+    relay_controller_set_zone_state(ch->zone, on);
+}
+
+// Викликається під s_lock
+static void schedule_edge(pwm_channel_t *ch, pwm_edge_t edge, int64_t target_us, int64_t now_us) {
+    int64_t delay_us = target_us - now_us;
+    if (delay_us < 0) delay_us = 0;
+
+    ch->next_edge = edge;
+    esp_timer_stop(ch->timer);
+    esp_timer_start_once(ch->timer, (uint64_t)delay_us);
+}
+
+// Викликається під s_lock
+static void start_cycle(pwm_channel_t *ch, int64_t start_us, int64_t now_us) {
+    ch->cycle_start_us = start_us;
+    ch->cycle_ms = ch->pending_cycle_ms;
+
+    // Нульове та повне завдання виконуються точно і скидають борг
+    if (ch->pending_on_ms == 0 || ch->pending_on_ms >= ch->cycle_ms) {
+        ch->carry_in_ms = 0;
+        ch->on_ms = ch->pending_on_ms == 0 ? 0 : ch->cycle_ms;
+    } else {
+        ch->carry_in_ms = ch->carry_ms;
+        int64_t want_ms = (int64_t)ch->pending_on_ms + ch->carry_in_ms;
+        ch->on_ms = quantize_on_ms(want_ms, ch->cycle_ms);
+    }
+    ch->carry_ms = clamp_carry((int64_t)ch->pending_on_ms + ch->carry_in_ms - ch->on_ms, ch->cycle_ms);
+
+    int64_t cycle_end_us = ch->cycle_start_us + (int64_t)ch->cycle_ms * 1000;
+
+    if (ch->on_ms == 0) {
+        ch->state = PWM_PHASE_OFF;
+        set_relay(ch, false, now_us);
+        schedule_edge(ch, PWM_EDGE_CYCLE, cycle_end_us, now_us);
+    } else {
+        ch->state = PWM_PHASE_ON;
+        set_relay(ch, true, now_us);
+        if (ch->on_ms < ch->cycle_ms) {
+            schedule_edge(ch, PWM_EDGE_OFF, ch->cycle_start_us + (int64_t)ch->on_ms * 1000, now_us);
+        } else {
+            schedule_edge(ch, PWM_EDGE_CYCLE, cycle_end_us, now_us);
+        }
+    }
+
+    ESP_LOGD(TAG, "Zone %u PWM cycle %" PRIu32 " ms, on %" PRIu32 " ms", ch->zone, ch->cycle_ms, ch->on_ms);
+}
+
+// Викликається під s_lock
+static void stop_channel(pwm_channel_t *ch) {
+    if (ch->state != PWM_PHASE_IDLE) {
+        ESP_LOGI(TAG, "Resetting zone %u PWM. Forcing heater OFF.", ch->zone);
+    }
+    esp_timer_stop(ch->timer);
+    ch->state = PWM_PHASE_IDLE;
+    ch->carry_ms = 0;
+    set_relay(ch, false, esp_timer_get_time());
+}
+
+static void pwm_timer_callback(void *arg) {
+    pwm_channel_t *ch = (pwm_channel_t *)arg;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    if (ch->state != PWM_PHASE_IDLE) {
+        int64_t now_us = esp_timer_get_time();
+        int64_t cycle_end_us = ch->cycle_start_us + (int64_t)ch->cycle_ms * 1000;
+
+        if (ch->next_edge == PWM_EDGE_OFF) {
+            ch->state = PWM_PHASE_OFF;
+            set_relay(ch, false, now_us);
+            schedule_edge(ch, PWM_EDGE_CYCLE, cycle_end_us, now_us);
+        } else {
+            // Новий період відраховується від кінця попереднього, а не від моменту
+            // спрацювання, щоб затримка колбеку не накопичувалась
+            int64_t start_us = cycle_end_us;
+            if (now_us - start_us >= (int64_t)ch->cycle_ms * 1000) {
+                ESP_LOGW(TAG, "Zone %u PWM timer late by %" PRId64 " us, resyncing", ch->zone, now_us - start_us);
+                start_us = now_us;
+            }
+            start_cycle(ch, start_us, now_us);
+        }
+    }
+
+    xSemaphoreGive(s_lock);
+}
+
+static esp_err_t create_channel(uint8_t zone, float phase) {
+    pwm_channel_t *ch = &s_channels[zone];
+    if (ch->timer != NULL) return ESP_ERR_INVALID_STATE;
+
+    ch->zone = zone;
+    ch->phase = phase;
+    ch->state = PWM_PHASE_IDLE;
+    ch->pending_cycle_ms = PWM_DEFAULT_CYCLE_MS;
+    ch->pending_on_ms = 0;
+    ch->carry_in_ms = 0;
+    ch->carry_ms = 0;
+    ch->relay_on = false;
+    ch->last_off_us = INT64_MIN;
+    ch->overheat = false;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = pwm_timer_callback,
+        .arg = ch,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "pwm_edge",
+        .skip_unhandled_events = false
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &ch->timer);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to create PWM timer for zone %u: %s", zone, esp_err_to_name(err));
+        ch->timer = NULL;
+    }
+    return err;
+}
+
+esp_err_t pwm_manager_init(void) {
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) return ESP_ERR_NO_MEM;
+
+    esp_err_t err = create_channel(0, 0.0f);
+    if (err != ESP_OK) return err;
+
+    ESP_LOGI(TAG, "PWM manager initialized");
+    return ESP_OK;
+}
+
+esp_err_t pwm_manager_add_zone(uint8_t zone, float phase) {
+    if (s_lock == NULL) return ESP_ERR_INVALID_STATE;
+    if (zone == 0 || zone >= HEAT_ZONES_MAX) return ESP_ERR_INVALID_ARG;
+    if (!(phase >= 0.0f && phase < 1.0f)) phase = 0.0f;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    esp_err_t err = create_channel(zone, phase);
+    xSemaphoreGive(s_lock);
+
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Zone %u PWM channel added, phase %.0f%%", zone, phase * 100.0f);
+    }
+    return err;
+}
 
-    if (pwm_cycle_duration <= 0) {
-        pwm_cycle_duration = 60;
+void pwm_manager_update_zone(uint8_t zone, float pid_output, float current_radiator_temp) {
+    if (s_lock == NULL || zone >= HEAT_ZONES_MAX || s_channels[zone].timer == NULL) {
+        ESP_LOGE(TAG, "PWM for zone %u not initialized", zone);
+        return;
     }
+    pwm_channel_t *ch = &s_channels[zone];
+
+    const app_settings_t *cfg = settings_get();
+
+    float safe_max_temp = cfg->control.limits.rad_max;
 
     if(safe_max_temp >= 70.0f) {
         safe_max_temp = 70.0f;
     }
 
     if (current_radiator_temp >= safe_max_temp) {
-        relay_controller_set_heater_state(false);
+        ch->overheat = true;
+        pwm_manager_reset_zone(zone);
         
-        ESP_LOGW(TAG, "SAFETY CUTOFF! Rad temp %.1f C exceeds limit %.1f C. Heater OFF.", 
-                 current_radiator_temp, safe_max_temp);
+        ESP_LOGW(TAG, "SAFETY CUTOFF! Zone %u rad temp %.1f C exceeds limit %.1f C. Heater OFF.", 
+                 zone, current_radiator_temp, safe_max_temp);
         
         return; 
     }
 
-    time_t now = time(NULL);
+    // Радіатор біля межі не має перемикати реле щосекунди: після відсічки чекаємо охолодження
+    if (ch->overheat) {
+        if (current_radiator_temp > safe_max_temp - PWM_OVERHEAT_HYSTERESIS_C) {
+            pwm_manager_reset_zone(zone);
+            return;
+        }
+        ch->overheat = false;
+        ESP_LOGI(TAG, "Zone %u rad temp %.1f C back below %.1f C, resuming PWM",
+                 zone, current_radiator_temp, safe_max_temp - PWM_OVERHEAT_HYSTERESIS_C);
+    }
+
+    uint32_t cycle_ms = get_cycle_ms(cfg);
+    uint32_t on_ms = duty_to_on_ms(pid_output, cycle_ms);
 
-    if (s_cycle_start_time == 0 || (now - s_cycle_start_time) >= pwm_cycle_duration) {
-        s_cycle_start_time = now;
-        ESP_LOGI(TAG, "Starting new PWM cycle of %d seconds.", pwm_cycle_duration);
+    uint32_t min_on_ms = clamp_min_pulse(cfg->control.relay.min_on_ms, cycle_ms);
+    uint32_t min_off_ms = clamp_min_pulse(cfg->control.relay.min_off_ms, cycle_ms);
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    if ((min_on_ms != s_min_on_ms && min_on_ms != cfg->control.relay.min_on_ms) ||
+        (min_off_ms != s_min_off_ms && min_off_ms != cfg->control.relay.min_off_ms)) {
+        ESP_LOGW(TAG, "Relay min on/off %" PRIu32 "/%" PRIu32 " ms clamped to %" PRIu32 "/%" PRIu32
+                 " ms for PWM cycle of %" PRIu32 " ms", cfg->control.relay.min_on_ms,
+                 cfg->control.relay.min_off_ms, min_on_ms, min_off_ms, cycle_ms);
     }
-    
-    if (pid_output < 0.0f) pid_output = 0.0f;
-    if (pid_output > 100.0f) pid_output = 100.0f;
+    s_min_on_ms = min_on_ms;
+    s_min_off_ms = min_off_ms;
+    ch->pending_cycle_ms = cycle_ms;
+    ch->pending_on_ms = on_ms;
 
-    uint32_t on_duration_sec = (uint32_t)((pid_output / 100.0f) * pwm_cycle_duration);
+    int64_t now_us = esp_timer_get_time();
+    if (ch->state == PWM_PHASE_IDLE) {
+        ESP_LOGI(TAG, "Starting zone %u PWM with cycle of %" PRIu32 " ms.", zone, cycle_ms);
+        int64_t first_us = now_us + (int64_t)(ch->phase * (float)cycle_ms) * 1000;
+        // Скидання вимикає реле негайно, тож мінімальна пауза відраховується і через нього:
+        // інакше часті зміни режиму чи відсічки вмикали б реле одразу після вимкнення
+        if (ch->last_off_us != INT64_MIN && first_us < ch->last_off_us + (int64_t)min_off_ms * 1000) {
+            first_us = ch->last_off_us + (int64_t)min_off_ms * 1000;
+        }
+        if (first_us > now_us) {
+            // Перший період зони відкладений: до нього - пауза, далі ланцюжок періодів
+            // іде від кінця попереднього, тож зсув фази зберігається
+            ch->cycle_start_us = first_us - (int64_t)cycle_ms * 1000;
+            ch->cycle_ms = cycle_ms;
+            ch->on_ms = 0;
+            ch->state = PWM_PHASE_OFF;
+            set_relay(ch, false, now_us);
+            schedule_edge(ch, PWM_EDGE_CYCLE, first_us, now_us);
+        } else {
+            start_cycle(ch, now_us, now_us);
+        }
+    } else if (ch->state == PWM_PHASE_ON && cycle_ms == ch->cycle_ms) {
+        // Зменшення потужності застосовується одразу: імпульс закінчується раніше,
+        // але не коротшим за мінімальний і не раніше, ніж уже минуло.
+        // Збільшення чекає наступного періоду, щоб не додавати зайвих перемикань.
+        int64_t want_ms = (int64_t)on_ms + ch->carry_in_ms;
+        if (on_ms == 0) want_ms = 0;
+        uint32_t new_on_ms = quantize_on_ms(want_ms, cycle_ms);
+        uint32_t elapsed_ms = (uint32_t)((now_us - ch->cycle_start_us) / 1000);
+        if (new_on_ms < s_min_on_ms) new_on_ms = s_min_on_ms;
+        if (new_on_ms < elapsed_ms) new_on_ms = elapsed_ms;
 
-    bool should_be_on = false;
-    if (on_duration_sec > 0) {
-        time_t elapsed_in_cycle = now - s_cycle_start_time;
-        if (elapsed_in_cycle < on_duration_sec) {
-            should_be_on = true;
+        // Паузу коротшу за мінімальну не створюємо: імпульс дотягується до кінця періоду
+        if (new_on_ms < ch->on_ms && cycle_ms - new_on_ms >= s_min_off_ms) {
+            ch->on_ms = new_on_ms;
+            ch->carry_ms = on_ms == 0 ? 0 : clamp_carry(want_ms - new_on_ms, cycle_ms);
+            int64_t off_us = ch->cycle_start_us + (int64_t)new_on_ms * 1000;
+            if (off_us <= now_us) {
+                ch->state = PWM_PHASE_OFF;
+                set_relay(ch, false, now_us);
+                schedule_edge(ch, PWM_EDGE_CYCLE, ch->cycle_start_us + (int64_t)ch->cycle_ms * 1000, now_us);
+            } else {
+                schedule_edge(ch, PWM_EDGE_OFF, off_us, now_us);
+            }
         }
     }
-    
-    relay_controller_set_heater_state(should_be_on);
 
-    ESP_LOGD(TAG, "PID: %.1f%% | Rad: %.1fC / Max: %.1fC | OnTime: %" PRIu32 "s of %ds | State: %s",
-             pid_output, current_radiator_temp, safe_max_temp, 
-             on_duration_sec, pwm_cycle_duration, should_be_on ? "ON" : "OFF");
+    xSemaphoreGive(s_lock);
+
+    ESP_LOGD(TAG, "Zone %u PID: %.1f%% | Rad: %.1fC / Max: %.1fC | OnTime: %" PRIu32 " ms of %" PRIu32 " ms",
+             zone, pid_output, current_radiator_temp, safe_max_temp, on_ms, cycle_ms);
+}
+
+void pwm_manager_update(float pid_output, float current_radiator_temp) {
+    pwm_manager_update_zone(0, pid_output, current_radiator_temp);
+}
+
+void pwm_manager_reset_zone(uint8_t zone) {
+    if (zone >= HEAT_ZONES_MAX) return;
+    if (s_lock == NULL || s_channels[zone].timer == NULL) {
+        relay_controller_set_zone_state(zone, false);
+        return;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    stop_channel(&s_channels[zone]);
+    xSemaphoreGive(s_lock);
 }
 
 void pwm_manager_reset(void) {
-    ESP_LOGI(TAG, "Resetting PWM manager. Forcing heater OFF.");
-    relay_controller_set_heater_state(false);
-    s_cycle_start_time = 0;
-}
\ No newline at end of file
+    if (s_lock == NULL) {
+        relay_controller_set_heater_state(false);
+        return;
+    }
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        if (s_channels[i].timer != NULL) stop_channel(&s_channels[i]);
+    }
+    xSemaphoreGive(s_lock);
+}
@@ -1,25 +1,64 @@
 #ifndef PWM_MANAGER_H
 #define PWM_MANAGER_H
 
+#include "esp_err.h"
+#include <stdint.h>
+
+/**
+ * @brief Створює таймер ШІМ основної зони (зона 0). Викликати після relay_controller_init.
+ *
+ * Фронти реле перемикаються одноразовими таймерами esp_timer у точні моменти
+ * на монотонному годиннику, тому корекція настінного часу через NTP не впливає на період.
+ */
+esp_err_t pwm_manager_init(void);
+
+/**
+ * @brief Створює канал ШІМ для додаткової зони. Викликати після pwm_manager_init
+ * та relay_controller_init_zone.
+ *
+ * @param zone Індекс зони (1..HEAT_ZONES_MAX-1).
+ * @param phase Зсув початку періоду зони як частка періоду [0, 1). Рознесення фаз
+ *              не дає обігрівачам усіх зон вмикатися одночасно.
+ */
+esp_err_t pwm_manager_add_zone(uint8_t zone, float phase);
+
 /**
  * @brief Оновлює стан реле на основі виходу ПІД-регулятора та перевірки безпеки.
  * 
  * Ця функція реалізує логіку програмного ШІМ на довгому періоді.
  * Перед увімкненням перевіряється температура радіатора: якщо вона перевищує 
  * безпечний ліміт, реле примусово вимикається (або залишається вимкненим).
- * 
- * Її потрібно викликати періодично з головного циклу керування.
+ *
+ * Нове заповнення (з роздільністю 1 мс) застосовується з початку наступного періоду;
+ * зменшення заповнення в поточному періоді вимикає реле раніше.
+ * Імпульси та паузи коротші за control.relay.min_on_ms / min_off_ms не формуються:
+ * залишок переноситься в наступні періоди, тож середнє заповнення зберігається.
+ * Мінімальна пауза діє і після pwm_manager_reset: перше увімкнення відкладається.
+ * Після відсічки за перегрівом ШІМ відновлюється, лише коли радіатор охолоне на 2 C нижче межі.
+ * Виклик лише передає нове завдання, самі фронти формує таймер.
  *
  * @param pid_output Вихідний сигнал ПІД-регулятора (від 0.0 до 100.0).
  * @param current_radiator_temp Поточна температура радіатора для захисту від перегріву (у градусах Цельсія).
  */
 void pwm_manager_update(float pid_output, float current_radiator_temp);
+
 /**
- * @brief Скидає стан ШІМ-менеджера та негайно вимикає реле.
+ * @brief Те саме, що pwm_manager_update, для вказаної зони.
+ * Відсічка за перегрівом радіатора вимикає лише цю зону.
+ */
+void pwm_manager_update_zone(uint8_t zone, float pid_output, float current_radiator_temp);
+
+/**
+ * @brief Скидає стан ШІМ-менеджера та негайно вимикає реле всіх зон.
  * 
  * Використовуйте цю функцію при переході в режими, де обігрів має бути
  * гарантовано вимкнений (STATE_OFF, STATE_EMERGENCY).
  */
 void pwm_manager_reset(void);
 
-#endif // PWM_MANAGER_H
\ No newline at end of file
+/**
+ * @brief Скидає ШІМ однієї зони та вимикає її реле.
+ */
+void pwm_manager_reset_zone(uint8_t zone);
+
+#endif // PWM_MANAGER_H
@@ -1,36 +1,164 @@
 #include "controller/actuator/relay_controller.h"
 #include "drivers/actuator/relay_driver.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
 
 static const char *TAG = "relay_controller";
 
-static bool s_heater_desired_state = false;
+#define NVS_NAMESPACE "relay"
+#define NVS_KEY_STATS "wear_stats"
 
-esp_err_t relay_controller_init(gpio_num_t heater_gpio_num, int heater_active_level) {
-    ESP_LOGI(TAG, "Initializing relay controller...");
-    esp_err_t err = relay_driver_init(heater_gpio_num, heater_active_level);
+// Період збереження лічильників у NVS
+#define RELAY_STATS_SAVE_INTERVAL_S 3600
+
+static bool s_desired_state[RELAY_DRIVER_MAX_CHANNELS];
+
+static relay_stats_t s_stats[RELAY_DRIVER_MAX_CHANNELS];
+static int64_t s_on_since_us[RELAY_DRIVER_MAX_CHANNELS]; // Початок поточного ввімкнення
+static bool s_stats_dirty = false;
+static int64_t s_last_save_us = 0;
+static SemaphoreHandle_t s_stats_lock = NULL;
+
+static void load_stats(void) {
+    nvs_handle_t handle;
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle) != ESP_OK) {
+        ESP_LOGI(TAG, "No relay wear stats in NVS yet");
+        return;
+    }
+    relay_stats_t stored[RELAY_DRIVER_MAX_CHANNELS];
+    size_t size = sizeof(stored);
+    if (nvs_get_blob(handle, NVS_KEY_STATS, stored, &size) == ESP_OK && size == sizeof(stored)) {
+        for (int i = 0; i < RELAY_DRIVER_MAX_CHANNELS; i++) s_stats[i] = stored[i];
+        ESP_LOGI(TAG, "Relay wear stats loaded: zone 0 %" PRIu32 " cycles, %.1f h on",
+                 s_stats[0].switch_cycles, (double)s_stats[0].on_time_ms / 3600000.0);
+    }
+    nvs_close(handle);
+}
+
+esp_err_t relay_controller_init_zone(uint8_t zone, gpio_num_t gpio_num, int active_level) {
+    if (zone >= RELAY_DRIVER_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+
+    if (s_stats_lock == NULL) {
+        s_stats_lock = xSemaphoreCreateMutex();
+        if (s_stats_lock == NULL) return ESP_ERR_NO_MEM;
+        load_stats();
+        s_last_save_us = esp_timer_get_time();
+    }
+
+    ESP_LOGI(TAG, "Initializing relay controller for zone %u...", zone);
+    esp_err_t err = relay_driver_init_channel(zone, gpio_num, active_level);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize relay driver: %s", esp_err_to_name(err));
         return err;
     }
 
-    s_heater_desired_state = false;
-    relay_driver_set_state(s_heater_desired_state);
+    s_desired_state[zone] = false;
+    relay_driver_set_channel_state(zone, false);
 
-    ESP_LOGI(TAG, "Relay controller initialized. Heater initially OFF.");
+    ESP_LOGI(TAG, "Relay controller initialized. Zone %u heater initially OFF.", zone);
     return ESP_OK;
 }
 
-esp_err_t relay_controller_set_heater_state(bool state) {
-    if (s_heater_desired_state != state) {
-        s_heater_desired_state = state;
-        ESP_LOGI(TAG, "Setting heater state to: %s", state ? "ON" : "OFF");
-        return relay_driver_set_state(state);
+esp_err_t relay_controller_init(gpio_num_t heater_gpio_num, int heater_active_level) {
+    return relay_controller_init_zone(0, heater_gpio_num, heater_active_level);
+}
+
+// Облік вмикань і часу роботи. Викликається при кожній зміні бажаного стану
+static void account_switch(uint8_t zone, bool state) {
+    if (s_stats_lock == NULL) return;
+    int64_t now_us = esp_timer_get_time();
+
+    xSemaphoreTake(s_stats_lock, portMAX_DELAY);
+    if (state) {
+        s_stats[zone].switch_cycles++;
+        s_on_since_us[zone] = now_us;
+    } else {
+        s_stats[zone].on_time_ms += (uint64_t)((now_us - s_on_since_us[zone]) / 1000);
     }
-    ESP_LOGD(TAG, "Heater state already %s. No change.", state ? "ON" : "OFF");
+    s_stats_dirty = true;
+    xSemaphoreGive(s_stats_lock);
+}
+
+esp_err_t relay_controller_set_zone_state(uint8_t zone, bool state) {
+    if (zone >= RELAY_DRIVER_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+
+    if (s_desired_state[zone] != state) {
+        s_desired_state[zone] = state;
+        account_switch(zone, state);
+        ESP_LOGI(TAG, "Setting zone %u heater state to: %s", zone, state ? "ON" : "OFF");
+        return relay_driver_set_channel_state(zone, state);
+    }
+    ESP_LOGD(TAG, "Zone %u heater state already %s. No change.", zone, state ? "ON" : "OFF");
     return ESP_OK;
 }
 
+esp_err_t relay_controller_set_heater_state(bool state) {
+    return relay_controller_set_zone_state(0, state);
+}
+
+bool relay_controller_get_zone_state(uint8_t zone) {
+    if (zone >= RELAY_DRIVER_MAX_CHANNELS) return false;
+    return s_desired_state[zone];
+}
+
 bool relay_controller_get_heater_state(void) {
-    return s_heater_desired_state;
-}
\ No newline at end of file
+    return relay_controller_get_zone_state(0);
+}
+
+esp_err_t relay_controller_get_stats(uint8_t zone, relay_stats_t *out) {
+    if (zone >= RELAY_DRIVER_MAX_CHANNELS || out == NULL || s_stats_lock == NULL) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(s_stats_lock, portMAX_DELAY);
+    *out = s_stats[zone];
+    if (s_desired_state[zone]) {
+        out->on_time_ms += (uint64_t)((esp_timer_get_time() - s_on_since_us[zone]) / 1000);
+    }
+    xSemaphoreGive(s_stats_lock);
+    return ESP_OK;
+}
+
+esp_err_t relay_controller_save_stats(bool force) {
+    if (s_stats_lock == NULL) return ESP_ERR_INVALID_STATE;
+
+    int64_t now_us = esp_timer_get_time();
+    relay_stats_t snapshot[RELAY_DRIVER_MAX_CHANNELS];
+
+    xSemaphoreTake(s_stats_lock, portMAX_DELAY);
+    bool due = s_stats_dirty && (force || now_us - s_last_save_us >= (int64_t)RELAY_STATS_SAVE_INTERVAL_S * 1000000);
+    if (due) {
+        // Поточні ввімкнення зараховуються до збереження, відлік продовжується з цього моменту
+        for (int i = 0; i < RELAY_DRIVER_MAX_CHANNELS; i++) {
+            if (s_desired_state[i]) {
+                s_stats[i].on_time_ms += (uint64_t)((now_us - s_on_since_us[i]) / 1000);
+                s_on_since_us[i] = now_us;
+            }
+            snapshot[i] = s_stats[i];
+        }
+        s_stats_dirty = false;
+        s_last_save_us = now_us;
+    }
+    xSemaphoreGive(s_stats_lock);
+    if (!due) return ESP_OK;
+
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_set_blob(handle, NVS_KEY_STATS, snapshot, sizeof(snapshot));
+    if (err == ESP_OK) err = nvs_commit(handle);
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save relay wear stats: %s", esp_err_to_name(err));
+    } else {
+        ESP_LOGI(TAG, "Relay wear stats saved");
+    }
+    return err;
+}
@@ -3,10 +3,20 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include "driver/gpio.h"
 
+/**
+ * @brief Лічильники зносу реле зони. Зберігаються в NVS.
+ */
+typedef struct {
+    uint32_t switch_cycles;  // Кількість вмикань (циклів вимк -> увімк)
+    uint64_t on_time_ms;     // Сумарний час у ввімкненому стані
+} relay_stats_t;
+
 /**
  * @brief Ініціалізує контролер реле та базовий драйвер реле.
+ * Також завантажує з NVS лічильники зносу всіх зон.
  *
  * @param heater_gpio_num Номер GPIO піна для реле обігрівача.
  * @param heater_active_level Логічний рівень, який активує реле обігрівача (1 для HIGH, 0 для LOW).
@@ -14,6 +24,16 @@
  */
 esp_err_t relay_controller_init(gpio_num_t heater_gpio_num, int heater_active_level);
 
+/**
+ * @brief Ініціалізує реле додаткової зони опалення. Обігрівач основної зони - зона 0.
+ *
+ * @param zone Індекс зони (0..HEAT_ZONES_MAX-1).
+ * @param gpio_num Номер GPIO піна реле зони.
+ * @param active_level Логічний рівень, який активує реле.
+ * @return esp_err_t ESP_OK у разі успіху, інакше код помилки.
+ */
+esp_err_t relay_controller_init_zone(uint8_t zone, gpio_num_t gpio_num, int active_level);
+
 /**
  * @brief Встановлює бажаний стан обігрівача (увімкнено/вимкнено).
  * Ця функція оновлює фактичний стан реле через relay_driver.
@@ -23,6 +43,11 @@ esp_err_t relay_controller_init(gpio_num_t heater_gpio_num, int heater_active_le
  */
 esp_err_t relay_controller_set_heater_state(bool state);
 
+/**
+ * @brief Встановлює бажаний стан реле зони.
+ */
+esp_err_t relay_controller_set_zone_state(uint8_t zone, bool state);
+
 /**
  * @brief Отримує поточний бажаний стан обігрівача.
  *
@@ -30,4 +55,25 @@ esp_err_t relay_controller_set_heater_state(bool state);
  */
 bool relay_controller_get_heater_state(void);
 
-#endif /* COMPONENTS_CONTROLLER_RELAY_CONTROLLER_H_ */
\ No newline at end of file
+/**
+ * @brief Отримує поточний бажаний стан реле зони.
+ */
+bool relay_controller_get_zone_state(uint8_t zone);
+
+/**
+ * @brief Повертає лічильники зносу реле зони, включно з поточним увімкненням.
+ */
+esp_err_t relay_controller_get_stats(uint8_t zone, relay_stats_t *out);
+
+/**
+ * @brief Зберігає лічильники зносу в NVS.
+ *
+ * Без force запис відбувається не частіше ніж раз на RELAY_STATS_SAVE_INTERVAL_S
+ * і лише після змін, щоб не зношувати флеш. Викликати з циклу керування,
+ * а не з колбеку таймера ШІМ.
+ *
+ * @param force true - зберегти негайно, якщо є зміни.
+ */
+esp_err_t relay_controller_save_stats(bool force);
+
+#endif /* COMPONENTS_CONTROLLER_RELAY_CONTROLLER_H_ */
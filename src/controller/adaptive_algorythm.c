@@ -11,6 +11,8 @@
 #include "nvs.h"
 #include "nvs_flash.h"
 #include "controller/adaptive_algorythm.h"
+#include "controller/thermal_model.h"
+#include "controller/mpc_planner.h"
 #include "model/settings_manager.h"
 
 static const char *TAG = "adaptive_algo";
@@ -51,15 +53,21 @@ static const char *TAG = "adaptive_algo";
 #define WEATHER_MILD_GAIN       -0.03f
 #define WEATHER_MILD_MAX_COMP   -0.3f
 
-typedef struct {
-    float heat_rate_deg_per_h;
-} thermal_model_t;
+#define DEFAULT_HEAT_RATE_DEG_PER_H 3.0f
 
 static float s_behavior_bias[DAYS_PER_WEEK][HOURS_PER_DAY];
-static thermal_model_t s_thermal_model = { .heat_rate_deg_per_h = 3.0f };
+static thermal_model_ident_t s_thermal_ident;
+
+static mpc_planner_t s_mpc;
+static mpc_plan_t s_mpc_plan;
+static float s_mpc_ref[MPC_HORIZON_STEPS + 1];
+static bool s_mpc_valid = false;
 
 static float s_room_temp = 20.0f;
 static float s_outside_temp = 0.0f;
+static float s_rad_temp = 20.0f;
+static bool  s_relay_on = false;
+static bool  s_heating_valid = false; // Дані радіатора та реле вже надходили
 static bool  s_presence = false;
 static int   s_weekday = 0;
 static int   s_hour = 0;
@@ -133,6 +141,17 @@ static esp_err_t nvs_load_blob_local(const char *key, void *out, size_t size) {
     return err;
 }
 
+static float weather_correction(void) {
+    float weather_corr = 0.0f;
+    if(s_outside_temp <= WEATHER_COLD_THRESH) {
+        weather_corr = clampf((WEATHER_COLD_THRESH - s_outside_temp) * WEATHER_COLD_GAIN, 0.0f, WEATHER_COLD_MAX_COMP);
+    }
+    else if(s_outside_temp >= WEATHER_MILD_THRESH) {
+        weather_corr = clampf((WEATHER_MILD_THRESH - s_outside_temp) * WEATHER_MILD_GAIN, WEATHER_MILD_MAX_COMP, 0.0f);
+    }
+    return weather_corr;
+}
+
 static float compute_target_internal(void) {
     const app_settings_t *cfg = settings_get();
     float min_temp = cfg->control.limits.room_min;
@@ -144,14 +163,7 @@ static float compute_target_internal(void) {
     float bias = s_behavior_bias[wd][h];
     float target = min_temp + (comfort_temp - min_temp) * bias;
 
-    float weather_corr = 0.0f;
-    if(s_outside_temp <= WEATHER_COLD_THRESH) {
-        weather_corr = clampf((WEATHER_COLD_THRESH - s_outside_temp) * WEATHER_COLD_GAIN, 0.0f, WEATHER_COLD_MAX_COMP);
-    }
-    else if(s_outside_temp >= WEATHER_MILD_THRESH) {
-        weather_corr = clampf((WEATHER_MILD_THRESH - s_outside_temp) * WEATHER_MILD_GAIN, WEATHER_MILD_MAX_COMP, 0.0f);
-    }
-    target += weather_corr;
+    target += weather_correction();
 
     if (s_presence_valid) {
         target = fmaxf(target, comfort_temp);
@@ -166,6 +178,46 @@ static float compute_target_internal(void) {
     return target;
 }
 
+/**
+ * @brief Перепланування на горизонті: мінімальна температура на межах кроків
+ * з таблиці присутності (ймовірно зайняті години - комфорт) та поточна присутність.
+ */
+static void mpc_replan(float min_temp, float comfort_temp) {
+    if (!mpc_planner_set_model(&s_mpc, &s_thermal_ident.model) || s_outside_temp < -100.0f) {
+        s_mpc_valid = false;
+        return;
+    }
+
+    float weather_corr = weather_correction();
+    int now_min = (s_hour % HOURS_PER_DAY) * MINUTES_PER_HOUR + s_minute;
+    int step_min = MPC_STEP_SEC / SECONDS_PER_MINUTE;
+
+    for (int k = 0; k <= MPC_HORIZON_STEPS; k++) {
+        int total_min = now_min + k * step_min;
+        int h = (total_min / MINUTES_PER_HOUR) % HOURS_PER_DAY;
+        int wd = (s_weekday + total_min / (MINUTES_PER_HOUR * HOURS_PER_DAY)) % DAYS_PER_WEEK;
+        float bias = s_behavior_bias[wd][h];
+
+        float r = bias > PREHEAT_BIAS_THRESHOLD ? comfort_temp : min_temp + (comfort_temp - min_temp) * bias;
+        // Поточна присутність утримує комфорт щонайменше на тайм-аут присутності
+        if (s_presence_valid && k * step_min <= s_presence_timeout_min) r = comfort_temp;
+        s_mpc_ref[k] = clampf(r + weather_corr, min_temp, comfort_temp + PREHEAT_BOOST_DEG);
+    }
+
+    // Верхня межа - найвища уставка, яку може задати адаптивний режим
+    mpc_planner_solve(&s_mpc, s_room_temp, s_rad_temp, s_outside_temp, s_mpc_ref,
+                      comfort_temp + PREHEAT_BOOST_DEG, &s_mpc_plan);
+    if (!s_mpc_plan.within_max) {
+        // План перегріває кімнату: керування повертається ПІД до наступного перепланування
+        ESP_LOGW(TAG, "MPC plan exceeds %.1fC, falling back to PID", comfort_temp + PREHEAT_BOOST_DEG);
+        s_mpc_valid = false;
+        return;
+    }
+    s_mpc_valid = true;
+    ESP_LOGD(TAG, "MPC: duty %.0f%%, planned %.2f h, %s", s_mpc_plan.duty[0] * 100.0f,
+             s_mpc_plan.energy_h, s_mpc_plan.feasible ? "feasible" : "comfort not reachable");
+}
+
 static void adaptive_calc_task(void *arg) {
     TickType_t last_wake = xTaskGetTickCount();
     while(s_task_running){
@@ -207,8 +259,16 @@ static void adaptive_calc_task(void *arg) {
                 }
             }
 
+            if (s_heating_valid &&
+                thermal_model_add_sample(&s_thermal_ident, s_room_temp, s_rad_temp, s_outside_temp, s_relay_on ? 1.0f : 0.0f)) {
+                s_model_dirty = true;
+            }
+
+            // Швидкість нагріву з ідентифікованої моделі залежить від поточних кімнатної та зовнішньої температур
+            float heat_rate = thermal_model_heat_rate(&s_thermal_ident.model, s_room_temp, s_outside_temp);
+
             s_preheat_active = false;
-            if (!s_presence_valid && s_thermal_model.heat_rate_deg_per_h > 0.1f) {
+            if (!s_presence_valid && heat_rate > 0.1f) {
                 int current_total_min = (h * MINUTES_PER_HOUR) + s_minute;
                 for (int i = 1; i <= PREHEAT_LOOKAHEAD_HOURS; ++i) {
                     int future_total_min = current_total_min + (i * MINUTES_PER_HOUR);
@@ -219,7 +279,7 @@ static void adaptive_calc_task(void *arg) {
                     if (s_behavior_bias[future_wd][future_hour] > PREHEAT_BIAS_THRESHOLD) {
                         float temp_gain_needed = comfort_temp - s_room_temp;
                         if (temp_gain_needed > 0.0f) {
-                            float hours_to_heat = temp_gain_needed / s_thermal_model.heat_rate_deg_per_h;
+                            float hours_to_heat = temp_gain_needed / heat_rate;
                             int minutes_to_heat_early = (int)(hours_to_heat * MINUTES_PER_HOUR) + PREHEAT_BUFFER_MIN;
 
                             int minutes_until_target = (i * MINUTES_PER_HOUR);
@@ -252,13 +312,23 @@ static void adaptive_calc_task(void *arg) {
                     if (nvs_save_blob_local(NVS_KEY_BIAS, s_behavior_bias, sizeof(s_behavior_bias)) == ESP_OK) s_bias_dirty = false;
                 }
                 if (s_model_dirty) {
-                    if (nvs_save_blob_local(NVS_KEY_MODEL, &s_thermal_model, sizeof(s_thermal_model)) == ESP_OK) s_model_dirty = false;
+                    const thermal_model_t *m = &s_thermal_ident.model;
+                    ESP_LOGI(TAG, "Thermal model: %s, heat rate %.2f C/h, loss %.4f 1/h, tau %.1f h",
+                             thermal_model_is_converged(m) ? "converged" : "learning",
+                             heat_rate, thermal_model_loss_coeff(m), thermal_model_time_constant_h(m));
+                    if (nvs_save_blob_local(NVS_KEY_MODEL, m, sizeof(thermal_model_t)) == ESP_OK) s_model_dirty = false;
                 }
                 if (s_setpoint_dirty) {
                     if (nvs_save_blob_local(NVS_KEY_SETPOINT, &s_current_setpoint, sizeof(s_current_setpoint)) == ESP_OK) s_setpoint_dirty = false;
                 }
             }
 
+            if (!cfg->control.mpc_enabled || !s_heating_valid) {
+                s_mpc_valid = false;
+            } else if (!s_mpc_valid || (s_seconds_counter % MPC_STEP_SEC) == 0) {
+                mpc_replan(cfg->control.limits.room_min, comfort_temp);
+            }
+
             float target = compute_target_internal();
             float old_sp = s_current_setpoint;
 
@@ -287,7 +357,13 @@ esp_err_t adaptive_thermo_init(void){
 
     memset(s_behavior_bias, 0, sizeof(s_behavior_bias));
     nvs_load_blob_local(NVS_KEY_BIAS, s_behavior_bias, sizeof(s_behavior_bias));
-    nvs_load_blob_local(NVS_KEY_MODEL, &s_thermal_model, sizeof(s_thermal_model));
+    thermal_model_init(&s_thermal_ident.model, DEFAULT_HEAT_RATE_DEG_PER_H);
+    if (nvs_load_blob_local(NVS_KEY_MODEL, &s_thermal_ident.model, sizeof(thermal_model_t)) == ESP_OK &&
+        (s_thermal_ident.model.room.n != 3 || s_thermal_ident.model.radiator.n != 2)) {
+        ESP_LOGW(TAG, "Stored thermal model is invalid, starting from defaults");
+        thermal_model_init(&s_thermal_ident.model, DEFAULT_HEAT_RATE_DEG_PER_H);
+    }
+    thermal_model_ident_reset(&s_thermal_ident);
 
     const app_settings_t *cfg = settings_get();
     s_current_setpoint = cfg->control.limits.room_min;
@@ -330,6 +406,46 @@ void adaptive_thermo_notify_sensor(float room_temp, float outside_temp, bool pre
     }
 }
 
+void adaptive_thermo_notify_heating(float radiator_temp, bool relay_on) {
+    if(!s_lock) return;
+    if(xSemaphoreTake(s_lock, pdMS_TO_TICKS(50)) == pdTRUE) {
+        s_rad_temp = radiator_temp;
+        s_relay_on = relay_on;
+        s_heating_valid = true;
+        xSemaphoreGive(s_lock);
+    }
+}
+
+void adaptive_thermo_get_model(thermal_model_t *out) {
+    if(!s_lock) return;
+    if(xSemaphoreTake(s_lock, pdMS_TO_TICKS(200)) == pdTRUE) {
+        *out = s_thermal_ident.model;
+        xSemaphoreGive(s_lock);
+    }
+}
+
+bool adaptive_thermo_get_mpc_duty(float *duty_pct) {
+    bool valid = false;
+    if(!s_lock) return false;
+    if(xSemaphoreTake(s_lock, pdMS_TO_TICKS(20)) == pdTRUE) {
+        valid = s_mpc_valid;
+        if (valid) *duty_pct = s_mpc_plan.duty[0] * 100.0f;
+        xSemaphoreGive(s_lock);
+    }
+    return valid;
+}
+
+bool adaptive_thermo_get_mpc_plan(mpc_plan_t *out) {
+    bool valid = false;
+    if(!s_lock) return false;
+    if(xSemaphoreTake(s_lock, pdMS_TO_TICKS(200)) == pdTRUE) {
+        valid = s_mpc_valid;
+        if (valid) *out = s_mpc_plan;
+        xSemaphoreGive(s_lock);
+    }
+    return valid;
+}
+
 float adaptive_thermo_get_setpoint(void){
     float out = s_current_setpoint;
     if(!s_lock) return out;
@@ -345,7 +461,7 @@ void adaptive_thermo_set_heat_rate(float degrees_per_hour) {
     if(!s_lock) return;
     if(xSemaphoreTake(s_lock, pdMS_TO_TICKS(200)) == pdTRUE) {
         if (degrees_per_hour > 0.1f) {
-            s_thermal_model.heat_rate_deg_per_h = degrees_per_hour;
+            s_thermal_ident.model.heat_rate_deg_per_h = degrees_per_hour;
             s_model_dirty = true;
         }
         xSemaphoreGive(s_lock);
@@ -369,7 +485,7 @@ void adaptive_thermo_deinit(void){
     if(s_lock) {
         if (xSemaphoreTake(s_lock, pdMS_TO_TICKS(2000)) == pdTRUE) {
             nvs_save_blob_local(NVS_KEY_BIAS, s_behavior_bias, sizeof(s_behavior_bias));
-            nvs_save_blob_local(NVS_KEY_MODEL, &s_thermal_model, sizeof(s_thermal_model));
+            nvs_save_blob_local(NVS_KEY_MODEL, &s_thermal_ident.model, sizeof(thermal_model_t));
             nvs_save_blob_local(NVS_KEY_SETPOINT, &s_current_setpoint, sizeof(s_current_setpoint));
             xSemaphoreGive(s_lock);
         } else {
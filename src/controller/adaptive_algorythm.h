@@ -3,6 +3,8 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include "controller/thermal_model.h"
+#include "controller/mpc_planner.h"
 
 /**
  * @brief Ініціалізує адаптивний алгоритм (NVS, фонова задача навчання).
@@ -14,9 +16,34 @@ esp_err_t adaptive_thermo_init(void);
  */
 void adaptive_thermo_notify_sensor(float room_temp, float outside_temp, bool presence, int weekday, int hour, int minute);
 
+/**
+ * @brief Передає температуру радіатора та стан реле для ідентифікації теплової моделі.
+ * Викликати щосекунди разом з adaptive_thermo_notify_sensor.
+ */
+void adaptive_thermo_notify_heating(float radiator_temp, bool relay_on);
+
+/**
+ * @brief Копіює поточну ідентифіковану теплову модель.
+ */
+void adaptive_thermo_get_model(thermal_model_t *out);
+
+/**
+ * @brief Заповнення на поточний крок з прогнозного планувальника, %.
+ *
+ * План перераховується кожні MPC_STEP_SEC від виміряного стану (ковзний горизонт).
+ *
+ * @return false, якщо планувальник вимкнений у налаштуваннях або модель ще не зійшлася.
+ */
+bool adaptive_thermo_get_mpc_duty(float *duty_pct);
+
+/**
+ * @brief Копіює останній план. Повертає false, якщо план недійсний.
+ */
+bool adaptive_thermo_get_mpc_plan(mpc_plan_t *out);
+
 /**
  * @brief (Опціонально) Налаштування швидкості нагріву приміщення (градусів на годину).
- * За замовчуванням 3.0.
+ * За замовчуванням 3.0. Використовується, поки теплова модель не зійшлася.
  */
 void adaptive_thermo_set_heat_rate(float degrees_per_hour);
 
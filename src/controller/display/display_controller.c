@@ -2,22 +2,44 @@
 #include "view/display_manager.h"
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/timers.h"
+#include "freertos/task.h"
 #include "networking/ntp_time_sync.h"
 #include "model/system_state.h"
+#include "model/state_bus.h"
 #include "model/main_control.h"
 #include "controller/temp_setpoint_manager.h"
+#include "controller/sensor/temp_controller.h"
 #include <time.h>
 #include <string.h>
 #include "esp_netif.h"
 
 static const char *TAG = "DisplayController";
-static TimerHandle_t display_update_timer;
 sensors_state_t current_state;
+// Версія стану в current_state; UINT32_MAX - ще не копіювався (версія стану не сягає цього значення)
+static uint32_t current_state_version = UINT32_MAX;
+static state_bus_handle_t s_display_bus = NULL;
+
+// Поля, що видно на екрані: перемальовування лише після їх зміни та раз на хвилину для годинника
+#define DISPLAY_STATE_FIELDS (SYSTEM_STATE_FIELD_TEMP_CHANNEL(TEMP_SENSOR_ROOM) | SYSTEM_STATE_FIELD_WIFI | \
+                              SYSTEM_STATE_FIELD_MODE | SYSTEM_STATE_FIELD_UI | SYSTEM_STATE_FIELD_ERROR | \
+                              STATE_BUS_EVENT_MANUAL_SETPOINT | STATE_BUS_EVENT_PREVIEW)
+
+/**
+ * @brief Час до наступної зміни хвилини на годиннику.
+ */
+static TickType_t ticks_to_next_minute(void) {
+    time_t now = time(NULL);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    return pdMS_TO_TICKS((60 - tm_now.tm_sec) * 1000);
+}
 
-static void display_update_timer_callback(TimerHandle_t xTimer) {
-    system_state_get(&current_state);
-    display_controller_update();
+static void display_task(void *arg) {
+    for (;;) {
+        system_state_get_if_changed(&current_state_version, &current_state);
+        display_controller_update();
+        state_bus_wait(s_display_bus, ticks_to_next_minute());
+    }
 }
 
 void display_controller_update(void) {
@@ -29,7 +51,7 @@ void display_controller_update(void) {
         case UI_STATE_MAIN_SCREEN:
             main_screen_data_t data;
 
-            data.temperature = current_state.temperature_c_sensor1;
+            data.temperature = current_state.temperature_c[TEMP_SENSOR_ROOM];
             data.wifi_connected = current_state.wifi_connected;
 
             char date_str[11];
@@ -62,6 +84,9 @@ void display_controller_update(void) {
                 case STATE_MODE_SELECT:
                     data.mode_str = "SEL";
                     break;
+                case STATE_AUTOTUNE:
+                    data.mode_str = "TUNE";
+                    break;
                 default:
                     data.mode_str = "---";
                     break;
@@ -115,7 +140,7 @@ void display_controller_update(void) {
         }
 
         case UI_STATE_EMERGENCY:
-            render_emergency_screen(current_state.error_code);
+            render_emergency_screen(current_state.error_code, current_state.error_sensor);
             break;
 
         default:
@@ -126,20 +151,13 @@ void display_controller_update(void) {
 esp_err_t display_controller_init(gpio_num_t sda_gpio, gpio_num_t scl_gpio) {
     display_manager_init(sda_gpio, scl_gpio);
     
-    display_update_timer = xTimerCreate(
-        "DisplayUpdateTimer",
-        pdMS_TO_TICKS(50),
-        pdTRUE,
-        (void*)0,
-        display_update_timer_callback
-    );
-
-    if (display_update_timer == NULL) {
-        ESP_LOGE(TAG, "Failed to create display update timer.");
+    // Замість таймера на 50 мс: завдання спить до зміни видимих полів
+    TaskHandle_t task = NULL;
+    if (xTaskCreate(display_task, "display_task", 3072, NULL, 5, &task) != pdPASS) {
+        ESP_LOGE(TAG, "Failed to create display task.");
         return ESP_FAIL;
     }
-    
-    xTimerStart(display_update_timer, 0);
+    s_display_bus = state_bus_subscribe("display", task, DISPLAY_STATE_FIELDS);
 
     ESP_LOGI(TAG, "Display controller initialized.");
     return ESP_OK;
@@ -0,0 +1,201 @@
+#include "controller/heating_curve.h"
+#include "esp_log.h"
+#include "nvs_flash.h"
+#include "nvs.h"
+#include <inttypes.h>
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "heating_curve";
+
+#define NVS_NAMESPACE "heat_curve"
+#define NVS_KEY_MODEL "model"
+
+// Вікно навчання: 30 хв поспіль в усталеному режимі усереднюють ШІМ і шум датчика
+#define HEATING_CURVE_WINDOW_SEC   1800
+
+// Забування 0.97 на вікно - пам'ять близько 16 год усталеної роботи
+#define HEATING_CURVE_LAMBDA       0.97f
+// Початкова невизначеність: нахил +-1 %/C, зміщення +-10 %
+#define HEATING_CURVE_P0_SLOPE     1.0f
+#define HEATING_CURVE_P0_OFFSET    100.0f
+// Усталені вікна мало відрізняються за різницею температур: без обмеження
+// забування роздувало б коваріацію в незбудженому напрямку
+#define HEATING_CURVE_TRACE_MAX    (10.0f * (HEATING_CURVE_P0_SLOPE + HEATING_CURVE_P0_OFFSET))
+
+// Середнє заповнення вікна ближче до меж не використовується для навчання
+#define HEATING_CURVE_DUTY_MARGIN  1.0f
+
+// Фізично правдоподібні межі кривої
+#define HEATING_CURVE_SLOPE_MAX    10.0f
+#define HEATING_CURVE_OFFSET_MAX   30.0f
+
+// Зовнішня температура нижче цього значення вважається недоступною
+#define OUTSIDE_TEMP_VALID_MIN     -100.0f
+
+// Прямий зв'язок тримає зовнішню температуру не довше за два періоди опитування погоди:
+// один пропущений запит переживає, а застарілий прогноз не підживлює кімнату годинами
+#define OUTSIDE_MAX_AGE_INTERVALS    2
+#define OUTSIDE_DEFAULT_INTERVAL_MIN 15
+
+static float clampf(float v, float lo, float hi) {
+    if (v < lo) return lo;
+    if (v > hi) return hi;
+    return v;
+}
+
+static bool outside_valid(float outside_t) {
+    return !isnan(outside_t) && outside_t > OUTSIDE_TEMP_VALID_MIN;
+}
+
+static void window_reset(heating_curve_t *hc) {
+    hc->window_count = 0;
+    hc->sum_delta = 0.0f;
+    hc->sum_duty = 0.0f;
+    hc->window_setpoint = NAN;
+}
+
+// RLS з регресором [delta, 1] та виходом duty
+static void rls_update(heating_curve_model_t *m, float delta, float duty) {
+    const float phi[2] = { delta, 1.0f };
+    float pphi[2];
+    for (int i = 0; i < 2; i++) pphi[i] = m->p[i][0] * phi[0] + m->p[i][1] * phi[1];
+
+    float trace = m->p[0][0] + m->p[1][1];
+    float lambda = trace < HEATING_CURVE_TRACE_MAX ? HEATING_CURVE_LAMBDA : 1.0f;
+    float denom = lambda + phi[0] * pphi[0] + phi[1] * pphi[1];
+    float err = duty - (m->slope * delta + m->offset);
+
+    m->slope += pphi[0] / denom * err;
+    m->offset += pphi[1] / denom * err;
+
+    for (int i = 0; i < 2; i++) {
+        for (int j = i; j < 2; j++) {
+            float v = (m->p[i][j] - pphi[i] * pphi[j] / denom) / lambda;
+            m->p[i][j] = v;
+            m->p[j][i] = v;
+        }
+    }
+
+    m->slope = clampf(m->slope, 0.0f, HEATING_CURVE_SLOPE_MAX);
+    m->offset = clampf(m->offset, -HEATING_CURVE_OFFSET_MAX, HEATING_CURVE_OFFSET_MAX);
+    m->windows++;
+}
+
+void heating_curve_init(heating_curve_t *hc, float slope, float offset) {
+    memset(hc, 0, sizeof(heating_curve_t));
+    heating_curve_model_t *m = &hc->model;
+    m->slope = clampf(slope, 0.0f, HEATING_CURVE_SLOPE_MAX);
+    m->offset = clampf(offset, -HEATING_CURVE_OFFSET_MAX, HEATING_CURVE_OFFSET_MAX);
+    m->seed_slope = slope;
+    m->seed_offset = offset;
+    m->p[0][0] = HEATING_CURVE_P0_SLOPE;
+    m->p[1][1] = HEATING_CURVE_P0_OFFSET;
+    window_reset(hc);
+}
+
+esp_err_t heating_curve_load(heating_curve_t *hc) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READONLY, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGI(TAG, "No learned heating curve in NVS yet");
+        return err;
+    }
+
+    heating_curve_model_t stored;
+    size_t size = sizeof(stored);
+    err = nvs_get_blob(handle, NVS_KEY_MODEL, &stored, &size);
+    nvs_close(handle);
+    if (err != ESP_OK || size != sizeof(stored)) {
+        return err != ESP_OK ? err : ESP_ERR_INVALID_SIZE;
+    }
+
+    if (stored.seed_slope != hc->model.seed_slope || stored.seed_offset != hc->model.seed_offset) {
+        ESP_LOGI(TAG, "Heating curve settings changed, discarding learned curve");
+        return ESP_ERR_INVALID_VERSION;
+    }
+
+    hc->model = stored;
+    ESP_LOGI(TAG, "Heating curve loaded: %.2f %%/C, offset %.1f %%, %" PRIu32 " windows",
+             stored.slope, stored.offset, stored.windows);
+    return ESP_OK;
+}
+
+esp_err_t heating_curve_save(const heating_curve_t *hc) {
+    nvs_handle_t handle;
+    esp_err_t err = nvs_open(NVS_NAMESPACE, NVS_READWRITE, &handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Error opening NVS handle: %s", esp_err_to_name(err));
+        return err;
+    }
+    err = nvs_set_blob(handle, NVS_KEY_MODEL, &hc->model, sizeof(heating_curve_model_t));
+    if (err == ESP_OK) err = nvs_commit(handle);
+    nvs_close(handle);
+
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to save heating curve: %s", esp_err_to_name(err));
+    }
+    return err;
+}
+
+float heating_curve_feedforward(const heating_curve_t *hc, float setpoint, float outside_t) {
+    if (isnan(setpoint) || !outside_valid(outside_t)) return 0.0f;
+    return clampf(hc->model.slope * (setpoint - outside_t) + hc->model.offset, 0.0f, 100.0f);
+}
+
+bool heating_curve_add_sample(heating_curve_t *hc, bool steady, float setpoint, float outside_t, float duty) {
+    if (!steady || isnan(setpoint) || !outside_valid(outside_t) ||
+        (hc->window_count > 0 && setpoint != hc->window_setpoint)) {
+        window_reset(hc);
+        return false;
+    }
+
+    if (hc->window_count == 0) hc->window_setpoint = setpoint;
+    hc->window_count++;
+    hc->sum_delta += setpoint - outside_t;
+    hc->sum_duty += duty;
+
+    if (hc->window_count < HEATING_CURVE_WINDOW_SEC) return false;
+
+    float delta = hc->sum_delta / (float)hc->window_count;
+    float avg_duty = hc->sum_duty / (float)hc->window_count;
+    window_reset(hc);
+
+    // Окремі вибірки можуть сягати меж (шум похідної), але в середньому насичення означає,
+    // що заповнення не відповідає тепловтратам
+    if (avg_duty <= HEATING_CURVE_DUTY_MARGIN || avg_duty >= 100.0f - HEATING_CURVE_DUTY_MARGIN) return false;
+
+    rls_update(&hc->model, delta, avg_duty);
+    ESP_LOGI(TAG, "Heating curve updated: dT %.1f C, duty %.1f%% -> %.2f %%/C, offset %.1f%%",
+             delta, avg_duty, hc->model.slope, hc->model.offset);
+    return true;
+}
+
+void heating_curve_outside_init(heating_curve_outside_t *o) {
+    o->temp = NAN;
+    o->weather_update = 0;
+    o->stamp_us = 0;
+}
+
+float heating_curve_outside_update(heating_curve_outside_t *o, float outside_temp, time_t weather_update,
+                                   int interval_min, int64_t now_us) {
+    if (outside_valid(outside_temp) && weather_update != o->weather_update) {
+        if (isnan(o->temp)) {
+            ESP_LOGI(TAG, "Outside temperature %.1fC available, feed-forward enabled", outside_temp);
+        }
+        o->temp = outside_temp;
+        o->weather_update = weather_update;
+        o->stamp_us = now_us;
+    }
+
+    if (!isnan(o->temp)) {
+        if (interval_min <= 0) interval_min = OUTSIDE_DEFAULT_INTERVAL_MIN;
+        int64_t max_age_us = (int64_t)OUTSIDE_MAX_AGE_INTERVALS * interval_min * 60LL * 1000000LL;
+        if (now_us - o->stamp_us > max_age_us) {
+            ESP_LOGW(TAG, "Outside temperature is %lld min old, feed-forward disabled",
+                     (long long)((now_us - o->stamp_us) / 60000000LL));
+            o->temp = NAN;
+        }
+    }
+    return o->temp;
+}
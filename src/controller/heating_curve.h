@@ -0,0 +1,107 @@
+#ifndef HEATING_CURVE_H
+#define HEATING_CURVE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
+
+/**
+ * @brief Крива опалення: усталене заповнення, потрібне для утримання уставки.
+ *
+ * duty = slope * (setpoint - Tout) + offset, %.
+ * Тепловтрати пропорційні різниці температур, тож при зміні погоди чи уставки
+ * крива одразу дає нове заповнення, а ПІД відпрацьовує лише залишок.
+ */
+typedef struct {
+    float slope;            // Нахил, % на градус різниці кімната - вулиця
+    float offset;           // Зміщення, % (внутрішні тепловиділення дають від'ємне)
+    float p[2][2];          // Коваріація RLS для [slope, offset]
+    uint32_t windows;       // Кількість вікон, на яких крива вчилась
+    float seed_slope;       // Початкові значення з налаштувань: їх зміна скидає навчання
+    float seed_offset;
+} heating_curve_model_t;
+
+/**
+ * @brief Крива та накопичувачі поточного вікна навчання.
+ */
+typedef struct {
+    heating_curve_model_t model;
+
+    uint32_t window_count;  // Усталених вибірок у поточному вікні
+    float sum_delta;        // Сума (уставка - Tout)
+    float sum_duty;         // Сума фактичного заповнення
+    float window_setpoint;  // Уставка, на якій почалось вікно
+} heating_curve_t;
+
+/**
+ * @brief Зовнішня температура для прямого зв'язку та момент, коли її отримано.
+ */
+typedef struct {
+    float temp;            // NAN - недоступна або застаріла
+    time_t weather_update; // Мітка оновлення погоди, з якого взято temp
+    int64_t stamp_us;      // Монотонний час отримання temp
+} heating_curve_outside_t;
+
+/**
+ * @brief Заповнює криву початковими значеннями без навчання.
+ *
+ * @param slope Нахил, %/C.
+ * @param offset Зміщення, %.
+ */
+void heating_curve_init(heating_curve_t *hc, float slope, float offset);
+
+/**
+ * @brief Завантажує навчену криву з NVS.
+ * Якщо збереженої кривої немає або вона вчилась з інших початкових значень, крива не змінюється.
+ */
+esp_err_t heating_curve_load(heating_curve_t *hc);
+
+/**
+ * @brief Зберігає навчену криву в NVS.
+ */
+esp_err_t heating_curve_save(const heating_curve_t *hc);
+
+/**
+ * @brief Заповнення прямого зв'язку для уставки та зовнішньої температури, % у [0, 100].
+ *
+ * @param outside_t Зовнішня температура, C (NAN або нижче -100 - недоступна, повертає 0).
+ */
+float heating_curve_feedforward(const heating_curve_t *hc, float setpoint, float outside_t);
+
+/**
+ * @brief Додає одну секундну вибірку для навчання кривої.
+ *
+ * Вибірка враховується лише в усталеному режимі: кімната на уставці, без дрейфу.
+ * Вікно з будь-якою неусталеною вибіркою чи зміною уставки відкидається, як і вікно
+ * з середнім заповненням у насиченні. По завершенню вікна крива уточнюється RLS.
+ *
+ * @param steady Вибірка усталена (визначає викликач).
+ * @param duty Фактично застосоване заповнення, %.
+ * @return true, якщо на цьому кроці крива оновилась.
+ */
+bool heating_curve_add_sample(heating_curve_t *hc, bool steady, float setpoint, float outside_t, float duty);
+
+/**
+ * @brief Скидає зовнішню температуру прямого зв'язку в стан "недоступна".
+ */
+void heating_curve_outside_init(heating_curve_outside_t *o);
+
+/**
+ * @brief Оновлює зовнішню температуру для прямого зв'язку.
+ *
+ * Кеш погоди зберігає останнє значення безстроково, тому свіжість визначається
+ * за зміною мітки оновлення погоди і відраховується монотонним годинником.
+ * Коротка недоступність погоди не вимикає прямий зв'язок стрибком, але значення,
+ * старше за два періоди опитування, відкидається (ff = 0, лишається чистий ПІД).
+ *
+ * @param outside_temp Зовнішня температура з кешу погоди, C (нижче -100 - недоступна).
+ * @param weather_update Мітка останнього оновлення погоди.
+ * @param interval_min Період опитування погоди, хв (0 - за замовчуванням).
+ * @param now_us Монотонний час, мкс.
+ * @return float Зовнішня температура або NAN, якщо свіжої немає.
+ */
+float heating_curve_outside_update(heating_curve_outside_t *o, float outside_temp, time_t weather_update,
+                                   int interval_min, int64_t now_us);
+
+#endif // HEATING_CURVE_H
@@ -87,7 +87,7 @@ static void button_event_handler_task(void *pvParameters) {
                         } else {
                             is_in_info_mode = false;
                             system_state_set_ui_state(UI_STATE_MAIN_SCREEN);
-                            main_control_change_state(STATE_OFF);
+                            main_control_change_state(STATE_OFF, MAIN_CONTROL_CAUSE_BUTTON);
                         }
                     }
                     break;
@@ -106,7 +106,7 @@ static void button_event_handler_task(void *pvParameters) {
                         }
                     } else if (event.event == BUTTON_EVENT_LONG_PRESS_START) {
                         if (current_system_state != STATE_MODE_SELECT) {
-                            main_control_change_state(STATE_MODE_SELECT);
+                            main_control_change_state(STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON);
                         }
                     }
                     break;
@@ -0,0 +1,107 @@
+#include "controller/loop_timing.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <string.h>
+
+struct loop_timing {
+    loop_timing_stats_t stats;
+    int64_t begin_us;          // Початок поточної ітерації (0 - ще не було)
+    bool in_iteration;
+};
+
+static struct loop_timing s_loops[LOOP_TIMING_MAX_LOOPS];
+static int s_loop_count = 0;
+static SemaphoreHandle_t s_lock = NULL;
+
+static int bucket_for(uint32_t us) {
+    int b = 0;
+    uint32_t edge = LOOP_TIMING_BUCKET0_US;
+    while (us >= edge && b < LOOP_TIMING_BUCKETS - 1) {
+        edge <<= 1;
+        b++;
+    }
+    return b;
+}
+
+static void reset_stats(loop_timing_stats_t *s) {
+    const char *name = s->name;
+    uint32_t nominal = s->nominal_us;
+    memset(s, 0, sizeof(loop_timing_stats_t));
+    s->name = name;
+    s->nominal_us = nominal;
+    s->period_min_us = UINT32_MAX;
+}
+
+loop_timing_handle_t loop_timing_register(const char *name, uint32_t nominal_us) {
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL) return NULL;
+    }
+
+    loop_timing_handle_t handle = NULL;
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (s_loop_count < LOOP_TIMING_MAX_LOOPS) {
+        handle = &s_loops[s_loop_count++];
+        memset(handle, 0, sizeof(struct loop_timing));
+        handle->stats.name = name;
+        handle->stats.nominal_us = nominal_us;
+        reset_stats(&handle->stats);
+    }
+    xSemaphoreGive(s_lock);
+    return handle;
+}
+
+void loop_timing_begin(loop_timing_handle_t handle, uint32_t nominal_us) {
+    if (handle == NULL) return;
+    int64_t now_us = esp_timer_get_time();
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    loop_timing_stats_t *s = &handle->stats;
+    if (nominal_us != 0) s->nominal_us = nominal_us;
+
+    // Після скидання статистики перший період рахується від останнього початку
+    if (handle->begin_us != 0) {
+        uint32_t period_us = (uint32_t)(now_us - handle->begin_us);
+        uint32_t jitter_us = period_us > s->nominal_us ? period_us - s->nominal_us : s->nominal_us - period_us;
+        s->count++;
+        s->period_sum_us += period_us;
+        if (period_us < s->period_min_us) s->period_min_us = period_us;
+        if (period_us > s->period_max_us) s->period_max_us = period_us;
+        s->jitter_hist[bucket_for(jitter_us)]++;
+    }
+    handle->begin_us = now_us;
+    handle->in_iteration = true;
+    xSemaphoreGive(s_lock);
+}
+
+void loop_timing_end(loop_timing_handle_t handle) {
+    if (handle == NULL) return;
+    int64_t now_us = esp_timer_get_time();
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    if (handle->in_iteration) {
+        loop_timing_stats_t *s = &handle->stats;
+        uint32_t exec_us = (uint32_t)(now_us - handle->begin_us);
+        s->exec_sum_us += exec_us;
+        if (exec_us > s->exec_max_us) s->exec_max_us = exec_us;
+        if (exec_us > s->nominal_us) s->overruns++;
+        s->exec_hist[bucket_for(exec_us)]++;
+        handle->in_iteration = false;
+    }
+    xSemaphoreGive(s_lock);
+}
+
+int loop_timing_count(void) {
+    return s_loop_count;
+}
+
+esp_err_t loop_timing_get(int index, loop_timing_stats_t *out, bool reset) {
+    if (index < 0 || index >= s_loop_count || out == NULL) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_loops[index].stats;
+    if (reset) reset_stats(&s_loops[index].stats);
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
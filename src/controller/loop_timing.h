@@ -0,0 +1,69 @@
+#ifndef LOOP_TIMING_H
+#define LOOP_TIMING_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+// Гістограми з логарифмічними кошиками: [0, 50) мкс, [50, 100), [100, 200), ... подвоєння
+#define LOOP_TIMING_BUCKETS      16
+#define LOOP_TIMING_BUCKET0_US   50
+
+// Максимальна кількість зареєстрованих циклів
+#define LOOP_TIMING_MAX_LOOPS    4
+
+/**
+ * @brief Статистика часу одного періодичного циклу.
+ */
+typedef struct {
+    const char *name;
+    uint32_t nominal_us;                        // Очікуваний період
+    uint32_t count;                             // Виміряних періодів
+    uint32_t overruns;                          // Ітерацій, що виконувались довше за період
+
+    uint32_t period_min_us;
+    uint32_t period_max_us;
+    uint64_t period_sum_us;
+    uint32_t jitter_hist[LOOP_TIMING_BUCKETS];  // |період - номінал|
+
+    uint32_t exec_max_us;
+    uint64_t exec_sum_us;
+    uint32_t exec_hist[LOOP_TIMING_BUCKETS];    // Час виконання ітерації
+} loop_timing_stats_t;
+
+typedef struct loop_timing *loop_timing_handle_t;
+
+/**
+ * @brief Реєструє цикл для збору статистики.
+ *
+ * @param name Ім'я (статичний рядок) для API.
+ * @param nominal_us Очікуваний період.
+ * @return loop_timing_handle_t Дескриптор або NULL, якщо місця немає.
+ */
+loop_timing_handle_t loop_timing_register(const char *name, uint32_t nominal_us);
+
+/**
+ * @brief Позначає початок ітерації (час пробудження). Вимірює період від попереднього початку.
+ *
+ * @param nominal_us Поточний очікуваний період (0 - без змін), для циклів зі змінним періодом.
+ */
+void loop_timing_begin(loop_timing_handle_t handle, uint32_t nominal_us);
+
+/**
+ * @brief Позначає кінець корисної роботи ітерації.
+ */
+void loop_timing_end(loop_timing_handle_t handle);
+
+/**
+ * @brief Кількість зареєстрованих циклів.
+ */
+int loop_timing_count(void);
+
+/**
+ * @brief Копіює статистику циклу за індексом.
+ *
+ * @param reset true - обнулити лічильники після копіювання.
+ */
+esp_err_t loop_timing_get(int index, loop_timing_stats_t *out, bool reset);
+
+#endif // LOOP_TIMING_H
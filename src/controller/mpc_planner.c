@@ -0,0 +1,138 @@
+#include "controller/mpc_planner.h"
+#include <math.h>
+#include <string.h>
+
+// Інтегрування моделі всередині кроку планування
+#define MPC_SUBSTEPS       5
+#define MPC_SUBSTEP_H      ((float)MPC_STEP_SEC / 3600.0f / MPC_SUBSTEPS)
+
+// Допуск на порушення обмеження, C
+#define MPC_TOLERANCE_C    0.02f
+
+// Затримки з внеском менше цієї частки від максимального не використовуються:
+// найближчі порушення через інерцію радіатора майже не виправити, а повна потужність
+// "на зараз" дала б перегрів через години. Такі обмеження стають м'якими.
+#define MPC_MIN_GAIN_FRACTION 0.3f
+
+// Один крок моделі: duty сталий впродовж кроку
+static void model_step(const thermal_model_t *m, float *room, float *rad, float outside, float duty, bool forced_only) {
+    float k_rad = m->room.theta[0], k_loss = m->room.theta[1], q_int = m->room.theta[2];
+    float g_heat = m->radiator.theta[0], k_rr = m->radiator.theta[1];
+
+    for (int s = 0; s < MPC_SUBSTEPS; s++) {
+        // Для імпульсної характеристики зовнішні джерела не враховуються (відгук лінійної частини)
+        float ext_room = forced_only ? k_loss * (*room) : k_loss * (*room - outside) - q_int;
+        float d_room = k_rad * (*rad - *room) - ext_room;
+        float d_rad = g_heat * duty - k_rr * (*rad - *room);
+        *room += d_room * MPC_SUBSTEP_H;
+        *rad += d_rad * MPC_SUBSTEP_H;
+    }
+}
+
+bool mpc_planner_set_model(mpc_planner_t *planner, const thermal_model_t *model) {
+    if (!thermal_model_is_converged(model)) {
+        planner->valid = false;
+        return false;
+    }
+    if (planner->valid &&
+        memcmp(planner->model.room.theta, model->room.theta, sizeof(model->room.theta)) == 0 &&
+        memcmp(planner->model.radiator.theta, model->radiator.theta, sizeof(model->radiator.theta)) == 0) {
+        return true;
+    }
+
+    planner->model = *model;
+
+    float room = 0.0f, rad = 0.0f;
+    planner->h_room[0] = 0.0f;
+    for (int k = 1; k <= MPC_HORIZON_STEPS; k++) {
+        model_step(model, &room, &rad, 0.0f, k == 1 ? 1.0f : 0.0f, true);
+        planner->h_room[k] = room;
+    }
+
+    // Ефективні затримки (внесок не менше частки від максимального) у порядку зростання:
+    // нагрів додається якомога пізніше, щоб не піднімати вже виконані обмеження
+    float h_max = 0.0f;
+    for (int k = 1; k <= MPC_HORIZON_STEPS; k++) {
+        if (planner->h_room[k] > h_max) h_max = planner->h_room[k];
+    }
+    planner->num_lags = 0;
+    for (int lag = 1; lag <= MPC_HORIZON_STEPS; lag++) {
+        if (planner->h_room[lag] >= MPC_MIN_GAIN_FRACTION * h_max) {
+            planner->lag_order[planner->num_lags++] = (uint8_t)lag;
+        }
+    }
+
+    planner->valid = true;
+    return true;
+}
+
+/**
+ * @brief Найбільший приріст заповнення на кроці j, за якого прогноз у всіх наступних
+ * точках не перевищує room_max. Точки, вже вищі за межу, забороняють нагрів на j.
+ */
+static float headroom_duty(const mpc_planner_t *planner, const mpc_plan_t *plan, int j, float room_max) {
+    float cap = 1.0f - plan->duty[j];
+    for (int m = j + 1; m <= MPC_HORIZON_STEPS && cap > 0.0f; m++) {
+        float h = planner->h_room[m - j];
+        if (h <= 0.0f) continue;
+        float room_cap = (room_max - plan->room[m]) / h;
+        if (room_cap < cap) cap = room_cap;
+    }
+    return cap > 0.0f ? cap : 0.0f;
+}
+
+void mpc_planner_solve(const mpc_planner_t *planner, float room_t, float rad_t, float outside_t,
+                       const float *ref, float room_max, mpc_plan_t *plan) {
+    memset(plan, 0, sizeof(mpc_plan_t));
+    plan->feasible = true;
+    plan->within_max = true;
+    if (!planner->valid) {
+        plan->feasible = false;
+        return;
+    }
+
+    // Вільний рух без нагріву
+    float free_room[MPC_HORIZON_STEPS + 1];
+    float room = room_t, rad = rad_t;
+    plan->room[0] = room_t;
+    for (int k = 1; k <= MPC_HORIZON_STEPS; k++) {
+        model_step(&planner->model, &room, &rad, outside_t, 0.0f, false);
+        plan->room[k] = room;
+    }
+    memcpy(free_room, plan->room, sizeof(free_room));
+
+    // Обмеження перевіряються по черзі: нагрів, доданий для точки k, лише підвищує
+    // прогноз у пізніших точках, тому повернення до попередніх не потрібне
+    for (int k = 1; k <= MPC_HORIZON_STEPS; k++) {
+        float deficit = ref[k] - plan->room[k];
+        if (deficit <= MPC_TOLERANCE_C) continue;
+
+        for (int li = 0; li < planner->num_lags && deficit > MPC_TOLERANCE_C; li++) {
+            int lag = planner->lag_order[li];
+            int j = k - lag;
+            if (j < 0 || plan->duty[j] >= 1.0f) continue;
+
+            float h = planner->h_room[lag];
+            float delta = fminf(headroom_duty(planner, plan, j, room_max), deficit / h);
+            if (delta <= 0.0f) continue;
+            plan->duty[j] += delta;
+            for (int m = j + 1; m <= MPC_HORIZON_STEPS; m++) {
+                plan->room[m] += delta * planner->h_room[m - j];
+            }
+            deficit = ref[k] - plan->room[k];
+        }
+        if (deficit > MPC_TOLERANCE_C) plan->feasible = false;
+    }
+
+    for (int k = 0; k < MPC_HORIZON_STEPS; k++) {
+        plan->energy_h += plan->duty[k] * ((float)MPC_STEP_SEC / 3600.0f);
+    }
+
+    // Контроль верхньої межі: перевищення, до якого доклався запланований нагрів
+    for (int k = 1; k <= MPC_HORIZON_STEPS; k++) {
+        if (plan->room[k] > room_max + MPC_TOLERANCE_C && plan->room[k] > free_room[k] + MPC_TOLERANCE_C) {
+            plan->within_max = false;
+            break;
+        }
+    }
+}
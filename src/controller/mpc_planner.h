@@ -0,0 +1,62 @@
+#ifndef MPC_PLANNER_H
+#define MPC_PLANNER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "controller/thermal_model.h"
+
+// Горизонт 6 год кроками по 5 хв
+#define MPC_STEP_SEC       300
+#define MPC_HORIZON_STEPS  72
+
+/**
+ * @brief Планувальник: імпульсна характеристика кімнати для поточної теплової моделі.
+ *
+ * Модель лінійна, тож прогноз = вільний рух + сума відгуків на заплановані кроки потужності.
+ * Характеристика перераховується лише при зміні параметрів моделі.
+ */
+typedef struct {
+    thermal_model_t model;                       // Копія параметрів, для яких пораховано відгук
+    bool valid;
+    float h_room[MPC_HORIZON_STEPS + 1];         // Приріст Tr через k кроків від duty = 1 на одному кроці
+    uint8_t lag_order[MPC_HORIZON_STEPS];        // Ефективні затримки у порядку зростання
+    uint8_t num_lags;
+} mpc_planner_t;
+
+/**
+ * @brief Результат розв'язання на горизонті.
+ */
+typedef struct {
+    float duty[MPC_HORIZON_STEPS];               // Заплановане заповнення 0..1 на кожному кроці
+    float room[MPC_HORIZON_STEPS + 1];           // Прогноз температури кімнати на межах кроків
+    float energy_h;                              // Сумарний час роботи нагрівача, год
+    bool feasible;                               // Усі комфортні обмеження досяжні
+    bool within_max;                             // Запланований нагрів не піднімає прогноз вище room_max
+} mpc_plan_t;
+
+/**
+ * @brief Оновлює імпульсну характеристику, якщо параметри моделі змінились.
+ *
+ * @return false, якщо модель не зійшлася (планувати не можна).
+ */
+bool mpc_planner_set_model(mpc_planner_t *planner, const thermal_model_t *model);
+
+/**
+ * @brief Планує мінімальну енергію, за якої ref[k] <= Tr[k] <= room_max на всьому горизонті.
+ *
+ * Жадібний розв'язок лінійної задачі: для першого порушення нижньої межі нагрів додається
+ * на найпізніший крок, чий внесок у порушену точку близький до максимального на одиницю
+ * енергії, але не більше, ніж дозволяє запас до room_max у всіх наступних точках.
+ * Нижні обмеження, які через інерцію або верхню межу вже не виконати, залишаються м'якими;
+ * верхня межа жорстка для запланованого нагріву (вільний рух вище неї не виправити).
+ * Складність O(N^3) у гіршому випадку.
+ *
+ * @param room_t, rad_t, outside_t Поточний стан і прогноз зовнішньої температури (стала).
+ * @param ref Мінімально допустима температура на межах кроків, MPC_HORIZON_STEPS + 1 значень.
+ * @param room_max Максимально допустима температура кімнати.
+ * @param[out] plan Результат.
+ */
+void mpc_planner_solve(const mpc_planner_t *planner, float room_t, float rad_t, float outside_t,
+                       const float *ref, float room_max, mpc_plan_t *plan);
+
+#endif // MPC_PLANNER_H
@@ -0,0 +1,94 @@
+#include "controller/room_estimator.h"
+#include "esp_timer.h"
+#include <math.h>
+#include <string.h>
+
+// Спектральна щільність шуму процесу: температура та збурення (випадкове блукання)
+#define PROCESS_NOISE_TEMP  1e-6f   // C^2/с
+#define PROCESS_NOISE_BIAS  1e-11f  // (C/с)^2/с
+
+// Початкова невизначеність збурення (відповідає ~1 C/год)
+#define INITIAL_BIAS_VAR    ((1.0f / 3600.0f) * (1.0f / 3600.0f))
+
+// Межа збурення, щоб хибні вимірювання не розхитали модель
+#define MAX_BIAS_C_PER_SEC  (5.0f / 3600.0f)
+
+static float model_rate(const room_estimator_t *est, float temp, float rad_t, bool relay_on, float outside_t) {
+    float rate = est->cfg.k_rad * (rad_t - temp);
+    if (outside_t > -100.0f) {
+        rate -= est->cfg.k_loss * (temp - outside_t);
+    }
+    if (relay_on) {
+        rate += est->cfg.k_relay;
+    }
+    return rate;
+}
+
+void room_estimator_init(room_estimator_t *est, const room_estimator_config_t *cfg) {
+    memset(est, 0, sizeof(room_estimator_t));
+    est->cfg = *cfg;
+    if (est->cfg.meas_noise <= 0.0f) est->cfg.meas_noise = 0.01f;
+    est->_last_time_us = esp_timer_get_time();
+}
+
+float room_estimator_update(room_estimator_t *est, float room_t, float rad_t, bool relay_on, float outside_t) {
+    int64_t now_us = esp_timer_get_time();
+    float dt = (float)(now_us - est->_last_time_us) / 1000000.0f;
+    est->_last_time_us = now_us;
+
+    if (dt <= 0.0f || dt > 100.0f) {
+        dt = 1.0f;
+    }
+
+    if (!est->initialized) {
+        est->temp = room_t;
+        est->bias = 0.0f;
+        est->rate = model_rate(est, room_t, rad_t, relay_on, outside_t);
+        est->p[0][0] = est->cfg.meas_noise;
+        est->p[0][1] = 0.0f;
+        est->p[1][0] = 0.0f;
+        est->p[1][1] = INITIAL_BIAS_VAR;
+        est->initialized = true;
+        return est->temp;
+    }
+
+    // Прогноз: x = F x + u, F = [[1 - dt*(k_rad + k_loss), dt], [0, 1]]
+    float k_total = est->cfg.k_rad + (outside_t > -100.0f ? est->cfg.k_loss : 0.0f);
+    float f00 = 1.0f - dt * k_total;
+    float f01 = dt;
+
+    est->temp += dt * (model_rate(est, est->temp, rad_t, relay_on, outside_t) + est->bias);
+
+    // P = F P F^T + Q
+    float p00 = est->p[0][0], p01 = est->p[0][1], p10 = est->p[1][0], p11 = est->p[1][1];
+    float fp00 = f00 * p00 + f01 * p10;
+    float fp01 = f00 * p01 + f01 * p11;
+    est->p[0][0] = fp00 * f00 + fp01 * f01 + PROCESS_NOISE_TEMP * dt;
+    est->p[0][1] = fp01;
+    est->p[1][0] = fp01;
+    est->p[1][1] = p11 + PROCESS_NOISE_BIAS * dt;
+
+    // Корекція вимірюванням температури кімнати, H = [1, 0]
+    float innovation = room_t - est->temp;
+    float s = est->p[0][0] + est->cfg.meas_noise;
+    float k0 = est->p[0][0] / s;
+    float k1 = est->p[1][0] / s;
+
+    est->temp += k0 * innovation;
+    est->bias += k1 * innovation;
+    est->bias = fmaxf(-MAX_BIAS_C_PER_SEC, fminf(MAX_BIAS_C_PER_SEC, est->bias));
+
+    // P = (I - K H) P
+    p00 = est->p[0][0]; p01 = est->p[0][1]; p11 = est->p[1][1];
+    est->p[0][0] = (1.0f - k0) * p00;
+    est->p[0][1] = (1.0f - k0) * p01;
+    est->p[1][0] = est->p[0][1];
+    est->p[1][1] = p11 - k1 * p01;
+
+    est->rate = model_rate(est, est->temp, rad_t, relay_on, outside_t) + est->bias;
+    return est->temp;
+}
+
+float room_estimator_get_rate_per_hour(const room_estimator_t *est) {
+    return est->rate * 3600.0f;
+}
@@ -0,0 +1,58 @@
+#ifndef ROOM_ESTIMATOR_H
+#define ROOM_ESTIMATOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Параметри теплової моделі кімнати для оцінювача.
+ *
+ * dT/dt = k_rad * (T_rad - T) - k_loss * (T - T_out) + k_relay * relay + b
+ * де b - повільне невідоме збурення (сонце, люди, похибка моделі), що оцінюється фільтром.
+ */
+typedef struct {
+    float k_rad;       // Теплопередача від радіатора, 1/с
+    float k_loss;      // Тепловтрати назовні, 1/с
+    float k_relay;     // Прямий внесок увімкненого нагрівача, C/с
+    float meas_noise;  // Дисперсія шуму вимірювання кімнатної температури, C^2
+} room_estimator_config_t;
+
+/**
+ * @brief Стан фільтра Калмана зі станом [T, b].
+ */
+typedef struct {
+    room_estimator_config_t cfg;
+
+    float temp;        // Оцінка температури кімнати, C
+    float bias;        // Оцінка збурення, C/с
+    float rate;        // Оцінка швидкості зміни температури, C/с
+
+    float p[2][2];     // Коваріація похибки оцінки
+
+    bool initialized;
+    int64_t _last_time_us;
+} room_estimator_t;
+
+/**
+ * @brief Ініціалізує оцінювач. Перше вимірювання задає початковий стан.
+ */
+void room_estimator_init(room_estimator_t *est, const room_estimator_config_t *cfg);
+
+/**
+ * @brief Виконує крок прогнозу та корекції.
+ *
+ * @param est Вказівник на оцінювач.
+ * @param room_t Виміряна температура кімнати (без важкого згладжування), C.
+ * @param rad_t Температура радіатора, C.
+ * @param relay_on Поточний стан реле нагрівача.
+ * @param outside_t Зовнішня температура, C (нижче -100 - недоступна).
+ * @return float Оцінка температури кімнати.
+ */
+float room_estimator_update(room_estimator_t *est, float room_t, float rad_t, bool relay_on, float outside_t);
+
+/**
+ * @brief Повертає оцінку швидкості зміни температури кімнати, C/год.
+ */
+float room_estimator_get_rate_per_hour(const room_estimator_t *est);
+
+#endif // ROOM_ESTIMATOR_H
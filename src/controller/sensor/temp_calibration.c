@@ -0,0 +1,164 @@
+#include "controller/sensor/temp_calibration.h"
+#include "esp_log.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "TEMP_CAL";
+
+#define KELVIN_OFFSET 273.15
+
+// Повторне захоплення в межах цього інтервалу замінює наявну точку
+#define TEMP_CAL_MERGE_C 2.0f
+
+// Діапазон опорів, у якому крива має залишатися монотонною, Ом
+#define TEMP_CAL_R_MIN 100.0
+#define TEMP_CAL_R_MAX 1000000.0
+
+static bool point_valid(const temp_cal_point_t *p) {
+    return isfinite(p->temp_c) && isfinite(p->resistance) &&
+           p->resistance > 0.0f && p->temp_c > -KELVIN_OFFSET;
+}
+
+esp_err_t temp_calibration_fit_steinhart_hart(const temp_cal_point_t points[3], float *a, float *b, float *c) {
+    if (points == NULL || a == NULL || b == NULL || c == NULL) return ESP_ERR_INVALID_ARG;
+
+    double l[3], y[3];
+    for (int i = 0; i < 3; i++) {
+        if (!point_valid(&points[i])) return ESP_ERR_INVALID_ARG;
+        l[i] = log((double)points[i].resistance);
+        y[i] = 1.0 / ((double)points[i].temp_c + KELVIN_OFFSET);
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int j = i + 1; j < 3; j++) {
+            if (fabsf(points[i].temp_c - points[j].temp_c) < TEMP_CAL_MIN_SPAN_C) return ESP_ERR_INVALID_ARG;
+            if (fabs(l[i] - l[j]) < 1e-6) return ESP_ERR_INVALID_ARG;
+        }
+    }
+
+    // Точний розв'язок системи 3x3 через розділені різниці
+    double g2 = (y[1] - y[0]) / (l[1] - l[0]);
+    double g3 = (y[2] - y[0]) / (l[2] - l[0]);
+    double cc = (g3 - g2) / (l[2] - l[1]) / (l[0] + l[1] + l[2]);
+    double bb = g2 - cc * (l[0] * l[0] + l[0] * l[1] + l[1] * l[1]);
+    double aa = y[0] - (bb + l[0] * l[0] * cc) * l[0];
+
+    if (!isfinite(aa) || !isfinite(bb) || !isfinite(cc) || bb <= 0.0) return ESP_ERR_INVALID_ARG;
+
+    // d(1/T)/d(lnR) = b + 3c*lnR^2 має бути додатною в усьому робочому діапазоні,
+    // інакше таблиця перетворення стане немонотонною
+    double l_lo = log(TEMP_CAL_R_MIN), l_hi = log(TEMP_CAL_R_MAX);
+    if (bb + 3.0 * cc * l_lo * l_lo <= 0.0 || bb + 3.0 * cc * l_hi * l_hi <= 0.0) return ESP_ERR_INVALID_ARG;
+
+    *a = (float)aa;
+    *b = (float)bb;
+    *c = (float)cc;
+    return ESP_OK;
+}
+
+esp_err_t temp_calibration_fit_beta(const temp_cal_point_t *points, int num_points, float t0, float *r0, float *beta) {
+    if (points == NULL || r0 == NULL || beta == NULL || num_points < 1 || num_points > 2) return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < num_points; i++) {
+        if (!point_valid(&points[i])) return ESP_ERR_INVALID_ARG;
+    }
+
+    double y0 = 1.0 / ((double)t0 + KELVIN_OFFSET);
+    double y1 = 1.0 / ((double)points[0].temp_c + KELVIN_OFFSET);
+    double b = *beta;
+
+    if (num_points == 2) {
+        if (fabsf(points[0].temp_c - points[1].temp_c) < TEMP_CAL_MIN_SPAN_C) return ESP_ERR_INVALID_ARG;
+        double y2 = 1.0 / ((double)points[1].temp_c + KELVIN_OFFSET);
+        b = log((double)points[0].resistance / (double)points[1].resistance) / (y1 - y2);
+    }
+    if (!isfinite(b) || b <= 0.0) return ESP_ERR_INVALID_ARG;
+
+    // R(T0) з R(T1) = R0 * exp(B * (1/T1 - 1/T0))
+    double r = (double)points[0].resistance * exp(b * (y0 - y1));
+    if (!isfinite(r) || r <= 0.0) return ESP_ERR_INVALID_ARG;
+
+    *r0 = (float)r;
+    *beta = (float)b;
+    return ESP_OK;
+}
+
+esp_err_t temp_calibration_capture(temp_sensor_id_t id, float reference_c) {
+    if (id < 0 || id >= NUM_TEMP_SENSORS || !isfinite(reference_c)) return ESP_ERR_INVALID_ARG;
+
+    float avg_raw = 0.0f, resistance = 0.0f;
+    esp_err_t err = temp_controller_get_channel_raw(id, &avg_raw, &resistance);
+    if (err != ESP_OK) return err;
+
+    temp_cal_point_t point = { .temp_c = reference_c, .resistance = resistance };
+    if (!point_valid(&point)) return ESP_ERR_INVALID_STATE;
+
+    app_settings_t *s = settings_get_writeable();
+    temp_sensor_settings_t *ch = &s->sensors.channels[id];
+    if (ch->cal.num_points > TEMP_CAL_MAX_POINTS) ch->cal.num_points = 0;
+
+    // Точка з близькою температурою або, якщо слотів немає, найближча - замінюється
+    int nearest = -1;
+    float nearest_d = INFINITY;
+    for (int i = 0; i < ch->cal.num_points; i++) {
+        float d = fabsf(ch->cal.points[i].temp_c - reference_c);
+        if (d < nearest_d) {
+            nearest_d = d;
+            nearest = i;
+        }
+    }
+    int slot;
+    if (nearest >= 0 && (nearest_d < TEMP_CAL_MERGE_C || ch->cal.num_points == TEMP_CAL_MAX_POINTS)) {
+        slot = nearest;
+    } else {
+        slot = ch->cal.num_points++;
+    }
+    ch->cal.points[slot] = point;
+
+    ESP_LOGI(TAG, "Sensor %d: point %d captured, ref=%.2f C, raw=%.1f, R=%.1f Ohm",
+             id, slot, reference_c, avg_raw, resistance);
+    return settings_save();
+}
+
+esp_err_t temp_calibration_solve(temp_sensor_id_t id) {
+    if (id < 0 || id >= NUM_TEMP_SENSORS) return ESP_ERR_INVALID_ARG;
+
+    app_settings_t *s = settings_get_writeable();
+    temp_sensor_settings_t *ch = &s->sensors.channels[id];
+    int n = ch->cal.num_points;
+    if (n < 1 || n > TEMP_CAL_MAX_POINTS) return ESP_ERR_INVALID_STATE;
+
+    esp_err_t err;
+    if (n == 3) {
+        float a, b, c;
+        err = temp_calibration_fit_steinhart_hart(ch->cal.points, &a, &b, &c);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Sensor %d: Steinhart-Hart fit rejected", id);
+            return err;
+        }
+        ch->cal.a = a;
+        ch->cal.b = b;
+        ch->cal.c = c;
+        ch->cal.enabled = true;
+        ESP_LOGI(TAG, "Sensor %d: SH a=%.6e b=%.6e c=%.6e", id, a, b, c);
+    } else {
+        float r0 = ch->ntc.r0, beta = ch->ntc.beta;
+        err = temp_calibration_fit_beta(ch->cal.points, n, ch->ntc.t0, &r0, &beta);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "Sensor %d: beta fit rejected", id);
+            return err;
+        }
+        ch->ntc.r0 = r0;
+        ch->ntc.beta = beta;
+        ch->cal.enabled = false;
+        ESP_LOGI(TAG, "Sensor %d: R0=%.1f Ohm, B=%.1f", id, r0, beta);
+    }
+    return settings_save();
+}
+
+esp_err_t temp_calibration_clear(temp_sensor_id_t id) {
+    if (id < 0 || id >= NUM_TEMP_SENSORS) return ESP_ERR_INVALID_ARG;
+
+    app_settings_t *s = settings_get_writeable();
+    memset(&s->sensors.channels[id].cal, 0, sizeof(s->sensors.channels[id].cal));
+    ESP_LOGI(TAG, "Sensor %d: calibration cleared", id);
+    return settings_save();
+}
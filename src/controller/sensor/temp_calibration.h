@@ -0,0 +1,58 @@
+#ifndef TEMP_CALIBRATION_H
+#define TEMP_CALIBRATION_H
+
+#include "esp_err.h"
+#include "controller/sensor/temp_controller.h"
+#include "model/settings_manager.h"
+
+// Мінімальна різниця еталонних температур між точками, C.
+// Ближчі точки дають погано обумовлену систему для коефіцієнтів.
+#define TEMP_CAL_MIN_SPAN_C 5.0f
+
+/**
+ * @brief Розв'язує коефіцієнти Стейнгарта–Гарта за трьома точками (точний розв'язок).
+ *
+ * @param points Три точки з різними температурами.
+ * @param[out] a, b, c Коефіцієнти рівняння 1/T = a + b*ln(R) + c*ln(R)^3.
+ * @return esp_err_t ESP_ERR_INVALID_ARG, якщо точки погано обумовлені
+ *         або отримана крива немонотонна.
+ */
+esp_err_t temp_calibration_fit_steinhart_hart(const temp_cal_point_t points[3], float *a, float *b, float *c);
+
+/**
+ * @brief Уточнює параметри B-рівняння за однією або двома точками.
+ *
+ * Одна точка зсуває номінальний опір r0 при незмінному B,
+ * дві точки визначають і B, і r0 при номінальній температурі t0.
+ *
+ * @param points Точки калібрування.
+ * @param num_points 1 або 2.
+ * @param t0 Номінальна температура, C.
+ * @param[in,out] r0 Номінальний опір, Ом.
+ * @param[in,out] beta B-коефіцієнт.
+ */
+esp_err_t temp_calibration_fit_beta(const temp_cal_point_t *points, int num_points, float t0, float *r0, float *beta);
+
+/**
+ * @brief Захоплює калібрувальну точку: поточний опір каналу при еталонній температурі.
+ *
+ * Точка з близькою температурою (або найближча, якщо всі слоти зайняті) замінюється.
+ * Точки зберігаються в NVS одразу, щоб пережити перезавантаження між вимірюваннями.
+ */
+esp_err_t temp_calibration_capture(temp_sensor_id_t id, float reference_c);
+
+/**
+ * @brief Обчислює калібрування каналу з захоплених точок і зберігає його в NVS.
+ *
+ * Три точки вмикають Стейнгарта–Гарта, одна або дві уточнюють B-рівняння.
+ * Нові коефіцієнти застосовуються при наступній ініціалізації драйвера,
+ * коли будується таблиця перетворення, тому вимірювання не дорожчає.
+ */
+esp_err_t temp_calibration_solve(temp_sensor_id_t id);
+
+/**
+ * @brief Видаляє точки та вимикає Стейнгарта–Гарта для каналу і зберігає в NVS.
+ */
+esp_err_t temp_calibration_clear(temp_sensor_id_t id);
+
+#endif // TEMP_CALIBRATION_H
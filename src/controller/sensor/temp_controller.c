@@ -1,10 +1,19 @@
 #include "controller/sensor/temp_controller.h"
+#include "controller/sensor/temp_filter.h"
+#include "controller/sensor/temp_health.h"
+#include "controller/sensor/temp_history.h"
+#include "controller/loop_timing.h"
+#include "controller/actuator/relay_controller.h"
 #include "drivers/sensor/temp_sensor_driver.h"
 #include "model/system_state.h"
+#include "model/settings_manager.h"
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include <math.h>
+#include <stdlib.h>
+#include <string.h>
 #include "hal/adc_types.h"
 #include "hw_config.h"
 
@@ -16,110 +25,525 @@ static const char *TAG = "TEMP_CONTROLLER";
 // 16-64 оптимальний діапазоном.
 #define OVERSAMPLING_COUNT 32
 
+// Налаштування для безперервного (DMA) режиму
+// Вибірки накопичуються апаратно, тому передискретизація не коштує часу процесора.
+// ESP32 не підтримує частоту сканування нижче 20 кГц; кожен канал додає до кадру 64 вибірки (~3.2 мс).
+#define CONTINUOUS_SAMPLE_FREQ_HZ     20000
+#define CONTINUOUS_OVERSAMPLING_COUNT 64
+#define CONTINUOUS_FRAME_TIMEOUT_MS   100
+
 // Налаштування для експоненційного фільтра (EMA)
 // Коефіцієнт згладжування. Чим ближче до 0, тим сильніше згладжування (повільніша реакція).
 // Чим ближче до 1, тим слабше згладжування (швидша реакція).
-// 0.1 - оптимальний вибір для повільно змінюваних даних, як температура.
+// Використовується, якщо в налаштуваннях каналу задано некоректне значення.
 #define EMA_FILTER_ALPHA 0.1f
 
-// Статичні змінні для зберігання відфільтрованих значень між викликами
-static float s_filtered_temp[NUM_TEMP_SENSORS];
+// Як часто (у циклах сканування) виводити в лог вартість обробки каналів
+#define SCAN_STATS_LOG_INTERVAL 120
+
+// Адаптивне планування вимірювань
+// FAST: радіатор опитується часто, поки реле увімкнене або радіатор швидко змінює температуру.
+// IDLE: реле давно вимкнене і всі канали стабільні - рідкі вимірювання з меншою передискретизацією.
+#define FAST_RADIATOR_INTERVAL_MS      250
+#define IDLE_INTERVAL_MS               2000
+#define IDLE_OVERSAMPLING_COUNT        8
+#define FAST_RADIATOR_SLOPE_C_PER_MIN  1.0f   // Поріг швидкості радіатора для режиму FAST
+#define IDLE_SLOPE_C_PER_MIN           0.05f  // Усі канали повільніші за цей поріг - можна в IDLE
+#define IDLE_ENTER_DELAY_MS            (5 * 60 * 1000) // Реле має бути вимкнене щонайменше стільки
+#define SLOPE_EMA_ALPHA                0.2f
+#define MIN_TASK_DELAY_MS              10
+
+// Як часто виводити в лог витрати часу на вимірювання за режимами
+#define SAMPLING_STATS_LOG_INTERVAL_US (3600LL * 1000000LL)
+
+// Конвеєри фільтрації (медіана -> Хампель -> EMA/біквад) для кожного каналу
+static temp_filter_t s_filters[NUM_TEMP_SENSORS];
+
+// Монітори справності каналів (обрив, замикання, заморожене показання, шум)
+static temp_health_monitor_t s_health[NUM_TEMP_SENSORS];
+
+// Останній усереднений сирий код каналу (Q8) для захоплення калібрувальних точок
+static volatile uint32_t s_last_avg_q8[NUM_TEMP_SENSORS];
+
+// Вартість обробки: середній час на канал та час читання кадру DMA, мкс
+static float s_channel_cost_us[NUM_TEMP_SENSORS];
+static float s_frame_cost_us = 0.0f;
+static uint32_t s_scan_counter = 0;
 
 static ntc_sensor_handle_t s_sensor_handles[NUM_TEMP_SENSORS];
+static int s_num_active_sensors = 0;
 static TaskHandle_t s_task_handle = NULL;
 static uint32_t s_update_interval_ms = 1000;
+static temp_acq_mode_t s_acq_mode = TEMP_ACQ_ONESHOT;
+
+typedef enum {
+    SAMPLING_NORMAL,
+    SAMPLING_FAST,
+    SAMPLING_IDLE,
+    SAMPLING_MODE_COUNT
+} sampling_mode_t;
+
+typedef struct {
+    uint32_t interval_ms;           // Період опитування звичайних каналів
+    uint32_t radiator_interval_ms;  // Період опитування радіатора
+    int oversampling;               // Кількість одиночних читань на канал (режим ONESHOT)
+} sampling_profile_t;
+
+// Витрати часу в режимі: сумарний час роботи завдання та час роботи АЦП
+typedef struct {
+    uint32_t scans;
+    int64_t elapsed_us;
+    int64_t task_us;
+    int64_t adc_us;
+} sampling_stats_t;
+
+static bool s_adaptive_sampling = false;
+static sampling_profile_t s_profiles[SAMPLING_MODE_COUNT];
+static sampling_mode_t s_sampling_mode = SAMPLING_NORMAL;
+static sampling_stats_t s_sampling_stats[SAMPLING_MODE_COUNT];
+static int64_t s_stats_window_start_us = 0;
+static int64_t s_scan_adc_us = 0;            // Час АЦП за поточне сканування (ONESHOT)
+
+static int64_t s_next_due_us[NUM_TEMP_SENSORS];
+static float s_last_filtered[NUM_TEMP_SENSORS];
+static int64_t s_last_sample_us[NUM_TEMP_SENSORS];
+static float s_slope_c_per_min[NUM_TEMP_SENSORS];
+static int64_t s_relay_off_since_us = 0;
+
+static const char *sampling_mode_name(sampling_mode_t mode) {
+    switch (mode) {
+        case SAMPLING_FAST: return "FAST";
+        case SAMPLING_IDLE: return "IDLE";
+        default: return "NORMAL";
+    }
+}
+
+// Кільцевий буфер історії: записувач - завдання контролера, читачі - веб-сервер тощо
+static temp_history_t s_history;
+
+// Пакет передискретизації одного каналу за цикл
+typedef struct {
+    uint32_t sum;
+    uint32_t samples;
+    uint32_t avg_q8;    // Середній код у форматі Q8
+    uint16_t min;
+    uint16_t max;
+} raw_batch_t;
 
 /**
- * @brief Приватна функція для читання та усереднення температури з датчика.
- * Перший рівень фільтрації.
+ * @brief Перетворює пакет сирих кодів у температуру: один пошук у таблиці на канал.
+ * У цілочисельному шляху використовується середнє у форматі Q8 без втрати дробової частини коду.
  */
-static esp_err_t read_averaged_temperature(temp_sensor_id_t sensor_id, float *avg_temp) {
-    float temp_sum = 0;
-    int valid_samples = 0;
-    float current_temp;
-
-    for (int i = 0; i < OVERSAMPLING_COUNT; i++) {
-        if (temp_sensor_driver_read_ntc(s_sensor_handles[sensor_id], &current_temp) == ESP_OK) {
-            if (!isnan(current_temp)) {
-                temp_sum += current_temp;
-                valid_samples++;
-            }
+static esp_err_t convert_batch(temp_sensor_id_t sensor_id, const raw_batch_t *batch,
+                               uint16_t *raw_code, temp_value_t *avg_temp) {
+    *raw_code = (uint16_t)((batch->avg_q8 + (1 << (NTC_RAW_Q8_SHIFT - 1))) >> NTC_RAW_Q8_SHIFT);
+
+#if TEMP_FIXED_POINT
+    return temp_sensor_driver_raw_q8_to_centi(s_sensor_handles[sensor_id], batch->avg_q8, avg_temp);
+#else
+    float avg_raw = (float)batch->sum / batch->samples;
+    if (temp_sensor_driver_raw_to_temp(s_sensor_handles[sensor_id], avg_raw, avg_temp) != ESP_OK || isnan(*avg_temp)) {
+        return ESP_FAIL;
+    }
+    return ESP_OK;
+#endif
+}
+
+/**
+ * @brief Приватна функція для читання пакета одиночних вимірювань з датчика.
+ * Перший рівень фільтрації. Підсумовуються сирі коди АЦП, а перетворення
+ * в температуру виконується один раз для середнього значення.
+ */
+static void read_oneshot_batch(temp_sensor_id_t sensor_id, int oversampling, raw_batch_t *batch) {
+    int raw;
+
+    for (int i = 0; i < oversampling; i++) {
+        int64_t conv_start_us = esp_timer_get_time();
+        if (temp_sensor_driver_read_raw(s_sensor_handles[sensor_id], &raw) == ESP_OK) {
+            batch->sum += raw;
+            batch->samples++;
+            if (raw < batch->min) batch->min = (uint16_t)raw;
+            if (raw > batch->max) batch->max = (uint16_t)raw;
         }
+        s_scan_adc_us += esp_timer_get_time() - conv_start_us;
         vTaskDelay(pdMS_TO_TICKS(2));
     }
+}
 
-    if (valid_samples > 0) {
-        *avg_temp = temp_sum / valid_samples;
-        return ESP_OK;
+/**
+ * @brief Приватна функція для отримання пакета каналу з кадру DMA.
+ */
+static void read_frame_batch(temp_sensor_id_t sensor_id, const ntc_adc_frame_t *frame, raw_batch_t *batch) {
+    if (frame == NULL ||
+        temp_sensor_driver_frame_sum(frame, s_sensor_handles[sensor_id], &batch->sum, &batch->samples) != ESP_OK ||
+        temp_sensor_driver_frame_extremes(frame, s_sensor_handles[sensor_id], &batch->min, &batch->max) != ESP_OK) {
+        batch->samples = 0;
     }
+}
 
-    return ESP_FAIL;
+/**
+ * @brief Збирає пакет вибірок каналу обраним способом.
+ * @return esp_err_t ESP_FAIL, якщо не отримано жодної вибірки.
+ */
+static esp_err_t read_sensor_batch(temp_sensor_id_t sensor_id, const ntc_adc_frame_t *frame, raw_batch_t *batch) {
+    batch->sum = 0;
+    batch->samples = 0;
+    batch->min = UINT16_MAX;
+    batch->max = 0;
+
+    if (s_acq_mode == TEMP_ACQ_CONTINUOUS) {
+        read_frame_batch(sensor_id, frame, batch);
+    } else {
+        read_oneshot_batch(sensor_id, s_profiles[s_sampling_mode].oversampling, batch);
+    }
+
+    if (batch->samples == 0) return ESP_FAIL;
+    batch->avg_q8 = (uint32_t)((((uint64_t)batch->sum << NTC_RAW_Q8_SHIFT) + batch->samples / 2) / batch->samples);
+    return ESP_OK;
+}
+
+/**
+ * @brief Оновлює монітор справності каналу та додає зміну стану до пакета скану.
+ */
+static void update_health(temp_sensor_id_t id, const raw_batch_t *batch, bool valid, int64_t now_us,
+                          system_state_txn_t *txn) {
+    temp_health_sample_t sample = {
+        .valid = valid,
+        .avg_raw_q8 = batch->avg_q8,
+        .raw_min = batch->min,
+        .raw_max = batch->max
+    };
+    temp_health_t prev = s_health[id].status;
+    temp_health_t health = temp_health_update(&s_health[id], &sample, now_us);
+    if (health != prev) {
+        ESP_LOGW(TAG, "Sensor %d health: %s -> %s (raw %u..%u, spread %u)", id,
+                 temp_health_to_string(prev), temp_health_to_string(health),
+                 s_health[id].raw_min_seen, s_health[id].raw_max_seen, s_health[id].last_spread);
+        system_state_txn_set_sensor_health(txn, id, health);
+    }
+}
+
+/**
+ * @brief Формує конфігурацію конвеєра фільтрації з налаштувань каналу.
+ * Коефіцієнт EMA з налаштувань задано для звичайного періоду оновлення; на інших
+ * періодах опитування каналу фільтр перераховується зі збереженням сталої часу.
+ */
+static void build_filter_config(const temp_sensor_settings_t *ch, temp_filter_config_t *fc) {
+    fc->median_window = ch->filter.median_window;
+    fc->hampel_window = ch->filter.hampel_window;
+    fc->hampel_k = ch->filter.hampel_k;
+    fc->smooth = (temp_filter_smooth_t)ch->filter.smoothing;
+    if (fc->smooth > TEMP_FILTER_SMOOTH_BIQUAD) fc->smooth = TEMP_FILTER_SMOOTH_EMA;
+    fc->ema_alpha = (ch->ema_alpha > 0.0f && ch->ema_alpha <= 1.0f) ? ch->ema_alpha : EMA_FILTER_ALPHA;
+    fc->cutoff_hz = ch->filter.cutoff_hz;
+    fc->sample_rate_hz = s_update_interval_ms > 0 ? 1000.0f / (float)s_update_interval_ms : 1.0f;
 }
 
 /**
- * @brief Приватна функція для ініціалізації та оновлення експоненційного фільтра.
- * Другий рівень фільтрації.
+ * @brief Оновлює ковзне середнє часу виконання (для звіту про вартість каналу).
  */
-static void update_ema_filter(temp_sensor_id_t sensor_id, float raw_temp) {
-    if (isnan(s_filtered_temp[sensor_id])) {
-        s_filtered_temp[sensor_id] = raw_temp;
+static void update_cost(float *avg_us, int64_t elapsed_us) {
+    if (*avg_us <= 0.0f) {
+        *avg_us = (float)elapsed_us;
     } else {
-        // Формула фільтра: new_value = alpha * new_sample + (1 - alpha) * old_value
-        s_filtered_temp[sensor_id] = (EMA_FILTER_ALPHA * raw_temp) + ((1.0f - EMA_FILTER_ALPHA) * s_filtered_temp[sensor_id]);
+        *avg_us = 0.9f * (*avg_us) + 0.1f * (float)elapsed_us;
+    }
+}
+
+/**
+ * @brief Оновлює оцінку швидкості зміни температури каналу, C/хв.
+ */
+static void update_slope(temp_sensor_id_t id, float filtered, int64_t now_us) {
+    if (s_last_sample_us[id] > 0) {
+        float dt_min = (float)(now_us - s_last_sample_us[id]) / 60000000.0f;
+        if (dt_min > 0.0f) {
+            float slope = (filtered - s_last_filtered[id]) / dt_min;
+            s_slope_c_per_min[id] = SLOPE_EMA_ALPHA * slope + (1.0f - SLOPE_EMA_ALPHA) * s_slope_c_per_min[id];
+        }
+    }
+    s_last_filtered[id] = filtered;
+    s_last_sample_us[id] = now_us;
+}
+
+/**
+ * @brief Обирає режим вимірювань за станом реле та швидкістю зміни температур.
+ */
+static sampling_mode_t select_sampling_mode(int64_t now_us) {
+    if (!s_adaptive_sampling) return SAMPLING_NORMAL;
+
+    bool relay_on = relay_controller_get_heater_state();
+    if (relay_on) {
+        s_relay_off_since_us = 0;
+        return SAMPLING_FAST;
+    }
+    if (s_relay_off_since_us == 0) {
+        s_relay_off_since_us = now_us;
+    }
+
+    if (fabsf(s_slope_c_per_min[TEMP_SENSOR_RADIATOR]) > FAST_RADIATOR_SLOPE_C_PER_MIN) {
+        return SAMPLING_FAST;
+    }
+
+    if (now_us - s_relay_off_since_us < (int64_t)IDLE_ENTER_DELAY_MS * 1000) {
+        return SAMPLING_NORMAL;
+    }
+    for (int id = 0; id < NUM_TEMP_SENSORS; id++) {
+        if (s_sensor_handles[id] == NULL) continue;
+        if (fabsf(s_slope_c_per_min[id]) > IDLE_SLOPE_C_PER_MIN) {
+            return SAMPLING_NORMAL;
+        }
     }
+    return SAMPLING_IDLE;
+}
+
+static uint32_t channel_interval_ms(temp_sensor_id_t id, sampling_mode_t mode) {
+    return id == TEMP_SENSOR_RADIATOR ? s_profiles[mode].radiator_interval_ms : s_profiles[mode].interval_ms;
+}
+
+/**
+ * @brief Перемикає режим вимірювань: переносить терміни опитування каналів на новий період
+ * і перераховує фільтри каналів на нову частоту вибірок.
+ */
+static void apply_sampling_mode(sampling_mode_t mode, int64_t now_us) {
+    if (mode == s_sampling_mode) return;
+
+    ESP_LOGI(TAG, "Sampling mode: %s -> %s", sampling_mode_name(s_sampling_mode), sampling_mode_name(mode));
+    s_sampling_mode = mode;
+
+    for (int id = 0; id < NUM_TEMP_SENSORS; id++) {
+        uint32_t interval_ms = channel_interval_ms(id, mode);
+        int64_t due = now_us + (int64_t)interval_ms * 1000;
+        if (s_next_due_us[id] > due) s_next_due_us[id] = due;
+        temp_filter_set_sample_rate(&s_filters[id], 1000.0f / (float)interval_ms);
+    }
+
+    if (s_acq_mode == TEMP_ACQ_CONTINUOUS) {
+        // У рідкому режимі АЦП не сканує між кадрами
+        temp_sensor_driver_continuous_set_gated(mode == SAMPLING_IDLE);
+    }
+}
+
+static void log_sampling_stats(void) {
+    for (int m = 0; m < SAMPLING_MODE_COUNT; m++) {
+        const sampling_stats_t *st = &s_sampling_stats[m];
+        if (st->elapsed_us <= 0) continue;
+        // Нормалізація до однієї години перебування в режимі
+        float hours = (float)st->elapsed_us / 3600e6f;
+        ESP_LOGI(TAG, "Sampling %s: %.0f%% of time, %lu scans, task %.2f s/h, ADC %.2f s/h",
+                 sampling_mode_name(m), 100.0f * st->elapsed_us / SAMPLING_STATS_LOG_INTERVAL_US,
+                 (unsigned long)st->scans, st->task_us / 1e6f / hours, st->adc_us / 1e6f / hours);
+    }
+    memset(s_sampling_stats, 0, sizeof(s_sampling_stats));
+}
+
+static void log_scan_stats(void) {
+    float total_us = s_frame_cost_us;
+    for (int i = 0; i < NUM_TEMP_SENSORS; i++) {
+        if (s_sensor_handles[i] == NULL) continue;
+        total_us += s_channel_cost_us[i];
+        ESP_LOGI(TAG, "Scan cost: ch %d = %.0f us, outliers rejected %lu", i, s_channel_cost_us[i],
+                 (unsigned long)s_filters[i].outliers);
+    }
+    ESP_LOGI(TAG, "Scan cost: %d channel(s), frame %.0f us, total %.0f us (%.0f us per channel)",
+             s_num_active_sensors, s_frame_cost_us, total_us,
+             s_num_active_sensors > 0 ? total_us / s_num_active_sensors : 0.0f);
 }
 
 
 static void temp_controller_task(void *pvParameters) {
     ESP_LOGI(TAG, "Task started.");
-    float raw_averaged_temp;
+    temp_value_t raw_averaged_temp;
+    uint16_t raw_code;
+    raw_batch_t batch;
+    ntc_adc_frame_t frame;
+    temp_history_entry_t entry;
+    system_state_txn_t state_txn;
+    int64_t last_loop_us = esp_timer_get_time();
+    s_stats_window_start_us = last_loop_us;
+    loop_timing_handle_t loop_timing = loop_timing_register("temp_scan",
+        channel_interval_ms(TEMP_SENSOR_ROOM, s_sampling_mode) * 1000);
 
     while (1) {
-        // Обробка датчика 1
-        if (read_averaged_temperature(TEMP_SENSOR_1, &raw_averaged_temp) == ESP_OK) {
-            // Застосування другого рівня фільтрації
-            update_ema_filter(TEMP_SENSOR_1, raw_averaged_temp);
-            // Оновлення стану відфільтрованим значенням
-            system_state_set_temp_s1(s_filtered_temp[TEMP_SENSOR_1]);
-            ESP_LOGD(TAG, "Sensor 1: Raw=%.2f C, Filtered=%.2f C", raw_averaged_temp, s_filtered_temp[TEMP_SENSOR_1]);
-        } else {
-            ESP_LOGW(TAG, "Failed to read from Sensor 1");
+        int64_t now_us = esp_timer_get_time();
+        sampling_stats_t *stats = &s_sampling_stats[s_sampling_mode];
+        stats->elapsed_us += now_us - last_loop_us;
+        if (s_acq_mode == TEMP_ACQ_CONTINUOUS && temp_sensor_driver_continuous_is_running()) {
+            // Безперервне сканування: АЦП працює весь час між ітераціями
+            stats->adc_us += now_us - last_loop_us;
         }
+        last_loop_us = now_us;
 
-        // Обробка датчика 2
-        if (read_averaged_temperature(TEMP_SENSOR_2, &raw_averaged_temp) == ESP_OK) {
-            // Застосування другого рівня фільтрації
-            update_ema_filter(TEMP_SENSOR_2, raw_averaged_temp);
-            // Оновлення стану відфільтрованим значенням
-            system_state_set_temp_s2(s_filtered_temp[TEMP_SENSOR_2]);
-            ESP_LOGD(TAG, "Sensor 2: Raw=%.2f C, Filtered=%.2f C", raw_averaged_temp, s_filtered_temp[TEMP_SENSOR_2]);
-        } else {
-            ESP_LOGW(TAG, "Failed to read from Sensor 2");
+        apply_sampling_mode(select_sampling_mode(now_us), now_us);
+        stats = &s_sampling_stats[s_sampling_mode];
+
+        bool due[NUM_TEMP_SENSORS];
+        bool any_due = false;
+        for (int id = 0; id < NUM_TEMP_SENSORS; id++) {
+            due[id] = s_sensor_handles[id] != NULL && now_us >= s_next_due_us[id];
+            any_due |= due[id];
         }
 
-        vTaskDelay(pdMS_TO_TICKS(s_update_interval_ms));
+        if (any_due) {
+            // Період вимірюється по кімнатному каналу, радіаторний може опитуватись частіше
+            if (due[TEMP_SENSOR_ROOM]) {
+                loop_timing_begin(loop_timing, channel_interval_ms(TEMP_SENSOR_ROOM, s_sampling_mode) * 1000);
+            }
+            s_scan_adc_us = 0;
+            const ntc_adc_frame_t *frame_ptr = NULL;
+            if (s_acq_mode == TEMP_ACQ_CONTINUOUS) {
+                bool gated = !temp_sensor_driver_continuous_is_running();
+                int64_t frame_start_us = esp_timer_get_time();
+                if (temp_sensor_driver_read_frame(&frame, CONTINUOUS_FRAME_TIMEOUT_MS) == ESP_OK) {
+                    frame_ptr = &frame;
+                } else {
+                    ESP_LOGW(TAG, "Failed to read ADC DMA frame");
+                }
+                int64_t frame_us = esp_timer_get_time() - frame_start_us;
+                if (gated) s_scan_adc_us += frame_us;
+                update_cost(&s_frame_cost_us, frame_us);
+            }
+
+            entry.timestamp_us = esp_timer_get_time();
+            // Результати всього скану публікуються одним пакетом: читачі бачать
+            // кімнату й радіатор з одного скану, а версія стану зростає раз на скан
+            system_state_txn_begin(&state_txn);
+            for (int id = 0; id < NUM_TEMP_SENSORS; id++) {
+                entry.raw[id] = TEMP_HISTORY_RAW_INVALID;
+                entry.filtered[id] = NAN;
+                if (!due[id]) continue;
+
+                // Терміни йдуть від попереднього терміну, а не від моменту пробудження,
+                // щоб затримки планувальника не накопичувались у дрейф періоду
+                int64_t interval_us = (int64_t)channel_interval_ms(id, s_sampling_mode) * 1000;
+                s_next_due_us[id] += interval_us;
+                if (s_next_due_us[id] <= now_us) s_next_due_us[id] = now_us + interval_us;
+
+                int64_t start_us = esp_timer_get_time();
+                bool got_batch = read_sensor_batch(id, frame_ptr, &batch) == ESP_OK;
+                update_health(id, &batch, got_batch, entry.timestamp_us, &state_txn);
+                s_last_avg_q8[id] = got_batch ? batch.avg_q8 : 0;
+
+                if (got_batch && convert_batch(id, &batch, &raw_code, &raw_averaged_temp) == ESP_OK) {
+                    // Другий рівень фільтрації: конвеєр каналу
+                    float filtered = TEMP_VALUE_TO_C(temp_filter_process(&s_filters[id], raw_averaged_temp));
+                    // Оновлення стану відфільтрованим значенням (межа з рештою системи - у градусах)
+                    system_state_txn_set_temp(&state_txn, id, filtered, TEMP_VALUE_TO_C(s_filters[id].despiked));
+                    update_slope(id, filtered, entry.timestamp_us);
+                    entry.raw[id] = raw_code;
+                    entry.filtered[id] = filtered;
+                    ESP_LOGD(TAG, "Sensor %d: Raw=%.2f C, Filtered=%.2f C", id, TEMP_VALUE_TO_C(raw_averaged_temp), filtered);
+                } else {
+                    ESP_LOGW(TAG, "Failed to read from Sensor %d", id);
+                }
+                update_cost(&s_channel_cost_us[id], esp_timer_get_time() - start_us);
+            }
+            system_state_txn_commit(&state_txn);
+            temp_history_push(&s_history, &entry);
+            loop_timing_end(loop_timing);
+
+            stats->scans++;
+            stats->task_us += esp_timer_get_time() - now_us;
+            stats->adc_us += s_scan_adc_us;
+
+            if (++s_scan_counter % SCAN_STATS_LOG_INTERVAL == 0) {
+                log_scan_stats();
+            }
+        }
+
+        int64_t after_us = esp_timer_get_time();
+        if (after_us - s_stats_window_start_us >= SAMPLING_STATS_LOG_INTERVAL_US) {
+            log_sampling_stats();
+            s_stats_window_start_us = after_us;
+        }
+
+        // Сон до найближчого терміну опитування
+        int64_t next_us = INT64_MAX;
+        for (int id = 0; id < NUM_TEMP_SENSORS; id++) {
+            if (s_sensor_handles[id] != NULL && s_next_due_us[id] < next_us) next_us = s_next_due_us[id];
+        }
+        int64_t sleep_ms = (next_us - after_us) / 1000;
+        if (sleep_ms < MIN_TASK_DELAY_MS) sleep_ms = MIN_TASK_DELAY_MS;
+        vTaskDelay(pdMS_TO_TICKS((uint32_t)sleep_ms));
     }
 }
 
 esp_err_t temp_controller_init(const temp_controller_config_t *config) {
     ESP_LOGI(TAG, "Initializing...");
 
-    // Ініціалізація початкових значень для фільтрів
+    const app_settings_t *cfg = settings_get();
+
+    if (config) {
+        s_update_interval_ms = config->update_interval_ms;
+        s_acq_mode = config->acq_mode;
+        s_adaptive_sampling = config->adaptive_sampling;
+    }
+
+    s_profiles[SAMPLING_NORMAL] = (sampling_profile_t){ s_update_interval_ms, s_update_interval_ms, OVERSAMPLING_COUNT };
+    s_profiles[SAMPLING_FAST] = (sampling_profile_t){ s_update_interval_ms, FAST_RADIATOR_INTERVAL_MS, OVERSAMPLING_COUNT };
+    s_profiles[SAMPLING_IDLE] = (sampling_profile_t){ IDLE_INTERVAL_MS, IDLE_INTERVAL_MS, IDLE_OVERSAMPLING_COUNT };
+
+    // Ініціалізація драйверів за реєстром каналів з налаштувань
     for (int i = 0; i < NUM_TEMP_SENSORS; i++) {
-        s_filtered_temp[i] = NAN;
+        const temp_sensor_settings_t *ch = &cfg->sensors.channels[i];
+
+        s_channel_cost_us[i] = 0.0f;
+        s_sensor_handles[i] = NULL;
+        s_next_due_us[i] = 0;
+        s_last_sample_us[i] = 0;
+        s_slope_c_per_min[i] = 0.0f;
+
+        temp_filter_config_t filter_config;
+        build_filter_config(ch, &filter_config);
+        temp_filter_init(&s_filters[i], &filter_config);
+        temp_health_init(&s_health[i], esp_timer_get_time());
+
+        if (!ch->enabled) continue;
+
+        ntc_thermistor_config_t ntc_config = {
+            .nominal_resistance = ch->ntc.r0,
+            .nominal_temperature_c = ch->ntc.t0,
+            .b_value = ch->ntc.beta,
+            .fixed_resistor_ohms = ch->ntc.r_fixed,
+            .use_steinhart_hart = ch->cal.enabled,
+            .sh_a = ch->cal.a,
+            .sh_b = ch->cal.b,
+            .sh_c = ch->cal.c
+        };
+        s_sensor_handles[i] = temp_sensor_driver_init_ntc(ch->adc_channel, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &ntc_config);
+        if (!s_sensor_handles[i]) {
+            ESP_LOGE(TAG, "Failed to init sensor %d '%s' (ADC ch %d)", i, ch->name, ch->adc_channel);
+            if (i == TEMP_SENSOR_ROOM || i == TEMP_SENSOR_RADIATOR) return ESP_FAIL;
+            continue;
+        }
+        s_num_active_sensors++;
+        ESP_LOGI(TAG, "Sensor %d '%s' on ADC ch %d, filter: median %d, hampel %d, smooth %d",
+                 i, ch->name, ch->adc_channel, s_filters[i].cfg.median_window,
+                 s_filters[i].cfg.hampel_window, s_filters[i].cfg.smooth);
     }
 
-    // Ініціалізація драйверів
-    ntc_thermistor_config_t ntc_config_1 = {.nominal_resistance = 10000.0f, .nominal_temperature_c = 25.0f, .b_value = 3950.0f, .fixed_resistor_ohms = 10000.0f};
-    s_sensor_handles[TEMP_SENSOR_1] = temp_sensor_driver_init_ntc(THERMISTOR_ENVIRONMENT, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &ntc_config_1);
-    if (!s_sensor_handles[TEMP_SENSOR_1]) return ESP_FAIL;
+    if (!s_sensor_handles[TEMP_SENSOR_ROOM] || !s_sensor_handles[TEMP_SENSOR_RADIATOR]) {
+        ESP_LOGE(TAG, "Room and radiator sensors must be enabled");
+        return ESP_FAIL;
+    }
 
-    ntc_thermistor_config_t ntc_config_2 = {.nominal_resistance = 10000.0f, .nominal_temperature_c = 25.0f, .b_value = 3950.0f, .fixed_resistor_ohms = 10000.0f};
-    s_sensor_handles[TEMP_SENSOR_2] = temp_sensor_driver_init_ntc(THERMISTOR_RADIATOR, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &ntc_config_2);
-    if (!s_sensor_handles[TEMP_SENSOR_2]) return ESP_FAIL;
+    if (config && config->history_bytes > 0) {
+        esp_err_t err = temp_history_init(&s_history, config->history_bytes);
+        if (err != ESP_OK) {
+            ESP_LOGW(TAG, "History disabled (%s)", esp_err_to_name(err));
+        } else {
+            ESP_LOGI(TAG, "History: %u entries (%u bytes, %.1f min)", (unsigned)s_history.capacity,
+                     (unsigned)(s_history.capacity * sizeof(temp_history_entry_t)),
+                     s_history.capacity * s_update_interval_ms / 60000.0f);
+        }
+    }
 
-    if (config) {
-        s_update_interval_ms = config->update_interval_ms;
+    if (s_acq_mode == TEMP_ACQ_CONTINUOUS) {
+        esp_err_t err = temp_sensor_driver_continuous_start(CONTINUOUS_SAMPLE_FREQ_HZ, CONTINUOUS_OVERSAMPLING_COUNT);
+        if (err != ESP_OK) {
+            // Драйвер повернув АЦП в oneshot: вимірювання продовжуються одиночними читаннями
+            ESP_LOGW(TAG, "Failed to start continuous ADC (%s), falling back to oneshot", esp_err_to_name(err));
+            s_acq_mode = TEMP_ACQ_ONESHOT;
+        }
     }
 
     BaseType_t status = xTaskCreate(
@@ -138,4 +562,23 @@ esp_err_t temp_controller_init(const temp_controller_config_t *config) {
 
     ESP_LOGI(TAG, "Initialized and task started successfully.");
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+size_t temp_controller_history_capacity(void) {
+    return s_history.capacity;
+}
+
+size_t temp_controller_history_read(int64_t from_us, int64_t to_us, temp_history_entry_t *out, size_t max_entries) {
+    return temp_history_read(&s_history, from_us, to_us, out, max_entries);
+}
+
+esp_err_t temp_controller_get_channel_raw(temp_sensor_id_t id, float *avg_raw, float *resistance) {
+    if (id < 0 || id >= NUM_TEMP_SENSORS || avg_raw == NULL || resistance == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_sensor_handles[id] == NULL) return ESP_ERR_INVALID_STATE;
+
+    uint32_t avg_q8 = s_last_avg_q8[id];
+    if (avg_q8 == 0) return ESP_ERR_NOT_FOUND;
+
+    *avg_raw = (float)avg_q8 / (float)(1 << NTC_RAW_Q8_SHIFT);
+    return temp_sensor_driver_raw_to_resistance(s_sensor_handles[id], *avg_raw, resistance);
+}
@@ -2,21 +2,51 @@
 #define COMPONENTS_CONTROLLERS_TEMP_CONTROLLER_H_
 
 #include "esp_err.h"
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "hw_config.h"
+
+// Спосіб отримання вибірок з АЦП
+typedef enum {
+    TEMP_ACQ_ONESHOT,    // Послідовні одиночні читання з паузами між ними
+    TEMP_ACQ_CONTINUOUS  // Безперервне сканування каналів через DMA, обробка цілими кадрами
+} temp_acq_mode_t;
 
 // Конфігурація для завдання контролера
 typedef struct {
     uint32_t update_interval_ms; // Інтервал оновлення даних у мілісекундах
     int task_priority;           // Пріоритет завдання FreeRTOS
     int task_stack_size;         // Розмір стеку для завдання
+    temp_acq_mode_t acq_mode;    // Режим отримання вибірок (за замовчуванням TEMP_ACQ_ONESHOT)
+    size_t history_bytes;        // Бюджет пам'яті кільцевого буфера історії (0 = історія вимкнена)
+    bool adaptive_sampling;      // Змінювати частоту вимірювань за активністю нагрівача
 } temp_controller_config_t;
 
-// Перелік датчиків для внутрішнього використання
+// Слоти реєстру датчиків. Параметри кожного слота беруться з app_settings_t.sensors.
+// Кімната та радіатор обов'язкові, решта каналів вмикаються в налаштуваннях.
 typedef enum {
-    TEMP_SENSOR_1,
-    TEMP_SENSOR_2,
+    TEMP_SENSOR_ROOM,
+    TEMP_SENSOR_RADIATOR,
+    TEMP_SENSOR_FLOOR,
+    TEMP_SENSOR_PIPE_RETURN,
+    TEMP_SENSOR_ROOM_2,
+    TEMP_SENSOR_AUX,
     NUM_TEMP_SENSORS
 } temp_sensor_id_t;
 
+_Static_assert(NUM_TEMP_SENSORS == MAX_TEMP_SENSORS, "temp_sensor_id_t must cover MAX_TEMP_SENSORS");
+
+// Значення сирого коду для вимкненого каналу або невдалого читання
+#define TEMP_HISTORY_RAW_INVALID 0xFFFF
+
+// Один запис історії: результат циклу сканування всіх каналів
+typedef struct {
+    int64_t timestamp_us;                  // Час сканування (esp_timer)
+    uint16_t raw[NUM_TEMP_SENSORS];        // Усереднений сирий код АЦП
+    float filtered[NUM_TEMP_SENSORS];      // Відфільтрована температура, C (NAN - немає даних)
+} temp_history_entry_t;
+
 /**
  * @brief Ініціалізує контролер температури та запускає фонове завдання для оновлення даних.
  *
@@ -25,4 +55,33 @@ typedef enum {
  */
 esp_err_t temp_controller_init(const temp_controller_config_t *config);
 
+/**
+ * @brief Копіює записи історії з інтервалу часу [from_us, to_us] у хронологічному порядку.
+ *
+ * Не блокує завдання вимірювання: якщо під час копіювання найстаріші записи
+ * були перезаписані, вони відкидаються з результату.
+ *
+ * @param from_us Початок інтервалу (esp_timer, мкс).
+ * @param to_us Кінець інтервалу (esp_timer, мкс).
+ * @param out Буфер для записів.
+ * @param max_entries Місткість буфера. Якщо записів більше, повертаються найновіші.
+ * @return size_t Кількість скопійованих записів.
+ */
+size_t temp_controller_history_read(int64_t from_us, int64_t to_us, temp_history_entry_t *out, size_t max_entries);
+
+/**
+ * @brief Повертає місткість кільцевого буфера історії в записах.
+ */
+size_t temp_controller_history_capacity(void);
+
+/**
+ * @brief Повертає останній усереднений сирий код каналу та відповідний опір термістора.
+ *
+ * @param id Слот датчика.
+ * @param[out] avg_raw Середній сирий код АЦП.
+ * @param[out] resistance Опір термістора, Ом.
+ * @return esp_err_t ESP_ERR_NOT_FOUND, якщо канал ще не має вимірювань.
+ */
+esp_err_t temp_controller_get_channel_raw(temp_sensor_id_t id, float *avg_raw, float *resistance);
+
 #endif /* COMPONENTS_CONTROLLERS_TEMP_CONTROLLER_H_ */
\ No newline at end of file
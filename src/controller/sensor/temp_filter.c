@@ -0,0 +1,257 @@
+#include "controller/sensor/temp_filter.h"
+#include <math.h>
+#include <string.h>
+
+// Коефіцієнт переходу від MAD до оцінки стандартного відхилення (нормальний розподіл)
+#define MAD_TO_SIGMA 1.4826f
+
+// Мінімальний поріг Хампеля, C. Без нього квантування АЦП дає MAD = 0,
+// і будь-яка зміна на один код вважалась би викидом.
+#define HAMPEL_MIN_THRESHOLD 0.1f
+
+#define BIQUAD_Q 0.70710678f
+
+// Межа частоти зрізу біквада відносно частоти вибірок (трохи нижче Найквіста)
+#define BIQUAD_MAX_CUTOFF_RATIO 0.45f
+
+#if TEMP_FIXED_POINT
+#define Q16_ONE   (1 << 16)
+#define Q16_HALF  (1 << 15)
+#define TEMP_VALUE_ABS(v) ((v) < 0 ? -(v) : (v))
+#else
+#define TEMP_VALUE_ABS(v) fabsf(v)
+#endif
+
+static temp_value_t median_of(const temp_value_t *buf, uint8_t len) {
+    temp_value_t sorted[TEMP_FILTER_MAX_WINDOW];
+    memcpy(sorted, buf, len * sizeof(temp_value_t));
+
+    // Сортування вставками: вікно не перевищує 9 елементів
+    for (int i = 1; i < len; i++) {
+        temp_value_t v = sorted[i];
+        int j = i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    if (len % 2) {
+        return sorted[len / 2];
+    }
+#if TEMP_FIXED_POINT
+    // Середнє двох центральних з округленням униз (детерміновано для від'ємних)
+    int32_t sum = sorted[len / 2 - 1] + sorted[len / 2];
+    return sum >= 0 ? sum / 2 : -((-sum + 1) / 2);
+#else
+    return 0.5f * (sorted[len / 2 - 1] + sorted[len / 2]);
+#endif
+}
+
+static void window_push(temp_value_t *buf, uint8_t *len, uint8_t *pos, uint8_t size, temp_value_t x) {
+    buf[*pos] = x;
+    *pos = (uint8_t)((*pos + 1) % size);
+    if (*len < size) (*len)++;
+}
+
+static temp_value_t stage_median(temp_filter_t *f, temp_value_t x) {
+    uint8_t size = f->cfg.median_window;
+    if (size <= 1) return x;
+
+    window_push(f->median_buf, &f->median_len, &f->median_pos, size, x);
+    return median_of(f->median_buf, f->median_len);
+}
+
+static temp_value_t hampel_threshold(const temp_filter_t *f, temp_value_t mad) {
+#if TEMP_FIXED_POINT
+    int32_t threshold = (int32_t)(((int64_t)mad * f->hampel_k_sigma_q16 + Q16_HALF) >> 16);
+    int32_t min_threshold = (int32_t)(HAMPEL_MIN_THRESHOLD * 100.0f + 0.5f);
+    return threshold > min_threshold ? threshold : min_threshold;
+#else
+    return fmaxf(f->cfg.hampel_k * MAD_TO_SIGMA * mad, HAMPEL_MIN_THRESHOLD);
+#endif
+}
+
+/**
+ * @brief Причинний фільтр Хампеля: вибірка порівнюється з медіаною попереднього вікна.
+ * У вікно потрапляє вихідна вибірка, а не замінена, тому справжній стрибок
+ * температури приймається після заповнення половини вікна.
+ */
+static temp_value_t stage_hampel(temp_filter_t *f, temp_value_t x) {
+    uint8_t size = f->cfg.hampel_window;
+    if (size == 0) return x;
+
+    temp_value_t y = x;
+    if (f->hampel_len >= 3) {
+        temp_value_t med = median_of(f->hampel_buf, f->hampel_len);
+
+        temp_value_t dev[TEMP_FILTER_MAX_WINDOW];
+        for (int i = 0; i < f->hampel_len; i++) {
+            dev[i] = TEMP_VALUE_ABS(f->hampel_buf[i] - med);
+        }
+        temp_value_t threshold = hampel_threshold(f, median_of(dev, f->hampel_len));
+
+        if (TEMP_VALUE_ABS(x - med) > threshold) {
+            y = med;
+            f->outliers++;
+        }
+    }
+
+    window_push(f->hampel_buf, &f->hampel_len, &f->hampel_pos, size, x);
+    return y;
+}
+
+#if TEMP_FIXED_POINT
+// Коефіцієнт переводиться в Q16 лише при ініціалізації та зміні частоти; далі обробка без float
+static void ema_coefficients(temp_filter_t *f) {
+    f->ema_alpha_q16 = (int32_t)lroundf(f->cfg.ema_alpha * Q16_ONE);
+    if (f->ema_alpha_q16 < 1) f->ema_alpha_q16 = 1;
+}
+
+static temp_value_t stage_smooth(temp_filter_t *f, temp_value_t x) {
+    if (f->cfg.smooth != TEMP_FILTER_SMOOTH_EMA) {
+        return x;
+    }
+
+    int32_t x_q16 = x * Q16_ONE;
+    if (!f->primed) {
+        f->ema_q16 = x_q16;
+    } else {
+        // ema += alpha * (x - ema); добуток у 64 бітах, округлення до найближчого
+        int64_t delta = (int64_t)f->ema_alpha_q16 * ((int64_t)x_q16 - f->ema_q16);
+        f->ema_q16 += (int32_t)(delta >= 0 ? (delta + Q16_HALF) >> 16 : -((-delta + Q16_HALF) >> 16));
+    }
+    return f->ema_q16 >= 0 ? (f->ema_q16 + Q16_HALF) >> 16 : -((-f->ema_q16 + Q16_HALF) >> 16);
+}
+#else
+static void biquad_lowpass_design(temp_filter_t *f) {
+    float fs = f->cfg.sample_rate_hz;
+    float fc = fminf(f->cfg.cutoff_hz, BIQUAD_MAX_CUTOFF_RATIO * fs);
+
+    float w0 = 2.0f * (float)M_PI * fc / fs;
+    float cos_w0 = cosf(w0);
+    float alpha = sinf(w0) / (2.0f * BIQUAD_Q);
+    float a0 = 1.0f + alpha;
+
+    f->b0 = ((1.0f - cos_w0) / 2.0f) / a0;
+    f->b1 = (1.0f - cos_w0) / a0;
+    f->b2 = f->b0;
+    f->a1 = (-2.0f * cos_w0) / a0;
+    f->a2 = (1.0f - alpha) / a0;
+}
+
+/**
+ * @brief Усталений стан біквада для сталого сигналу y (коефіцієнт підсилення на постійному струмі - 1).
+ */
+static void biquad_settle(temp_filter_t *f, float y) {
+    f->z2 = (f->b2 - f->a2) * y;
+    f->z1 = (f->b1 - f->a1) * y + f->z2;
+}
+
+static temp_value_t stage_smooth(temp_filter_t *f, temp_value_t x) {
+    switch (f->cfg.smooth) {
+        case TEMP_FILTER_SMOOTH_EMA:
+            if (!f->primed) {
+                f->ema = x;
+            } else {
+                f->ema = f->cfg.ema_alpha * x + (1.0f - f->cfg.ema_alpha) * f->ema;
+            }
+            return f->ema;
+
+        case TEMP_FILTER_SMOOTH_BIQUAD: {
+            if (!f->primed) {
+                // Встановлюємо стан, що відповідає усталеному режиму для x (без перехідного процесу)
+                biquad_settle(f, x);
+            }
+            float y = f->b0 * x + f->z1;
+            f->z1 = f->b1 * x - f->a1 * y + f->z2;
+            f->z2 = f->b2 * x - f->a2 * y;
+            f->biquad_out = y;
+            return y;
+        }
+
+        case TEMP_FILTER_SMOOTH_NONE:
+        default:
+            return x;
+    }
+}
+#endif
+
+void temp_filter_reset(temp_filter_t *f) {
+    f->median_len = 0;
+    f->median_pos = 0;
+    f->hampel_len = 0;
+    f->hampel_pos = 0;
+#if TEMP_FIXED_POINT
+    f->ema_q16 = 0;
+#else
+    f->z1 = 0.0f;
+    f->z2 = 0.0f;
+    f->biquad_out = 0.0f;
+    f->ema = 0.0f;
+#endif
+    f->primed = false;
+}
+
+void temp_filter_init(temp_filter_t *f, const temp_filter_config_t *cfg) {
+    memset(f, 0, sizeof(temp_filter_t));
+    f->cfg = *cfg;
+
+    if (f->cfg.median_window > TEMP_FILTER_MAX_WINDOW) f->cfg.median_window = TEMP_FILTER_MAX_WINDOW;
+    if (f->cfg.hampel_window > TEMP_FILTER_MAX_WINDOW) f->cfg.hampel_window = TEMP_FILTER_MAX_WINDOW;
+    if (f->cfg.hampel_k <= 0.0f) f->cfg.hampel_k = 3.0f;
+    if (f->cfg.ema_alpha <= 0.0f || f->cfg.ema_alpha > 1.0f) f->cfg.ema_alpha = 0.1f;
+
+    // alpha = 1 - exp(-1 / (tau * fs)): стала часу зберігається при зміні частоти вибірок
+    f->ema_tau_s = 0.0f;
+    if (f->cfg.sample_rate_hz > 0.0f && f->cfg.ema_alpha < 1.0f) {
+        f->ema_tau_s = -1.0f / (f->cfg.sample_rate_hz * logf(1.0f - f->cfg.ema_alpha));
+    }
+
+#if TEMP_FIXED_POINT
+    if (f->cfg.smooth == TEMP_FILTER_SMOOTH_BIQUAD) f->cfg.smooth = TEMP_FILTER_SMOOTH_EMA;
+    f->hampel_k_sigma_q16 = (int32_t)lroundf(f->cfg.hampel_k * MAD_TO_SIGMA * Q16_ONE);
+    ema_coefficients(f);
+#else
+    if (f->cfg.smooth == TEMP_FILTER_SMOOTH_BIQUAD) {
+        // Частота зрізу має бути нижчою за частоту Найквіста
+        if (f->cfg.sample_rate_hz <= 0.0f || f->cfg.cutoff_hz <= 0.0f ||
+            f->cfg.cutoff_hz >= BIQUAD_MAX_CUTOFF_RATIO * f->cfg.sample_rate_hz) {
+            f->cfg.smooth = TEMP_FILTER_SMOOTH_EMA;
+        } else {
+            biquad_lowpass_design(f);
+        }
+    }
+#endif
+
+    temp_filter_reset(f);
+}
+
+void temp_filter_set_sample_rate(temp_filter_t *f, float sample_rate_hz) {
+    if (sample_rate_hz <= 0.0f || sample_rate_hz == f->cfg.sample_rate_hz) return;
+    f->cfg.sample_rate_hz = sample_rate_hz;
+
+    if (f->ema_tau_s > 0.0f) {
+        f->cfg.ema_alpha = 1.0f - expf(-1.0f / (f->ema_tau_s * sample_rate_hz));
+    }
+#if TEMP_FIXED_POINT
+    ema_coefficients(f);
+#else
+    if (f->cfg.smooth == TEMP_FILTER_SMOOTH_BIQUAD) {
+        biquad_lowpass_design(f);
+        // Стан транспонованої форми залежить від коефіцієнтів: перерахунок з останнього
+        // виходу продовжує сигнал без стрибка (похідна при цьому обнуляється)
+        if (f->primed) biquad_settle(f, f->biquad_out);
+    }
+#endif
+}
+
+temp_value_t temp_filter_process(temp_filter_t *f, temp_value_t x) {
+    temp_value_t y = stage_median(f, x);
+    y = stage_hampel(f, y);
+    f->despiked = y;
+    y = stage_smooth(f, y);
+    f->primed = true;
+    return y;
+}
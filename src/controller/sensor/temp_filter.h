@@ -0,0 +1,105 @@
+#ifndef TEMP_FILTER_H
+#define TEMP_FILTER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hw_config.h"
+
+#if TEMP_FIXED_POINT
+// Температура в сотих частках градуса
+typedef int32_t temp_value_t;
+#define TEMP_VALUE_TO_C(v)   ((float)(v) * 0.01f)
+#define TEMP_VALUE_FROM_C(c) ((temp_value_t)lroundf((c) * 100.0f))
+#else
+typedef float temp_value_t;
+#define TEMP_VALUE_TO_C(v)   (v)
+#define TEMP_VALUE_FROM_C(c) (c)
+#endif
+
+// Максимальна довжина вікна медіанного фільтра та фільтра Хампеля
+#define TEMP_FILTER_MAX_WINDOW 9
+
+// Останній (згладжувальний) каскад конвеєра
+typedef enum {
+    TEMP_FILTER_SMOOTH_NONE,
+    TEMP_FILTER_SMOOTH_EMA,     // Експоненційне ковзне середнє
+    TEMP_FILTER_SMOOTH_BIQUAD   // ФНЧ Баттерворта 2-го порядку (лише у шляху з float)
+} temp_filter_smooth_t;
+
+/**
+ * @brief Конфігурація конвеєра фільтрації одного датчика.
+ * Каскади: медіана з N -> відкидання викидів Хампелем -> EMA / біквад.
+ */
+typedef struct {
+    uint8_t median_window;        // Довжина вікна медіани (0/1 = вимкнено, бажано непарна)
+    uint8_t hampel_window;        // Довжина вікна Хампеля (0 = вимкнено)
+    float hampel_k;               // Поріг викиду в оцінках сигми (типово 3)
+    temp_filter_smooth_t smooth;  // Тип згладжування
+    float ema_alpha;              // Коефіцієнт EMA (0..1] на частоті sample_rate_hz
+    float cutoff_hz;              // Частота зрізу біквада, Гц
+    float sample_rate_hz;         // Частота надходження вибірок, Гц (0 - невідома, без перерахунку)
+} temp_filter_config_t;
+
+/**
+ * @brief Стан конвеєра. Фіксованого розміру, без динамічного виділення пам'яті.
+ */
+typedef struct {
+    temp_filter_config_t cfg;
+
+    temp_value_t median_buf[TEMP_FILTER_MAX_WINDOW];
+    uint8_t median_len;
+    uint8_t median_pos;
+
+    temp_value_t hampel_buf[TEMP_FILTER_MAX_WINDOW];
+    uint8_t hampel_len;
+    uint8_t hampel_pos;
+
+#if TEMP_FIXED_POINT
+    int32_t hampel_k_sigma_q16;   // hampel_k * 1.4826 у форматі Q16
+    int32_t ema_alpha_q16;        // Коефіцієнт EMA у форматі Q16
+    int32_t ema_q16;              // Стан EMA: соті частки градуса << 16
+#else
+    // Коефіцієнти та стан біквада (транспонована пряма форма II)
+    float b0, b1, b2, a1, a2;
+    float z1, z2;
+    float biquad_out;             // Останній вихід біквада
+
+    float ema;
+#endif
+    float ema_tau_s;              // Стала часу EMA, с (0 - не перераховується зі зміною частоти)
+    bool primed;
+
+    temp_value_t despiked;        // Останнє значення після медіани та Хампеля, до згладжування
+
+    uint32_t outliers;            // Кількість вибірок, замінених фільтром Хампеля
+} temp_filter_t;
+
+/**
+ * @brief Ініціалізує конвеєр фільтрації та обмежує некоректні параметри.
+ */
+void temp_filter_init(temp_filter_t *f, const temp_filter_config_t *cfg);
+
+/**
+ * @brief Перераховує згладжувач на нову частоту вибірок, не скидаючи стан.
+ *
+ * EMA зберігає сталу часу в секундах, біквад - частоту зрізу в герцах
+ * (обмежену частотою Найквіста нової частоти). Вікна медіани та Хампеля
+ * задані у вибірках і не змінюються.
+ */
+void temp_filter_set_sample_rate(temp_filter_t *f, float sample_rate_hz);
+
+/**
+ * @brief Скидає накопичений стан (історію вікон і згладжувача).
+ */
+void temp_filter_reset(temp_filter_t *f);
+
+/**
+ * @brief Пропускає одну вибірку через усі увімкнені каскади.
+ *
+ * @param f Вказівник на ініціалізований конвеєр.
+ * @param x Нова вибірка (усереднена температура за цикл).
+ * @return temp_value_t Відфільтроване значення.
+ */
+temp_value_t temp_filter_process(temp_filter_t *f, temp_value_t x);
+
+#endif // TEMP_FILTER_H
@@ -0,0 +1,97 @@
+#include "controller/sensor/temp_health.h"
+#include "drivers/sensor/temp_sensor_driver.h"
+#include <string.h>
+
+// Дільник: NTC до 3.3 В, опорний резистор до землі.
+// Обрив NTC притискає вхід до нуля, коротке замикання - до верхньої межі шкали.
+#define HEALTH_RAW_OPEN_MAX     16
+#define HEALTH_RAW_SHORT_MIN    (NTC_ADC_RAW_MAX - 16)
+
+// Заморожене показання: середнє змінюється менше ніж на пів коду, а розкид пакета
+// не перевищує 1 коду (живий канал завжди має кілька кодів шуму) довше за тайм-аут
+#define HEALTH_STUCK_DELTA_Q8   128
+#define HEALTH_STUCK_SPREAD_MAX 1
+#define HEALTH_STUCK_TIMEOUT_US (120LL * 1000000LL)
+
+// Шум: СКВ різниці сусідніх середніх понад 25 кодів (~0.5 C біля 20 C)
+// або розкид пакета понад 400 кодів (поганий контакт, наводки від реле)
+#define HEALTH_NOISY_DIFF_VAR   (25 * 25)
+#define HEALTH_NOISY_SPREAD     400
+#define HEALTH_VAR_EMA_SHIFT    3
+
+// Усунення брязкоту: несправність підтверджується за 3 цикли, відновлення - за 10
+#define HEALTH_FAULT_SCANS      3
+#define HEALTH_RECOVER_SCANS    10
+
+void temp_health_init(temp_health_monitor_t *m, int64_t now_us) {
+    memset(m, 0, sizeof(temp_health_monitor_t));
+    m->status = TEMP_HEALTH_OK;
+    m->candidate = TEMP_HEALTH_OK;
+    m->raw_min_seen = UINT16_MAX;
+    m->raw_max_seen = 0;
+    m->last_change_us = now_us;
+}
+
+static temp_health_t classify(temp_health_monitor_t *m, const temp_health_sample_t *s, int64_t now_us) {
+    if (!s->valid) {
+        return TEMP_HEALTH_NO_DATA;
+    }
+
+    uint16_t avg = (uint16_t)((s->avg_raw_q8 + 128) >> 8);
+    uint16_t spread = s->raw_max >= s->raw_min ? s->raw_max - s->raw_min : 0;
+    m->last_spread = spread;
+    if (avg < m->raw_min_seen) m->raw_min_seen = avg;
+    if (avg > m->raw_max_seen) m->raw_max_seen = avg;
+
+    if (m->has_last) {
+        int32_t diff = (int32_t)s->avg_raw_q8 - (int32_t)m->last_avg_q8;
+        int32_t abs_diff = diff < 0 ? -diff : diff;
+
+        // Квадрат різниці в кодах^2: (Q8)^2 >> 16; обмеження, щоб не переповнити EMA
+        uint32_t sq = abs_diff >= (1 << 16) ? UINT16_MAX * 16u : (uint32_t)(((uint64_t)abs_diff * abs_diff) >> 16);
+        m->diff_var = m->diff_var + (sq >> HEALTH_VAR_EMA_SHIFT) - (m->diff_var >> HEALTH_VAR_EMA_SHIFT);
+
+        if (abs_diff >= HEALTH_STUCK_DELTA_Q8 || spread > HEALTH_STUCK_SPREAD_MAX) {
+            m->last_change_us = now_us;
+        }
+    } else {
+        m->last_change_us = now_us;
+    }
+    m->last_avg_q8 = s->avg_raw_q8;
+    m->has_last = true;
+
+    if (avg <= HEALTH_RAW_OPEN_MAX) return TEMP_HEALTH_OPEN;
+    if (avg >= HEALTH_RAW_SHORT_MIN) return TEMP_HEALTH_SHORT;
+    if (now_us - m->last_change_us >= HEALTH_STUCK_TIMEOUT_US) return TEMP_HEALTH_STUCK;
+    if (m->diff_var > HEALTH_NOISY_DIFF_VAR || spread > HEALTH_NOISY_SPREAD) return TEMP_HEALTH_NOISY;
+    return TEMP_HEALTH_OK;
+}
+
+temp_health_t temp_health_update(temp_health_monitor_t *m, const temp_health_sample_t *sample, int64_t now_us) {
+    temp_health_t observed = classify(m, sample, now_us);
+
+    if (observed == m->candidate) {
+        if (m->candidate_count < UINT16_MAX) m->candidate_count++;
+    } else {
+        m->candidate = observed;
+        m->candidate_count = 1;
+    }
+
+    uint16_t needed = observed == TEMP_HEALTH_OK ? HEALTH_RECOVER_SCANS : HEALTH_FAULT_SCANS;
+    if (m->candidate != m->status && m->candidate_count >= needed) {
+        m->status = m->candidate;
+    }
+    return m->status;
+}
+
+const char *temp_health_to_string(temp_health_t health) {
+    switch (health) {
+        case TEMP_HEALTH_OK: return "OK";
+        case TEMP_HEALTH_NO_DATA: return "NO_DATA";
+        case TEMP_HEALTH_OPEN: return "OPEN";
+        case TEMP_HEALTH_SHORT: return "SHORT";
+        case TEMP_HEALTH_STUCK: return "STUCK";
+        case TEMP_HEALTH_NOISY: return "NOISY";
+        default: return "UNKNOWN";
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef TEMP_HEALTH_H
+#define TEMP_HEALTH_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Стан справності каналу термістора
+typedef enum {
+    TEMP_HEALTH_OK = 0,
+    TEMP_HEALTH_NO_DATA,   // Немає вибірок (помилка АЦП або каналу)
+    TEMP_HEALTH_OPEN,      // Обрив термістора: код притиснутий до нуля
+    TEMP_HEALTH_SHORT,     // Коротке замикання термістора: код притиснутий до максимуму
+    TEMP_HEALTH_STUCK,     // Показання заморожене: код і розкид пакета не змінюються
+    TEMP_HEALTH_NOISY      // Надмірний шум між циклами або в межах пакета передискретизації
+} temp_health_t;
+
+/**
+ * @brief Статистика одного пакета передискретизації каналу.
+ */
+typedef struct {
+    bool valid;            // false - пакет не отримано
+    uint32_t avg_raw_q8;   // Середній сирий код у форматі Q8 (код * 256)
+    uint16_t raw_min;      // Мінімальний код у пакеті
+    uint16_t raw_max;      // Максимальний код у пакеті
+} temp_health_sample_t;
+
+/**
+ * @brief Стан монітора одного каналу. Цілочисельний, фіксованого розміру.
+ */
+typedef struct {
+    temp_health_t status;      // Підтверджений стан (після усунення брязкоту)
+    temp_health_t candidate;   // Стан, що очікує підтвердження
+    uint16_t candidate_count;  // Скільки циклів поспіль спостерігається candidate
+
+    uint16_t raw_min_seen;     // Екстремуми середнього коду з моменту запуску
+    uint16_t raw_max_seen;
+    uint16_t last_spread;      // Розкид (max - min) останнього пакета
+
+    uint32_t last_avg_q8;
+    uint32_t diff_var;         // EMA квадрата різниці сусідніх середніх, коди^2
+    bool has_last;
+
+    int64_t last_change_us;    // Коли середній код востаннє помітно змінився
+} temp_health_monitor_t;
+
+/**
+ * @brief Ініціалізує монітор каналу.
+ */
+void temp_health_init(temp_health_monitor_t *m, int64_t now_us);
+
+/**
+ * @brief Обробляє статистику чергового пакета та оновлює стан каналу.
+ *
+ * @param m Монітор каналу.
+ * @param sample Статистика пакета.
+ * @param now_us Поточний час (esp_timer), мкс.
+ * @return temp_health_t Підтверджений стан каналу.
+ */
+temp_health_t temp_health_update(temp_health_monitor_t *m, const temp_health_sample_t *sample, int64_t now_us);
+
+/**
+ * @brief Повертає коротку назву стану для логів та API.
+ */
+const char *temp_health_to_string(temp_health_t health);
+
+#endif // TEMP_HEALTH_H
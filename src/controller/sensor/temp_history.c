@@ -0,0 +1,77 @@
+#include "controller/sensor/temp_history.h"
+#include <stdlib.h>
+#include <string.h>
+
+esp_err_t temp_history_init(temp_history_t *h, size_t bytes) {
+    h->slots = NULL;
+    h->capacity = 0;
+    atomic_init(&h->head, 0);
+    if (bytes < sizeof(temp_history_entry_t)) return ESP_ERR_INVALID_SIZE;
+
+    size_t capacity = bytes / sizeof(temp_history_entry_t);
+    h->slots = malloc(capacity * sizeof(temp_history_entry_t));
+    if (h->slots == NULL) return ESP_ERR_NO_MEM;
+    h->capacity = capacity;
+    return ESP_OK;
+}
+
+void temp_history_deinit(temp_history_t *h) {
+    free(h->slots);
+    h->slots = NULL;
+    h->capacity = 0;
+    atomic_store_explicit(&h->head, 0, memory_order_relaxed);
+}
+
+void temp_history_push(temp_history_t *h, const temp_history_entry_t *entry) {
+    if (h->slots == NULL) return;
+
+    // Слот заповнюється до публікації нового head, тому читач ніколи
+    // не вважає валідним недописаний запис
+    uint32_t head = atomic_load_explicit(&h->head, memory_order_relaxed);
+    h->slots[head % h->capacity] = *entry;
+    atomic_store_explicit(&h->head, head + 1, memory_order_release);
+}
+
+size_t temp_history_read(const temp_history_t *h, int64_t from_us, int64_t to_us,
+                         temp_history_entry_t *out, size_t max_entries) {
+    if (h->slots == NULL || out == NULL || max_entries == 0) return 0;
+
+    uint32_t head = atomic_load_explicit(&h->head, memory_order_acquire);
+    uint32_t oldest = head > h->capacity ? head - (uint32_t)h->capacity : 0;
+
+    // Межі інтервалу; мітки часу монотонні, тож записи інтервалу йдуть поспіль
+    uint32_t first = head;
+    uint32_t end = head;
+    for (uint32_t i = oldest; i < head; i++) {
+        int64_t ts = h->slots[i % h->capacity].timestamp_us;
+        if (ts < from_us) continue;
+        if (ts > to_us) {
+            end = i;
+            break;
+        }
+        if (first == head) first = i;
+    }
+    if (first >= end) return 0;
+
+    if (end - first > max_entries) {
+        first = end - (uint32_t)max_entries;
+    }
+
+    size_t count = 0;
+    for (uint32_t i = first; i < end; i++) {
+        out[count++] = h->slots[i % h->capacity];
+    }
+
+    // Перевірка після копіювання: записи, слоти яких записувач уже міг зачепити, відкидаються
+    atomic_thread_fence(memory_order_acquire);
+    uint32_t head_after = atomic_load_explicit(&h->head, memory_order_relaxed);
+    uint32_t valid_from = head_after >= h->capacity ? head_after - (uint32_t)h->capacity + 1 : 0;
+    if (first < valid_from) {
+        size_t dropped = valid_from - first;
+        if (dropped >= count) return 0;
+        memmove(out, out + dropped, (count - dropped) * sizeof(temp_history_entry_t));
+        count -= dropped;
+    }
+
+    return count;
+}
@@ -0,0 +1,53 @@
+#ifndef TEMP_HISTORY_H
+#define TEMP_HISTORY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include "esp_err.h"
+#include "controller/sensor/temp_controller.h"
+
+/**
+ * @brief Кільцевий буфер історії вимірювань: один записувач, довільні читачі без блокувань.
+ *
+ * head - монотонний лічильник записаних елементів; запис з індексом i лежить у слоті
+ * i % capacity і валідний, доки head <= i + capacity - 1 (слот head % capacity
+ * записувач може переписувати просто зараз).
+ */
+typedef struct {
+    temp_history_entry_t *slots;
+    size_t capacity;
+    atomic_uint_fast32_t head;
+} temp_history_t;
+
+/**
+ * @brief Виділяє буфер на стільки записів, скільки вміщує бюджет пам'яті.
+ *
+ * @param h Буфер історії.
+ * @param bytes Бюджет пам'яті, байт.
+ * @return esp_err_t ESP_ERR_INVALID_SIZE, якщо бюджет менший за один запис; ESP_ERR_NO_MEM.
+ */
+esp_err_t temp_history_init(temp_history_t *h, size_t bytes);
+
+/**
+ * @brief Звільняє буфер. Читачів та записувача на цей момент бути не повинно.
+ */
+void temp_history_deinit(temp_history_t *h);
+
+/**
+ * @brief Додає запис (лише з одного завдання-записувача).
+ */
+void temp_history_push(temp_history_t *h, const temp_history_entry_t *entry);
+
+/**
+ * @brief Копіює записи з інтервалу [from_us, to_us] у хронологічному порядку.
+ *
+ * Записи, слоти яких записувач міг зачепити під час копіювання, відкидаються.
+ *
+ * @param max_entries Місткість out. Якщо записів більше, повертаються найновіші.
+ * @return size_t Кількість скопійованих записів.
+ */
+size_t temp_history_read(const temp_history_t *h, int64_t from_us, int64_t to_us,
+                         temp_history_entry_t *out, size_t max_entries);
+
+#endif // TEMP_HISTORY_H
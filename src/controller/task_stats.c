@@ -0,0 +1,155 @@
+#include "controller/task_stats.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <inttypes.h>
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *TAG = "task_stats";
+
+#ifndef CONFIG_FREERTOS_NUMBER_OF_CORES
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 1
+#endif
+
+// Лічильник попередньої вибірки для завдання
+typedef struct {
+    uint32_t number;
+    uint32_t runtime;
+} runtime_mark_t;
+
+// Буфери вибірки статичні: колбек esp_timer виконується на невеликому стеку
+static TaskStatus_t s_status[TASK_STATS_MAX_TASKS];
+static runtime_mark_t s_prev[TASK_STATS_MAX_TASKS];
+static int s_prev_count = 0;
+static uint32_t s_prev_total = 0;
+static bool s_has_prev = false;
+
+static task_stats_snapshot_t s_snapshot;
+static SemaphoreHandle_t s_lock = NULL;
+static esp_timer_handle_t s_timer = NULL;
+
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+static int cmp_cpu_desc(const void *a, const void *b) {
+    const task_stats_task_t *ta = a;
+    const task_stats_task_t *tb = b;
+    // Без частки процесора (NAN) - за номером створення
+    if (isnan(ta->cpu_percent) || isnan(tb->cpu_percent) || ta->cpu_percent == tb->cpu_percent) {
+        return ta->number < tb->number ? -1 : ta->number > tb->number;
+    }
+    return ta->cpu_percent < tb->cpu_percent ? 1 : -1;
+}
+
+static bool prev_runtime(uint32_t number, uint32_t *out) {
+    for (int i = 0; i < s_prev_count; i++) {
+        if (s_prev[i].number == number) {
+            *out = s_prev[i].runtime;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void sample(void *arg) {
+    uint32_t total = 0;
+    UBaseType_t n = uxTaskGetSystemState(s_status, TASK_STATS_MAX_TASKS, &total);
+    if (n == 0) {
+        ESP_LOGW(TAG, "More than %d tasks, snapshot skipped", TASK_STATS_MAX_TASKS);
+        return;
+    }
+
+    // Лічильники 32-бітні (мкс esp_timer): різниця по модулю коректна для періодів до 71 хв.
+    // Сума часу завдань - це час усіх ядер, тому знаменник множиться на кількість ядер
+    bool cpu = false;
+#if CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+    cpu = true;
+#endif
+    uint32_t period = total - s_prev_total;
+    float capacity = (float)period * CONFIG_FREERTOS_NUMBER_OF_CORES;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    task_stats_snapshot_t *snap = &s_snapshot;
+    snap->uptime_us = esp_timer_get_time();
+    snap->period_us = s_has_prev ? period : 0;
+    snap->cpu_available = cpu;
+    snap->count = (int)n;
+    for (UBaseType_t i = 0; i < n; i++) {
+        const TaskStatus_t *st = &s_status[i];
+        task_stats_task_t *t = &snap->tasks[i];
+        strncpy(t->name, st->pcTaskName, sizeof(t->name) - 1);
+        t->name[sizeof(t->name) - 1] = '\0';
+        t->number = st->xTaskNumber;
+        t->priority = (uint8_t)st->uxCurrentPriority;
+#if CONFIG_FREERTOS_VTASKLIST_INCLUDE_COREID
+        t->core = st->xCoreID == tskNO_AFFINITY ? -1 : (int8_t)st->xCoreID;
+#else
+        t->core = -1;
+#endif
+        t->state = (uint8_t)st->eCurrentState;
+        t->stack_free_min = st->usStackHighWaterMark;
+
+        // Нове завдання без попередньої вибірки - частка невідома до наступного періоду
+        uint32_t prev = 0;
+        t->cpu_percent = NAN;
+        if (cpu && s_has_prev && period > 0 && prev_runtime(st->xTaskNumber, &prev)) {
+            t->cpu_percent = (float)(st->ulRunTimeCounter - prev) * 100.0f / capacity;
+        }
+    }
+    qsort(snap->tasks, n, sizeof(task_stats_task_t), cmp_cpu_desc);
+
+    snap->heap.free = heap_caps_get_free_size(MALLOC_CAP_8BIT);
+    snap->heap.min_free = heap_caps_get_minimum_free_size(MALLOC_CAP_8BIT);
+    snap->heap.largest_block = heap_caps_get_largest_free_block(MALLOC_CAP_8BIT);
+    snap->heap.total = heap_caps_get_total_size(MALLOC_CAP_8BIT);
+    xSemaphoreGive(s_lock);
+
+    for (UBaseType_t i = 0; i < n; i++) {
+        s_prev[i].number = s_status[i].xTaskNumber;
+        s_prev[i].runtime = s_status[i].ulRunTimeCounter;
+    }
+    s_prev_count = (int)n;
+    s_prev_total = total;
+    s_has_prev = true;
+}
+#endif
+
+esp_err_t task_stats_init(uint32_t period_ms) {
+#if CONFIG_FREERTOS_USE_TRACE_FACILITY
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) return ESP_ERR_NO_MEM;
+
+    const esp_timer_create_args_t timer_args = {
+        .callback = sample,
+        .dispatch_method = ESP_TIMER_TASK,
+        .name = "task_stats",
+        .skip_unhandled_events = true,
+    };
+    esp_err_t err = esp_timer_create(&timer_args, &s_timer);
+    if (err != ESP_OK) return err;
+
+    // Перша вибірка одразу: запас стека та купа доступні без очікування періоду
+    sample(NULL);
+    err = esp_timer_start_periodic(s_timer, (uint64_t)period_ms * 1000ULL);
+    if (err == ESP_OK) {
+        ESP_LOGI(TAG, "Sampling every %" PRIu32 " ms", period_ms);
+    }
+    return err;
+#else
+    ESP_LOGW(TAG, "CONFIG_FREERTOS_USE_TRACE_FACILITY is off, task stats disabled");
+    return ESP_ERR_NOT_SUPPORTED;
+#endif
+}
+
+esp_err_t task_stats_get(task_stats_snapshot_t *out) {
+    if (out == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_lock == NULL) return ESP_ERR_INVALID_STATE;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_snapshot;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
@@ -0,0 +1,71 @@
+#ifndef TASK_STATS_H
+#define TASK_STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+
+/**
+ * @brief Періодичний знімок завдань FreeRTOS та купи.
+ *
+ * Для кожного завдання: частка процесора за останній період вибірки (з лічильників
+ * run-time stats) та мінімальний запас стека за весь час роботи. Для купи: вільно зараз,
+ * мінімум з моменту старту та найбільший суцільний блок (фрагментація).
+ * Потребує CONFIG_FREERTOS_USE_TRACE_FACILITY; без CONFIG_FREERTOS_GENERATE_RUN_TIME_STATS
+ * частка процесора недоступна.
+ */
+
+// Максимальна кількість завдань у знімку (зараз їх близько двадцяти разом із системними)
+#define TASK_STATS_MAX_TASKS     32
+
+// Період вибірки за замовчуванням
+#define TASK_STATS_PERIOD_MS     10000
+
+/**
+ * @brief Одне завдання у знімку.
+ */
+typedef struct {
+    char name[16];
+    uint32_t number;          // xTaskNumber: не повторюється, на відміну від дескриптора
+    uint8_t priority;         // Поточний пріоритет
+    int8_t core;              // Прив'язка до ядра (-1 - будь-яке)
+    uint8_t state;            // eTaskState
+    uint32_t stack_free_min;  // Мінімальний запас стека з моменту створення, байт
+    float cpu_percent;        // Частка всіх ядер за період (NAN - невідомо)
+} task_stats_task_t;
+
+/**
+ * @brief Знімок купи (MALLOC_CAP_8BIT).
+ */
+typedef struct {
+    uint32_t free;
+    uint32_t min_free;        // Мінімум з моменту старту
+    uint32_t largest_block;   // Найбільший блок, який можна виділити
+    uint32_t total;
+} task_stats_heap_t;
+
+/**
+ * @brief Повний знімок.
+ */
+typedef struct {
+    int64_t uptime_us;        // Час вибірки (0 - вибірок ще не було)
+    uint32_t period_us;       // Тривалість періоду, за який рахувалась частка процесора
+    bool cpu_available;       // Прошивка зібрана з run-time stats
+    int count;
+    task_stats_task_t tasks[TASK_STATS_MAX_TASKS];
+    task_stats_heap_t heap;
+} task_stats_snapshot_t;
+
+/**
+ * @brief Запускає періодичну вибірку.
+ *
+ * @param period_ms Період вибірки.
+ */
+esp_err_t task_stats_init(uint32_t period_ms);
+
+/**
+ * @brief Копіює останній знімок. Завдання відсортовані за спаданням частки процесора.
+ */
+esp_err_t task_stats_get(task_stats_snapshot_t *out);
+
+#endif // TASK_STATS_H
@@ -2,6 +2,7 @@
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_log.h"
+#include "model/state_bus.h"
 #include <string.h>
 
 static const char *TAG = "TEMP_SETPOINT_MGR";
@@ -53,6 +54,7 @@ esp_err_t temp_setpoint_manager_init(void) {
 
 void temp_setpoint_manager_set(float new_temp) {
     g_setpoint_temp = new_temp;
+    state_bus_publish(STATE_BUS_EVENT_MANUAL_SETPOINT);
     ESP_LOGI(TAG, "Встановлено нову температуру: %.2f°C. Зберігаємо в NVS...", g_setpoint_temp);
 
     nvs_handle_t my_handle;
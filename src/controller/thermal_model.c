@@ -0,0 +1,146 @@
+#include "controller/thermal_model.h"
+#include <math.h>
+#include <string.h>
+
+// Вікно усереднення: різниця середніх сусідніх вікон дає похідну з прийнятним шумом
+#define THERMAL_MODEL_WINDOW_SEC   300
+#define THERMAL_MODEL_WINDOW_H     ((float)THERMAL_MODEL_WINDOW_SEC / 3600.0f)
+
+// Забування 0.999 на 5-хвилинне вікно - пам'ять близько 3.5 доби
+#define THERMAL_RLS_LAMBDA         0.999f
+#define THERMAL_RLS_P0             100.0f
+// Без збудження (нагрівач вимкнений тижнями) забування роздувало б коваріацію
+#define THERMAL_RLS_TRACE_MAX      1000.0f
+
+// Збіжність: щонайменше 12 год даних
+#define THERMAL_MODEL_MIN_SAMPLES  144
+
+static void rls_init(thermal_rls_t *rls, uint8_t n, const float *theta0) {
+    memset(rls, 0, sizeof(thermal_rls_t));
+    rls->n = n;
+    for (int i = 0; i < n; i++) {
+        rls->theta[i] = theta0[i];
+        rls->p[i][i] = THERMAL_RLS_P0;
+    }
+}
+
+static void rls_update(thermal_rls_t *rls, const float *phi, float y) {
+    int n = rls->n;
+    float pphi[THERMAL_RLS_MAX_PARAMS];
+    float denom = 0.0f;
+    float trace = 0.0f;
+
+    for (int i = 0; i < n; i++) {
+        pphi[i] = 0.0f;
+        for (int j = 0; j < n; j++) pphi[i] += rls->p[i][j] * phi[j];
+        trace += rls->p[i][i];
+    }
+    float lambda = trace < THERMAL_RLS_TRACE_MAX ? THERMAL_RLS_LAMBDA : 1.0f;
+
+    for (int i = 0; i < n; i++) denom += phi[i] * pphi[i];
+    denom += lambda;
+
+    float err = y;
+    for (int i = 0; i < n; i++) err -= phi[i] * rls->theta[i];
+
+    for (int i = 0; i < n; i++) rls->theta[i] += pphi[i] / denom * err;
+
+    // P = (P - P*phi*phi'*P / denom) / lambda, симетричний запис
+    for (int i = 0; i < n; i++) {
+        for (int j = i; j < n; j++) {
+            float v = (rls->p[i][j] - pphi[i] * pphi[j] / denom) / lambda;
+            rls->p[i][j] = v;
+            rls->p[j][i] = v;
+        }
+    }
+}
+
+void thermal_model_init(thermal_model_t *model, float fallback_heat_rate) {
+    memset(model, 0, sizeof(thermal_model_t));
+    model->heat_rate_deg_per_h = fallback_heat_rate;
+
+    // Стартові значення - типова кімната з масляним радіатором
+    const float room0[3] = { 0.05f, 0.03f, 0.0f };
+    const float rad0[2] = { 60.0f, 1.5f };
+    rls_init(&model->room, 3, room0);
+    rls_init(&model->radiator, 2, rad0);
+}
+
+void thermal_model_ident_reset(thermal_model_ident_t *ident) {
+    thermal_model_t model = ident->model;
+    memset(ident, 0, sizeof(thermal_model_ident_t));
+    ident->model = model;
+}
+
+bool thermal_model_add_sample(thermal_model_ident_t *ident, float room_t, float rad_t, float outside_t, float duty) {
+    if (!isfinite(room_t) || !isfinite(rad_t) || !isfinite(outside_t) || outside_t < -100.0f) {
+        // Розрив у даних: похідна через нього недостовірна
+        ident->window_count = 0;
+        ident->sum_room = ident->sum_rad = ident->sum_out = ident->sum_duty = 0.0f;
+        ident->has_prev = false;
+        return false;
+    }
+
+    ident->sum_room += room_t;
+    ident->sum_rad += rad_t;
+    ident->sum_out += outside_t;
+    ident->sum_duty += duty;
+    if (++ident->window_count < THERMAL_MODEL_WINDOW_SEC) return false;
+
+    float n = (float)ident->window_count;
+    float room = ident->sum_room / n;
+    float rad = ident->sum_rad / n;
+    float out = ident->sum_out / n;
+    float d = ident->sum_duty / n;
+    ident->window_count = 0;
+    ident->sum_room = ident->sum_rad = ident->sum_out = ident->sum_duty = 0.0f;
+
+    bool updated = false;
+    if (ident->has_prev) {
+        // Регресори беремо посередині між центрами вікон (трапеції)
+        float room_mid = 0.5f * (room + ident->prev_room);
+        float rad_mid = 0.5f * (rad + ident->prev_rad);
+        float out_mid = 0.5f * (out + ident->prev_out);
+        float duty_mid = 0.5f * (d + ident->prev_duty);
+
+        float phi_room[3] = { rad_mid - room_mid, -(room_mid - out_mid), 1.0f };
+        rls_update(&ident->model.room, phi_room, (room - ident->prev_room) / THERMAL_MODEL_WINDOW_H);
+
+        float phi_rad[2] = { duty_mid, -(rad_mid - room_mid) };
+        rls_update(&ident->model.radiator, phi_rad, (rad - ident->prev_rad) / THERMAL_MODEL_WINDOW_H);
+
+        ident->model.samples++;
+        updated = true;
+    }
+
+    ident->prev_room = room;
+    ident->prev_rad = rad;
+    ident->prev_out = out;
+    ident->prev_duty = d;
+    ident->has_prev = true;
+    return updated;
+}
+
+bool thermal_model_is_converged(const thermal_model_t *model) {
+    return model->samples >= THERMAL_MODEL_MIN_SAMPLES &&
+           model->room.theta[0] > 0.0f && model->room.theta[1] > 0.0f &&
+           model->radiator.theta[0] > 0.0f && model->radiator.theta[1] > 0.0f;
+}
+
+float thermal_model_heat_rate(const thermal_model_t *model, float room_t, float outside_t) {
+    if (!thermal_model_is_converged(model) || outside_t < -100.0f) return model->heat_rate_deg_per_h;
+
+    float rad_excess = model->radiator.theta[0] / model->radiator.theta[1];
+    return model->room.theta[0] * rad_excess
+         - model->room.theta[1] * (room_t - outside_t)
+         + model->room.theta[2];
+}
+
+float thermal_model_loss_coeff(const thermal_model_t *model) {
+    return thermal_model_is_converged(model) ? model->room.theta[1] : 0.0f;
+}
+
+float thermal_model_time_constant_h(const thermal_model_t *model) {
+    if (!thermal_model_is_converged(model)) return 0.0f;
+    return 1.0f / (model->room.theta[0] + model->room.theta[1]);
+}
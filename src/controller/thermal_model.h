@@ -0,0 +1,92 @@
+#ifndef THERMAL_MODEL_H
+#define THERMAL_MODEL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define THERMAL_RLS_MAX_PARAMS 3
+
+/**
+ * @brief Рекурсивний метод найменших квадратів з експоненційним забуванням.
+ */
+typedef struct {
+    uint8_t n;                                           // Кількість параметрів
+    float theta[THERMAL_RLS_MAX_PARAMS];                 // Оцінки параметрів
+    float p[THERMAL_RLS_MAX_PARAMS][THERMAL_RLS_MAX_PARAMS]; // Коваріація
+} thermal_rls_t;
+
+/**
+ * @brief Параметри двовузлової RC-моделі, що зберігаються в NVS.
+ *
+ * Кімната:  dTr/dt = k_rad * (Trad - Tr) - k_loss * (Tr - Tout) + q_int
+ * Радіатор: dTrad/dt = g_heat * duty - k_rad_room * (Trad - Tr)
+ * Одиниці - C/год та 1/год, duty - 0..1.
+ */
+typedef struct {
+    float heat_rate_deg_per_h;  // Запасна швидкість нагріву, поки модель не зійшлася
+    thermal_rls_t room;         // theta = [k_rad, k_loss, q_int]
+    thermal_rls_t radiator;     // theta = [g_heat, k_rad_room]
+    uint32_t samples;           // Кількість оброблених вікон
+} thermal_model_t;
+
+/**
+ * @brief Стан ідентифікації: модель і накопичувачі поточного вікна усереднення.
+ */
+typedef struct {
+    thermal_model_t model;
+
+    uint32_t window_count;      // Вибірок у поточному вікні
+    float sum_room, sum_rad, sum_out, sum_duty;
+
+    bool has_prev;              // Є середні попереднього вікна
+    float prev_room, prev_rad, prev_out, prev_duty;
+} thermal_model_ident_t;
+
+/**
+ * @brief Заповнює модель початковими значеннями з великою невизначеністю.
+ *
+ * @param model Модель.
+ * @param fallback_heat_rate Швидкість нагріву (C/год) до збіжності моделі.
+ */
+void thermal_model_init(thermal_model_t *model, float fallback_heat_rate);
+
+/**
+ * @brief Скидає накопичувачі ідентифікації (після завантаження моделі з NVS).
+ */
+void thermal_model_ident_reset(thermal_model_ident_t *ident);
+
+/**
+ * @brief Додає одну секундну вибірку. Кожні THERMAL_MODEL_WINDOW_SEC оновлює RLS.
+ *
+ * @param room_t Температура кімнати, C.
+ * @param rad_t Температура радіатора, C.
+ * @param outside_t Зовнішня температура, C (нижче -100 - недоступна, вікно відкидається).
+ * @param duty Частка часу увімкненого реле за секунду, 0..1.
+ * @return true, якщо на цьому кроці модель оновилась.
+ */
+bool thermal_model_add_sample(thermal_model_ident_t *ident, float room_t, float rad_t, float outside_t, float duty);
+
+/**
+ * @brief Чи зійшлася модель: достатньо вікон і фізично правдоподібні параметри.
+ */
+bool thermal_model_is_converged(const thermal_model_t *model);
+
+/**
+ * @brief Швидкість нагріву кімнати на повній потужності при заданих умовах, C/год.
+ *
+ * Використовує квазістаціонарну температуру радіатора Trad - Tr = g_heat / k_rad_room.
+ * До збіжності повертає heat_rate_deg_per_h.
+ */
+float thermal_model_heat_rate(const thermal_model_t *model, float room_t, float outside_t);
+
+/**
+ * @brief Коефіцієнт тепловтрат назовні k_loss, 1/год (0, якщо модель не зійшлася).
+ */
+float thermal_model_loss_coeff(const thermal_model_t *model);
+
+/**
+ * @brief Стала часу кімнати 1 / (k_rad + k_loss), год (0, якщо модель не зійшлася).
+ */
+float thermal_model_time_constant_h(const thermal_model_t *model);
+
+#endif // THERMAL_MODEL_H
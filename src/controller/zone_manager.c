@@ -0,0 +1,204 @@
+#include "controller/zone_manager.h"
+#include "controller/actuator/pid_controller.h"
+#include "controller/actuator/pwm_manager.h"
+#include "controller/actuator/relay_controller.h"
+#include "controller/sensor/temp_controller.h"
+#include "controller/sensor/temp_health.h"
+#include "model/settings_manager.h"
+#include "driver/gpio.h"
+#include "esp_log.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+
+static const char *TAG = "zone_manager";
+
+// Уставка захисту від замерзання, та сама, що й для основної зони
+#define ZONE_ANTI_FREEZE_C 7.0f
+
+typedef struct {
+    bool configured;          // Реле та ШІМ зони створені
+    bool active;              // ПІД зони працює (скидається при вимкненні)
+    pid_controller_t pid;
+    zone_status_t status;
+} zone_t;
+
+static zone_t s_zones[HEAT_ZONES_MAX];
+static SemaphoreHandle_t s_lock = NULL;
+
+static bool sensor_usable(const app_settings_t *cfg, int id) {
+    return id >= 0 && id < MAX_TEMP_SENSORS && cfg->sensors.channels[id].enabled;
+}
+
+static bool validate_zone(const app_settings_t *cfg, int zone, const bool *gpio_used) {
+    const heat_zone_settings_t *zc = &cfg->zones.list[zone];
+
+    if (zc->relay_gpio < 0 || !GPIO_IS_VALID_OUTPUT_GPIO(zc->relay_gpio)) {
+        ESP_LOGW(TAG, "Zone %d (%s): invalid relay GPIO %d, skipped", zone, zc->name, zc->relay_gpio);
+        return false;
+    }
+    if (zc->relay_gpio == GPIO_RELAY || gpio_used[zc->relay_gpio]) {
+        ESP_LOGW(TAG, "Zone %d (%s): relay GPIO %d already in use, skipped", zone, zc->name, zc->relay_gpio);
+        return false;
+    }
+    if (!sensor_usable(cfg, zc->room_sensor)) {
+        ESP_LOGW(TAG, "Zone %d (%s): room sensor %d not enabled, skipped", zone, zc->name, zc->room_sensor);
+        return false;
+    }
+    if (zc->radiator_sensor >= 0 && !sensor_usable(cfg, zc->radiator_sensor)) {
+        ESP_LOGW(TAG, "Zone %d (%s): radiator sensor %d not enabled, skipped", zone, zc->name, zc->radiator_sensor);
+        return false;
+    }
+    return true;
+}
+
+esp_err_t zone_manager_init(void) {
+    const app_settings_t *cfg = settings_get();
+
+    s_lock = xSemaphoreCreateMutex();
+    if (s_lock == NULL) return ESP_ERR_NO_MEM;
+
+    memset(s_zones, 0, sizeof(s_zones));
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        strncpy(s_zones[i].status.name, cfg->zones.list[i].name, sizeof(s_zones[i].status.name) - 1);
+        s_zones[i].status.temp = -999.0f;
+        s_zones[i].status.setpoint = NAN;
+    }
+    s_zones[0].configured = true;
+    s_zones[0].status.enabled = true;
+
+    bool valid[HEAT_ZONES_MAX] = { false };
+    bool gpio_used[GPIO_NUM_MAX] = { false };
+    int num_valid = 1; // Основна зона
+    for (int i = 1; i < HEAT_ZONES_MAX; i++) {
+        if (!cfg->zones.list[i].enabled) continue;
+        if (!validate_zone(cfg, i, gpio_used)) continue;
+        valid[i] = true;
+        gpio_used[cfg->zones.list[i].relay_gpio] = true;
+        num_valid++;
+    }
+
+    // Фази ШІМ рівномірно розносяться по періоду між усіма робочими зонами
+    int rank = 1;
+    for (int i = 1; i < HEAT_ZONES_MAX; i++) {
+        if (!valid[i]) continue;
+        const heat_zone_settings_t *zc = &cfg->zones.list[i];
+
+        esp_err_t err = relay_controller_init_zone(i, (gpio_num_t)zc->relay_gpio, zc->relay_active_level);
+        if (err == ESP_OK) {
+            err = pwm_manager_add_zone(i, (float)rank / (float)num_valid);
+        }
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "Zone %d (%s): init failed: %s", i, zc->name, esp_err_to_name(err));
+            continue;
+        }
+
+        s_zones[i].configured = true;
+        s_zones[i].status.enabled = true;
+        rank++;
+        ESP_LOGI(TAG, "Zone %d (%s): relay GPIO %d, room sensor %d, offset %+.1f C",
+                 i, zc->name, zc->relay_gpio, zc->room_sensor, zc->setpoint_offset);
+    }
+
+    ESP_LOGI(TAG, "%d heating zone(s) active", rank);
+    return ESP_OK;
+}
+
+/**
+ * @brief Вимикає зону і скидає її ПІД, щоб при наступному ввімкненні не було старого інтегралу.
+ */
+static void zone_stop(uint8_t zone, zone_t *z) {
+    if (z->active) {
+        pwm_manager_reset_zone(zone);
+        z->active = false;
+    }
+    z->status.setpoint = NAN;
+    z->status.duty = 0.0f;
+}
+
+static bool zone_sensor_ok(const sensors_state_t *sensors, int id) {
+    float t = sensors->temperature_c[id];
+    return sensors->sensor_health[id] == TEMP_HEALTH_OK &&
+           t >= SENSOR_MIN_VALID_TEMP && t <= SENSOR_MAX_VALID_TEMP;
+}
+
+static void zone_step(const app_settings_t *cfg, uint8_t zone, zone_t *z,
+                      system_state_t state, float base_setpoint, const sensors_state_t *sensors) {
+    const heat_zone_settings_t *zc = &cfg->zones.list[zone];
+
+    z->status.temp = sensors->temperature_c[zc->room_sensor];
+    z->status.fault = !zone_sensor_ok(sensors, zc->room_sensor) ||
+                      (zc->radiator_sensor >= 0 && !zone_sensor_ok(sensors, zc->radiator_sensor));
+
+    float target = NAN;
+    switch (state) {
+        case STATE_MANUAL:
+        case STATE_PROGRAMMED:
+        case STATE_ADAPTIVE:
+        case STATE_AUTOTUNE:
+            target = base_setpoint + zc->setpoint_offset;
+            break;
+        case STATE_ANTI_FREEZE:
+            target = ZONE_ANTI_FREEZE_C;
+            break;
+        default:
+            break;
+    }
+
+    if (z->status.fault || isnan(target)) {
+        if (z->status.fault && z->active) {
+            ESP_LOGW(TAG, "Zone %u (%s): sensor fault, heater OFF", zone, zc->name);
+        }
+        zone_stop(zone, z);
+        return;
+    }
+
+    // Додатне зміщення не виводить зону за верхню межу комфорту
+    if (target > cfg->control.limits.room_max) target = cfg->control.limits.room_max;
+
+    if (!z->active) {
+        pid_init(&z->pid, cfg->control.pid.kp, cfg->control.pid.ki, cfg->control.pid.kd, 0.0f, 100.0f);
+        pid_set_weighting(&z->pid, cfg->control.pid.setpoint_weight, cfg->control.pid.d_filter_n);
+        z->active = true;
+    }
+
+    float duty = pid_compute(&z->pid, target, z->status.temp);
+    float rad_temp = zc->radiator_sensor >= 0 ? sensors->temperature_c[zc->radiator_sensor] : -999.0f;
+    pwm_manager_update_zone(zone, duty, rad_temp);
+
+    z->status.setpoint = target;
+    z->status.duty = duty;
+}
+
+void zone_manager_update(system_state_t state, float base_setpoint, float main_duty, const sensors_state_t *sensors) {
+    if (s_lock == NULL) return;
+    const app_settings_t *cfg = settings_get();
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+
+    zone_t *main_zone = &s_zones[0];
+    main_zone->status.temp = sensors->temperature_c[TEMP_SENSOR_ROOM];
+    main_zone->status.setpoint = base_setpoint;
+    main_zone->status.duty = main_duty;
+    main_zone->status.relay_on = relay_controller_get_heater_state();
+    main_zone->status.fault = state == STATE_EMERGENCY;
+
+    for (uint8_t i = 1; i < HEAT_ZONES_MAX; i++) {
+        zone_t *z = &s_zones[i];
+        if (!z->configured) continue;
+        zone_step(cfg, i, z, state, base_setpoint, sensors);
+        z->status.relay_on = relay_controller_get_zone_state(i);
+    }
+
+    xSemaphoreGive(s_lock);
+}
+
+esp_err_t zone_manager_get_status(uint8_t zone, zone_status_t *out) {
+    if (zone >= HEAT_ZONES_MAX || out == NULL || s_lock == NULL) return ESP_ERR_INVALID_ARG;
+
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    *out = s_zones[zone].status;
+    xSemaphoreGive(s_lock);
+    return ESP_OK;
+}
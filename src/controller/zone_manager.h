@@ -0,0 +1,54 @@
+#ifndef ZONE_MANAGER_H
+#define ZONE_MANAGER_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "esp_err.h"
+#include "hw_config.h"
+#include "model/system_state.h"
+
+/**
+ * @brief Стан зони опалення для API та MQTT.
+ */
+typedef struct {
+    bool enabled;
+    char name[16];
+    float temp;       // Температура кімнати зони, C (-999 - немає даних)
+    float setpoint;   // Поточна уставка, C (NAN - обігрів зони не активний)
+    float duty;       // Заповнення ШІМ, %
+    bool relay_on;
+    bool fault;       // Датчик зони несправний, зона вимкнена
+} zone_status_t;
+
+/**
+ * @brief Ініціалізує додаткові зони опалення з налаштувань.
+ *
+ * Для кожної увімкненої зони 1..HEAT_ZONES_MAX-1 перевіряються GPIO реле та датчики,
+ * створюються реле та канал ШІМ з рознесеною фазою. Зона з некоректною конфігурацією
+ * пропускається з попередженням. Викликати після pwm_manager_init.
+ */
+esp_err_t zone_manager_init(void);
+
+/**
+ * @brief Крок керування зонами. Викликати з циклу керування раз на ітерацію.
+ *
+ * Основна зона (0) керується самим циклом; тут лише фіксується її стан.
+ * Додаткові зони мають власні ПІД (коефіцієнти спільні з control.pid) і йдуть за
+ * уставкою активного режиму зі своїм зміщенням. Несправний датчик зони вимикає
+ * лише цю зону.
+ *
+ * @param state Активний режим системи.
+ * @param base_setpoint Уставка активного режиму (NAN - режим не гріє).
+ * @param main_duty Заповнення основної зони, %.
+ * @param sensors Поточний стан датчиків.
+ */
+void zone_manager_update(system_state_t state, float base_setpoint, float main_duty, const sensors_state_t *sensors);
+
+/**
+ * @brief Потокобезпечно копіює стан зони.
+ *
+ * @return esp_err_t ESP_ERR_INVALID_ARG для неіснуючої зони.
+ */
+esp_err_t zone_manager_get_status(uint8_t zone, zone_status_t *out);
+
+#endif // ZONE_MANAGER_H
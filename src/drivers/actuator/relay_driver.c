@@ -3,46 +3,73 @@
 #include "driver/gpio.h"
 
 static const char *TAG = "relay_driver";
-static gpio_num_t s_relay_gpio_num;
-static int s_relay_active_level;
 
-esp_err_t relay_driver_init(gpio_num_t gpio_num, int active_level) {
-    s_relay_gpio_num = gpio_num;
-    s_relay_active_level = active_level;
+typedef struct {
+    bool initialized;
+    gpio_num_t gpio_num;
+    int active_level;
+} relay_channel_t;
+
+static relay_channel_t s_channels[RELAY_DRIVER_MAX_CHANNELS];
 
-    gpio_reset_pin(s_relay_gpio_num);
+esp_err_t relay_driver_init_channel(uint8_t channel, gpio_num_t gpio_num, int active_level) {
+    if (channel >= RELAY_DRIVER_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+    relay_channel_t *ch = &s_channels[channel];
 
-    esp_err_t err = gpio_set_direction(s_relay_gpio_num, GPIO_MODE_OUTPUT);
+    gpio_reset_pin(gpio_num);
+
+    esp_err_t err = gpio_set_direction(gpio_num, GPIO_MODE_OUTPUT);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set GPIO direction for relay: %s", esp_err_to_name(err));
         return err;
     }
 
-    gpio_set_level(s_relay_gpio_num, !s_relay_active_level);
+    gpio_set_level(gpio_num, !active_level);
+
+    ch->gpio_num = gpio_num;
+    ch->active_level = active_level;
+    ch->initialized = true;
 
-    ESP_LOGI(TAG, "Relay driver initialized on GPIO %d (active level: %d)", s_relay_gpio_num, s_relay_active_level);
+    ESP_LOGI(TAG, "Relay %u initialized on GPIO %d (active level: %d)", channel, gpio_num, active_level);
     return ESP_OK;
 }
 
-esp_err_t relay_driver_set_state(bool state) {
+esp_err_t relay_driver_init(gpio_num_t gpio_num, int active_level) {
+    return relay_driver_init_channel(0, gpio_num, active_level);
+}
+
+esp_err_t relay_driver_set_channel_state(uint8_t channel, bool state) {
+    if (channel >= RELAY_DRIVER_MAX_CHANNELS) return ESP_ERR_INVALID_ARG;
+    relay_channel_t *ch = &s_channels[channel];
+    if (!ch->initialized) return ESP_ERR_INVALID_STATE;
+
     int level_to_set;
 
     if (state) {
-        level_to_set = s_relay_active_level;
+        level_to_set = ch->active_level;
     } else {
-        level_to_set = !s_relay_active_level;
+        level_to_set = !ch->active_level;
     }
 
-    esp_err_t err = gpio_set_level(s_relay_gpio_num, level_to_set);
+    esp_err_t err = gpio_set_level(ch->gpio_num, level_to_set);
     if (err != ESP_OK) {
         ESP_LOGE(TAG, "Failed to set relay level: %s", esp_err_to_name(err));
         return err;
     }
 
-    ESP_LOGD(TAG, "Relay state set to %s (GPIO level: %d)", state ? "ON" : "OFF", level_to_set);
+    ESP_LOGD(TAG, "Relay %u state set to %s (GPIO level: %d)", channel, state ? "ON" : "OFF", level_to_set);
     return ESP_OK;
 }
 
+esp_err_t relay_driver_set_state(bool state) {
+    return relay_driver_set_channel_state(0, state);
+}
+
+bool relay_driver_get_channel_state(uint8_t channel) {
+    if (channel >= RELAY_DRIVER_MAX_CHANNELS || !s_channels[channel].initialized) return false;
+    return (gpio_get_level(s_channels[channel].gpio_num) == s_channels[channel].active_level);
+}
+
 bool relay_driver_get_state(void) {
-    return (gpio_get_level(s_relay_gpio_num) == s_relay_active_level);
-}
\ No newline at end of file
+    return relay_driver_get_channel_state(0);
+}
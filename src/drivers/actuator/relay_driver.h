@@ -4,9 +4,14 @@
 #include "esp_err.h"
 #include "driver/gpio.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include "hw_config.h"
+
+// Кількість каналів реле (по одному на зону опалення)
+#define RELAY_DRIVER_MAX_CHANNELS HEAT_ZONES_MAX
 
 /**
- * @brief Ініціалізує драйвер реле.
+ * @brief Ініціалізує драйвер реле (канал 0).
  *
  * @param gpio_num Номер GPIO піна, до якого підключено реле.
  * @param active_level Логічний рівень, який активує реле (1 для HIGH, 0 для LOW).
@@ -14,6 +19,16 @@
  */
 esp_err_t relay_driver_init(gpio_num_t gpio_num, int active_level);
 
+/**
+ * @brief Ініціалізує канал реле з вказаним індексом.
+ *
+ * @param channel Індекс каналу (0..RELAY_DRIVER_MAX_CHANNELS-1).
+ * @param gpio_num Номер GPIO піна, до якого підключено реле.
+ * @param active_level Логічний рівень, який активує реле (1 для HIGH, 0 для LOW).
+ * @return esp_err_t ESP_OK у разі успіху, ESP_ERR_INVALID_ARG для неіснуючого каналу.
+ */
+esp_err_t relay_driver_init_channel(uint8_t channel, gpio_num_t gpio_num, int active_level);
+
 /**
  * @brief Встановлює стан реле (увімкнено/вимкнено).
  *
@@ -22,6 +37,13 @@ esp_err_t relay_driver_init(gpio_num_t gpio_num, int active_level);
  */
 esp_err_t relay_driver_set_state(bool state);
 
+/**
+ * @brief Встановлює стан реле каналу.
+ *
+ * @return esp_err_t ESP_ERR_INVALID_STATE, якщо канал не ініціалізований.
+ */
+esp_err_t relay_driver_set_channel_state(uint8_t channel, bool state);
+
 /**
  * @brief Отримує поточний стан реле.
  *
@@ -29,4 +51,9 @@ esp_err_t relay_driver_set_state(bool state);
  */
 bool relay_driver_get_state(void);
 
-#endif /* COMPONENTS_DRIVERS_RELAY_DRIVER_H_ */
\ No newline at end of file
+/**
+ * @brief Отримує поточний стан реле каналу (false для неініціалізованого каналу).
+ */
+bool relay_driver_get_channel_state(uint8_t channel);
+
+#endif /* COMPONENTS_DRIVERS_RELAY_DRIVER_H_ */
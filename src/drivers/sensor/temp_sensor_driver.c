@@ -2,8 +2,11 @@
 #include "esp_log.h"
 #include <math.h>
 #include <string.h>
+#include <stdlib.h>
+#include <inttypes.h>
 
 #include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
 #include "esp_adc/adc_cali.h"
 #include "esp_adc/adc_cali_scheme.h"
 
@@ -11,10 +14,38 @@ static const char *TAG = "temp_sensor_drv";
 
 #define KELVIN_OFFSET 273.15f
 
+#if CONFIG_IDF_TARGET_ESP32 || CONFIG_IDF_TARGET_ESP32S2
+#define NTC_ADC_OUTPUT_TYPE         ADC_DIGI_OUTPUT_FORMAT_TYPE1
+#define NTC_ADC_GET_CHANNEL(p_data) ((p_data)->type1.channel)
+#define NTC_ADC_GET_DATA(p_data)    ((p_data)->type1.data)
+#else
+#define NTC_ADC_OUTPUT_TYPE         ADC_DIGI_OUTPUT_FORMAT_TYPE2
+#define NTC_ADC_GET_CHANNEL(p_data) ((p_data)->type2.channel)
+#define NTC_ADC_GET_DATA(p_data)    ((p_data)->type2.data)
+#endif
+
+// Таблиця перетворення код АЦП -> температура.
+// Вузли через кожні 16 кодів з лінійною інтерполяцією між ними при 514 байтах на датчик.
+// Похибка відносно B-рівняння ~0.04 C у діапазоні 0..60 C і до ~0.25 C на краях
+// -40..125 C, де крива найкрутіша (перевіряє test/test_ntc_lut).
+#define NTC_LUT_STEP         16
+#define NTC_LUT_STEP_SHIFT   4
+#define NTC_LUT_SIZE         ((NTC_ADC_RAW_MAX + 1) / NTC_LUT_STEP + 1)
+#define NTC_LUT_INVALID      INT16_MIN
+#define NTC_LUT_LIMIT_CENTI  30000
+
+// Цілочисельна інтерполяція: дробова частина позиції у таблиці має 8 + 4 біти
+#define NTC_LUT_FRAC_BITS    (NTC_RAW_Q8_SHIFT + NTC_LUT_STEP_SHIFT)
+
+_Static_assert((1 << NTC_LUT_STEP_SHIFT) == NTC_LUT_STEP, "NTC_LUT_STEP_SHIFT must match NTC_LUT_STEP");
+
 typedef struct ntc_sensor_handle_t {
     adc_channel_t channel;
+    adc_atten_t atten;
+    adc_bitwidth_t bitwidth;
     adc_cali_handle_t cali_handle;
     ntc_thermistor_config_t config;
+    int16_t lut_centi[NTC_LUT_SIZE]; // Температура у вузлах таблиці, сотих часток градуса
     bool is_initialized;
 } ntc_sensor_t;
 
@@ -22,6 +53,14 @@ static adc_oneshot_unit_handle_t s_adc1_handle;
 static ntc_sensor_t s_ntc_sensors[MAX_NTC_SENSORS];
 static int s_num_initialized_sensors = 0;
 
+// Стан безперервного режиму
+static adc_continuous_handle_t s_cont_handle = NULL;
+static uint8_t *s_dma_frame_buf = NULL;
+static uint32_t s_dma_frame_size = 0;
+static ntc_adc_slot_map_t s_slot_map;
+static bool s_cont_running = false;
+static bool s_cont_gated = false;
+
 static bool adc_calibration_init(adc_unit_t unit, adc_atten_t atten, adc_cali_handle_t *out_handle) {
     adc_cali_handle_t handle = NULL;
     esp_err_t ret = ESP_FAIL;
@@ -44,6 +83,115 @@ static bool adc_calibration_init(adc_unit_t unit, adc_atten_t atten, adc_cali_ha
     return calibrated;
 }
 
+/**
+ * @brief Опір термістора за сирим кодом (NTC до 3.3 В, опорний резистор до землі).
+ */
+static float ntc_raw_to_resistance(const ntc_sensor_t *sensor, int raw) {
+    int voltage_mv;
+    if (adc_cali_raw_to_voltage(sensor->cali_handle, raw, &voltage_mv) != ESP_OK) {
+        return NAN;
+    }
+    float voltage = (float)voltage_mv / 1000.0f;
+
+    if (voltage <= 0.001f || voltage >= 3.3f) {
+        return NAN;
+    }
+
+    return sensor->config.fixed_resistor_ohms * ((3.3f / voltage) - 1.0f);
+}
+
+/**
+ * @brief Точне перетворення сирого коду в температуру через B-рівняння
+ * або калібрування Стейнгарта–Гарта. Використовується лише для побудови таблиці.
+ */
+static float ntc_raw_to_temp_exact(const ntc_sensor_t *sensor, int raw) {
+    float r_ntc = ntc_raw_to_resistance(sensor, raw);
+    if (isnan(r_ntc)) {
+        return NAN;
+    }
+
+    float t_kelvin;
+    if (sensor->config.use_steinhart_hart) {
+        float ln_r = logf(r_ntc);
+        t_kelvin = 1.0f / (sensor->config.sh_a + sensor->config.sh_b * ln_r + sensor->config.sh_c * ln_r * ln_r * ln_r);
+    } else {
+        t_kelvin = 1.0f / ((1.0f / (sensor->config.nominal_temperature_c + KELVIN_OFFSET)) +
+                           (1.0f / sensor->config.b_value) * logf(r_ntc / sensor->config.nominal_resistance));
+    }
+
+    return t_kelvin - KELVIN_OFFSET;
+}
+
+static float ntc_lut_lookup(const ntc_sensor_t *sensor, float raw) {
+    if (!(raw >= 0.0f && raw <= (float)NTC_ADC_RAW_MAX)) {
+        return NAN;
+    }
+
+    float pos = raw / NTC_LUT_STEP;
+    int idx = (int)pos;
+    if (idx >= NTC_LUT_SIZE - 1) {
+        idx = NTC_LUT_SIZE - 2;
+    }
+
+    int16_t lo = sensor->lut_centi[idx];
+    int16_t hi = sensor->lut_centi[idx + 1];
+    if (lo == NTC_LUT_INVALID || hi == NTC_LUT_INVALID) {
+        return NAN;
+    }
+
+    float frac = pos - (float)idx;
+    return ((float)lo + (float)(hi - lo) * frac) / 100.0f;
+}
+
+/**
+ * @brief Цілочисельний варіант ntc_lut_lookup: той самий вузол і та сама пропорція,
+ * але з округленням до сотої частки градуса. Результат не залежить від FPU.
+ */
+static esp_err_t ntc_lut_lookup_centi(const ntc_sensor_t *sensor, uint32_t raw_q8, int32_t *centi) {
+    if (raw_q8 > ((uint32_t)NTC_ADC_RAW_MAX << NTC_RAW_Q8_SHIFT)) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    uint32_t idx = raw_q8 >> NTC_LUT_FRAC_BITS;
+    if (idx >= NTC_LUT_SIZE - 1) {
+        idx = NTC_LUT_SIZE - 2;
+    }
+    int32_t frac = (int32_t)(raw_q8 - (idx << NTC_LUT_FRAC_BITS));
+
+    int32_t lo = sensor->lut_centi[idx];
+    int32_t hi = sensor->lut_centi[idx + 1];
+    if (lo == NTC_LUT_INVALID || hi == NTC_LUT_INVALID) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    // Округлення половини від нуля; ділення на степінь двійки з явним знаком,
+    // щоб результат не залежав від реалізації зсуву від'ємних чисел
+    int32_t prod = (hi - lo) * frac;
+    int32_t half = 1 << (NTC_LUT_FRAC_BITS - 1);
+    *centi = lo + (prod >= 0 ? (prod + half) >> NTC_LUT_FRAC_BITS : -((-prod + half) >> NTC_LUT_FRAC_BITS));
+    return ESP_OK;
+}
+
+/**
+ * @brief Будує таблицю перетворення для датчика.
+ *
+ * Таблиця залежить від калібрування АЦП конкретного чипа (eFuse), тому
+ * будується один раз при ініціалізації, а не під час компіляції.
+ */
+static void ntc_build_lut(ntc_sensor_t *sensor) {
+    for (int i = 0; i < NTC_LUT_SIZE; i++) {
+        int raw = i * NTC_LUT_STEP;
+        if (raw > NTC_ADC_RAW_MAX) raw = NTC_ADC_RAW_MAX;
+
+        float t = ntc_raw_to_temp_exact(sensor, raw);
+        if (isnan(t) || fabsf(t * 100.0f) > NTC_LUT_LIMIT_CENTI) {
+            sensor->lut_centi[i] = NTC_LUT_INVALID;
+        } else {
+            sensor->lut_centi[i] = (int16_t)lroundf(t * 100.0f);
+        }
+    }
+}
+
 ntc_sensor_handle_t temp_sensor_driver_init_ntc(adc_channel_t adc_channel,
                                                 adc_atten_t adc_attenuation,
                                                 adc_bitwidth_t adc_width_bit,
@@ -53,6 +201,11 @@ ntc_sensor_handle_t temp_sensor_driver_init_ntc(adc_channel_t adc_channel,
         return NULL;
     }
 
+    if (s_cont_handle != NULL) {
+        ESP_LOGE(TAG, "Cannot add sensors while continuous mode is running.");
+        return NULL;
+    }
+
     if (s_adc1_handle == NULL) {
         ESP_LOGI(TAG, "Initializing ADC1 unit...");
         adc_oneshot_unit_init_cfg_t init_config1 = {.unit_id = ADC_UNIT_1};
@@ -69,12 +222,15 @@ ntc_sensor_handle_t temp_sensor_driver_init_ntc(adc_channel_t adc_channel,
     memset(sensor, 0, sizeof(ntc_sensor_t));
 
     sensor->channel = adc_channel;
+    sensor->atten = adc_attenuation;
+    sensor->bitwidth = adc_width_bit;
     if (!adc_calibration_init(ADC_UNIT_1, adc_attenuation, &sensor->cali_handle)) {
         ESP_LOGE(TAG, "ADC calibration failed for sensor on channel %d", adc_channel);
         return NULL;
     }
 
     sensor->config = *ntc_config;
+    ntc_build_lut(sensor);
     sensor->is_initialized = true;
     s_num_initialized_sensors++;
 
@@ -82,32 +238,308 @@ ntc_sensor_handle_t temp_sensor_driver_init_ntc(adc_channel_t adc_channel,
     ESP_LOGI(TAG, "NTC Config: R0=%.1f, T0=%.1fC, B=%.1f, R_Fixed=%.1f",
              sensor->config.nominal_resistance, sensor->config.nominal_temperature_c,
              sensor->config.b_value, sensor->config.fixed_resistor_ohms);
+    if (sensor->config.use_steinhart_hart) {
+        ESP_LOGI(TAG, "Steinhart-Hart: A=%.6e, B=%.6e, C=%.6e",
+                 sensor->config.sh_a, sensor->config.sh_b, sensor->config.sh_c);
+    }
 
     return (ntc_sensor_handle_t)sensor;
 }
 
-esp_err_t temp_sensor_driver_read_ntc(ntc_sensor_handle_t handle, float *temperature_c) {
+esp_err_t temp_sensor_driver_raw_to_temp(ntc_sensor_handle_t handle, float raw, float *temperature_c) {
     if (handle == NULL || temperature_c == NULL) return ESP_ERR_INVALID_ARG;
     ntc_sensor_t *sensor = (ntc_sensor_t *)handle;
     if (!sensor->is_initialized) return ESP_ERR_INVALID_STATE;
 
-    int adc_raw, voltage_mv;
-    ESP_ERROR_CHECK(adc_oneshot_read(s_adc1_handle, sensor->channel, &adc_raw));
-    ESP_ERROR_CHECK(adc_cali_raw_to_voltage(sensor->cali_handle, adc_raw, &voltage_mv));
-    float voltage = (float)voltage_mv / 1000.0f;
-    float r_ntc;
-
-    if (voltage > 0.001f && voltage < 3.3f) {
-        r_ntc = sensor->config.fixed_resistor_ohms * ((3.3f / voltage) - 1.0f);
-    } else {
-        *temperature_c = NAN;
+    *temperature_c = ntc_lut_lookup(sensor, raw);
+    if (isnan(*temperature_c)) {
         return ESP_ERR_INVALID_STATE;
     }
 
-    float t_kelvin = 1.0f / ((1.0f / (sensor->config.nominal_temperature_c + KELVIN_OFFSET)) +
-                              (1.0f / sensor->config.b_value) * logf(r_ntc / sensor->config.nominal_resistance));
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_driver_raw_q8_to_centi(ntc_sensor_handle_t handle, uint32_t raw_q8, int32_t *centi) {
+    if (handle == NULL || centi == NULL) return ESP_ERR_INVALID_ARG;
+    ntc_sensor_t *sensor = (ntc_sensor_t *)handle;
+    if (!sensor->is_initialized) return ESP_ERR_INVALID_STATE;
+
+    return ntc_lut_lookup_centi(sensor, raw_q8, centi);
+}
+
+esp_err_t temp_sensor_driver_raw_to_resistance(ntc_sensor_handle_t handle, float raw, float *ohms) {
+    if (handle == NULL || ohms == NULL) return ESP_ERR_INVALID_ARG;
+    ntc_sensor_t *sensor = (ntc_sensor_t *)handle;
+    if (!sensor->is_initialized) return ESP_ERR_INVALID_STATE;
 
-    *temperature_c = t_kelvin - KELVIN_OFFSET;
-    
+    // Калібрування АЦП приймає цілий код: інтерполюємо між сусідніми кодами
+    int lo = (int)floorf(raw);
+    if (lo < 0 || lo >= NTC_ADC_RAW_MAX) return ESP_ERR_INVALID_ARG;
+    float r_lo = ntc_raw_to_resistance(sensor, lo);
+    float r_hi = ntc_raw_to_resistance(sensor, lo + 1);
+    if (isnan(r_lo) || isnan(r_hi)) return ESP_ERR_INVALID_STATE;
+
+    *ohms = r_lo + (r_hi - r_lo) * (raw - (float)lo);
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t temp_sensor_driver_read_raw(ntc_sensor_handle_t handle, int *raw) {
+    if (handle == NULL || raw == NULL) return ESP_ERR_INVALID_ARG;
+    ntc_sensor_t *sensor = (ntc_sensor_t *)handle;
+    if (!sensor->is_initialized || s_adc1_handle == NULL) return ESP_ERR_INVALID_STATE;
+
+    return adc_oneshot_read(s_adc1_handle, sensor->channel, raw);
+}
+
+esp_err_t temp_sensor_driver_read_ntc(ntc_sensor_handle_t handle, float *temperature_c) {
+    if (handle == NULL || temperature_c == NULL) return ESP_ERR_INVALID_ARG;
+
+    int adc_raw;
+    esp_err_t err = temp_sensor_driver_read_raw(handle, &adc_raw);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return temp_sensor_driver_raw_to_temp(handle, (float)adc_raw, temperature_c);
+}
+
+esp_err_t temp_sensor_driver_read_ntc_centi(ntc_sensor_handle_t handle, int32_t *centi) {
+    if (handle == NULL || centi == NULL) return ESP_ERR_INVALID_ARG;
+
+    int adc_raw;
+    esp_err_t err = temp_sensor_driver_read_raw(handle, &adc_raw);
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    return temp_sensor_driver_raw_q8_to_centi(handle, (uint32_t)adc_raw << NTC_RAW_Q8_SHIFT, centi);
+}
+
+/**
+ * @brief Повертає ADC1 в oneshot-режим після невдалого запуску безперервного:
+ * створює юніт і налаштовує канали всіх датчиків так само, як при ініціалізації.
+ */
+static esp_err_t oneshot_restore(void) {
+    adc_oneshot_unit_init_cfg_t init_config1 = {.unit_id = ADC_UNIT_1};
+    esp_err_t err = adc_oneshot_new_unit(&init_config1, &s_adc1_handle);
+    if (err != ESP_OK) {
+        s_adc1_handle = NULL;
+        return err;
+    }
+
+    for (int i = 0; i < s_num_initialized_sensors; i++) {
+        adc_oneshot_chan_cfg_t config = {
+            .bitwidth = s_ntc_sensors[i].bitwidth,
+            .atten = s_ntc_sensors[i].atten,
+        };
+        err = adc_oneshot_config_channel(s_adc1_handle, s_ntc_sensors[i].channel, &config);
+        if (err != ESP_OK) return err;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Звільняє дескриптор і буфер невдало запущеного безперервного режиму
+ * та повертає ADC1 в oneshot, щоб контролер міг продовжити одиночні читання.
+ */
+static esp_err_t continuous_start_failed(esp_err_t err) {
+    if (s_cont_handle != NULL) {
+        adc_continuous_deinit(s_cont_handle);
+        s_cont_handle = NULL;
+    }
+    free(s_dma_frame_buf);
+    s_dma_frame_buf = NULL;
+    s_dma_frame_size = 0;
+
+    if (oneshot_restore() != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restore oneshot ADC after continuous start failure");
+    }
+    return err;
+}
+
+esp_err_t temp_sensor_driver_continuous_start(uint32_t sample_freq_hz, uint32_t samples_per_channel) {
+    if (s_cont_handle != NULL) return ESP_ERR_INVALID_STATE;
+    if (s_num_initialized_sensors == 0 || samples_per_channel == 0) return ESP_ERR_INVALID_ARG;
+
+    if (sample_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW) {
+        sample_freq_hz = SOC_ADC_SAMPLE_FREQ_THRES_LOW;
+    }
+
+    // Oneshot і безперервний режими не можуть одночасно володіти ADC1
+    if (s_adc1_handle != NULL) {
+        esp_err_t err = adc_oneshot_del_unit(s_adc1_handle);
+        if (err != ESP_OK) {
+            ESP_LOGE(TAG, "adc_oneshot_del_unit failed: %s", esp_err_to_name(err));
+            return err;
+        }
+        s_adc1_handle = NULL;
+    }
+
+    s_dma_frame_size = samples_per_channel * s_num_initialized_sensors * SOC_ADC_DIGI_RESULT_BYTES;
+    s_dma_frame_buf = malloc(s_dma_frame_size);
+    if (s_dma_frame_buf == NULL) {
+        ESP_LOGE(TAG, "Failed to allocate DMA frame buffer (%u bytes)", (unsigned)s_dma_frame_size);
+        return continuous_start_failed(ESP_ERR_NO_MEM);
+    }
+
+    adc_continuous_handle_cfg_t handle_cfg = {
+        .max_store_buf_size = s_dma_frame_size * 2,
+        .conv_frame_size = s_dma_frame_size,
+        .flags.flush_pool = 1,
+    };
+    esp_err_t err = adc_continuous_new_handle(&handle_cfg, &s_cont_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "adc_continuous_new_handle failed: %s", esp_err_to_name(err));
+        s_cont_handle = NULL;
+        return continuous_start_failed(err);
+    }
+
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX] = {0};
+    adc_channel_t channels[MAX_NTC_SENSORS];
+    for (int i = 0; i < s_num_initialized_sensors; i++) {
+        pattern[i].atten = s_ntc_sensors[i].atten;
+        pattern[i].channel = s_ntc_sensors[i].channel & 0x7;
+        pattern[i].unit = ADC_UNIT_1;
+        pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH;
+        channels[i] = s_ntc_sensors[i].channel;
+    }
+    temp_sensor_driver_slot_map_init(&s_slot_map, channels, s_num_initialized_sensors);
+
+    adc_continuous_config_t dig_cfg = {
+        .pattern_num = s_num_initialized_sensors,
+        .adc_pattern = pattern,
+        .sample_freq_hz = sample_freq_hz,
+        .conv_mode = ADC_CONV_SINGLE_UNIT_1,
+        .format = NTC_ADC_OUTPUT_TYPE,
+    };
+    err = adc_continuous_config(s_cont_handle, &dig_cfg);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "adc_continuous_config failed: %s", esp_err_to_name(err));
+        return continuous_start_failed(err);
+    }
+    err = adc_continuous_start(s_cont_handle);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "adc_continuous_start failed: %s", esp_err_to_name(err));
+        return continuous_start_failed(err);
+    }
+    s_cont_running = true;
+
+    ESP_LOGI(TAG, "Continuous ADC started: %d channel(s), %" PRIu32 " Hz, frame %" PRIu32 " bytes",
+             s_num_initialized_sensors, sample_freq_hz, s_dma_frame_size);
+    return ESP_OK;
+}
+
+void temp_sensor_driver_slot_map_init(ntc_adc_slot_map_t *map, const adc_channel_t *channels, int count) {
+    memset(map->slot, NTC_ADC_NO_SLOT, sizeof(map->slot));
+    for (int i = 0; i < count && i < MAX_NTC_SENSORS; i++) {
+        if ((unsigned)channels[i] < NTC_ADC_CHANNEL_SLOTS) {
+            map->slot[channels[i]] = (uint8_t)i;
+        }
+    }
+}
+
+void temp_sensor_driver_parse_block(const uint8_t *buf, uint32_t len, const ntc_adc_slot_map_t *map,
+                                    ntc_adc_frame_t *frame) {
+    for (uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_output_data_t *p = (const adc_digi_output_data_t *)&buf[i];
+        uint32_t chan = NTC_ADC_GET_CHANNEL(p);
+        if (chan >= NTC_ADC_CHANNEL_SLOTS) continue;
+
+        uint8_t slot = map->slot[chan];
+        if (slot == NTC_ADC_NO_SLOT) continue;
+
+        uint16_t data = NTC_ADC_GET_DATA(p);
+        frame->raw_sum[slot] += data;
+        frame->samples[slot]++;
+        if (data < frame->raw_min[slot]) frame->raw_min[slot] = data;
+        if (data > frame->raw_max[slot]) frame->raw_max[slot] = data;
+    }
+}
+
+esp_err_t temp_sensor_driver_read_frame(ntc_adc_frame_t *frame, uint32_t timeout_ms) {
+    if (frame == NULL) return ESP_ERR_INVALID_ARG;
+    if (s_cont_handle == NULL) return ESP_ERR_INVALID_STATE;
+
+    memset(frame, 0, sizeof(ntc_adc_frame_t));
+    memset(frame->raw_min, 0xFF, sizeof(frame->raw_min));
+
+    if (!s_cont_running) {
+        esp_err_t err = adc_continuous_start(s_cont_handle);
+        if (err != ESP_OK) return err;
+        s_cont_running = true;
+    }
+
+    // Відкидаємо накопичені між викликами кадри, щоб отримати свіжі дані
+    adc_continuous_flush_pool(s_cont_handle);
+
+    uint32_t got = 0;
+    esp_err_t err = adc_continuous_read(s_cont_handle, s_dma_frame_buf, s_dma_frame_size, &got, timeout_ms);
+
+    if (s_cont_gated) {
+        adc_continuous_stop(s_cont_handle);
+        s_cont_running = false;
+    }
+
+    if (err != ESP_OK) {
+        return err;
+    }
+
+    temp_sensor_driver_parse_block(s_dma_frame_buf, got, &s_slot_map, frame);
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_driver_frame_average(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, float *avg_raw) {
+    if (frame == NULL || handle == NULL || avg_raw == NULL) return ESP_ERR_INVALID_ARG;
+    int slot = (ntc_sensor_t *)handle - s_ntc_sensors;
+    if (slot < 0 || slot >= s_num_initialized_sensors) return ESP_ERR_INVALID_ARG;
+
+    if (frame->samples[slot] == 0) return ESP_FAIL;
+
+    *avg_raw = (float)frame->raw_sum[slot] / frame->samples[slot];
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_driver_frame_sum(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, uint32_t *raw_sum, uint32_t *samples) {
+    if (frame == NULL || handle == NULL || raw_sum == NULL || samples == NULL) return ESP_ERR_INVALID_ARG;
+    int slot = (ntc_sensor_t *)handle - s_ntc_sensors;
+    if (slot < 0 || slot >= s_num_initialized_sensors) return ESP_ERR_INVALID_ARG;
+
+    if (frame->samples[slot] == 0) return ESP_FAIL;
+
+    *raw_sum = frame->raw_sum[slot];
+    *samples = frame->samples[slot];
+    return ESP_OK;
+}
+
+esp_err_t temp_sensor_driver_continuous_set_gated(bool gated) {
+    if (s_cont_handle == NULL) return ESP_ERR_INVALID_STATE;
+    if (gated == s_cont_gated) return ESP_OK;
+
+    if (gated && s_cont_running) {
+        esp_err_t err = adc_continuous_stop(s_cont_handle);
+        if (err != ESP_OK) return err;
+        s_cont_running = false;
+    } else if (!gated && !s_cont_running) {
+        esp_err_t err = adc_continuous_start(s_cont_handle);
+        if (err != ESP_OK) return err;
+        s_cont_running = true;
+    }
+    s_cont_gated = gated;
+    return ESP_OK;
+}
+
+bool temp_sensor_driver_continuous_is_running(void) {
+    return s_cont_running;
+}
+
+esp_err_t temp_sensor_driver_frame_extremes(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, uint16_t *raw_min, uint16_t *raw_max) {
+    if (frame == NULL || handle == NULL || raw_min == NULL || raw_max == NULL) return ESP_ERR_INVALID_ARG;
+    int slot = (ntc_sensor_t *)handle - s_ntc_sensors;
+    if (slot < 0 || slot >= s_num_initialized_sensors) return ESP_ERR_INVALID_ARG;
+
+    if (frame->samples[slot] == 0) return ESP_FAIL;
+
+    *raw_min = frame->raw_min[slot];
+    *raw_max = frame->raw_max[slot];
+    return ESP_OK;
+}
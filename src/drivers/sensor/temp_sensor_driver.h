@@ -3,19 +3,53 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
 #include "hal/adc_types.h"
 
-#define MAX_NTC_SENSORS 2
+#define MAX_NTC_SENSORS 8
+#define NTC_ADC_RAW_MAX 4095
+
+// Формат усередненого сирого коду для цілочисельного шляху: код * 256 (Q8)
+#define NTC_RAW_Q8_SHIFT 8
+
+// Кількість каналів ADC1, які можуть зустрітись у DMA-буфері
+#define NTC_ADC_CHANNEL_SLOTS 10
+#define NTC_ADC_NO_SLOT       0xFF
 
 typedef struct {
     float nominal_resistance;
     float nominal_temperature_c;
     float b_value;
     float fixed_resistor_ohms;
+
+    // Калібрування Стейнгарта–Гарта: 1/T = a + b*ln(R) + c*ln(R)^3, T у кельвінах.
+    // Якщо увімкнене, замінює B-рівняння при побудові таблиці.
+    bool use_steinhart_hart;
+    float sh_a;
+    float sh_b;
+    float sh_c;
 } ntc_thermistor_config_t;
 
 typedef struct ntc_sensor_handle_t *ntc_sensor_handle_t;
 
+/**
+ * @brief Блок вибірок, зібраний DMA у безперервному режимі.
+ * Індексується за порядком ініціалізації датчиків (слотом драйвера).
+ */
+typedef struct {
+    uint32_t raw_sum[MAX_NTC_SENSORS]; // Сума сирих кодів АЦП по кожному каналу
+    uint16_t samples[MAX_NTC_SENSORS]; // Кількість вибірок по кожному каналу
+    uint16_t raw_min[MAX_NTC_SENSORS]; // Мінімальний код у кадрі (розкид пакета для монітора справності)
+    uint16_t raw_max[MAX_NTC_SENSORS]; // Максимальний код у кадрі
+} ntc_adc_frame_t;
+
+/**
+ * @brief Відповідність каналу АЦП слоту датчика в кадрі.
+ */
+typedef struct {
+    uint8_t slot[NTC_ADC_CHANNEL_SLOTS]; // Слот для каналу або NTC_ADC_NO_SLOT
+} ntc_adc_slot_map_t;
+
 /**
  * @brief Ініціалізує драйвер датчика температури на основі NTC і ADC1.
  *
@@ -30,6 +64,132 @@ ntc_sensor_handle_t temp_sensor_driver_init_ntc(adc_channel_t adc_channel,
                                                 adc_bitwidth_t adc_width_bit, // <<< ВИПРАВЛЕНО ТИП
                                                 const ntc_thermistor_config_t *ntc_config);
 
+/**
+ * @brief Одиночне (oneshot) читання сирого коду АЦП без перетворення.
+ * Дозволяє підсумовувати коди і перетворювати в температуру один раз на цикл.
+ */
+esp_err_t temp_sensor_driver_read_raw(ntc_sensor_handle_t handle, int *raw);
+
+/**
+ * @brief Одиночне (oneshot) вимірювання температури.
+ * Недоступне після переходу драйвера в безперервний режим.
+ */
 esp_err_t temp_sensor_driver_read_ntc(ntc_sensor_handle_t handle, float *temperature_c);
 
-#endif /* COMPONENTS_DRIVERS_TEMP_SENSOR_DRIVER_H_ */
\ No newline at end of file
+/**
+ * @brief Одиночне вимірювання температури в сотих частках градуса (без float).
+ */
+esp_err_t temp_sensor_driver_read_ntc_centi(ntc_sensor_handle_t handle, int32_t *centi);
+
+/**
+ * @brief Переводить АЦП у безперервний режим з DMA.
+ *
+ * Усі ініціалізовані датчики додаються до списку сканування. Oneshot-юніт
+ * (якщо був створений) звільняється, бо обидва режими не можуть ділити ADC1.
+ * Пул драйвера розрахований на два кадри: поки DMA заповнює один, інший читається.
+ * Якщо безперервний режим не вдалося запустити, дескриптор і буфер звільняються,
+ * а oneshot-юніт відновлюється, тож одиночні читання продовжують працювати.
+ *
+ * @param sample_freq_hz Загальна частота перетворень (для ESP32 не менше 20 кГц).
+ * @param samples_per_channel Кількість вибірок на канал в одному кадрі.
+ * @return esp_err_t ESP_OK у разі успіху, інакше помилка драйвера АЦП.
+ */
+esp_err_t temp_sensor_driver_continuous_start(uint32_t sample_freq_hz, uint32_t samples_per_channel);
+
+/**
+ * @brief Зчитує один свіжий кадр з DMA та розкладає його по каналах.
+ *
+ * Задача блокується лише на час заповнення кадру, без активного очікування.
+ *
+ * @param[out] frame Кадр з сумами та кількістю вибірок по кожному датчику.
+ * @param timeout_ms Максимальний час очікування кадру.
+ * @return esp_err_t ESP_OK, ESP_ERR_TIMEOUT або ESP_ERR_INVALID_STATE, якщо режим не запущено.
+ */
+esp_err_t temp_sensor_driver_read_frame(ntc_adc_frame_t *frame, uint32_t timeout_ms);
+
+/**
+ * @brief Вмикає або вимикає стробування безперервного режиму.
+ *
+ * У стробованому режимі АЦП запускається лише на час заповнення кадру
+ * в temp_sensor_driver_read_frame і зупиняється одразу після нього.
+ * Викликати з того ж завдання, що читає кадри.
+ *
+ * @param gated true - зупиняти АЦП між кадрами, false - сканувати безперервно.
+ * @return esp_err_t ESP_OK або ESP_ERR_INVALID_STATE, якщо режим не запущено.
+ */
+esp_err_t temp_sensor_driver_continuous_set_gated(bool gated);
+
+/**
+ * @brief Повертає, чи працює зараз АЦП у безперервному режимі.
+ */
+bool temp_sensor_driver_continuous_is_running(void);
+
+/**
+ * @brief Заповнює відповідність каналів слотам: канал channels[i] потрапляє у слот i.
+ *
+ * @param[out] map Відповідність для temp_sensor_driver_parse_block.
+ * @param channels Канали у порядку слотів.
+ * @param count Кількість каналів (не більше MAX_NTC_SENSORS).
+ */
+void temp_sensor_driver_slot_map_init(ntc_adc_slot_map_t *map, const adc_channel_t *channels, int count);
+
+/**
+ * @brief Розбирає сирий DMA-буфер і накопичує вибірки у кадрі.
+ *
+ * Не звертається до апаратури і до стану драйвера, тому може використовуватись
+ * з підставним джерелом даних (наприклад, при перевірці обробки блоків на хості).
+ *
+ * @param buf Буфер з результатами перетворень у форматі adc_digi_output_data_t.
+ * @param len Довжина буфера в байтах.
+ * @param map Відповідність каналів слотам кадру.
+ * @param[in,out] frame Кадр для накопичення (не очищується; raw_min має бути заповнений UINT16_MAX).
+ */
+void temp_sensor_driver_parse_block(const uint8_t *buf, uint32_t len, const ntc_adc_slot_map_t *map,
+                                    ntc_adc_frame_t *frame);
+
+/**
+ * @brief Повертає середній сирий код АЦП датчика з кадру.
+ *
+ * @return esp_err_t ESP_FAIL, якщо у кадрі немає вибірок цього датчика.
+ */
+esp_err_t temp_sensor_driver_frame_average(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, float *avg_raw);
+
+/**
+ * @brief Повертає суму сирих кодів датчика та кількість вибірок з кадру (без ділення).
+ *
+ * @return esp_err_t ESP_FAIL, якщо у кадрі немає вибірок цього датчика.
+ */
+esp_err_t temp_sensor_driver_frame_sum(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, uint32_t *raw_sum, uint32_t *samples);
+
+/**
+ * @brief Повертає мінімальний та максимальний сирий код датчика з кадру.
+ *
+ * @return esp_err_t ESP_FAIL, якщо у кадрі немає вибірок цього датчика.
+ */
+esp_err_t temp_sensor_driver_frame_extremes(const ntc_adc_frame_t *frame, ntc_sensor_handle_t handle, uint16_t *raw_min, uint16_t *raw_max);
+
+/**
+ * @brief Перетворює (усереднений) сирий код АЦП у температуру.
+ *
+ * Використовує таблицю, побудовану при ініціалізації датчика з його параметрів
+ * NTC та калібрування АЦП, з лінійною інтерполяцією між вузлами (без logf).
+ */
+esp_err_t temp_sensor_driver_raw_to_temp(ntc_sensor_handle_t handle, float raw, float *temperature_c);
+
+/**
+ * @brief Цілочисельний варіант temp_sensor_driver_raw_to_temp.
+ *
+ * @param raw_q8 Усереднений сирий код у форматі Q8 (код << NTC_RAW_Q8_SHIFT).
+ * @param[out] centi Температура в сотих частках градуса, округлена.
+ */
+esp_err_t temp_sensor_driver_raw_q8_to_centi(ntc_sensor_handle_t handle, uint32_t raw_q8, int32_t *centi);
+
+/**
+ * @brief Перетворює (усереднений) сирий код в опір термістора через калібрування АЦП.
+ * Використовується для захоплення калібрувальних точок.
+ *
+ * @param[out] ohms Опір термістора, Ом.
+ */
+esp_err_t temp_sensor_driver_raw_to_resistance(ntc_sensor_handle_t handle, float raw, float *ohms);
+
+#endif /* COMPONENTS_DRIVERS_TEMP_SENSOR_DRIVER_H_ */
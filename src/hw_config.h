@@ -1,6 +1,12 @@
+#pragma once
+
 #define GPIO_RELAY GPIO_NUM_2
 #define RELAY_ACTIVE_LEVEL 1
 
+// Максимальна кількість зон опалення. Зона 0 - основна (GPIO_RELAY, кімната та радіатор),
+// реле та датчики решти зон задаються в налаштуваннях
+#define HEAT_ZONES_MAX 8
+
 #define GPIO_BUTTON_UP_PIN GPIO_NUM_4
 #define GPIO_BUTTON_DOWN_PIN GPIO_NUM_5
 
@@ -18,7 +24,22 @@
 
 #define THERMISTOR_ENVIRONMENT ADC_CHANNEL_6
 #define THERMISTOR_RADIATOR ADC_CHANNEL_7
+#define THERMISTOR_FLOOR ADC_CHANNEL_4
+#define THERMISTOR_PIPE_RETURN ADC_CHANNEL_5
+#define THERMISTOR_ROOM_2 ADC_CHANNEL_0
+#define THERMISTOR_AUX ADC_CHANNEL_3
+
+// Кількість слотів у реєстрі термісторів (усі виведені канали ADC1)
+#define MAX_TEMP_SENSORS 6
 
 #define SENSOR_MIN_VALID_TEMP (-40.0f)
 #define SENSOR_MAX_VALID_TEMP (80.0f)
-#define MAX_TEMP_JUMP_PER_SEC (5.0f)
\ No newline at end of file
+#define MAX_TEMP_JUMP_PER_SEC (5.0f)
+
+// Цілочисельний шлях обробки температури (1 - увімкнено).
+// Перетворення коду АЦП, усереднення, фільтрація та ПІД працюють у сотих частках градуса
+// без float, результат детермінований і не залежить від FPU.
+// Можна перевизначити з командного рядка (-DTEMP_FIXED_POINT=1), як у середовищі native_fixed.
+#ifndef TEMP_FIXED_POINT
+#define TEMP_FIXED_POINT 0
+#endif
@@ -1,4 +1,5 @@
 #include "esp_log.h"
+#include "esp_timer.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
 #include "freertos/semphr.h"
@@ -20,27 +21,32 @@
 #include "controller/input/button_controller.h"
 #include "controller/display/display_controller.h"
 #include "controller/sensor/temp_controller.h"
+#include "controller/sensor/temp_health.h"
 #include "controller/actuator/pwm_manager.h"
 #include "controller/actuator/relay_controller.h"
 #include "controller/sensor/presence_controller.h"
 #include "controller/actuator/pid_controller.h" 
+#include "controller/actuator/pid_autotune.h"
+#include "controller/room_estimator.h"
+#include "controller/heating_curve.h"
+#include "controller/loop_timing.h"
+#include "controller/task_stats.h"
 #include "controller/adaptive_algorythm.h"
+#include "controller/zone_manager.h"
 #include "controller/temp_setpoint_manager.h"
 #include "model/main_control.h"
+#include "model/state_bus.h"
 #include "controller/schedule_manager.h"
 #include "networking/mqtt_client.h"
 #include "networking/mqtt_task.h"
 
 static const char* TAG = "MAIN";
 
-sensors_state_t current_sensors_state;
-
-static system_state_t current_state = STATE_BOOT;
-static SemaphoreHandle_t state_mutex;
+// Усталений режим для навчання кривої опалення: кімната на уставці й не дрейфує
+#define HEATING_CURVE_STEADY_ERR_C     0.3f
+#define HEATING_CURVE_STEADY_RATE_C_H  0.3f
 
-static system_state_t preview_state = STATE_MANUAL;
-static TickType_t mode_select_enter_time;
-#define MODE_SELECT_TIMEOUT_MS 5000
+sensors_state_t current_sensors_state;
 
 static float prev_room_temp = -999.0f;
 static float prev_rad_temp = -999.0f;
@@ -52,41 +58,70 @@ typedef enum {
     ERR_SENSOR_RAD_FAIL,
     ERR_SENSOR_SPIKE,
     ERR_RAD_OVERHEAT,
-    ERR_WEATHER_CRITICAL
+    ERR_WEATHER_CRITICAL,
+    ERR_SENSOR_OPEN,
+    ERR_SENSOR_SHORT,
+    ERR_SENSOR_STUCK,
+    ERR_SENSOR_NOISY
 } system_error_t;
 
 static system_error_t active_error = ERR_NONE;
-
-const char* state_to_string(system_state_t state) {
-    switch (state) {
-        case STATE_OFF: return "OFF";
-        case STATE_MANUAL: return "MANUAL";
-        case STATE_PROGRAMMED: return "PROGRAMMED";
-        case STATE_ADAPTIVE: return "ADAPTIVE";
-        case STATE_ANTI_FREEZE: return "ANTI_FREEZE";
-        case STATE_EMERGENCY: return "EMERGENCY";
-        case STATE_MODE_SELECT: return "MODE SELECT";
-        default: return "UNKNOWN";
+static int active_error_sensor = -1;
+
+/**
+ * @brief Перевіряє стан справності обов'язкового датчика з монітора контролера температур.
+ */
+static bool check_sensor_health(temp_sensor_id_t id, uint8_t health) {
+    switch ((temp_health_t)health) {
+        case TEMP_HEALTH_OK:
+            return true;
+        case TEMP_HEALTH_NO_DATA:
+            active_error = id == TEMP_SENSOR_ROOM ? ERR_SENSOR_ROOM_FAIL : ERR_SENSOR_RAD_FAIL;
+            break;
+        case TEMP_HEALTH_OPEN:
+            active_error = ERR_SENSOR_OPEN;
+            break;
+        case TEMP_HEALTH_SHORT:
+            active_error = ERR_SENSOR_SHORT;
+            break;
+        case TEMP_HEALTH_STUCK:
+            active_error = ERR_SENSOR_STUCK;
+            break;
+        case TEMP_HEALTH_NOISY:
+        default:
+            active_error = ERR_SENSOR_NOISY;
+            break;
     }
+    active_error_sensor = id;
+    ESP_LOGE(TAG, "SAFETY: Sensor %d health %s", id, temp_health_to_string((temp_health_t)health));
+    return false;
 }
 
-bool check_system_safety(float room_t, float rad_t, const app_settings_t *cfg, system_state_t current_mode) {
+bool check_system_safety(float room_t, float rad_t, const uint8_t *sensor_health, const app_settings_t *cfg, system_state_t current_mode) {
+
+    if (!check_sensor_health(TEMP_SENSOR_ROOM, sensor_health[TEMP_SENSOR_ROOM]) ||
+        !check_sensor_health(TEMP_SENSOR_RADIATOR, sensor_health[TEMP_SENSOR_RADIATOR])) {
+        return false;
+    }
     
     if (room_t < SENSOR_MIN_VALID_TEMP || room_t > SENSOR_MAX_VALID_TEMP) {
         ESP_LOGE(TAG, "SAFETY: Room sensor failure! Val: %.2f", room_t);
         active_error = ERR_SENSOR_ROOM_FAIL;
+        active_error_sensor = TEMP_SENSOR_ROOM;
         return false;
     }
 
     if (rad_t < SENSOR_MIN_VALID_TEMP || rad_t > SENSOR_MAX_VALID_TEMP) {
         ESP_LOGE(TAG, "SAFETY: Radiator sensor failure! Val: %.2f", rad_t);
         active_error = ERR_SENSOR_RAD_FAIL;
+        active_error_sensor = TEMP_SENSOR_RADIATOR;
         return false;
     }
 
     if (rad_t >= cfg->control.limits.rad_max + 5.0f) {
         ESP_LOGE(TAG, "SAFETY: Radiator Overheat! %.2f > %.2f", rad_t, cfg->control.limits.rad_max + 5.0f);
         active_error = ERR_RAD_OVERHEAT;
+        active_error_sensor = TEMP_SENSOR_RADIATOR;
         return false;
     }
 
@@ -99,6 +134,7 @@ bool check_system_safety(float room_t, float rad_t, const app_settings_t *cfg, s
             if (delta_room >= MAX_TEMP_JUMP_PER_SEC) {
                  ESP_LOGE(TAG, "SAFETY: Room Temp Spike! Delta: %.2f in %.1fs", delta_room, delta_time_sec);
                  active_error = ERR_SENSOR_SPIKE;
+                 active_error_sensor = TEMP_SENSOR_ROOM;
                  return false;
             }
         }
@@ -114,6 +150,7 @@ bool check_system_safety(float room_t, float rad_t, const app_settings_t *cfg, s
         if (!weather_ok) {
             ESP_LOGE(TAG, "SAFETY: Critical Weather Data Unavailable!");
             active_error = ERR_WEATHER_CRITICAL;
+            active_error_sensor = -1;
             return false;
         }
     } else {
@@ -123,79 +160,47 @@ bool check_system_safety(float room_t, float rad_t, const app_settings_t *cfg, s
     }
 
     active_error = ERR_NONE;
+    active_error_sensor = -1;
     return true;
 }
 
-void main_control_change_state(system_state_t new_state) {
-    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
-        if (current_state != new_state) {
-            pwm_manager_reset();
-            ESP_LOGI(TAG, "STATE CHANGE: %s -> %s", state_to_string(current_state), state_to_string(new_state));
-            current_state = new_state;
-            
-            if (new_state == STATE_MODE_SELECT) {
-                preview_state = STATE_MANUAL;
-                mode_select_enter_time = xTaskGetTickCount();
-            }
-        }
-        xSemaphoreGive(state_mutex);
-    }
-}
-
-system_state_t main_control_get_state(void) {
-    system_state_t state = STATE_OFF; 
-    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
-        state = current_state;
-        xSemaphoreGive(state_mutex);
-    }
-    return state;
+int zeller_day_of_week(int d, int m, int y){
+    if(m < 3){ m += 12; y -= 1; }
+    int K = y % 100;
+    int J = y / 100;
+    int h = (d + 13*(m+1)/5 + K + K/4 + J/4 + 5*J) % 7;
+    return (h + 6) % 7;
 }
 
-void main_control_cycle_preview_mode(bool go_up) {
-    if (main_control_get_state() != STATE_MODE_SELECT) return;
-
-    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
-        system_state_t selectable_states[] = {STATE_MANUAL, STATE_ADAPTIVE, STATE_PROGRAMMED, STATE_ANTI_FREEZE};
-        int num_states = sizeof(selectable_states) / sizeof(selectable_states[0]);
-        int current_idx = -1;
-
-        for (int i = 0; i < num_states; i++) {
-            if (preview_state == selectable_states[i]) {
-                current_idx = i;
-                break;
-            }
-        }
-        if (current_idx == -1) current_idx = 0;
-
-        if (go_up) {
-            current_idx = (current_idx + 1) % num_states;
-        } else {
-            current_idx = (current_idx - 1 + num_states) % num_states;
-        }
-        
-        preview_state = selectable_states[current_idx];
-
-        ESP_LOGI(TAG, "Preview mode changed to: %s", state_to_string(preview_state));
-        mode_select_enter_time = xTaskGetTickCount();
-        xSemaphoreGive(state_mutex);
+/**
+ * @brief Очікування наступного періоду циклу керування.
+ * Якщо ітерація затягнулась і термін уже минув, фаза відновлюється від поточного моменту,
+ * щоб не виконувати пропущені ітерації пачкою.
+ */
+static void control_loop_wait(loop_timing_handle_t timing, TickType_t *last_wake_time, TickType_t period) {
+    loop_timing_end(timing);
+    if (xTaskDelayUntil(last_wake_time, period) == pdFALSE) {
+        ESP_LOGW(TAG, "Control loop overran its %lu ms period", (unsigned long)pdTICKS_TO_MS(period));
+        *last_wake_time = xTaskGetTickCount();
     }
 }
 
-system_state_t main_control_get_preview_state(void) {
-    system_state_t s = STATE_OFF;
-    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
-        s = preview_state;
-        xSemaphoreGive(state_mutex);
-    }
-    return s;
+/**
+ * @brief Заповнення прямого зв'язку від кривої опалення (0, якщо вимкнено в налаштуваннях).
+ */
+static float heating_feedforward(const heating_curve_t *curve, const app_settings_t *cfg, float setpoint, float outside_temp) {
+    if (!cfg->control.ff.enabled) return 0.0f;
+    return heating_curve_feedforward(curve, setpoint, outside_temp);
 }
 
-int zeller_day_of_week(int d, int m, int y){
-    if(m < 3){ m += 12; y -= 1; }
-    int K = y % 100;
-    int J = y / 100;
-    int h = (d + 13*(m+1)/5 + K + K/4 + J/4 + 5*J) % 7;
-    return (h + 6) % 7;
+/**
+ * @brief ПІД з прямим зв'язком: вихід = ff + ПІД.
+ * Межі регулятора зсуваються на ff, тож сума лишається в [0, 100],
+ * а антинасичення бачить фактичне насичення реле.
+ */
+static float heating_pid_compute(pid_controller_t *pid, float ff, float setpoint, float measured) {
+    pid_set_output_limits(pid, -ff, 100.0f - ff);
+    return ff + pid_compute(pid, setpoint, measured);
 }
 
 void heating_control_task(void *pvParameters) {
@@ -203,7 +208,7 @@ void heating_control_task(void *pvParameters) {
     
     const app_settings_t *cfg = settings_get();
 
-    main_control_change_state(STATE_OFF); 
+    main_control_change_state(STATE_OFF, MAIN_CONTROL_CAUSE_BOOT);
 
     pid_controller_t heater_pid;
     pid_init(&heater_pid, 
@@ -211,46 +216,95 @@ void heating_control_task(void *pvParameters) {
              cfg->control.pid.ki, 
              cfg->control.pid.kd, 
              0.0f, 100.0f);
+    pid_set_weighting(&heater_pid, cfg->control.pid.setpoint_weight, cfg->control.pid.d_filter_n);
+
+    // Крива опалення дає усталене заповнення одразу при зміні погоди, інтеграл добирає лише залишок
+    heating_curve_t heating_curve;
+    heating_curve_init(&heating_curve, cfg->control.ff.slope, cfg->control.ff.offset);
+    if (cfg->control.ff.enabled && cfg->control.ff.learn) {
+        heating_curve_load(&heating_curve);
+    }
+    heating_curve_outside_t ff_outside;
+    heating_curve_outside_init(&ff_outside);
+    float ff_outside_temp = NAN; // Свіжа зовнішня температура для прямого зв'язку
+
+    room_estimator_t room_est;
+    room_estimator_config_t est_config = {
+        .k_rad = cfg->control.estimator.k_rad,
+        .k_loss = cfg->control.estimator.k_loss,
+        .k_relay = 0.0f,
+        .meas_noise = cfg->control.estimator.meas_noise
+    };
+    room_estimator_init(&room_est, &est_config);
+
+    // Без очікуваного запуску стан автоналаштування одразу повертається в попередній режим
+    pid_autotune_t autotune = { .status = PID_AUTOTUNE_FAILED };
+    pid_autotune_config_t autotune_start;
+    system_state_t autotune_exit_state = STATE_OFF;
     
     float room_temp, radiator_temp;
+    float control_temp; // Температура, що подається на ПІД (виміряна або оцінена)
     bool presence_detected;
     bool heater_state;
     float outside_temp;
+    system_state_txn_t state_txn;
 
     TickType_t last_wake_time = xTaskGetTickCount();
     const TickType_t loop_period = pdMS_TO_TICKS(1000);
+    loop_timing_handle_t loop_timing = loop_timing_register("control", pdTICKS_TO_MS(loop_period) * 1000);
 
     for (;;) {
+        loop_timing_begin(loop_timing, 0);
+        main_control_update();
         system_state_t active_state = main_control_get_state();
-        system_state_set_system_state(active_state);
-        system_state_set_temp_outside(weather_get_temperature());
-        system_state_set_relay_state(relay_controller_get_heater_state());
+        // Вхідні дані ітерації публікуються одним пакетом: одна версія стану замість трьох
+        system_state_txn_begin(&state_txn);
+        system_state_txn_set_system_state(&state_txn, active_state);
+        system_state_txn_set_temp_outside(&state_txn, weather_get_temperature());
+        system_state_txn_set_relay_state(&state_txn, relay_controller_get_heater_state());
+        system_state_txn_commit(&state_txn);
 
         system_state_get(&current_sensors_state);
-        room_temp = current_sensors_state.temperature_c_sensor1;
-        radiator_temp = current_sensors_state.temperature_c_sensor2;
+        room_temp = current_sensors_state.temperature_c[TEMP_SENSOR_ROOM];
+        radiator_temp = current_sensors_state.temperature_c[TEMP_SENSOR_RADIATOR];
         presence_detected = current_sensors_state.presence_state;
         heater_state = current_sensors_state.relay_is_on;
         outside_temp = current_sensors_state.temperature_c_outside;
+        ff_outside_temp = heating_curve_outside_update(&ff_outside, outside_temp, weather_get_last_update_time(),
+                                                       cfg->geo.interval_min, esp_timer_get_time());
 
-        if (!check_system_safety(room_temp, radiator_temp, cfg, active_state)) {
+        if (!check_system_safety(room_temp, radiator_temp, current_sensors_state.sensor_health, cfg, active_state)) {
             if (active_state != STATE_EMERGENCY) {
-                main_control_change_state(STATE_EMERGENCY);
+                main_control_change_state(STATE_EMERGENCY, MAIN_CONTROL_CAUSE_SAFETY);
             }
             
             relay_controller_set_heater_state(false); 
             pwm_manager_reset();
 
-            system_state_set_error_code(active_error);
-            system_state_set_ui_state(UI_STATE_EMERGENCY);
+            zone_manager_update(STATE_EMERGENCY, NAN, 0.0f, &current_sensors_state);
+
+            system_state_txn_begin(&state_txn);
+            system_state_txn_set_error_code(&state_txn, active_error, active_error_sensor);
+            system_state_txn_set_ui_state(&state_txn, UI_STATE_EMERGENCY);
+            system_state_txn_commit(&state_txn);
             ESP_LOGE(TAG, "SYSTEM IN EMERGENCY STATE! Error Code: %d", active_error);
             
-            vTaskDelayUntil(&last_wake_time, loop_period);
+            control_loop_wait(loop_timing, &last_wake_time, loop_period);
             continue; 
         }
         
-        ESP_LOGI(TAG, "Room: %.2f, Rad: %.2f, Out: %.2f, Pres: %d, Heat: %d", 
-            room_temp, radiator_temp, outside_temp, presence_detected, heater_state);
+        room_estimator_update(&room_est,
+            current_sensors_state.temperature_fast_c[TEMP_SENSOR_ROOM],
+            current_sensors_state.temperature_fast_c[TEMP_SENSOR_RADIATOR],
+            heater_state, outside_temp);
+        // Оцінка кімнати та уставка режиму публікуються разом після розрахунку виходу
+        system_state_txn_begin(&state_txn);
+        system_state_txn_set_room_estimate(&state_txn, room_est.temp, room_estimator_get_rate_per_hour(&room_est));
+        control_temp = cfg->control.estimator.enabled ? room_est.temp : room_temp;
+
+        ESP_LOGI(TAG, "Room: %.2f (est %.2f, %.2f C/h), Rad: %.2f, Out: %.2f, Pres: %d, Heat: %d", 
+            room_temp, room_est.temp, room_estimator_get_rate_per_hour(&room_est),
+            radiator_temp, outside_temp, presence_detected, heater_state);
         
         char date_str[11];
         char time_str[6];
@@ -262,9 +316,17 @@ void heating_control_task(void *pvParameters) {
             zeller_day_of_week((date_str[0]-'0')*10 + (date_str[1]-'0'), (date_str[3]-'0')*10 + (date_str[4]-'0'), (date_str[6]-'0')*1000 + (date_str[7]-'0')*100 + (date_str[8]-'0')*10 + (date_str[9]-'0')),
             (time_str[0] - '0') * 10 + (time_str[1] - '0'), (time_str[3] - '0') * 10 + (time_str[4] - '0')
         );
+        adaptive_thermo_notify_heating(radiator_temp, heater_state);
+
+        // Вхід у режим з ПІД з режиму без нього: регулятор починає з чистого стану
+        if (main_control_take_pid_reset()) {
+            pid_reset(&heater_pid);
+        }
 
         float pid_output_f = 0.0f;
-        float setpoint_temp;
+        float ff = 0.0f; // Прямий зв'язок, що входить у pid_output_f
+        float setpoint_temp = NAN;
+        bool pid_active = false; // Вихід цієї ітерації розрахував ПІД
 
         switch (active_state) {
             case STATE_OFF:
@@ -274,57 +336,121 @@ void heating_control_task(void *pvParameters) {
             case STATE_MANUAL:
                 setpoint_temp = temp_setpoint_manager_get();
                 ESP_LOGI(TAG, "Manual setpoint: %.2fC", setpoint_temp);
-                system_state_set_current_setpoint(setpoint_temp);
-                pid_output_f = pid_compute(&heater_pid, setpoint_temp, room_temp);
+                system_state_txn_set_current_setpoint(&state_txn, setpoint_temp);
+                ff = heating_feedforward(&heating_curve, cfg, setpoint_temp, ff_outside_temp);
+                pid_output_f = heating_pid_compute(&heater_pid, ff, setpoint_temp, control_temp);
+                pid_active = true;
                 pwm_manager_update(pid_output_f, radiator_temp);
                 break;
 
             case STATE_MODE_SELECT:
-                if(current_sensors_state.ui_state != UI_STATE_SELECT_MENU) {
-                    system_state_set_ui_state(UI_STATE_SELECT_MENU);
-                }
-                if ((xTaskGetTickCount() - mode_select_enter_time) > pdMS_TO_TICKS(MODE_SELECT_TIMEOUT_MS)) {
-                    main_control_change_state(preview_state);
-                    system_state_set_ui_state(UI_STATE_MAIN_SCREEN);
-                }
+                // Екран меню та вихід за тайм-аутом - дії станів у main_control
                 break;
 
             case STATE_PROGRAMMED:
                 setpoint_temp = schedule_manager_get_current_setpoint();
                 ESP_LOGI(TAG, "Programmed setpoint: %.2fC", setpoint_temp);
-                system_state_set_current_setpoint(setpoint_temp);
-                pid_output_f = pid_compute(&heater_pid, setpoint_temp, room_temp);
+                system_state_txn_set_current_setpoint(&state_txn, setpoint_temp);
+                ff = heating_feedforward(&heating_curve, cfg, setpoint_temp, ff_outside_temp);
+                pid_output_f = heating_pid_compute(&heater_pid, ff, setpoint_temp, control_temp);
+                pid_active = true;
                 pwm_manager_update(pid_output_f, radiator_temp);
                 break;
 
             case STATE_ADAPTIVE:
                 setpoint_temp = adaptive_thermo_get_setpoint();
                 ESP_LOGI(TAG, "Adaptive setpoint: %.2fC", setpoint_temp);
-                system_state_set_current_setpoint(setpoint_temp);
-                pid_output_f = pid_compute(&heater_pid, setpoint_temp, room_temp);
+                system_state_txn_set_current_setpoint(&state_txn, setpoint_temp);
+                if (adaptive_thermo_get_mpc_duty(&pid_output_f)) {
+                    ESP_LOGI(TAG, "MPC duty: %.1f%%", pid_output_f);
+                } else {
+                    ff = heating_feedforward(&heating_curve, cfg, setpoint_temp, ff_outside_temp);
+                    pid_output_f = heating_pid_compute(&heater_pid, ff, setpoint_temp, control_temp);
+                    pid_active = true;
+                }
                 pwm_manager_update(pid_output_f, radiator_temp);
                 break;
 
             case STATE_ANTI_FREEZE:
                 if (room_temp <= cfg->control.limits.room_min) {
-                    pid_output_f = pid_compute(&heater_pid, 7.0f, room_temp);
-                    system_state_set_current_setpoint(7.0f);
+                    setpoint_temp = 7.0f;
+                    ff = heating_feedforward(&heating_curve, cfg, setpoint_temp, ff_outside_temp);
+                    pid_output_f = heating_pid_compute(&heater_pid, ff, setpoint_temp, control_temp);
+                    pid_active = true;
+                    system_state_txn_set_current_setpoint(&state_txn, setpoint_temp);
                 } else {
                     pid_output_f = 0;
                 }
                 pwm_manager_update(pid_output_f, radiator_temp);
                 break;
 
+            case STATE_AUTOTUNE:
+                if (main_control_take_autotune(&autotune_start, &autotune_exit_state)) {
+                    pid_autotune_init(&autotune, &autotune_start, control_temp, esp_timer_get_time());
+                }
+                system_state_txn_set_current_setpoint(&state_txn, autotune.cfg.setpoint);
+                pid_output_f = pid_autotune_update(&autotune, control_temp, esp_timer_get_time());
+                if (autotune.status == PID_AUTOTUNE_RUNNING) {
+                    pwm_manager_update(pid_output_f, radiator_temp);
+                    break;
+                }
+
+                if (autotune.status == PID_AUTOTUNE_DONE) {
+                    app_settings_t *wcfg = settings_get_writeable();
+                    wcfg->control.pid.kp = autotune.kp;
+                    wcfg->control.pid.ki = autotune.ki;
+                    wcfg->control.pid.kd = autotune.kd;
+                    settings_save();
+                    pid_set_tuning(&heater_pid, autotune.kp, autotune.ki, autotune.kd);
+                    ESP_LOGI(TAG, "Autotune gains saved: kp=%.3f ki=%.5f kd=%.2f", autotune.kp, autotune.ki, autotune.kd);
+                } else {
+                    ESP_LOGW(TAG, "Autotune failed, keeping previous gains");
+                }
+                autotune.status = PID_AUTOTUNE_FAILED;
+                main_control_change_state(autotune_exit_state, MAIN_CONTROL_CAUSE_AUTOTUNE);
+                break;
+
             case STATE_EMERGENCY:
                 relay_controller_set_heater_state(false);
                 pwm_manager_reset();
                 break;
             
             default:
-                main_control_change_state(STATE_OFF);
+                main_control_change_state(STATE_OFF, MAIN_CONTROL_CAUSE_INTERNAL);
                 break;
         }
-        vTaskDelay(pdMS_TO_TICKS(1000));
+
+        // Коли вихід формує не ПІД (вимкнений обігрів, MPC, автоналаштування), регулятор
+        // стежить за фактичним виходом: перехід до ПІД між режимами обігріву (MPC -> ПІД)
+        // буде безударним (ПІД підхоплює вихід без прямого зв'язку, який додасться до нього
+        // при поверненні). Вхід з режиму без обігріву натомість скидає регулятор (main_control)
+        if (!pid_active) {
+            float track_setpoint = isnan(setpoint_temp) ? control_temp : setpoint_temp;
+            ff = heating_feedforward(&heating_curve, cfg, track_setpoint, ff_outside_temp);
+            pid_set_output_limits(&heater_pid, -ff, 100.0f - ff);
+            pid_track(&heater_pid, track_setpoint, control_temp, pid_output_f - ff);
+        } else if (cfg->control.ff.enabled && cfg->control.ff.learn) {
+            bool steady = fabsf(setpoint_temp - control_temp) < HEATING_CURVE_STEADY_ERR_C &&
+                          fabsf(room_estimator_get_rate_per_hour(&room_est)) < HEATING_CURVE_STEADY_RATE_C_H;
+            if (heating_curve_add_sample(&heating_curve, steady, setpoint_temp, ff_outside_temp, pid_output_f)) {
+                // Уточнення кривої не має стрибком змінювати вихід: різницю забирає інтеграл
+                ff = heating_feedforward(&heating_curve, cfg, setpoint_temp, ff_outside_temp);
+                pid_set_output_limits(&heater_pid, -ff, 100.0f - ff);
+                pid_track(&heater_pid, setpoint_temp, control_temp, pid_output_f - ff);
+                heating_curve_save(&heating_curve);
+            }
+        }
+
+        system_state_txn_commit(&state_txn);
+
+        // Додаткові зони йдуть за уставкою активного режиму; під час автоналаштування - за ручною
+        float zone_setpoint = active_state == STATE_AUTOTUNE ? temp_setpoint_manager_get() : setpoint_temp;
+        zone_manager_update(active_state, zone_setpoint, pid_output_f, &current_sensors_state);
+
+        // Лічильники зносу реле пишуться у флеш рідко і лише з цього циклу
+        relay_controller_save_stats(false);
+
+        control_loop_wait(loop_timing, &last_wake_time, loop_period);
     }
 }
 
@@ -359,8 +485,7 @@ void on_wifi_connected_and_got_ip(void) {
 esp_err_t thermostat_controller_init(void) {
     const app_settings_t *cfg = settings_get();
 
-    state_mutex = xSemaphoreCreateMutex();
-    if (state_mutex == NULL) return ESP_FAIL;
+    if (main_control_init() != ESP_OK) return ESP_FAIL;
 
     system_state_init();
     ESP_ERROR_CHECK(display_controller_init(GPIO_SDA, GPIO_SCL));
@@ -374,7 +499,10 @@ esp_err_t thermostat_controller_init(void) {
     };
 
     temp_controller_config_t temp_config = {
-        .update_interval_ms = 500, .task_priority = 5, .task_stack_size = 4096
+        .update_interval_ms = 500, .task_priority = 5, .task_stack_size = 4096,
+        .acq_mode = TEMP_ACQ_CONTINUOUS,
+        .history_bytes = 32 * 1024,
+        .adaptive_sampling = true
     };
     
     if (time_storage_restore_time() == ESP_OK) {
@@ -395,12 +523,19 @@ esp_err_t thermostat_controller_init(void) {
     ESP_ERROR_CHECK(button_controller_init(button_configs, sizeof(button_configs) / sizeof(button_configs[0])));
     ESP_ERROR_CHECK(presence_controller_init(HLK_PRESENCE_PIN));
     ESP_ERROR_CHECK(relay_controller_init(GPIO_RELAY, RELAY_ACTIVE_LEVEL));
+    ESP_ERROR_CHECK(pwm_manager_init());
+    ESP_ERROR_CHECK(zone_manager_init());
     ESP_ERROR_CHECK(temp_controller_init(&temp_config));
 
     ESP_ERROR_CHECK(temp_setpoint_manager_init());
     ESP_ERROR_CHECK(schedule_manager_init());
     ESP_ERROR_CHECK(adaptive_thermo_init());
 
+    // Діагностика не обов'язкова для роботи: без неї термостат стартує далі
+    if (task_stats_init(TASK_STATS_PERIOD_MS) != ESP_OK) {
+        ESP_LOGW(TAG, "Task stats unavailable");
+    }
+
     system_state_set_ui_state(UI_STATE_MAIN_SCREEN);
     return ESP_OK;
 }
@@ -0,0 +1,371 @@
+#include "model/main_control.h"
+#include "model/system_state.h"
+#include "model/state_bus.h"
+#include "model/settings_manager.h"
+#include "controller/actuator/pwm_manager.h"
+#include "controller/actuator/relay_controller.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include <math.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "main_control";
+
+#define MODE_SELECT_TIMEOUT_MS 5000
+
+// Релейний експеримент: гістерезис понад шум відфільтрованого датчика кімнати,
+// тайм-аут з запасом на повільну кімнату (період коливань - година і більше)
+#define AUTOTUNE_HYSTERESIS_C 0.1f
+#define AUTOTUNE_TIMEOUT_US   (24LL * 3600LL * 1000000LL)
+
+// Будь-який стан у таблиці переходів
+#define STATE_ANY STATE_COUNT
+
+#define CAUSE_BIT(c) (1u << (c))
+#define CAUSE_USER   (CAUSE_BIT(MAIN_CONTROL_CAUSE_BUTTON) | CAUSE_BIT(MAIN_CONTROL_CAUSE_WEB))
+
+/**
+ * @brief Опис стану: властивості та дії на вході й виході.
+ * Дії виконуються під м'ютексом стану, тож не можуть змінювати стан самі.
+ */
+typedef struct {
+    const char *name;
+    bool heating;       // Обігрівом керує ПІД основної зони
+    bool selectable;    // Користувач може вибрати режим (кнопки, веб)
+    void (*on_entry)(system_state_t from);
+    void (*on_exit)(system_state_t to);
+} state_desc_t;
+
+/**
+ * @brief Рядок таблиці переходів. Перший рядок, що підходить, дозволяє перехід.
+ */
+typedef struct {
+    system_state_t from;   // STATE_ANY - з будь-якого
+    system_state_t to;     // STATE_ANY - у будь-який
+    uint32_t causes;       // Маска CAUSE_BIT дозволених причин
+    bool (*guard)(system_state_t from, system_state_t to);
+} transition_t;
+
+static system_state_t current_state = STATE_BOOT;
+static SemaphoreHandle_t state_mutex;
+
+static system_state_t preview_state = STATE_MANUAL;
+static TickType_t mode_select_enter_time;
+
+static system_state_t autotune_return_state = STATE_OFF;
+static pid_autotune_config_t autotune_config;
+static bool autotune_pending = false;
+
+static bool pid_reset_pending = false;
+
+static main_control_transition_t s_journal[MAIN_CONTROL_JOURNAL_SIZE];
+static uint32_t s_journal_count = 0;
+
+// --- Дії станів ---
+
+static void heating_on_entry(system_state_t from);
+
+static void idle_on_entry(system_state_t from) {
+    // Без ПІД обігрів вимикається одразу, а не в кінці періоду ШІМ
+    pwm_manager_reset();
+}
+
+static void emergency_on_entry(system_state_t from) {
+    relay_controller_set_heater_state(false);
+    pwm_manager_reset();
+}
+
+static void emergency_on_exit(system_state_t to) {
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_error_code(&txn, 0, -1);
+    system_state_txn_set_ui_state(&txn, UI_STATE_MAIN_SCREEN);
+    system_state_txn_commit(&txn);
+}
+
+static void mode_select_on_entry(system_state_t from) {
+    pwm_manager_reset();
+    preview_state = STATE_MANUAL;
+    mode_select_enter_time = xTaskGetTickCount();
+    system_state_set_ui_state(UI_STATE_SELECT_MENU);
+}
+
+static void mode_select_on_exit(system_state_t to) {
+    if (to != STATE_EMERGENCY) system_state_set_ui_state(UI_STATE_MAIN_SCREEN);
+}
+
+static void autotune_on_exit(system_state_t to) {
+    // Запуск, який цикл керування ще не забрав, скасовується разом з виходом зі стану
+    autotune_pending = false;
+}
+
+static const state_desc_t s_states[STATE_COUNT] = {
+    [STATE_BOOT]        = { "BOOT",        false, false, NULL,                 NULL },
+    [STATE_OFF]         = { "OFF",         false, true,  idle_on_entry,        NULL },
+    [STATE_MANUAL]      = { "MANUAL",      true,  true,  heating_on_entry,     NULL },
+    [STATE_ADAPTIVE]    = { "ADAPTIVE",    true,  true,  heating_on_entry,     NULL },
+    [STATE_PROGRAMMED]  = { "PROGRAMMED",  true,  true,  heating_on_entry,     NULL },
+    [STATE_ANTI_FREEZE] = { "ANTI_FREEZE", true,  true,  heating_on_entry,     NULL },
+    [STATE_EMERGENCY]   = { "EMERGENCY",   false, false, emergency_on_entry,   emergency_on_exit },
+    [STATE_MODE_SELECT] = { "MODE SELECT", false, false, mode_select_on_entry, mode_select_on_exit },
+    [STATE_AUTOTUNE]    = { "AUTOTUNE",    false, false, idle_on_entry,        autotune_on_exit },
+};
+
+static void heating_on_entry(system_state_t from) {
+    // Між режимами з ПІД ШІМ продовжує поточний період, а регулятор - інтеграл.
+    // З режиму без ПІД регулятор починає з чистого стану
+    if (!s_states[from].heating) {
+        pwm_manager_reset();
+        pid_reset_pending = true;
+    }
+}
+
+// --- Умови переходів ---
+
+static bool guard_to_selectable(system_state_t from, system_state_t to) {
+    return s_states[to].selectable;
+}
+
+static bool guard_not_boot(system_state_t from, system_state_t to) {
+    return from != STATE_BOOT;
+}
+
+static bool guard_autotune_start(system_state_t from, system_state_t to) {
+    return from != STATE_BOOT && from != STATE_EMERGENCY;
+}
+
+static bool guard_user_choice(system_state_t from, system_state_t to) {
+    return from != STATE_BOOT && s_states[to].selectable;
+}
+
+static const transition_t s_transitions[] = {
+    // Аварія має пріоритет над усім
+    { STATE_ANY,         STATE_EMERGENCY,   CAUSE_BIT(MAIN_CONTROL_CAUSE_SAFETY),   NULL },
+    { STATE_BOOT,        STATE_OFF,         CAUSE_BIT(MAIN_CONTROL_CAUSE_BOOT),     NULL },
+    { STATE_ANY,         STATE_OFF,         CAUSE_BIT(MAIN_CONTROL_CAUSE_INTERNAL), NULL },
+    { STATE_ANY,         STATE_MODE_SELECT, CAUSE_BIT(MAIN_CONTROL_CAUSE_BUTTON),   guard_not_boot },
+    { STATE_MODE_SELECT, STATE_ANY,         CAUSE_BIT(MAIN_CONTROL_CAUSE_TIMEOUT),  guard_to_selectable },
+    { STATE_ANY,         STATE_AUTOTUNE,    CAUSE_BIT(MAIN_CONTROL_CAUSE_AUTOTUNE), guard_autotune_start },
+    { STATE_AUTOTUNE,    STATE_ANY,         CAUSE_BIT(MAIN_CONTROL_CAUSE_AUTOTUNE), guard_to_selectable },
+    // Вибір користувача, зокрема вихід з аварії, меню чи автоналаштування
+    { STATE_ANY,         STATE_ANY,         CAUSE_USER,                             guard_user_choice },
+};
+
+static const transition_t *find_transition(system_state_t from, system_state_t to, main_control_cause_t cause) {
+    for (size_t i = 0; i < sizeof(s_transitions) / sizeof(s_transitions[0]); i++) {
+        const transition_t *t = &s_transitions[i];
+        if (t->from != STATE_ANY && t->from != from) continue;
+        if (t->to != STATE_ANY && t->to != to) continue;
+        if ((t->causes & CAUSE_BIT(cause)) == 0) continue;
+        if (t->guard != NULL && !t->guard(from, to)) continue;
+        return t;
+    }
+    return NULL;
+}
+
+static void journal_add(system_state_t from, system_state_t to, main_control_cause_t cause) {
+    main_control_transition_t *e = &s_journal[s_journal_count % MAIN_CONTROL_JOURNAL_SIZE];
+    e->uptime_us = esp_timer_get_time();
+    e->epoch_s = (int64_t)time(NULL);
+    e->from = from;
+    e->to = to;
+    e->cause = cause;
+    s_journal_count++;
+}
+
+esp_err_t main_control_init(void) {
+    state_mutex = xSemaphoreCreateMutex();
+    return state_mutex != NULL ? ESP_OK : ESP_FAIL;
+}
+
+esp_err_t main_control_change_state(system_state_t new_state, main_control_cause_t cause) {
+    if (new_state >= STATE_COUNT || cause >= MAIN_CONTROL_CAUSE_COUNT) return ESP_ERR_INVALID_ARG;
+
+    esp_err_t err = ESP_OK;
+    bool changed = false;
+    system_state_t old_state = STATE_BOOT;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        old_state = current_state;
+        if (current_state != new_state) {
+            if (find_transition(current_state, new_state, cause) == NULL) {
+                err = ESP_ERR_INVALID_STATE;
+            } else {
+                const state_desc_t *from = &s_states[current_state];
+                const state_desc_t *to = &s_states[new_state];
+                if (from->on_exit) from->on_exit(new_state);
+                current_state = new_state;
+                if (to->on_entry) to->on_entry(old_state);
+                journal_add(old_state, new_state, cause);
+                changed = true;
+            }
+        }
+        xSemaphoreGive(state_mutex);
+    }
+
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "Transition %s -> %s (%s) rejected", state_to_string(old_state),
+                 state_to_string(new_state), main_control_cause_to_string(cause));
+        return err;
+    }
+    // Підписники шини дізнаються про новий режим одразу, а не з наступної ітерації циклу
+    if (changed) {
+        ESP_LOGI(TAG, "STATE CHANGE: %s -> %s (%s)", state_to_string(old_state),
+                 state_to_string(new_state), main_control_cause_to_string(cause));
+        system_state_set_system_state(new_state);
+        if (new_state == STATE_MODE_SELECT) state_bus_publish(STATE_BUS_EVENT_PREVIEW);
+    }
+    return ESP_OK;
+}
+
+system_state_t main_control_get_state(void) {
+    system_state_t state = STATE_OFF;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        state = current_state;
+        xSemaphoreGive(state_mutex);
+    }
+    return state;
+}
+
+void main_control_update(void) {
+    bool expired = false;
+    system_state_t target = STATE_OFF;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        expired = current_state == STATE_MODE_SELECT &&
+                  (xTaskGetTickCount() - mode_select_enter_time) > pdMS_TO_TICKS(MODE_SELECT_TIMEOUT_MS);
+        target = preview_state;
+        xSemaphoreGive(state_mutex);
+    }
+    if (expired) main_control_change_state(target, MAIN_CONTROL_CAUSE_TIMEOUT);
+}
+
+bool main_control_take_pid_reset(void) {
+    bool reset = false;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        reset = pid_reset_pending;
+        pid_reset_pending = false;
+        xSemaphoreGive(state_mutex);
+    }
+    return reset;
+}
+
+int main_control_get_journal(main_control_transition_t *out, int max) {
+    int n = 0;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        uint32_t count = s_journal_count;
+        while (n < max && (uint32_t)n < count && n < MAIN_CONTROL_JOURNAL_SIZE) {
+            out[n] = s_journal[(count - 1 - n) % MAIN_CONTROL_JOURNAL_SIZE];
+            n++;
+        }
+        xSemaphoreGive(state_mutex);
+    }
+    return n;
+}
+
+void main_control_cycle_preview_mode(bool go_up) {
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) != pdTRUE) return;
+    if (current_state != STATE_MODE_SELECT) {
+        xSemaphoreGive(state_mutex);
+        return;
+    }
+
+    // Меню перебирає режими з ПІД, які можна вибрати, у порядку переліку
+    system_state_t next = preview_state;
+    do {
+        next = go_up ? (system_state_t)((next + 1) % STATE_COUNT)
+                     : (system_state_t)((next + STATE_COUNT - 1) % STATE_COUNT);
+    } while (!(s_states[next].selectable && s_states[next].heating));
+    preview_state = next;
+
+    ESP_LOGI(TAG, "Preview mode changed to: %s", state_to_string(preview_state));
+    mode_select_enter_time = xTaskGetTickCount();
+    xSemaphoreGive(state_mutex);
+    state_bus_publish(STATE_BUS_EVENT_PREVIEW);
+}
+
+system_state_t main_control_get_preview_state(void) {
+    system_state_t s = STATE_OFF;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        s = preview_state;
+        xSemaphoreGive(state_mutex);
+    }
+    return s;
+}
+
+esp_err_t main_control_start_autotune(pid_tune_rule_t rule, float setpoint) {
+    const app_settings_t *cfg = settings_get();
+    if (!isfinite(setpoint) || setpoint < cfg->control.limits.room_min || setpoint > cfg->control.limits.room_max) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) != pdTRUE) return ESP_FAIL;
+    if (current_state == STATE_AUTOTUNE ||
+        find_transition(current_state, STATE_AUTOTUNE, MAIN_CONTROL_CAUSE_AUTOTUNE) == NULL) {
+        xSemaphoreGive(state_mutex);
+        return ESP_ERR_INVALID_STATE;
+    }
+    autotune_return_state = s_states[current_state].selectable ? current_state : STATE_OFF;
+    autotune_config = (pid_autotune_config_t){
+        .setpoint = setpoint,
+        .hysteresis = AUTOTUNE_HYSTERESIS_C,
+        .output_high = 100.0f,
+        .output_low = 0.0f,
+        .timeout_us = AUTOTUNE_TIMEOUT_US,
+        .rule = rule
+    };
+    // Запуск має очікувати вже в момент входу, інакше цикл керування завершить порожній експеримент
+    autotune_pending = true;
+    xSemaphoreGive(state_mutex);
+
+    esp_err_t err = main_control_change_state(STATE_AUTOTUNE, MAIN_CONTROL_CAUSE_AUTOTUNE);
+    if (err != ESP_OK && xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        autotune_pending = false;
+        xSemaphoreGive(state_mutex);
+    }
+    return err;
+}
+
+bool main_control_take_autotune(pid_autotune_config_t *out, system_state_t *return_state) {
+    bool pending = false;
+    if (xSemaphoreTake(state_mutex, portMAX_DELAY) == pdTRUE) {
+        pending = autotune_pending;
+        if (pending) {
+            *out = autotune_config;
+            *return_state = autotune_return_state;
+            autotune_pending = false;
+        }
+        xSemaphoreGive(state_mutex);
+    }
+    return pending;
+}
+
+const char* state_to_string(system_state_t state) {
+    if (state >= STATE_COUNT || state == STATE_BOOT) return "UNKNOWN";
+    return s_states[state].name;
+}
+
+esp_err_t main_control_state_from_string(const char *name, system_state_t *out) {
+    if (name == NULL) return ESP_ERR_NOT_FOUND;
+    for (int s = 0; s < STATE_COUNT; s++) {
+        if (s_states[s].selectable && strcmp(s_states[s].name, name) == 0) {
+            *out = (system_state_t)s;
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NOT_FOUND;
+}
+
+const char* main_control_cause_to_string(main_control_cause_t cause) {
+    switch (cause) {
+        case MAIN_CONTROL_CAUSE_BOOT: return "boot";
+        case MAIN_CONTROL_CAUSE_BUTTON: return "button";
+        case MAIN_CONTROL_CAUSE_WEB: return "web";
+        case MAIN_CONTROL_CAUSE_SAFETY: return "safety";
+        case MAIN_CONTROL_CAUSE_TIMEOUT: return "timeout";
+        case MAIN_CONTROL_CAUSE_AUTOTUNE: return "autotune";
+        case MAIN_CONTROL_CAUSE_INTERNAL: return "internal";
+        default: return "unknown";
+    }
+}
@@ -1,7 +1,11 @@
 #ifndef MAIN_CONTROL_H
 #define MAIN_CONTROL_H
 
+#include <stdbool.h>
+#include <stdint.h>
 #include "freertos/FreeRTOS.h"
+#include "esp_err.h"
+#include "controller/actuator/pid_autotune.h"
 
 typedef enum {
     STATE_BOOT,
@@ -11,16 +15,76 @@ typedef enum {
     STATE_PROGRAMMED,
     STATE_ANTI_FREEZE,
     STATE_EMERGENCY,
-    STATE_MODE_SELECT
+    STATE_MODE_SELECT,
+    STATE_AUTOTUNE,
+    STATE_COUNT
 } system_state_t;
 
+/**
+ * @brief Причина переходу: таблиця переходів дозволяє кожен перехід лише для певних причин.
+ */
+typedef enum {
+    MAIN_CONTROL_CAUSE_BOOT,      // Старт керування
+    MAIN_CONTROL_CAUSE_BUTTON,    // Кнопки на пристрої
+    MAIN_CONTROL_CAUSE_WEB,       // Веб-API
+    MAIN_CONTROL_CAUSE_SAFETY,    // Перевірка безпеки циклу керування
+    MAIN_CONTROL_CAUSE_TIMEOUT,   // Тайм-аут меню вибору режиму
+    MAIN_CONTROL_CAUSE_AUTOTUNE,  // Запуск чи завершення автоналаштування
+    MAIN_CONTROL_CAUSE_INTERNAL,  // Відновлення з невідомого стану
+    MAIN_CONTROL_CAUSE_COUNT
+} main_control_cause_t;
+
+// Розмір журналу переходів
+#define MAIN_CONTROL_JOURNAL_SIZE 16
 
 /**
- * @brief Потокобезпечно змінює глобальний стан системи.
- * 
+ * @brief Запис журналу переходів.
+ */
+typedef struct {
+    int64_t uptime_us;            // Час від старту
+    int64_t epoch_s;              // Час за годинником (до синхронізації NTP - неточний)
+    system_state_t from;
+    system_state_t to;
+    main_control_cause_t cause;
+} main_control_transition_t;
+
+/**
+ * @brief Створює м'ютекс стану. Викликається до будь-яких інших функцій модуля.
+ */
+esp_err_t main_control_init(void);
+
+/**
+ * @brief Потокобезпечно виконує перехід за таблицею переходів.
+ *
+ * Вихідна дія старого стану та вхідна дія нового виконуються під м'ютексом стану,
+ * перехід записується в журнал.
+ *
  * @param new_state Новий стан, в який потрібно перейти.
+ * @param cause Причина переходу.
+ * @return esp_err_t ESP_OK (також якщо стан уже такий); ESP_ERR_INVALID_STATE, якщо
+ *         таблиця не дозволяє перехід з поточного стану з цієї причини.
+ */
+esp_err_t main_control_change_state(system_state_t new_state, main_control_cause_t cause);
+
+/**
+ * @brief Обробляє тайм-аути станів (вихід з меню вибору режиму). Викликається циклом керування.
+ */
+void main_control_update(void);
+
+/**
+ * @brief Повертає true один раз після входу в режим з ПІД з режиму без нього:
+ * регулятор треба скинути. Між режимами з ПІД інтеграл зберігається.
+ */
+bool main_control_take_pid_reset(void);
+
+/**
+ * @brief Копіює журнал переходів, від найновішого.
+ *
+ * @param[out] out Буфер записів.
+ * @param max Розмір буфера.
+ * @return Кількість скопійованих записів.
  */
-void main_control_change_state(system_state_t new_state);
+int main_control_get_journal(main_control_transition_t *out, int max);
 
 /**
  * @brief Потокобезпечно отримує поточний стан системи.
@@ -38,6 +102,29 @@ void main_control_cycle_preview_mode(bool go_up);
 
 system_state_t main_control_get_preview_state(void);
 
+/**
+ * @brief Запускає релейне автоналаштування ПІД (STATE_AUTOTUNE).
+ *
+ * Після експерименту коефіцієнти зберігаються в control.pid і система
+ * повертається в режим, з якого було запущено налаштування.
+ * Помилка або тайм-аут також повертають попередній режим без змін коефіцієнтів.
+ *
+ * @param rule Правило розрахунку коефіцієнтів.
+ * @param setpoint Температура кімнати, навколо якої проводиться експеримент.
+ * @return esp_err_t ESP_ERR_INVALID_ARG, якщо уставка поза межами room_min..room_max;
+ *         ESP_ERR_INVALID_STATE в аварійному режимі або під час іншого налаштування.
+ */
+esp_err_t main_control_start_autotune(pid_tune_rule_t rule, float setpoint);
+
+/**
+ * @brief Забирає параметри нового запуску автоналаштування, якщо він очікує.
+ *
+ * @param[out] out Параметри експерименту.
+ * @param[out] return_state Режим, куди повернутися після експерименту.
+ * @return true, якщо запуск очікував.
+ */
+bool main_control_take_autotune(pid_autotune_config_t *out, system_state_t *return_state);
+
 /**
  * @brief Повертає назву стану у вигляді рядка.
  * 
@@ -46,4 +133,16 @@ system_state_t main_control_get_preview_state(void);
  */
 const char* state_to_string(system_state_t state);
 
+/**
+ * @brief Знаходить стан, який користувач може вибрати, за назвою (як у state_to_string).
+ *
+ * @return esp_err_t ESP_ERR_NOT_FOUND для невідомої назви чи службового стану.
+ */
+esp_err_t main_control_state_from_string(const char *name, system_state_t *out);
+
+/**
+ * @brief Назва причини переходу.
+ */
+const char* main_control_cause_to_string(main_control_cause_t cause);
+
 #endif // MAIN_CONTROL_H
\ No newline at end of file
@@ -2,16 +2,38 @@
 #include "nvs_flash.h"
 #include "nvs.h"
 #include "esp_log.h"
+#include "hal/adc_types.h"
+#include "driver/gpio.h"
 #include <string.h>
+#include <stdio.h>
 
 static const char *TAG = "SETTINGS";
 static const char *NVS_NAMESPACE = "config";
 static const char *NVS_KEY = "main_cfg";
 
-#define SETTINGS_MAGIC 0xA1B2C301 
+#define SETTINGS_MAGIC 0xA1B2C30D 
 
 static app_settings_t current_settings;
 
+static void set_default_sensor(int idx, bool enabled, uint8_t adc_channel, const char *name) {
+    temp_sensor_settings_t *ch = &current_settings.sensors.channels[idx];
+    ch->enabled = enabled;
+    ch->adc_channel = adc_channel;
+    strncpy(ch->name, name, sizeof(ch->name) - 1);
+    ch->ntc.r0 = 10000.0f;
+    ch->ntc.t0 = 25.0f;
+    ch->ntc.beta = 3950.0f;
+    ch->ntc.r_fixed = 10000.0f;
+    // Медіана та Хампель прибирають імпульсні завади від реле,
+    // тому EMA може бути легшим і вносити менше запізнення
+    ch->ema_alpha = 0.3f;
+    ch->filter.median_window = 3;
+    ch->filter.hampel_window = 7;
+    ch->filter.hampel_k = 3.0f;
+    ch->filter.smoothing = 1;
+    ch->filter.cutoff_hz = 0.05f;
+}
+
 static void load_defaults(void) {
     ESP_LOGW(TAG, "Loading default settings...");
     memset(&current_settings, 0, sizeof(app_settings_t));
@@ -26,6 +48,7 @@ static void load_defaults(void) {
     strcpy(current_settings.mqtt.host, "demo.thingsboard.io");
     current_settings.mqtt.port = 1883;
     strcpy(current_settings.mqtt.token, "4aDZN8VTakk0L6iilnr5");
+    current_settings.mqtt.diag_interval_min = 0;
 
     // Geo (Kyiv)
     current_settings.geo.lat = 50.45f;
@@ -36,12 +59,50 @@ static void load_defaults(void) {
     current_settings.control.pid.kp = 10.0f;
     current_settings.control.pid.ki = 0.1f;
     current_settings.control.pid.kd = 0.5f;
+    current_settings.control.pid.setpoint_weight = 1.0f;
+    current_settings.control.pid.d_filter_n = 10.0f;
 
     current_settings.control.limits.rad_max = 60.0f;
     current_settings.control.limits.room_min = 18.0f;
     current_settings.control.limits.room_max = 22.0f;
     current_settings.control.pwm_cycle_s = 60;
 
+    // Оцінювач: ~3 C/год нагріву при різниці 40 C з радіатором, ~1 C/год втрат при 20 C назовні
+    current_settings.control.estimator.enabled = false;
+    current_settings.control.estimator.k_rad = 2.1e-5f;
+    current_settings.control.estimator.k_loss = 1.4e-5f;
+    current_settings.control.estimator.meas_noise = 0.0025f;
+    current_settings.control.mpc_enabled = false;
+    // Крива опалення свідомо положиста: недокомпенсацію добирає інтеграл, а навчання уточнює
+    current_settings.control.ff.enabled = true;
+    current_settings.control.ff.learn = true;
+    current_settings.control.ff.slope = 1.5f;
+    current_settings.control.ff.offset = 0.0f;
+    // За замовчуванням - електромеханічне реле з періодом ШІМ 60 с: секунди між перемиканнями.
+    // Для SSR можна зменшити до періоду мережі (20 мс); більші за півперіоду ШІМ обмежуються
+    current_settings.control.relay.min_on_ms = 10000;
+    current_settings.control.relay.min_off_ms = 10000;
+
+    // Sensors (порядок відповідає temp_sensor_id_t)
+    set_default_sensor(0, true,  THERMISTOR_ENVIRONMENT, "room");
+    set_default_sensor(1, true,  THERMISTOR_RADIATOR,    "radiator");
+    set_default_sensor(2, false, THERMISTOR_FLOOR,       "floor");
+    set_default_sensor(3, false, THERMISTOR_PIPE_RETURN, "pipe_return");
+    set_default_sensor(4, false, THERMISTOR_ROOM_2,      "room_2");
+    set_default_sensor(5, false, THERMISTOR_AUX,         "aux");
+
+    // Zones: основна зона увімкнена завжди, додаткові налаштовуються користувачем
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        heat_zone_settings_t *z = &current_settings.zones.list[i];
+        z->enabled = i == 0;
+        snprintf(z->name, sizeof(z->name), i == 0 ? "main" : "zone_%d", i);
+        z->relay_gpio = i == 0 ? GPIO_RELAY : -1;
+        z->relay_active_level = RELAY_ACTIVE_LEVEL;
+        z->room_sensor = 0;
+        z->radiator_sensor = i == 0 ? 1 : -1;
+        z->setpoint_offset = 0.0f;
+    }
+
     // Timezone
     strcpy(current_settings.timezone, "EET-2EEST-3,M3.5.0/3,M10.5.0/4");
 
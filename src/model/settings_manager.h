@@ -2,6 +2,55 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "esp_err.h"
+#include "hw_config.h"
+
+// Максимальна кількість калібрувальних точок на канал
+#define TEMP_CAL_MAX_POINTS 3
+
+// Калібрувальна точка: еталонна температура та виміряний опір термістора
+typedef struct {
+    float temp_c;
+    float resistance;
+} temp_cal_point_t;
+
+// Налаштування одного каналу термістора
+typedef struct {
+    bool enabled;
+    uint8_t adc_channel;  // Канал ADC1
+    char name[16];        // Ім'я каналу для API та MQTT
+    struct {
+        float r0;         // Номінальний опір, Ом
+        float t0;         // Номінальна температура, C
+        float beta;       // B-коефіцієнт
+        float r_fixed;    // Опорний резистор дільника, Ом
+    } ntc;
+    float ema_alpha;      // Коефіцієнт експоненційного фільтра (0..1]
+    struct {
+        uint8_t median_window;  // Вікно медіанного фільтра (0/1 = вимкнено)
+        uint8_t hampel_window;  // Вікно фільтра Хампеля (0 = вимкнено)
+        float hampel_k;         // Поріг викиду, у сигмах
+        uint8_t smoothing;      // temp_filter_smooth_t: 0 - немає, 1 - EMA, 2 - біквад
+        float cutoff_hz;        // Частота зрізу біквада, Гц
+    } filter;
+    struct {
+        bool enabled;           // Використовувати Стейнгарта–Гарта замість B-рівняння
+        float a, b, c;          // 1/T = a + b*ln(R) + c*ln(R)^3
+        uint8_t num_points;     // Кількість захоплених точок
+        temp_cal_point_t points[TEMP_CAL_MAX_POINTS];
+    } cal;
+} temp_sensor_settings_t;
+
+// Налаштування зони опалення. Для зони 0 реле та датчики фіксовані (hw_config.h),
+// з налаштувань береться лише ім'я
+typedef struct {
+    bool enabled;
+    char name[16];              // Ім'я зони для API та MQTT
+    int8_t relay_gpio;          // GPIO реле зони (-1 - не призначено)
+    uint8_t relay_active_level;
+    uint8_t room_sensor;        // temp_sensor_id_t датчика кімнати зони
+    int8_t radiator_sensor;     // temp_sensor_id_t для відсічки перегріву (-1 - немає)
+    float setpoint_offset;      // Зміщення від уставки активного режиму, C
+} heat_zone_settings_t;
 
 // Основна структура налаштувань
 typedef struct {
@@ -16,6 +65,7 @@ typedef struct {
         char host[64];
         int port;
         char token[32];
+        int diag_interval_min;  // Публікація діагностики завдань і купи (0 - вимкнено)
     } mqtt;
     
     struct {
@@ -25,14 +75,44 @@ typedef struct {
     } geo;
     
     struct {
-        struct { float kp; float ki; float kd; } pid;
+        struct {
+            float kp; float ki; float kd;
+            float setpoint_weight;  // Частка уставки в пропорційній складовій (0..1)
+            float d_filter_n;       // Ділення фільтра похідної: Tf = Td / N
+        } pid;
         struct { 
             float rad_max; 
             float room_min; 
             float room_max; 
         } limits;
         int pwm_cycle_s;
+        int pwm_cycle_ms;      // Період ШІМ у мс для твердотільного реле (0 - використовувати pwm_cycle_s)
+        struct {
+            bool enabled;      // ПІД отримує оцінку фільтра Калмана замість виміряної температури
+            float k_rad;       // Теплопередача від радіатора, 1/с
+            float k_loss;      // Тепловтрати назовні, 1/с
+            float meas_noise;  // Дисперсія шуму датчика кімнати, C^2
+        } estimator;
+        bool mpc_enabled;      // ADAPTIVE: заповнення з прогнозного планувальника замість ПІД
+        struct {
+            bool enabled;         // Додавати до виходу ПІД заповнення з кривої опалення
+            bool learn;           // Уточнювати криву за усталеним заповненням
+            float slope;          // Початковий нахил кривої, % на градус (уставка - вулиця)
+            float offset;         // Початкове зміщення кривої, %
+        } ff;
+        struct {
+            uint32_t min_on_ms;   // Мінімальна тривалість увімкнення реле, мс (не більше півперіоду ШІМ)
+            uint32_t min_off_ms;  // Мінімальна пауза між увімкненнями реле, мс (не більше півперіоду ШІМ)
+        } relay;
     } control;
+
+    struct {
+        temp_sensor_settings_t channels[MAX_TEMP_SENSORS]; // Індекс = temp_sensor_id_t
+    } sensors;
+
+    struct {
+        heat_zone_settings_t list[HEAT_ZONES_MAX]; // Індекс = номер зони
+    } zones;
     
     char timezone[64];
     
@@ -0,0 +1,83 @@
+#include "model/state_bus.h"
+#include "esp_log.h"
+#include <stdatomic.h>
+
+static const char *TAG = "state_bus";
+
+struct state_bus_sub {
+    const char *name;
+    TaskHandle_t task;
+    atomic_uint_fast32_t fields;
+    atomic_uint_fast32_t notifications;
+    atomic_uint_fast32_t wakeups;
+};
+
+// Слоти лише додаються: публікатор читає лічильник без блокування, слот заповнюється
+// до того, як лічильник його охопить
+static struct state_bus_sub s_subs[STATE_BUS_MAX_SUBSCRIBERS];
+static atomic_int s_sub_count = 0;
+static portMUX_TYPE s_subscribe_lock = portMUX_INITIALIZER_UNLOCKED;
+
+state_bus_handle_t state_bus_subscribe(const char *name, TaskHandle_t task, uint32_t fields) {
+    if (task == NULL) return NULL;
+
+    state_bus_handle_t handle = NULL;
+    portENTER_CRITICAL(&s_subscribe_lock);
+    int count = atomic_load_explicit(&s_sub_count, memory_order_relaxed);
+    if (count < STATE_BUS_MAX_SUBSCRIBERS) {
+        handle = &s_subs[count];
+        handle->name = name;
+        handle->task = task;
+        atomic_store_explicit(&handle->fields, fields, memory_order_relaxed);
+        atomic_store_explicit(&handle->notifications, 0, memory_order_relaxed);
+        atomic_store_explicit(&handle->wakeups, 0, memory_order_relaxed);
+        atomic_store_explicit(&s_sub_count, count + 1, memory_order_release);
+    }
+    portEXIT_CRITICAL(&s_subscribe_lock);
+
+    if (handle == NULL) {
+        ESP_LOGE(TAG, "No free subscriber slot for %s", name);
+    }
+    return handle;
+}
+
+void state_bus_set_fields(state_bus_handle_t handle, uint32_t fields) {
+    if (handle == NULL) return;
+    atomic_store_explicit(&handle->fields, fields, memory_order_relaxed);
+}
+
+void state_bus_publish(uint32_t changed) {
+    if (changed == 0) return;
+
+    int count = atomic_load_explicit(&s_sub_count, memory_order_acquire);
+    for (int i = 0; i < count; i++) {
+        struct state_bus_sub *sub = &s_subs[i];
+        uint32_t hit = changed & atomic_load_explicit(&sub->fields, memory_order_relaxed);
+        if (hit == 0) continue;
+        // eSetBits не блокує і не переповнюється: повторні зміни зливаються в одне пробудження
+        xTaskNotify(sub->task, hit, eSetBits);
+        atomic_fetch_add_explicit(&sub->notifications, 1, memory_order_relaxed);
+    }
+}
+
+uint32_t state_bus_wait(state_bus_handle_t handle, TickType_t timeout) {
+    uint32_t bits = 0;
+    if (xTaskNotifyWait(0, UINT32_MAX, &bits, timeout) != pdTRUE) bits = 0;
+    if (handle != NULL) atomic_fetch_add_explicit(&handle->wakeups, 1, memory_order_relaxed);
+    return bits;
+}
+
+int state_bus_count(void) {
+    return atomic_load_explicit(&s_sub_count, memory_order_acquire);
+}
+
+esp_err_t state_bus_get_stats(int index, state_bus_stats_t *out) {
+    if (out == NULL || index < 0 || index >= state_bus_count()) return ESP_ERR_INVALID_ARG;
+
+    const struct state_bus_sub *sub = &s_subs[index];
+    out->name = sub->name;
+    out->fields = atomic_load_explicit(&sub->fields, memory_order_relaxed);
+    out->notifications = atomic_load_explicit(&sub->notifications, memory_order_relaxed);
+    out->wakeups = atomic_load_explicit(&sub->wakeups, memory_order_relaxed);
+    return ESP_OK;
+}
@@ -0,0 +1,77 @@
+#ifndef STATE_BUS_H
+#define STATE_BUS_H
+
+#include <stdint.h>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+
+/**
+ * @brief Шина сповіщень про зміни стану.
+ *
+ * system_state публікує маску змінених груп полів (SYSTEM_STATE_FIELD_*) після кожного
+ * пакета, що справді щось змінив. Підписник отримує сповіщення завдання (task notification)
+ * лише для полів зі своєї маски. Біти накопичуються у значенні сповіщення, тож повільний
+ * підписник прокидається один раз з об'єднаною маскою, а публікатор ніколи не чекає.
+ *
+ * Сповіщення завдання (індекс 0) належить шині: підписник не має використовувати його інакше.
+ */
+
+// Максимальна кількість підписників
+#define STATE_BUS_MAX_SUBSCRIBERS   6
+
+// Події поза system_state, які публікують їхні власники
+#define STATE_BUS_EVENT_MANUAL_SETPOINT (1u << 24)  // Ручна уставка (temp_setpoint_manager)
+#define STATE_BUS_EVENT_PREVIEW         (1u << 25)  // Попередній вибір режиму в меню
+
+/**
+ * @brief Лічильники підписника.
+ */
+typedef struct {
+    const char *name;
+    uint32_t fields;         // Поточна маска підписки
+    uint32_t notifications;  // Публікацій, що зачепили маску
+    uint32_t wakeups;        // Повернень з state_bus_wait (сповіщення або таймаут)
+} state_bus_stats_t;
+
+typedef struct state_bus_sub *state_bus_handle_t;
+
+/**
+ * @brief Підписує завдання на зміни полів.
+ *
+ * @param name Ім'я (статичний рядок) для діагностики.
+ * @param task Завдання, яке отримуватиме сповіщення.
+ * @param fields Маска SYSTEM_STATE_FIELD_* та STATE_BUS_EVENT_*.
+ * @return state_bus_handle_t Дескриптор або NULL, якщо місця немає.
+ */
+state_bus_handle_t state_bus_subscribe(const char *name, TaskHandle_t task, uint32_t fields);
+
+/**
+ * @brief Змінює маску підписки (0 - тимчасово не отримувати сповіщень).
+ */
+void state_bus_set_fields(state_bus_handle_t handle, uint32_t fields);
+
+/**
+ * @brief Сповіщає підписників про зміну полів. Не блокує; лише з контексту завдань.
+ */
+void state_bus_publish(uint32_t changed);
+
+/**
+ * @brief Чекає на сповіщення поточного завдання-підписника.
+ *
+ * @param timeout Максимальне очікування.
+ * @return Об'єднана маска змін з моменту попереднього очікування (0 - таймаут).
+ */
+uint32_t state_bus_wait(state_bus_handle_t handle, TickType_t timeout);
+
+/**
+ * @brief Кількість підписників.
+ */
+int state_bus_count(void);
+
+/**
+ * @brief Копіює лічильники підписника за індексом.
+ */
+esp_err_t state_bus_get_stats(int index, state_bus_stats_t *out);
+
+#endif // STATE_BUS_H
@@ -1,97 +1,267 @@
 #include "model/system_state.h"
+#include "model/state_bus.h"
 #include "freertos/FreeRTOS.h"
-#include "freertos/semphr.h"
+#include <stdatomic.h>
 #include <string.h>
 #include <stdbool.h>
 
 // Статична змінна, доступна тільки всередині цього файлу.
 static sensors_state_t g_system_state;
 
-// М'ютекс для захисту доступу до g_system_state
-static SemaphoreHandle_t g_state_mutex;
+// Seqlock: лічильник непарний, поки триває запис. Читачі не блокуються: копіюють стан
+// і повторюють копіювання, якщо лічильник змінився. Записувачі серіалізуються між собою
+// короткою критичною секцією, в якій їх не можна витіснити посеред запису.
+static atomic_uint_fast32_t g_state_seq = 0;
+static portMUX_TYPE g_state_write_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline void state_write_begin(void) {
+    uint32_t seq = atomic_load_explicit(&g_state_seq, memory_order_relaxed);
+    atomic_store_explicit(&g_state_seq, seq + 1, memory_order_relaxed);
+    // Запис полів не може випередити позначку "запис триває"
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline uint32_t state_write_end(void) {
+    uint32_t seq = atomic_load_explicit(&g_state_seq, memory_order_relaxed) + 1;
+    atomic_store_explicit(&g_state_seq, seq, memory_order_release);
+    return seq;
+}
+
+// Копіює поле з пакета, якщо воно відрізняється; порівняння побайтове, щоб NAN не
+// вважався зміною щоразу
+#define STATE_MERGE(field, bit)                                                      \
+    do {                                                                             \
+        if (memcmp(&g_system_state.field, &txn->staged.field, sizeof(g_system_state.field)) != 0) { \
+            if (changed == 0) state_write_begin();                                  \
+            g_system_state.field = txn->staged.field;                               \
+            changed |= (bit);                                                        \
+        }                                                                            \
+    } while (0)
 
 void system_state_init(void) {
-    g_state_mutex = xSemaphoreCreateMutex();
     memset(&g_system_state, 0, sizeof(sensors_state_t));
-    g_system_state.temperature_c_sensor1 = -999.0f;
-    g_system_state.temperature_c_sensor2 = -999.0f;
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        g_system_state.temperature_c[i] = -999.0f;
+        g_system_state.temperature_fast_c[i] = -999.0f;
+    }
+    g_system_state.room_temp_estimate = -999.0f;
+    g_system_state.error_sensor = -1;
     g_system_state.relay_is_on = false;
     g_system_state.ui_state = UI_STATE_SPLASH_SCREEN;
 }
 
 void system_state_get(sensors_state_t *state_copy) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        *state_copy = g_system_state;
-        xSemaphoreGive(g_state_mutex);
-    }
+    uint32_t seq_before, seq_after;
+    do {
+        seq_before = atomic_load_explicit(&g_state_seq, memory_order_acquire);
+        memcpy(state_copy, &g_system_state, sizeof(sensors_state_t));
+        atomic_thread_fence(memory_order_acquire);
+        seq_after = atomic_load_explicit(&g_state_seq, memory_order_relaxed);
+    } while ((seq_before & 1u) != 0 || seq_before != seq_after);
 }
 
-void system_state_set_temp_s1(float temp) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.temperature_c_sensor1 = temp;
-        xSemaphoreGive(g_state_mutex);
-    }
+uint32_t system_state_get_version(void) {
+    // Поки триває запис, (seq >> 1) ще дорівнює попередній версії
+    return atomic_load_explicit(&g_state_seq, memory_order_acquire) >> 1;
 }
 
-void system_state_set_temp_s2(float temp) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.temperature_c_sensor2 = temp;
-        xSemaphoreGive(g_state_mutex);
+bool system_state_get_if_changed(uint32_t *version, sensors_state_t *state_copy) {
+    if (system_state_get_version() == *version) return false;
+    system_state_get(state_copy);
+    *version = state_copy->version;
+    return true;
+}
+
+void system_state_txn_begin(system_state_txn_t *txn) {
+    txn->fields = 0;
+    txn->sensor_mask = 0;
+}
+
+void system_state_txn_set_temp(system_state_txn_t *txn, int sensor_idx, float temp, float fast_temp) {
+    if (sensor_idx < 0 || sensor_idx >= MAX_TEMP_SENSORS) return;
+    txn->staged.temperature_c[sensor_idx] = temp;
+    txn->staged.temperature_fast_c[sensor_idx] = fast_temp;
+    txn->sensor_mask |= 1u << sensor_idx;
+    txn->fields |= SYSTEM_STATE_FIELD_TEMPERATURE;
+}
+
+void system_state_txn_set_sensor_health(system_state_txn_t *txn, int sensor_idx, uint8_t health) {
+    if (sensor_idx < 0 || sensor_idx >= MAX_TEMP_SENSORS) return;
+    txn->staged.sensor_health[sensor_idx] = health;
+    txn->sensor_mask |= 1u << sensor_idx;
+    txn->fields |= SYSTEM_STATE_FIELD_SENSOR_HEALTH;
+}
+
+void system_state_txn_set_room_estimate(system_state_txn_t *txn, float temp, float rate_per_hour) {
+    txn->staged.room_temp_estimate = temp;
+    txn->staged.room_temp_rate = rate_per_hour;
+    txn->fields |= SYSTEM_STATE_FIELD_ROOM_ESTIMATE;
+}
+
+void system_state_txn_set_temp_outside(system_state_txn_t *txn, float temp) {
+    txn->staged.temperature_c_outside = temp;
+    txn->fields |= SYSTEM_STATE_FIELD_TEMP_OUTSIDE;
+}
+
+void system_state_txn_set_current_setpoint(system_state_txn_t *txn, float setpoint) {
+    txn->staged.current_setpoint = setpoint;
+    txn->fields |= SYSTEM_STATE_FIELD_SETPOINT;
+}
+
+void system_state_txn_set_wifi_connected(system_state_txn_t *txn, bool connected) {
+    txn->staged.wifi_connected = connected;
+    txn->fields |= SYSTEM_STATE_FIELD_WIFI;
+}
+
+void system_state_txn_set_relay_state(system_state_txn_t *txn, bool relay_on) {
+    txn->staged.relay_is_on = relay_on;
+    txn->fields |= SYSTEM_STATE_FIELD_RELAY;
+}
+
+void system_state_txn_set_presence_state(system_state_txn_t *txn, bool presence) {
+    txn->staged.presence_state = presence;
+    txn->fields |= SYSTEM_STATE_FIELD_PRESENCE;
+}
+
+void system_state_txn_set_system_state(system_state_txn_t *txn, system_state_t new_state) {
+    txn->staged.system_state = new_state;
+    txn->fields |= SYSTEM_STATE_FIELD_MODE;
+}
+
+void system_state_txn_set_ui_state(system_state_txn_t *txn, ui_state_t new_state) {
+    txn->staged.ui_state = new_state;
+    txn->fields |= SYSTEM_STATE_FIELD_UI;
+}
+
+void system_state_txn_set_error_code(system_state_txn_t *txn, int error_code, int error_sensor) {
+    txn->staged.error_code = error_code;
+    txn->staged.error_sensor = error_sensor;
+    txn->fields |= SYSTEM_STATE_FIELD_ERROR;
+}
+
+uint32_t system_state_txn_commit(system_state_txn_t *txn) {
+    if (txn->fields == 0) return 0;
+
+    uint32_t changed = 0;
+    portENTER_CRITICAL(&g_state_write_lock);
+
+    // Лічильник стає непарним лише перед першим зміненим полем: пакет без змін
+    // не змушує читачів повторювати копіювання і не змінює версію
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        if (!(txn->sensor_mask & (1u << i))) continue;
+        if (txn->fields & SYSTEM_STATE_FIELD_TEMPERATURE) {
+            uint32_t channel_bits = SYSTEM_STATE_FIELD_TEMPERATURE | SYSTEM_STATE_FIELD_TEMP_CHANNEL(i);
+            STATE_MERGE(temperature_c[i], channel_bits);
+            STATE_MERGE(temperature_fast_c[i], channel_bits);
+        }
+        if (txn->fields & SYSTEM_STATE_FIELD_SENSOR_HEALTH) {
+            STATE_MERGE(sensor_health[i], SYSTEM_STATE_FIELD_SENSOR_HEALTH);
+        }
     }
+    if (txn->fields & SYSTEM_STATE_FIELD_ROOM_ESTIMATE) {
+        STATE_MERGE(room_temp_estimate, SYSTEM_STATE_FIELD_ROOM_ESTIMATE);
+        STATE_MERGE(room_temp_rate, SYSTEM_STATE_FIELD_ROOM_ESTIMATE);
+    }
+    if (txn->fields & SYSTEM_STATE_FIELD_TEMP_OUTSIDE) STATE_MERGE(temperature_c_outside, SYSTEM_STATE_FIELD_TEMP_OUTSIDE);
+    if (txn->fields & SYSTEM_STATE_FIELD_SETPOINT) STATE_MERGE(current_setpoint, SYSTEM_STATE_FIELD_SETPOINT);
+    if (txn->fields & SYSTEM_STATE_FIELD_WIFI) STATE_MERGE(wifi_connected, SYSTEM_STATE_FIELD_WIFI);
+    if (txn->fields & SYSTEM_STATE_FIELD_RELAY) STATE_MERGE(relay_is_on, SYSTEM_STATE_FIELD_RELAY);
+    if (txn->fields & SYSTEM_STATE_FIELD_PRESENCE) STATE_MERGE(presence_state, SYSTEM_STATE_FIELD_PRESENCE);
+    if (txn->fields & SYSTEM_STATE_FIELD_MODE) STATE_MERGE(system_state, SYSTEM_STATE_FIELD_MODE);
+    if (txn->fields & SYSTEM_STATE_FIELD_UI) STATE_MERGE(ui_state, SYSTEM_STATE_FIELD_UI);
+    if (txn->fields & SYSTEM_STATE_FIELD_ERROR) {
+        STATE_MERGE(error_code, SYSTEM_STATE_FIELD_ERROR);
+        STATE_MERGE(error_sensor, SYSTEM_STATE_FIELD_ERROR);
+    }
+
+    if (changed != 0) {
+        // Нова парна позначка відповідає версії (seq + 2) / 2
+        g_system_state.version = (atomic_load_explicit(&g_state_seq, memory_order_relaxed) + 1) >> 1;
+        state_write_end();
+    }
+    portEXIT_CRITICAL(&g_state_write_lock);
+
+    txn->fields = 0;
+    txn->sensor_mask = 0;
+    state_bus_publish(changed);
+    return changed;
+}
+
+// Окремі сетери - пакети з одного поля
+
+void system_state_set_temp(int sensor_idx, float temp, float fast_temp) {
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_temp(&txn, sensor_idx, temp, fast_temp);
+    system_state_txn_commit(&txn);
+}
+
+void system_state_set_room_estimate(float temp, float rate_per_hour) {
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_room_estimate(&txn, temp, rate_per_hour);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_temp_outside(float temp) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.temperature_c_outside = temp;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_temp_outside(&txn, temp);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_current_setpoint(float setpoint) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.current_setpoint = setpoint;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_current_setpoint(&txn, setpoint);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_wifi_connected(bool new_state) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.wifi_connected = new_state;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_wifi_connected(&txn, new_state);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_presence_state(bool presence) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.presence_state = presence;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_presence_state(&txn, presence);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_relay_state(bool relay_on) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.relay_is_on = relay_on;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_relay_state(&txn, relay_on);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_system_state(system_state_t new_state) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.system_state = new_state;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_system_state(&txn, new_state);
+    system_state_txn_commit(&txn);
 }
 
 void system_state_set_ui_state(ui_state_t new_state) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.ui_state = new_state;
-        xSemaphoreGive(g_state_mutex);
-    }
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_ui_state(&txn, new_state);
+    system_state_txn_commit(&txn);
 }
 
-void system_state_set_error_code(int error_code) {
-    if (xSemaphoreTake(g_state_mutex, portMAX_DELAY) == pdTRUE) {
-        g_system_state.error_code = error_code;
-        xSemaphoreGive(g_state_mutex);
-    }
-}
\ No newline at end of file
+void system_state_set_error_code(int error_code, int error_sensor) {
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_error_code(&txn, error_code, error_sensor);
+    system_state_txn_commit(&txn);
+}
+
+void system_state_set_sensor_health(int sensor_idx, uint8_t health) {
+    system_state_txn_t txn;
+    system_state_txn_begin(&txn);
+    system_state_txn_set_sensor_health(&txn, sensor_idx, health);
+    system_state_txn_commit(&txn);
+}
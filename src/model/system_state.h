@@ -3,14 +3,19 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include "hw_config.h"
 #include "view/display_manager.h"
 #include "model/main_control.h"
 
 
 // Структура, що описує всі спільні дані нашої системи
 typedef struct {
-    float temperature_c_sensor1;
-    float temperature_c_sensor2;
+    float temperature_c[MAX_TEMP_SENSORS]; // Індекс = temp_sensor_id_t, -999 якщо канал вимкнено
+    float temperature_fast_c[MAX_TEMP_SENSORS]; // Без згладжування (лише медіана та Хампель), для оцінювача
+    float room_temp_estimate;              // Оцінка температури кімнати (фільтр Калмана)
+    float room_temp_rate;                  // Оцінка швидкості зміни температури кімнати, C/год
+    uint8_t sensor_health[MAX_TEMP_SENSORS]; // temp_health_t кожного каналу
     float temperature_c_outside;
     float current_setpoint;
     bool wifi_connected;
@@ -19,29 +24,116 @@ typedef struct {
     system_state_t system_state;
     ui_state_t ui_state;
     int error_code;
+    int error_sensor;                      // Канал, що спричинив помилку (-1 - не стосується датчика)
+    uint32_t version;                      // Номер версії стану, зростає з кожною зміною
 } sensors_state_t;
 
+// Групи полів стану для пакетних оновлень і маски змін
+typedef enum {
+    SYSTEM_STATE_FIELD_TEMPERATURE   = 1u << 0,  // temperature_c, temperature_fast_c
+    SYSTEM_STATE_FIELD_ROOM_ESTIMATE = 1u << 1,  // room_temp_estimate, room_temp_rate
+    SYSTEM_STATE_FIELD_SENSOR_HEALTH = 1u << 2,
+    SYSTEM_STATE_FIELD_TEMP_OUTSIDE  = 1u << 3,
+    SYSTEM_STATE_FIELD_SETPOINT      = 1u << 4,
+    SYSTEM_STATE_FIELD_WIFI          = 1u << 5,
+    SYSTEM_STATE_FIELD_RELAY         = 1u << 6,
+    SYSTEM_STATE_FIELD_PRESENCE      = 1u << 7,
+    SYSTEM_STATE_FIELD_MODE          = 1u << 8,  // system_state
+    SYSTEM_STATE_FIELD_UI            = 1u << 9,
+    SYSTEM_STATE_FIELD_ERROR         = 1u << 10, // error_code, error_sensor
+} system_state_field_t;
+
+#define SYSTEM_STATE_FIELD_ALL 0x7FFu
+
+// Температура окремого каналу (temperature_c[id] чи temperature_fast_c[id]); задається разом
+// з SYSTEM_STATE_FIELD_TEMPERATURE, щоб підписник міг стежити лише за потрібним датчиком
+#define SYSTEM_STATE_FIELD_TEMP_CHANNEL(id) (1u << (16 + (id)))
+
 /**
- * @brief Ініціалізує менеджер стану (створює м'ютекс).
+ * @brief Пакетне оновлення стану.
+ *
+ * Зміни накопичуються локально (без блокування) і застосовуються разом у
+ * system_state_txn_commit, тож читачі ніколи не бачать половину пакета.
+ */
+typedef struct {
+    uint32_t fields;          // Маска груп полів, заданих у пакеті
+    uint32_t sensor_mask;     // Канали, для яких задані температура чи справність
+    sensors_state_t staged;   // Нові значення
+} system_state_txn_t;
+
+/**
+ * @brief Ініціалізує менеджер стану початковими значеннями.
+ *
+ * Стан захищений seqlock: сетери (лише з контексту завдань, не з ISR) коротко
+ * серіалізуються між собою, а читачі ніколи не чекають на записувачів.
  */
 void system_state_init(void);
 
 /**
- * @brief Потокобезпечно отримує копію поточного стану системи.
+ * @brief Потокобезпечно отримує узгоджену копію поточного стану системи без блокування.
+ * Якщо під час копіювання відбувся запис, копіювання повторюється.
  *
  * @param[out] state_copy Вказівник на структуру, куди буде скопійовано стан.
  */
 void system_state_get(sensors_state_t *state_copy);
 
 /**
- * @brief Потокобезпечно встановлює нове значення температури для датчика 1.
+ * @brief Повертає поточну версію стану (дешево, без копіювання).
+ * Незмінна версія означає, що жодне поле не змінилося.
  */
-void system_state_set_temp_s1(float temp);
+uint32_t system_state_get_version(void);
 
 /**
- * @brief Потокобезпечно встановлює нове значення температури для датчика 2.
+ * @brief Копіює стан, лише якщо він змінився після версії *version.
+ *
+ * @param[in,out] version Остання відома читачеві версія; оновлюється при копіюванні.
+ * @param[out] state_copy Копія стану.
+ * @return true, якщо стан змінився і скопійований.
+ */
+bool system_state_get_if_changed(uint32_t *version, sensors_state_t *state_copy);
+
+/**
+ * @brief Починає пакетне оновлення (лише очищає пакет, нічого не блокує).
  */
-void system_state_set_temp_s2(float temp);
+void system_state_txn_begin(system_state_txn_t *txn);
+
+void system_state_txn_set_temp(system_state_txn_t *txn, int sensor_idx, float temp, float fast_temp);
+void system_state_txn_set_sensor_health(system_state_txn_t *txn, int sensor_idx, uint8_t health);
+void system_state_txn_set_room_estimate(system_state_txn_t *txn, float temp, float rate_per_hour);
+void system_state_txn_set_temp_outside(system_state_txn_t *txn, float temp);
+void system_state_txn_set_current_setpoint(system_state_txn_t *txn, float setpoint);
+void system_state_txn_set_wifi_connected(system_state_txn_t *txn, bool connected);
+void system_state_txn_set_relay_state(system_state_txn_t *txn, bool relay_on);
+void system_state_txn_set_presence_state(system_state_txn_t *txn, bool presence);
+void system_state_txn_set_system_state(system_state_txn_t *txn, system_state_t new_state);
+void system_state_txn_set_ui_state(system_state_txn_t *txn, ui_state_t new_state);
+void system_state_txn_set_error_code(system_state_txn_t *txn, int error_code, int error_sensor);
+
+/**
+ * @brief Атомарно застосовує пакет однією короткою критичною секцією.
+ *
+ * Поля, значення яких не змінилося, не враховуються; версія зростає на одиницю,
+ * лише якщо змінилося хоча б одне поле.
+ *
+ * Маска змін публікується в шину сповіщень (model/state_bus.h).
+ *
+ * @return Маска груп полів (system_state_field_t), що фактично змінилися.
+ */
+uint32_t system_state_txn_commit(system_state_txn_t *txn);
+
+/**
+ * @brief Потокобезпечно встановлює нове значення температури для датчика з реєстру.
+ *
+ * @param sensor_idx Індекс датчика (temp_sensor_id_t).
+ * @param temp Відфільтрована температура.
+ * @param fast_temp Температура після відкидання викидів, без згладжування.
+ */
+void system_state_set_temp(int sensor_idx, float temp, float fast_temp);
+
+/*
+ * @brief Потокобезпечно встановлює оцінку температури кімнати та швидкості її зміни.
+*/
+void system_state_set_room_estimate(float temp, float rate_per_hour);
 
 /*
  * @brief Потокобезпечно встановлює нове значення зовнішньої температури.
@@ -66,6 +158,9 @@ void system_state_set_system_state(system_state_t new_state);
 // Встановлює поточний стан UI (викликається з контролерів, що керують логікою UI).
 void system_state_set_ui_state(ui_state_t new_state);
 
-void system_state_set_error_code(int error_code);
+void system_state_set_error_code(int error_code, int error_sensor);
+
+// Встановлює стан справності каналу термістора (temp_health_t)
+void system_state_set_sensor_health(int sensor_idx, uint8_t health);
 
 #endif /* COMPONENTS_SYSTEM_STATE_H_ */
\ No newline at end of file
@@ -9,6 +9,10 @@
 #include "networking/mqtt_client.h"
 #include "model/main_control.h"
 #include "model/settings_manager.h"
+#include "controller/sensor/temp_controller.h"
+#include "controller/zone_manager.h"
+#include <math.h>
+#include <string.h>
 
 static const char *TAG = "TB_MQTT";
 
@@ -83,8 +87,35 @@ void mqtt_publish_state(const sensors_state_t *st)
         return;
     }
 
-    cJSON_AddNumberToObject(root, "temperature_room", st->temperature_c_sensor1);
-    cJSON_AddNumberToObject(root, "temperature_radiator", st->temperature_c_sensor2);
+    cJSON_AddNumberToObject(root, "temperature_room", st->temperature_c[TEMP_SENSOR_ROOM]);
+    cJSON_AddNumberToObject(root, "temperature_radiator", st->temperature_c[TEMP_SENSOR_RADIATOR]);
+
+    // Додаткові канали реєстру публікуються під власними іменами
+    const app_settings_t *cfg = settings_get();
+    for (int i = TEMP_SENSOR_RADIATOR + 1; i < MAX_TEMP_SENSORS; i++) {
+        if (!cfg->sensors.channels[i].enabled) continue;
+        char key[32];
+        snprintf(key, sizeof(key), "temperature_%s", cfg->sensors.channels[i].name);
+        cJSON_AddNumberToObject(root, key, st->temperature_c[i]);
+    }
+    // Стан зон: zone_<ім'я>_*
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        zone_status_t zs;
+        if (zone_manager_get_status(i, &zs) != ESP_OK || !zs.enabled) continue;
+        char key[40];
+        snprintf(key, sizeof(key), "zone_%s_temp", zs.name);
+        cJSON_AddNumberToObject(root, key, zs.temp);
+        if (!isnan(zs.setpoint)) {
+            snprintf(key, sizeof(key), "zone_%s_setpoint", zs.name);
+            cJSON_AddNumberToObject(root, key, zs.setpoint);
+        }
+        snprintf(key, sizeof(key), "zone_%s_duty", zs.name);
+        cJSON_AddNumberToObject(root, key, zs.duty);
+        snprintf(key, sizeof(key), "zone_%s_relay", zs.name);
+        cJSON_AddBoolToObject(root, key, zs.relay_on);
+        snprintf(key, sizeof(key), "zone_%s_fault", zs.name);
+        cJSON_AddBoolToObject(root, key, zs.fault);
+    }
     cJSON_AddNumberToObject(root, "temperature_outside", st->temperature_c_outside);
     cJSON_AddNumberToObject(root, "current_setpiont", st->current_setpoint);
     cJSON_AddBoolToObject(root, "relay_is_on", st->relay_is_on);
@@ -110,4 +141,53 @@ void mqtt_publish_state(const sensors_state_t *st)
 
     cJSON_Delete(root);
     free(json_data);
-}
\ No newline at end of file
+}
+
+// Телеметрія діагностики: diag_heap_*, diag_stack_<завдання>, diag_cpu_<завдання>
+void mqtt_publish_diag(const task_stats_snapshot_t *snap)
+{
+    if (!client) {
+        ESP_LOGE(TAG, "MQTT client not initialized!");
+        return;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    if (root == NULL) {
+        ESP_LOGE(TAG, "Failed to create cJSON object");
+        return;
+    }
+
+    cJSON_AddNumberToObject(root, "diag_heap_free", snap->heap.free);
+    cJSON_AddNumberToObject(root, "diag_heap_min_free", snap->heap.min_free);
+    cJSON_AddNumberToObject(root, "diag_heap_largest_block", snap->heap.largest_block);
+    for (int i = 0; i < snap->count; i++) {
+        const task_stats_task_t *t = &snap->tasks[i];
+        // Імена завдань можуть містити пробіли
+        char name[sizeof(t->name)];
+        strcpy(name, t->name);
+        for (char *c = name; *c; c++) {
+            if (*c == ' ') *c = '_';
+        }
+
+        char key[40];
+        snprintf(key, sizeof(key), "diag_stack_%s", name);
+        cJSON_AddNumberToObject(root, key, t->stack_free_min);
+        if (!isnan(t->cpu_percent)) {
+            snprintf(key, sizeof(key), "diag_cpu_%s", name);
+            cJSON_AddNumberToObject(root, key, roundf(t->cpu_percent * 100.0f) / 100.0f);
+        }
+    }
+
+    char *json_data = cJSON_PrintUnformatted(root);
+    cJSON_Delete(root);
+    if (json_data == NULL) {
+        ESP_LOGE(TAG, "Failed to print cJSON to string");
+        return;
+    }
+
+    int msg_id = esp_mqtt_client_publish(client, MQTT_TOPIC, json_data, 0, 1, 0);
+    if (msg_id < 0) {
+        ESP_LOGE(TAG, "MQTT diag publish failed!");
+    }
+    free(json_data);
+}
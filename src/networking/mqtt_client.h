@@ -2,8 +2,10 @@
 #define MQTT_CLIENT_CONTROLLER_H
 
 #include "model/system_state.h"
+#include "controller/task_stats.h"
 
 void mqtt_init(void);
 void mqtt_publish_state(const sensors_state_t *st);
+void mqtt_publish_diag(const task_stats_snapshot_t *snap);
 
 #endif // MQTT_CLIENT_CONTROLLER_H
\ No newline at end of file
@@ -4,19 +4,62 @@
 #include "freertos/task.h"
 
 #include "model/system_state.h"
+#include "model/state_bus.h"
+#include "model/settings_manager.h"
+#include "controller/task_stats.h"
+#include "esp_timer.h"
+#include <stdlib.h>
+
+// Поля, що входять у повідомлення MQTT
+#define MQTT_STATE_FIELDS (SYSTEM_STATE_FIELD_TEMPERATURE | SYSTEM_STATE_FIELD_SENSOR_HEALTH | \
+                           SYSTEM_STATE_FIELD_TEMP_OUTSIDE | SYSTEM_STATE_FIELD_SETPOINT | \
+                           SYSTEM_STATE_FIELD_RELAY | SYSTEM_STATE_FIELD_PRESENCE | \
+                           SYSTEM_STATE_FIELD_MODE | SYSTEM_STATE_FIELD_ERROR)
+
+// Не частіше, ніж раніше публікувалось за таймером; зміни за цей час зливаються в одну публікацію
+#define MQTT_MIN_INTERVAL_MS  5000
+// Без змін стан (і дані зон поза system_state) все одно публікується раз на хвилину
+#define MQTT_HEARTBEAT_MS     60000
+
+static state_bus_handle_t s_mqtt_bus = NULL;
+
+// Діагностика публікується з тим самим циклом, тож її інтервал округлюється до хвилини серцебиття
+static void mqtt_publish_diag_if_due(int64_t *last_us)
+{
+    int interval_min = settings_get()->mqtt.diag_interval_min;
+    if (interval_min <= 0) return;
+
+    int64_t now_us = esp_timer_get_time();
+    if (*last_us != 0 && now_us - *last_us < (int64_t)interval_min * 60LL * 1000000LL) return;
+
+    // Знімок великий для стека завдання
+    task_stats_snapshot_t *snap = malloc(sizeof(task_stats_snapshot_t));
+    if (snap == NULL) return;
+    if (task_stats_get(snap) == ESP_OK && snap->uptime_us != 0) {
+        mqtt_publish_diag(snap);
+        *last_us = now_us;
+    }
+    free(snap);
+}
 
 static void mqtt_publish_task(void *arg)
 {
     sensors_state_t data;
+    int64_t diag_last_us = 0;
 
     while (1) {
         system_state_get(&data);
         mqtt_publish_state(&data);
-        vTaskDelay(pdMS_TO_TICKS(5000));
+        mqtt_publish_diag_if_due(&diag_last_us);
+        vTaskDelay(pdMS_TO_TICKS(MQTT_MIN_INTERVAL_MS));
+        state_bus_wait(s_mqtt_bus, pdMS_TO_TICKS(MQTT_HEARTBEAT_MS - MQTT_MIN_INTERVAL_MS));
     }
 }
 
 void mqtt_publish_task_start(void)
 {
-    xTaskCreate(mqtt_publish_task, "mqtt_publish_task", 4096, NULL, 5, NULL);
-}
\ No newline at end of file
+    TaskHandle_t task = NULL;
+    if (xTaskCreate(mqtt_publish_task, "mqtt_publish_task", 4096, NULL, 5, &task) == pdPASS) {
+        s_mqtt_bus = state_bus_subscribe("mqtt", task, MQTT_STATE_FIELDS);
+    }
+}
@@ -2,11 +2,26 @@
 #include "esp_http_server.h"
 #include "esp_log.h"
 #include "cJSON.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include "model/system_state.h"
+#include "model/state_bus.h"
 #include "model/settings_manager.h"
 #include "model/main_control.h"
 #include "controller/temp_setpoint_manager.h"
 #include "controller/schedule_manager.h"
+#include "controller/adaptive_algorythm.h"
+#include "controller/zone_manager.h"
+#include "controller/actuator/relay_controller.h"
+#include "controller/sensor/temp_controller.h"
+#include "controller/sensor/temp_health.h"
+#include "controller/sensor/temp_calibration.h"
+#include "controller/loop_timing.h"
+#include "controller/task_stats.h"
 
 static const char *TAG = "WEB_SERVER";
 
@@ -18,8 +33,6 @@ extern const uint8_t style_css_end[]    asm("_binary_style_css_end");
 extern const uint8_t app_js_start[]     asm("_binary_app_js_start");
 extern const uint8_t app_js_end[]       asm("_binary_app_js_end");
 
-extern const char* state_to_string(system_state_t state);
-
 static size_t get_embedded_file_len(const uint8_t *start, const uint8_t *end) {
     size_t len = end - start;
     while (len > 0 && start[len - 1] == 0) {
@@ -51,19 +64,91 @@ static esp_err_t app_js_get_handler(httpd_req_t *req) {
 }
 
 // --- API STATUS ---
-static esp_err_t api_status_get_handler(httpd_req_t *req) {
+/**
+ * @brief Збирає JSON стану системи (спільний для /api/status і WebSocket).
+ */
+static cJSON *status_to_json(void) {
     sensors_state_t state;
     system_state_get(&state);
 
     cJSON *root = cJSON_CreateObject();
-    cJSON_AddNumberToObject(root, "room_temp", state.temperature_c_sensor1);
-    cJSON_AddNumberToObject(root, "rad_temp", state.temperature_c_sensor2);
+    cJSON_AddNumberToObject(root, "room_temp", state.temperature_c[TEMP_SENSOR_ROOM]);
+    cJSON_AddNumberToObject(root, "rad_temp", state.temperature_c[TEMP_SENSOR_RADIATOR]);
     cJSON_AddNumberToObject(root, "outside_temp", state.temperature_c_outside);
+    cJSON_AddNumberToObject(root, "room_temp_est", state.room_temp_estimate);
+    cJSON_AddNumberToObject(root, "room_temp_rate", state.room_temp_rate);
     cJSON_AddNumberToObject(root, "current_setpoint", state.current_setpoint);
     cJSON_AddBoolToObject(root, "relay", state.relay_is_on);
     cJSON_AddStringToObject(root, "state", state_to_string(state.system_state));
     cJSON_AddNumberToObject(root, "manual_setpoint", temp_setpoint_manager_get());
+    cJSON_AddNumberToObject(root, "state_version", state.version);
+
+    const app_settings_t *cfg = settings_get();
+    cJSON *sensors = cJSON_CreateArray();
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        if (!cfg->sensors.channels[i].enabled) continue;
+        cJSON *s = cJSON_CreateObject();
+        cJSON_AddNumberToObject(s, "id", i);
+        cJSON_AddStringToObject(s, "name", cfg->sensors.channels[i].name);
+        cJSON_AddNumberToObject(s, "t", state.temperature_c[i]);
+        cJSON_AddStringToObject(s, "health", temp_health_to_string((temp_health_t)state.sensor_health[i]));
+        cJSON_AddItemToArray(sensors, s);
+    }
+    cJSON_AddItemToObject(root, "sensors", sensors);
+
+    cJSON *zones = cJSON_CreateArray();
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        zone_status_t zs;
+        if (zone_manager_get_status(i, &zs) != ESP_OK || !zs.enabled) continue;
+        cJSON *z = cJSON_CreateObject();
+        cJSON_AddNumberToObject(z, "id", i);
+        cJSON_AddStringToObject(z, "name", zs.name);
+        cJSON_AddNumberToObject(z, "t", zs.temp);
+        if (isnan(zs.setpoint)) {
+            cJSON_AddNullToObject(z, "setpoint");
+        } else {
+            cJSON_AddNumberToObject(z, "setpoint", zs.setpoint);
+        }
+        cJSON_AddNumberToObject(z, "duty", zs.duty);
+        cJSON_AddBoolToObject(z, "relay", zs.relay_on);
+        cJSON_AddBoolToObject(z, "fault", zs.fault);
+        relay_stats_t rs;
+        if (relay_controller_get_stats(i, &rs) == ESP_OK) {
+            cJSON_AddNumberToObject(z, "switch_cycles", rs.switch_cycles);
+            cJSON_AddNumberToObject(z, "on_hours", (double)rs.on_time_ms / 3600000.0);
+        }
+        cJSON_AddItemToArray(zones, z);
+    }
+    cJSON_AddItemToObject(root, "zones", zones);
+
+    thermal_model_t model;
+    thermal_model_init(&model, 0.0f);
+    adaptive_thermo_get_model(&model);
+    cJSON *tm = cJSON_CreateObject();
+    cJSON_AddBoolToObject(tm, "converged", thermal_model_is_converged(&model));
+    cJSON_AddNumberToObject(tm, "heat_rate", thermal_model_heat_rate(&model, state.temperature_c[TEMP_SENSOR_ROOM], state.temperature_c_outside));
+    cJSON_AddNumberToObject(tm, "loss_coeff", thermal_model_loss_coeff(&model));
+    cJSON_AddNumberToObject(tm, "tau_h", thermal_model_time_constant_h(&model));
+    cJSON_AddItemToObject(root, "thermal_model", tm);
+
+    mpc_plan_t *plan = malloc(sizeof(mpc_plan_t));
+    if (plan) {
+        cJSON *mpc = cJSON_CreateObject();
+        bool active = adaptive_thermo_get_mpc_plan(plan);
+        cJSON_AddBoolToObject(mpc, "active", active);
+        if (active) {
+            cJSON_AddNumberToObject(mpc, "duty", plan->duty[0] * 100.0f);
+            cJSON_AddNumberToObject(mpc, "energy_h", plan->energy_h);
+            cJSON_AddBoolToObject(mpc, "feasible", plan->feasible);
+        }
+        cJSON_AddItemToObject(root, "mpc", mpc);
+        free(plan);
+    }
+    return root;
+}
 
+static esp_err_t api_status_get_handler(httpd_req_t *req) {
+    cJSON *root = status_to_json();
     const char *json_str = cJSON_PrintUnformatted(root);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_send(req, json_str, strlen(json_str));
@@ -73,6 +158,100 @@ static esp_err_t api_status_get_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// --- WEBSOCKET /ws (push стану замість опитування /api/status) ---
+static httpd_handle_t s_server = NULL;
+static TaskHandle_t s_ws_task = NULL;
+static state_bus_handle_t s_ws_bus = NULL;
+
+// Поля, що показує веб-інтерфейс
+#define WS_STATE_FIELDS (SYSTEM_STATE_FIELD_TEMP_CHANNEL(TEMP_SENSOR_ROOM) | SYSTEM_STATE_FIELD_TEMP_OUTSIDE | \
+                         SYSTEM_STATE_FIELD_SETPOINT | SYSTEM_STATE_FIELD_RELAY | SYSTEM_STATE_FIELD_MODE | \
+                         SYSTEM_STATE_FIELD_ERROR | STATE_BUS_EVENT_MANUAL_SETPOINT)
+// Не частіше, ніж інтерфейс опитував /api/status раніше
+#define WS_PUSH_MIN_INTERVAL_MS  2000
+// Дані зон і моделі поза system_state оновлюються в інтерфейсі хоча б так часто
+#define WS_PUSH_HEARTBEAT_MS     30000
+// Нове з'єднання: надіслати стан одразу (біт поза масками шини)
+#define WS_NOTIFY_CLIENT         (1u << 31)
+
+#define WEB_MAX_OPEN_SOCKETS     7
+
+/**
+ * @brief Дескриптори відкритих WebSocket-з'єднань.
+ */
+static size_t ws_client_fds(int *fds) {
+    size_t count = WEB_MAX_OPEN_SOCKETS;
+    int all[WEB_MAX_OPEN_SOCKETS];
+    if (s_server == NULL || httpd_get_client_list(s_server, &count, all) != ESP_OK) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (httpd_ws_get_fd_info(s_server, all[i]) == HTTPD_WS_CLIENT_WEBSOCKET) fds[n++] = all[i];
+    }
+    return n;
+}
+
+/**
+ * @brief Розсилає JSON усім WebSocket-клієнтам (виконується в завданні сервера).
+ */
+static void ws_broadcast_work(void *arg) {
+    char *json_str = arg;
+    int fds[WEB_MAX_OPEN_SOCKETS];
+    size_t n = ws_client_fds(fds);
+
+    httpd_ws_frame_t frame = {
+        .type = HTTPD_WS_TYPE_TEXT,
+        .payload = (uint8_t *)json_str,
+        .len = strlen(json_str)
+    };
+    for (size_t i = 0; i < n; i++) {
+        httpd_ws_send_frame_async(s_server, fds[i], &frame);
+    }
+    free(json_str);
+}
+
+static void ws_push_task(void *arg) {
+    for (;;) {
+        int fds[WEB_MAX_OPEN_SOCKETS];
+        if (ws_client_fds(fds) == 0) {
+            // Без клієнтів завдання не прокидається на зміни стану взагалі
+            state_bus_set_fields(s_ws_bus, 0);
+            while ((state_bus_wait(s_ws_bus, portMAX_DELAY) & WS_NOTIFY_CLIENT) == 0) {}
+            state_bus_set_fields(s_ws_bus, WS_STATE_FIELDS);
+        }
+
+        cJSON *root = status_to_json();
+        char *json_str = cJSON_PrintUnformatted(root);
+        cJSON_Delete(root);
+        if (json_str != NULL && httpd_queue_work(s_server, ws_broadcast_work, json_str) != ESP_OK) {
+            free(json_str);
+        }
+
+        // Зміни за мінімальний інтервал накопичуються в бітах сповіщення і підуть одним повідомленням;
+        // далі завдання спить до наступної зміни або до періодичного оновлення
+        vTaskDelay(pdMS_TO_TICKS(WS_PUSH_MIN_INTERVAL_MS));
+        state_bus_wait(s_ws_bus, pdMS_TO_TICKS(WS_PUSH_HEARTBEAT_MS));
+    }
+}
+
+static esp_err_t ws_handler(httpd_req_t *req) {
+    if (req->method == HTTP_GET) {
+        ESP_LOGI(TAG, "WebSocket client connected, fd %d", httpd_req_to_sockfd(req));
+        if (s_ws_task != NULL) xTaskNotify(s_ws_task, WS_NOTIFY_CLIENT, eSetBits);
+        return ESP_OK;
+    }
+
+    // Клієнт нічого не надсилає; кадри лише вичитуються
+    httpd_ws_frame_t frame = { 0 };
+    esp_err_t err = httpd_ws_recv_frame(req, &frame, 0);
+    if (err != ESP_OK || frame.len == 0) return err;
+    frame.payload = malloc(frame.len);
+    if (frame.payload == NULL) return ESP_ERR_NO_MEM;
+    err = httpd_ws_recv_frame(req, &frame, frame.len);
+    free(frame.payload);
+    return err;
+}
+
 // --- API ACTION (Set Mode & Set Temp) ---
 static esp_err_t api_action_post_handler(httpd_req_t *req) {
     char buf[200];
@@ -87,14 +266,36 @@ static esp_err_t api_action_post_handler(httpd_req_t *req) {
     
     if (action && strcmp(action->valuestring, "set_mode") == 0) {
         cJSON *mode_item = cJSON_GetObjectItem(root, "mode");
-        if(mode_item) {
-            const char *m = mode_item->valuestring;
-            system_state_t new_state = STATE_OFF;
-            if (strcmp(m, "MANUAL") == 0) new_state = STATE_MANUAL;
-            else if (strcmp(m, "PROGRAMMED") == 0) new_state = STATE_PROGRAMMED;
-            else if (strcmp(m, "OFF") == 0) new_state = STATE_OFF;
-            else if (strcmp(m, "ADAPTIVE") == 0) new_state = STATE_ADAPTIVE;
-            main_control_change_state(new_state);
+        system_state_t new_state;
+        esp_err_t err = main_control_state_from_string(
+            cJSON_IsString(mode_item) ? mode_item->valuestring : NULL, &new_state);
+        if (err == ESP_OK) {
+            err = main_control_change_state(new_state, MAIN_CONTROL_CAUSE_WEB);
+        }
+        if (err != ESP_OK) {
+            cJSON_Delete(root);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err));
+            return ESP_FAIL;
+        }
+    }
+    else if (action && strcmp(action->valuestring, "autotune") == 0) {
+        // {"action":"autotune","setpoint":21.0,"rule":"zn_pi"}
+        cJSON *sp = cJSON_GetObjectItem(root, "setpoint");
+        cJSON *rule_item = cJSON_GetObjectItem(root, "rule");
+        pid_tune_rule_t rule = PID_TUNE_RULE_ZN_PI;
+        if (cJSON_IsString(rule_item)) {
+            for (int r = PID_TUNE_RULE_ZN_PID; r <= PID_TUNE_RULE_NO_OVERSHOOT; r++) {
+                if (strcmp(rule_item->valuestring, pid_autotune_rule_to_string((pid_tune_rule_t)r)) == 0) {
+                    rule = (pid_tune_rule_t)r;
+                }
+            }
+        }
+        float setpoint = cJSON_IsNumber(sp) ? (float)sp->valuedouble : temp_setpoint_manager_get();
+        esp_err_t err = main_control_start_autotune(rule, setpoint);
+        if (err != ESP_OK) {
+            cJSON_Delete(root);
+            httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err));
+            return ESP_FAIL;
         }
     }
     else if (action && strcmp(action->valuestring, "set_temp") == 0) {
@@ -146,6 +347,75 @@ static esp_err_t api_schedule_get_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// --- API HISTORY ---
+// Максимальна кількість записів в одній відповіді (обмежує розмір JSON)
+#define HISTORY_MAX_RESPONSE_ENTRIES 240
+
+// Буфер одного запису: вік, 6 сирих кодів і 6 температур з запасом
+#define HISTORY_CHUNK_SIZE 192
+
+/**
+ * @brief Надсилає один запис історії окремим фрагментом відповіді.
+ * Недійсні коди та температури передаються як null.
+ */
+static esp_err_t history_send_entry(httpd_req_t *req, const temp_history_entry_t *e, int64_t now_us,
+                                    bool comma, char *buf, size_t size) {
+    // Вік запису в мілісекундах відносно моменту запиту
+    int len = snprintf(buf, size, "%s{\"age_ms\":%lld,\"raw\":[", comma ? "," : "",
+                       (long long)((now_us - e->timestamp_us) / 1000));
+    for (int ch = 0; ch < NUM_TEMP_SENSORS; ch++) {
+        if (e->raw[ch] == TEMP_HISTORY_RAW_INVALID) {
+            len += snprintf(buf + len, size - len, "%snull", ch ? "," : "");
+        } else {
+            len += snprintf(buf + len, size - len, "%s%u", ch ? "," : "", (unsigned)e->raw[ch]);
+        }
+    }
+    len += snprintf(buf + len, size - len, "],\"t\":[");
+    for (int ch = 0; ch < NUM_TEMP_SENSORS; ch++) {
+        if (isnan(e->filtered[ch])) {
+            len += snprintf(buf + len, size - len, "%snull", ch ? "," : "");
+        } else {
+            len += snprintf(buf + len, size - len, "%s%.2f", ch ? "," : "", e->filtered[ch]);
+        }
+    }
+    len += snprintf(buf + len, size - len, "]}");
+    return httpd_resp_send_chunk(req, buf, len);
+}
+
+static esp_err_t api_history_get_handler(httpd_req_t *req) {
+    int seconds = 60;
+    char query[32];
+    char value[12];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "seconds", value, sizeof(value)) == ESP_OK) {
+        seconds = atoi(value);
+        if (seconds <= 0) seconds = 60;
+    }
+
+    temp_history_entry_t *entries = malloc(HISTORY_MAX_RESPONSE_ENTRIES * sizeof(temp_history_entry_t));
+    if (!entries) { httpd_resp_send_500(req); return ESP_FAIL; }
+
+    int64_t now_us = esp_timer_get_time();
+    size_t count = temp_controller_history_read(now_us - (int64_t)seconds * 1000000LL, now_us,
+                                                entries, HISTORY_MAX_RESPONSE_ENTRIES);
+
+    // Відповідь формується потоково по запису: дерево cJSON на 240 записів зайняло б ~180 КБ купи
+    httpd_resp_set_type(req, "application/json");
+    char buf[HISTORY_CHUNK_SIZE];
+    int len = snprintf(buf, sizeof(buf), "{\"capacity\":%u,\"samples\":[", (unsigned)temp_controller_history_capacity());
+    esp_err_t err = httpd_resp_send_chunk(req, buf, len);
+    for (size_t i = 0; i < count && err == ESP_OK; i++) {
+        err = history_send_entry(req, &entries[i], now_us, i > 0, buf, sizeof(buf));
+    }
+    free(entries);
+    if (err == ESP_OK) err = httpd_resp_send_chunk(req, "]}", 2);
+    if (err != ESP_OK) {
+        ESP_LOGW(TAG, "History response aborted: %s", esp_err_to_name(err));
+        return ESP_FAIL;
+    }
+    return httpd_resp_send_chunk(req, NULL, 0);
+}
+
 // --- API SCHEDULE POST ---
 static esp_err_t api_schedule_post_handler(httpd_req_t *req) {
     char *buf = malloc(req->content_len + 1);
@@ -205,6 +475,7 @@ static esp_err_t api_settings_get_handler(httpd_req_t *req) {
     cJSON_AddStringToObject(mqtt, "host", cfg->mqtt.host);
     cJSON_AddNumberToObject(mqtt, "port", cfg->mqtt.port);
     cJSON_AddStringToObject(mqtt, "token", cfg->mqtt.token);
+    cJSON_AddNumberToObject(mqtt, "diag_interval_min", cfg->mqtt.diag_interval_min);
     cJSON_AddItemToObject(root, "mqtt", mqtt);
 
     cJSON *geo = cJSON_CreateObject();
@@ -215,10 +486,13 @@ static esp_err_t api_settings_get_handler(httpd_req_t *req) {
 
     cJSON *control = cJSON_CreateObject();
     cJSON_AddNumberToObject(control, "pwm_cycle_s", cfg->control.pwm_cycle_s);
+    cJSON_AddNumberToObject(control, "pwm_cycle_ms", cfg->control.pwm_cycle_ms);
     cJSON *pid = cJSON_CreateObject();
     cJSON_AddNumberToObject(pid, "kp", cfg->control.pid.kp);
     cJSON_AddNumberToObject(pid, "ki", cfg->control.pid.ki);
     cJSON_AddNumberToObject(pid, "kd", cfg->control.pid.kd);
+    cJSON_AddNumberToObject(pid, "setpoint_weight", cfg->control.pid.setpoint_weight);
+    cJSON_AddNumberToObject(pid, "d_filter_n", cfg->control.pid.d_filter_n);
     cJSON_AddItemToObject(control, "pid", pid);
 
     cJSON *limits = cJSON_CreateObject();
@@ -226,9 +500,67 @@ static esp_err_t api_settings_get_handler(httpd_req_t *req) {
     cJSON_AddNumberToObject(limits, "room_min", cfg->control.limits.room_min);
     cJSON_AddNumberToObject(limits, "room_max", cfg->control.limits.room_max);
     cJSON_AddItemToObject(control, "limits", limits);
+
+    cJSON *estimator = cJSON_CreateObject();
+    cJSON_AddBoolToObject(estimator, "enabled", cfg->control.estimator.enabled);
+    cJSON_AddNumberToObject(estimator, "k_rad", cfg->control.estimator.k_rad);
+    cJSON_AddNumberToObject(estimator, "k_loss", cfg->control.estimator.k_loss);
+    cJSON_AddNumberToObject(estimator, "meas_noise", cfg->control.estimator.meas_noise);
+    cJSON_AddItemToObject(control, "estimator", estimator);
+    cJSON_AddBoolToObject(control, "mpc_enabled", cfg->control.mpc_enabled);
+
+    cJSON *ff = cJSON_CreateObject();
+    cJSON_AddBoolToObject(ff, "enabled", cfg->control.ff.enabled);
+    cJSON_AddBoolToObject(ff, "learn", cfg->control.ff.learn);
+    cJSON_AddNumberToObject(ff, "slope", cfg->control.ff.slope);
+    cJSON_AddNumberToObject(ff, "offset", cfg->control.ff.offset);
+    cJSON_AddItemToObject(control, "ff", ff);
+
+    cJSON *relay = cJSON_CreateObject();
+    cJSON_AddNumberToObject(relay, "min_on_ms", cfg->control.relay.min_on_ms);
+    cJSON_AddNumberToObject(relay, "min_off_ms", cfg->control.relay.min_off_ms);
+    cJSON_AddItemToObject(control, "relay", relay);
     
     cJSON_AddItemToObject(root, "control", control);
 
+    cJSON *sensors = cJSON_CreateArray();
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        const temp_sensor_settings_t *ch = &cfg->sensors.channels[i];
+        cJSON *s = cJSON_CreateObject();
+        cJSON_AddBoolToObject(s, "enabled", ch->enabled);
+        cJSON_AddNumberToObject(s, "adc_channel", ch->adc_channel);
+        cJSON_AddStringToObject(s, "name", ch->name);
+        cJSON_AddNumberToObject(s, "r0", ch->ntc.r0);
+        cJSON_AddNumberToObject(s, "t0", ch->ntc.t0);
+        cJSON_AddNumberToObject(s, "beta", ch->ntc.beta);
+        cJSON_AddNumberToObject(s, "r_fixed", ch->ntc.r_fixed);
+        cJSON_AddNumberToObject(s, "ema_alpha", ch->ema_alpha);
+        cJSON *filter = cJSON_CreateObject();
+        cJSON_AddNumberToObject(filter, "median", ch->filter.median_window);
+        cJSON_AddNumberToObject(filter, "hampel", ch->filter.hampel_window);
+        cJSON_AddNumberToObject(filter, "hampel_k", ch->filter.hampel_k);
+        cJSON_AddNumberToObject(filter, "smoothing", ch->filter.smoothing);
+        cJSON_AddNumberToObject(filter, "cutoff_hz", ch->filter.cutoff_hz);
+        cJSON_AddItemToObject(s, "filter", filter);
+        cJSON_AddItemToArray(sensors, s);
+    }
+    cJSON_AddItemToObject(root, "sensors", sensors);
+
+    cJSON *zones = cJSON_CreateArray();
+    for (int i = 0; i < HEAT_ZONES_MAX; i++) {
+        const heat_zone_settings_t *zc = &cfg->zones.list[i];
+        cJSON *z = cJSON_CreateObject();
+        cJSON_AddBoolToObject(z, "enabled", zc->enabled);
+        cJSON_AddStringToObject(z, "name", zc->name);
+        cJSON_AddNumberToObject(z, "relay_gpio", zc->relay_gpio);
+        cJSON_AddNumberToObject(z, "relay_active_level", zc->relay_active_level);
+        cJSON_AddNumberToObject(z, "room_sensor", zc->room_sensor);
+        cJSON_AddNumberToObject(z, "radiator_sensor", zc->radiator_sensor);
+        cJSON_AddNumberToObject(z, "setpoint_offset", zc->setpoint_offset);
+        cJSON_AddItemToArray(zones, z);
+    }
+    cJSON_AddItemToObject(root, "zones", zones);
+
     const char *json_str = cJSON_PrintUnformatted(root);
     httpd_resp_set_type(req, "application/json");
     httpd_resp_send(req, json_str, strlen(json_str));
@@ -240,7 +572,7 @@ static esp_err_t api_settings_get_handler(httpd_req_t *req) {
 
 // --- API SETTINGS POST ---
 static esp_err_t api_settings_post_handler(httpd_req_t *req) {
-    char buf[1024];
+    char buf[2048];
     int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
     if (ret <= 0) return ESP_FAIL;
     buf[ret] = '\0';
@@ -269,6 +601,8 @@ static esp_err_t api_settings_post_handler(httpd_req_t *req) {
         if(h) strncpy(cfg->mqtt.host, h->valuestring, sizeof(cfg->mqtt.host)-1);
         if(p) cfg->mqtt.port = p->valueint;
         if(t) strncpy(cfg->mqtt.token, t->valuestring, sizeof(cfg->mqtt.token)-1);
+        cJSON *di = cJSON_GetObjectItem(mqtt, "diag_interval_min");
+        if(cJSON_IsNumber(di) && di->valueint >= 0) cfg->mqtt.diag_interval_min = di->valueint;
     }
 
     cJSON *geo = cJSON_GetObjectItem(root, "geo");
@@ -288,11 +622,18 @@ static esp_err_t api_settings_post_handler(httpd_req_t *req) {
         if (pwm) {
             cfg->control.pwm_cycle_s = pwm->valueint;
         }
+        cJSON *pwm_ms = cJSON_GetObjectItem(ctrl, "pwm_cycle_ms");
+        if (pwm_ms) {
+            cfg->control.pwm_cycle_ms = pwm_ms->valueint;
+        }
         cJSON *pid = cJSON_GetObjectItem(ctrl, "pid");
         if(pid) {
              cfg->control.pid.kp = cJSON_GetObjectItem(pid, "kp")->valuedouble;
              cfg->control.pid.ki = cJSON_GetObjectItem(pid, "ki")->valuedouble;
              cfg->control.pid.kd = cJSON_GetObjectItem(pid, "kd")->valuedouble;
+             cJSON *item;
+             if ((item = cJSON_GetObjectItem(pid, "setpoint_weight"))) cfg->control.pid.setpoint_weight = item->valuedouble;
+             if ((item = cJSON_GetObjectItem(pid, "d_filter_n"))) cfg->control.pid.d_filter_n = item->valuedouble;
         }
         cJSON *lim = cJSON_GetObjectItem(ctrl, "limits");
         if(lim) {
@@ -300,6 +641,77 @@ static esp_err_t api_settings_post_handler(httpd_req_t *req) {
             cfg->control.limits.room_min = cJSON_GetObjectItem(lim, "room_min")->valuedouble;
             cfg->control.limits.room_max = cJSON_GetObjectItem(lim, "room_max")->valuedouble;
         }
+        cJSON *est = cJSON_GetObjectItem(ctrl, "estimator");
+        if (est) {
+            cJSON *item;
+            if ((item = cJSON_GetObjectItem(est, "enabled"))) cfg->control.estimator.enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(est, "k_rad"))) cfg->control.estimator.k_rad = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(est, "k_loss"))) cfg->control.estimator.k_loss = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(est, "meas_noise"))) cfg->control.estimator.meas_noise = item->valuedouble;
+        }
+        cJSON *mpc = cJSON_GetObjectItem(ctrl, "mpc_enabled");
+        if (mpc) cfg->control.mpc_enabled = cJSON_IsTrue(mpc);
+        cJSON *ff = cJSON_GetObjectItem(ctrl, "ff");
+        if (ff) {
+            cJSON *item;
+            if ((item = cJSON_GetObjectItem(ff, "enabled"))) cfg->control.ff.enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(ff, "learn"))) cfg->control.ff.learn = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(ff, "slope"))) cfg->control.ff.slope = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(ff, "offset"))) cfg->control.ff.offset = item->valuedouble;
+        }
+        cJSON *relay = cJSON_GetObjectItem(ctrl, "relay");
+        if (relay) {
+            cJSON *item;
+            if ((item = cJSON_GetObjectItem(relay, "min_on_ms")) && item->valueint >= 0) cfg->control.relay.min_on_ms = item->valueint;
+            if ((item = cJSON_GetObjectItem(relay, "min_off_ms")) && item->valueint >= 0) cfg->control.relay.min_off_ms = item->valueint;
+        }
+    }
+
+    cJSON *sensors = cJSON_GetObjectItem(root, "sensors");
+    if (sensors && cJSON_IsArray(sensors)) {
+        int count = cJSON_GetArraySize(sensors);
+        if (count > MAX_TEMP_SENSORS) count = MAX_TEMP_SENSORS;
+        for (int i = 0; i < count; i++) {
+            cJSON *s = cJSON_GetArrayItem(sensors, i);
+            temp_sensor_settings_t *ch = &cfg->sensors.channels[i];
+            cJSON *item;
+            if ((item = cJSON_GetObjectItem(s, "enabled"))) ch->enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(s, "adc_channel"))) ch->adc_channel = item->valueint;
+            if ((item = cJSON_GetObjectItem(s, "name")) && item->valuestring) strncpy(ch->name, item->valuestring, sizeof(ch->name) - 1);
+            if ((item = cJSON_GetObjectItem(s, "r0"))) ch->ntc.r0 = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(s, "t0"))) ch->ntc.t0 = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(s, "beta"))) ch->ntc.beta = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(s, "r_fixed"))) ch->ntc.r_fixed = item->valuedouble;
+            if ((item = cJSON_GetObjectItem(s, "ema_alpha"))) ch->ema_alpha = item->valuedouble;
+            cJSON *filter = cJSON_GetObjectItem(s, "filter");
+            if (filter) {
+                if ((item = cJSON_GetObjectItem(filter, "median"))) ch->filter.median_window = item->valueint;
+                if ((item = cJSON_GetObjectItem(filter, "hampel"))) ch->filter.hampel_window = item->valueint;
+                if ((item = cJSON_GetObjectItem(filter, "hampel_k"))) ch->filter.hampel_k = item->valuedouble;
+                if ((item = cJSON_GetObjectItem(filter, "smoothing"))) ch->filter.smoothing = item->valueint;
+                if ((item = cJSON_GetObjectItem(filter, "cutoff_hz"))) ch->filter.cutoff_hz = item->valuedouble;
+            }
+        }
+    }
+
+    cJSON *zones = cJSON_GetObjectItem(root, "zones");
+    if (zones && cJSON_IsArray(zones)) {
+        int count = cJSON_GetArraySize(zones);
+        if (count > HEAT_ZONES_MAX) count = HEAT_ZONES_MAX;
+        for (int i = 0; i < count; i++) {
+            cJSON *z = cJSON_GetArrayItem(zones, i);
+            heat_zone_settings_t *zc = &cfg->zones.list[i];
+            cJSON *item;
+            // Основна зона завжди увімкнена, її реле та датчики задані апаратно
+            if ((item = cJSON_GetObjectItem(z, "name")) && item->valuestring) strncpy(zc->name, item->valuestring, sizeof(zc->name) - 1);
+            if (i == 0) continue;
+            if ((item = cJSON_GetObjectItem(z, "enabled"))) zc->enabled = cJSON_IsTrue(item);
+            if ((item = cJSON_GetObjectItem(z, "relay_gpio"))) zc->relay_gpio = item->valueint;
+            if ((item = cJSON_GetObjectItem(z, "relay_active_level"))) zc->relay_active_level = item->valueint ? 1 : 0;
+            if ((item = cJSON_GetObjectItem(z, "room_sensor"))) zc->room_sensor = item->valueint;
+            if ((item = cJSON_GetObjectItem(z, "radiator_sensor"))) zc->radiator_sensor = item->valueint;
+            if ((item = cJSON_GetObjectItem(z, "setpoint_offset"))) zc->setpoint_offset = item->valuedouble;
+        }
     }
 
     cJSON_Delete(root);
@@ -311,15 +723,266 @@ static esp_err_t api_settings_post_handler(httpd_req_t *req) {
     return ESP_OK;
 }
 
+// --- API CALIBRATION GET ---
+static esp_err_t api_calibration_get_handler(httpd_req_t *req) {
+    const app_settings_t *cfg = settings_get();
+    cJSON *root = cJSON_CreateArray();
+    for (int i = 0; i < NUM_TEMP_SENSORS; i++) {
+        const temp_sensor_settings_t *ch = &cfg->sensors.channels[i];
+        if (!ch->enabled) continue;
+
+        cJSON *s = cJSON_CreateObject();
+        cJSON_AddNumberToObject(s, "id", i);
+        cJSON_AddStringToObject(s, "name", ch->name);
+        float avg_raw, resistance;
+        if (temp_controller_get_channel_raw((temp_sensor_id_t)i, &avg_raw, &resistance) == ESP_OK) {
+            cJSON_AddNumberToObject(s, "raw", avg_raw);
+            cJSON_AddNumberToObject(s, "resistance", resistance);
+        }
+        cJSON_AddNumberToObject(s, "r0", ch->ntc.r0);
+        cJSON_AddNumberToObject(s, "beta", ch->ntc.beta);
+        cJSON_AddBoolToObject(s, "sh_enabled", ch->cal.enabled);
+        cJSON_AddNumberToObject(s, "sh_a", ch->cal.a);
+        cJSON_AddNumberToObject(s, "sh_b", ch->cal.b);
+        cJSON_AddNumberToObject(s, "sh_c", ch->cal.c);
+        cJSON *points = cJSON_CreateArray();
+        for (int p = 0; p < ch->cal.num_points && p < TEMP_CAL_MAX_POINTS; p++) {
+            cJSON *pt = cJSON_CreateObject();
+            cJSON_AddNumberToObject(pt, "t", ch->cal.points[p].temp_c);
+            cJSON_AddNumberToObject(pt, "r", ch->cal.points[p].resistance);
+            cJSON_AddItemToArray(points, pt);
+        }
+        cJSON_AddItemToObject(s, "points", points);
+        cJSON_AddItemToArray(root, s);
+    }
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, strlen(json_str));
+    free((void *)json_str);
+    cJSON_Delete(root);
+    return ESP_OK;
+}
+
+// --- API CALIBRATION POST ---
+// {"sensor":0,"action":"capture","ref":21.5} | {"sensor":0,"action":"solve"} | {"sensor":0,"action":"clear"}
+static esp_err_t api_calibration_post_handler(httpd_req_t *req) {
+    char buf[200];
+    int ret = httpd_req_recv(req, buf, sizeof(buf) - 1);
+    if (ret <= 0) return ESP_FAIL;
+    buf[ret] = '\0';
+
+    cJSON *root = cJSON_Parse(buf);
+    if (!root) {
+        httpd_resp_send_500(req);
+        return ESP_FAIL;
+    }
+
+    cJSON *sensor = cJSON_GetObjectItem(root, "sensor");
+    cJSON *action = cJSON_GetObjectItem(root, "action");
+    if (!cJSON_IsNumber(sensor) || !cJSON_IsString(action)) {
+        cJSON_Delete(root);
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, "sensor and action required");
+        return ESP_FAIL;
+    }
+
+    temp_sensor_id_t id = (temp_sensor_id_t)sensor->valueint;
+    esp_err_t err = ESP_ERR_INVALID_ARG;
+    bool restart = false;
+    if (strcmp(action->valuestring, "capture") == 0) {
+        cJSON *ref = cJSON_GetObjectItem(root, "ref");
+        if (cJSON_IsNumber(ref)) err = temp_calibration_capture(id, (float)ref->valuedouble);
+    } else if (strcmp(action->valuestring, "solve") == 0) {
+        err = temp_calibration_solve(id);
+        restart = true;
+    } else if (strcmp(action->valuestring, "clear") == 0) {
+        err = temp_calibration_clear(id);
+        restart = true;
+    }
+    cJSON_Delete(root);
+
+    if (err != ESP_OK) {
+        httpd_resp_send_err(req, HTTPD_400_BAD_REQUEST, esp_err_to_name(err));
+        return ESP_FAIL;
+    }
+    httpd_resp_sendstr(req, "OK");
+
+    // Таблиця перетворення будується при ініціалізації драйвера
+    if (restart) {
+        vTaskDelay(pdMS_TO_TICKS(1000));
+        esp_restart();
+    }
+    return ESP_OK;
+}
+
+// --- API DIAG LOOP ---
+static cJSON *histogram_to_json(const uint32_t *hist) {
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < LOOP_TIMING_BUCKETS; i++) {
+        cJSON_AddItemToArray(arr, cJSON_CreateNumber(hist[i]));
+    }
+    return arr;
+}
+
+static esp_err_t api_diag_loop_get_handler(httpd_req_t *req) {
+    bool reset = false;
+    char query[32];
+    char value[4];
+    if (httpd_req_get_url_query_str(req, query, sizeof(query)) == ESP_OK &&
+        httpd_query_key_value(query, "reset", value, sizeof(value)) == ESP_OK) {
+        reset = atoi(value) != 0;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    // Межі кошиків гістограм: [0, b0), [b0, 2*b0), [2*b0, 4*b0), ... мкс
+    cJSON_AddNumberToObject(root, "bucket0_us", LOOP_TIMING_BUCKET0_US);
+    cJSON *loops = cJSON_CreateArray();
+    for (int i = 0; i < loop_timing_count(); i++) {
+        loop_timing_stats_t st;
+        if (loop_timing_get(i, &st, reset) != ESP_OK) continue;
+
+        cJSON *l = cJSON_CreateObject();
+        cJSON_AddStringToObject(l, "name", st.name);
+        cJSON_AddNumberToObject(l, "nominal_us", st.nominal_us);
+        cJSON_AddNumberToObject(l, "count", st.count);
+        cJSON_AddNumberToObject(l, "overruns", st.overruns);
+        if (st.count > 0) {
+            cJSON_AddNumberToObject(l, "period_min_us", st.period_min_us);
+            cJSON_AddNumberToObject(l, "period_max_us", st.period_max_us);
+            cJSON_AddNumberToObject(l, "period_mean_us", (double)(st.period_sum_us / st.count));
+        }
+        cJSON_AddItemToObject(l, "jitter_hist", histogram_to_json(st.jitter_hist));
+
+        uint32_t exec_count = 0;
+        for (int b = 0; b < LOOP_TIMING_BUCKETS; b++) exec_count += st.exec_hist[b];
+        cJSON_AddNumberToObject(l, "exec_max_us", st.exec_max_us);
+        if (exec_count > 0) {
+            cJSON_AddNumberToObject(l, "exec_mean_us", (double)(st.exec_sum_us / exec_count));
+        }
+        cJSON_AddItemToObject(l, "exec_hist", histogram_to_json(st.exec_hist));
+        cJSON_AddItemToArray(loops, l);
+    }
+    cJSON_AddItemToObject(root, "loops", loops);
+
+    // Підписники шини стану: скільки разів прокидались з моменту старту
+    cJSON *bus = cJSON_CreateArray();
+    for (int i = 0; i < state_bus_count(); i++) {
+        state_bus_stats_t st;
+        if (state_bus_get_stats(i, &st) != ESP_OK) continue;
+        cJSON *b = cJSON_CreateObject();
+        cJSON_AddStringToObject(b, "name", st.name);
+        cJSON_AddNumberToObject(b, "fields", st.fields);
+        cJSON_AddNumberToObject(b, "notifications", st.notifications);
+        cJSON_AddNumberToObject(b, "wakeups", st.wakeups);
+        cJSON_AddItemToArray(bus, b);
+    }
+    cJSON_AddItemToObject(root, "state_bus", bus);
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, strlen(json_str));
+    free((void *)json_str);
+    cJSON_Delete(root);
+    return ESP_OK;
+}
+
+// Журнал переходів режимів, від найновішого
+static esp_err_t api_diag_transitions_get_handler(httpd_req_t *req) {
+    main_control_transition_t journal[MAIN_CONTROL_JOURNAL_SIZE];
+    int n = main_control_get_journal(journal, MAIN_CONTROL_JOURNAL_SIZE);
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddStringToObject(root, "state", state_to_string(main_control_get_state()));
+    cJSON *arr = cJSON_CreateArray();
+    for (int i = 0; i < n; i++) {
+        cJSON *t = cJSON_CreateObject();
+        cJSON_AddNumberToObject(t, "uptime_s", (double)journal[i].uptime_us / 1e6);
+        cJSON_AddNumberToObject(t, "epoch", (double)journal[i].epoch_s);
+        cJSON_AddStringToObject(t, "from", state_to_string(journal[i].from));
+        cJSON_AddStringToObject(t, "to", state_to_string(journal[i].to));
+        cJSON_AddStringToObject(t, "cause", main_control_cause_to_string(journal[i].cause));
+        cJSON_AddItemToArray(arr, t);
+    }
+    cJSON_AddItemToObject(root, "transitions", arr);
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, strlen(json_str));
+    free((void *)json_str);
+    cJSON_Delete(root);
+    return ESP_OK;
+}
+
+static const char *task_state_to_string(uint8_t state) {
+    switch (state) {
+        case eRunning: return "running";
+        case eReady: return "ready";
+        case eBlocked: return "blocked";
+        case eSuspended: return "suspended";
+        case eDeleted: return "deleted";
+        default: return "invalid";
+    }
+}
+
+// Завдання (частка процесора, запас стека) та купа з останньої періодичної вибірки
+static esp_err_t api_diag_tasks_get_handler(httpd_req_t *req) {
+    task_stats_snapshot_t *snap = malloc(sizeof(task_stats_snapshot_t));
+    if (!snap) { httpd_resp_send_500(req); return ESP_FAIL; }
+    esp_err_t err = task_stats_get(snap);
+    if (err != ESP_OK) {
+        free(snap);
+        httpd_resp_send_err(req, HTTPD_500_INTERNAL_SERVER_ERROR, esp_err_to_name(err));
+        return ESP_FAIL;
+    }
+
+    cJSON *root = cJSON_CreateObject();
+    cJSON_AddNumberToObject(root, "age_s", (double)(esp_timer_get_time() - snap->uptime_us) / 1e6);
+    cJSON_AddNumberToObject(root, "period_s", (double)snap->period_us / 1e6);
+    cJSON_AddBoolToObject(root, "cpu_available", snap->cpu_available);
+
+    cJSON *heap = cJSON_CreateObject();
+    cJSON_AddNumberToObject(heap, "free", snap->heap.free);
+    cJSON_AddNumberToObject(heap, "min_free", snap->heap.min_free);
+    cJSON_AddNumberToObject(heap, "largest_block", snap->heap.largest_block);
+    cJSON_AddNumberToObject(heap, "total", snap->heap.total);
+    cJSON_AddItemToObject(root, "heap", heap);
+
+    cJSON *tasks = cJSON_CreateArray();
+    for (int i = 0; i < snap->count; i++) {
+        const task_stats_task_t *t = &snap->tasks[i];
+        cJSON *o = cJSON_CreateObject();
+        cJSON_AddStringToObject(o, "name", t->name);
+        cJSON_AddNumberToObject(o, "priority", t->priority);
+        cJSON_AddNumberToObject(o, "core", t->core);
+        cJSON_AddStringToObject(o, "state", task_state_to_string(t->state));
+        cJSON_AddNumberToObject(o, "stack_free_min", t->stack_free_min);
+        if (!isnan(t->cpu_percent)) {
+            cJSON_AddNumberToObject(o, "cpu_percent", roundf(t->cpu_percent * 100.0f) / 100.0f);
+        }
+        cJSON_AddItemToArray(tasks, o);
+    }
+    cJSON_AddItemToObject(root, "tasks", tasks);
+    free(snap);
+
+    const char *json_str = cJSON_PrintUnformatted(root);
+    httpd_resp_set_type(req, "application/json");
+    httpd_resp_send(req, json_str, strlen(json_str));
+    free((void *)json_str);
+    cJSON_Delete(root);
+    return ESP_OK;
+}
+
 // --- START SERVER ---
 esp_err_t start_web_server(void) {
     httpd_config_t config = HTTPD_DEFAULT_CONFIG();
-    config.max_uri_handlers = 15;
+    config.max_uri_handlers = 16;
     config.stack_size = 10240;
+    config.max_open_sockets = WEB_MAX_OPEN_SOCKETS;
 
     httpd_handle_t server = NULL;
 
     if (httpd_start(&server, &config) == ESP_OK) {
+        s_server = server;
         httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/", .method=HTTP_GET, .handler=root_get_handler});
         httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/style.css", .method=HTTP_GET, .handler=style_get_handler});
         httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/app.js", .method=HTTP_GET, .handler=app_js_get_handler});
@@ -332,6 +995,22 @@ esp_err_t start_web_server(void) {
 
         httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/schedule", .method=HTTP_GET, .handler=api_schedule_get_handler});
         httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/schedule", .method=HTTP_POST, .handler=api_schedule_post_handler});
+
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/history", .method=HTTP_GET, .handler=api_history_get_handler});
+
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/calibration", .method=HTTP_GET, .handler=api_calibration_get_handler});
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/calibration", .method=HTTP_POST, .handler=api_calibration_post_handler});
+
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/diag/loop", .method=HTTP_GET, .handler=api_diag_loop_get_handler});
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/diag/transitions", .method=HTTP_GET, .handler=api_diag_transitions_get_handler});
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/api/diag/tasks", .method=HTTP_GET, .handler=api_diag_tasks_get_handler});
+
+        httpd_register_uri_handler(server, &(httpd_uri_t){.uri="/ws", .method=HTTP_GET, .handler=ws_handler, .is_websocket=true});
+        if (xTaskCreate(ws_push_task, "ws_push_task", 6144, NULL, 5, &s_ws_task) == pdPASS) {
+            s_ws_bus = state_bus_subscribe("websocket", s_ws_task, 0);
+        } else {
+            ESP_LOGE(TAG, "Failed to create WebSocket push task");
+        }
         
         ESP_LOGI(TAG, "Web Server started!");
         return ESP_OK;
@@ -82,58 +82,79 @@ document.addEventListener('DOMContentLoaded', () => {
         } catch(e) { console.error("Temp set failed", e); }
     }
 
-    async function fetchStatus() {
-        try {
-            const res = await fetch(API_STATUS);
-            const data = await res.json();
-            
-            const elRoom = document.getElementById('temp-room');
-            if(elRoom && data.room_temp !== undefined) {
-                let t = data.room_temp;
-                if(t < -50 || t > 100) elRoom.innerText = "--";
-                else elRoom.innerText = t.toFixed(1);
-            }
+    function setConnectionBadge(online) {
+        const badge = document.getElementById('connection-status');
+        if(badge) {
+            badge.className = online ? "status-badge online" : "status-badge offline";
+            badge.innerText = online ? "Online" : "Offline";
+        }
+    }
 
-            const elOutside = document.getElementById('temp-outside');
-            if(elOutside && data.outside_temp !== undefined) {
-                let t = data.outside_temp;
-                if(t < -90) elOutside.innerText = "--"; 
-                else elOutside.innerText = t.toFixed(1);
-            }
+    function applyStatus(data) {
+        const elRoom = document.getElementById('temp-room');
+        if(elRoom && data.room_temp !== undefined) {
+            let t = data.room_temp;
+            if(t < -50 || t > 100) elRoom.innerText = "--";
+            else elRoom.innerText = t.toFixed(1);
+        }
 
-            const elSet = document.getElementById('current-setpoint');
-            if(elSet && data.current_setpoint !== undefined) {
-                elSet.innerText = data.current_setpoint.toFixed(1);
-            }
+        const elOutside = document.getElementById('temp-outside');
+        if(elOutside && data.outside_temp !== undefined) {
+            let t = data.outside_temp;
+            if(t < -90) elOutside.innerText = "--"; 
+            else elOutside.innerText = t.toFixed(1);
+        }
 
-            const elMode = document.getElementById('sys-mode');
-            if(elMode) elMode.innerText = data.state;
+        const elSet = document.getElementById('current-setpoint');
+        if(elSet && data.current_setpoint !== undefined) {
+            elSet.innerText = data.current_setpoint.toFixed(1);
+        }
 
-            const elHeat = document.getElementById('heater-state');
-            if(elHeat) {
-                elHeat.innerText = data.relay ? "ON" : "OFF";
-                elHeat.style.color = data.relay ? "#ff9800" : "#aaa";
-            }
-            
-            if (data.manual_setpoint && Math.abs(data.manual_setpoint - currentManualTemp) > 0.1) {
-                currentManualTemp = data.manual_setpoint;
-                updateManualTempDisplay();
-            }
-            
-            const badge = document.getElementById('connection-status');
-            if(badge) {
-                badge.className = "status-badge online";
-                badge.innerText = "Online";
-            }
+        const elMode = document.getElementById('sys-mode');
+        if(elMode) elMode.innerText = data.state;
+
+        const elHeat = document.getElementById('heater-state');
+        if(elHeat) {
+            elHeat.innerText = data.relay ? "ON" : "OFF";
+            elHeat.style.color = data.relay ? "#ff9800" : "#aaa";
+        }
+        
+        if (data.manual_setpoint && Math.abs(data.manual_setpoint - currentManualTemp) > 0.1) {
+            currentManualTemp = data.manual_setpoint;
+            updateManualTempDisplay();
+        }
+
+        setConnectionBadge(true);
+    }
+
+    async function fetchStatus() {
+        try {
+            const res = await fetch(API_STATUS);
+            applyStatus(await res.json());
         } catch (e) {
-            const badge = document.getElementById('connection-status');
-            if(badge) {
-                badge.className = "status-badge offline";
-                badge.innerText = "Offline";
-            }
+            setConnectionBadge(false);
         }
     }
 
+    // --- WebSocket: контролер сам надсилає стан після змін, опитування лише як запасний варіант ---
+    let statusSocket = null;
+
+    function connectStatusSocket() {
+        if (!('WebSocket' in window)) return;
+        statusSocket = new WebSocket(`ws://${location.host}/ws`);
+        statusSocket.onmessage = (ev) => {
+            try { applyStatus(JSON.parse(ev.data)); } catch (e) { console.error("Bad status message", e); }
+        };
+        statusSocket.onclose = () => {
+            statusSocket = null;
+            setTimeout(connectStatusSocket, 5000);
+        };
+    }
+
+    function socketOpen() {
+        return statusSocket !== null && statusSocket.readyState === WebSocket.OPEN;
+    }
+
     // ============================
     //         SETTINGS
     // ============================
@@ -154,6 +175,7 @@ document.addEventListener('DOMContentLoaded', () => {
             if(document.getElementById('mqtt_host')) document.getElementById('mqtt_host').value = cfg.mqtt.host || "";
             safeSetInput('mqtt_port', cfg.mqtt.port, 1883, 1, 65535, null);
             if(document.getElementById('mqtt_token')) document.getElementById('mqtt_token').value = cfg.mqtt.token || "";
+            safeSetInput('mqtt_diag_interval', cfg.mqtt.diag_interval_min, 0, 0, 1440, null);
 
             // Geo
             if(cfg.geo) {
@@ -206,7 +228,8 @@ document.addEventListener('DOMContentLoaded', () => {
                 mqtt: {
                     host: document.getElementById('mqtt_host').value,
                     port: getVal('mqtt_port', 'int'),
-                    token: document.getElementById('mqtt_token').value
+                    token: document.getElementById('mqtt_token').value,
+                    diag_interval_min: getVal('mqtt_diag_interval', 'int')
                 },
                 geo: {
                     lat: getVal('geo_lat', 'float'),
@@ -360,11 +383,12 @@ document.addEventListener('DOMContentLoaded', () => {
                 method: 'POST',
                 body: JSON.stringify({ action: 'set_mode', mode: btn.dataset.mode })
             });
-            setTimeout(fetchStatus, 200); 
+            if (!socketOpen()) setTimeout(fetchStatus, 200);
         });
     });
 
-    setInterval(fetchStatus, 2000);
+    setInterval(() => { if (!socketOpen()) fetchStatus(); }, 2000);
     fetchStatus();
+    connectStatusSocket();
     loadSettings();
 });
\ No newline at end of file
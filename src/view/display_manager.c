@@ -189,7 +189,7 @@ void render_info_screen(const char* ap_ssid, const char* ap_pass, const char* ip
     u8g2_SendBuffer(&u8g2);
 }
 
-void render_emergency_screen(int error_code) {
+void render_emergency_screen(int error_code, int error_sensor) {
     u8g2_ClearBuffer(&u8g2);
 
     u8g2_DrawXBM(&u8g2, 4, 20, 24, 24, image_alert_icon);
@@ -215,13 +215,29 @@ void render_emergency_screen(int error_code) {
         case 5:
             err_msg = "No Weather Data";
             break;
+        case 6:
+            err_msg = "Sensor Open";
+            break;
+        case 7:
+            err_msg = "Sensor Short";
+            break;
+        case 8:
+            err_msg = "Sensor Stuck";
+            break;
+        case 9:
+            err_msg = "Sensor Noisy";
+            break;
         default:
             err_msg = "System Fail";
             break;
     }
 
     char code_buf[16];
-    snprintf(code_buf, sizeof(code_buf), "Code: %d", error_code);
+    if (error_sensor >= 0) {
+        snprintf(code_buf, sizeof(code_buf), "Code: %d/S%d", error_code, error_sensor);
+    } else {
+        snprintf(code_buf, sizeof(code_buf), "Code: %d", error_code);
+    }
     
     u8g2_SetFont(&u8g2, u8g2_font_profont17_tr);
     u8g2_DrawStr(&u8g2, 36, 32, code_buf);
@@ -27,4 +27,4 @@ void render_main_screen(const main_screen_data_t* data);
 void render_mode_select_screen(system_state_t preview_state);
 void render_temperature_select_screen(float current_temp);
 void render_info_screen(const char* ap_ssid, const char* ap_pass, const char* ip_addr);
-void render_emergency_screen(int error_code);
\ No newline at end of file
+void render_emergency_screen(int error_code, int error_sensor);
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+/**
+ * @brief Керування хостовими підставками ESP-IDF/FreeRTOS з тестів.
+ *
+ * Час віртуальний: esp_timer_get_time(), xTaskGetTickCount() і time() показують
+ * його, а таймери esp_timer спрацьовують лише з host_run_until(). Завдання FreeRTOS -
+ * співпрограми, які тест просуває host_tasks_run() після зсуву часу.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <time.h>
+#include "esp_err.h"
+#include "driver/gpio.h"
+#include "hal/adc_types.h"
+
+/* ---- Віртуальний час ---- */
+
+// Скидає годинник: монотонний час у 0, а time() відраховується від epoch
+void host_clock_reset(time_t epoch);
+void host_clock_set_us(int64_t now_us);
+
+// Момент найближчого активного таймера esp_timer, -1 - таймерів немає
+int64_t host_timer_next_due_us(void);
+
+// Зсуває час до until_us, виконуючи колбеки таймерів у порядку їхніх моментів
+void host_run_until(int64_t until_us);
+
+// Зупиняє і забуває всі таймери (між тестами)
+void host_timers_reset(void);
+
+/* ---- Завдання ---- */
+
+// Один раз відновлює кожне завдання, час пробудження якого настав
+void host_tasks_run(void);
+
+// Знищує всі завдання без їх виконання (між тестами)
+void host_tasks_reset(void);
+
+/* ---- NVS ---- */
+
+void host_nvs_reset(void);
+
+/* ---- GPIO ---- */
+
+void host_gpio_reset(void);
+// Кількість переходів 0 -> 1 на виводі з моменту останнього скидання
+uint32_t host_gpio_rising_edges(gpio_num_t gpio_num);
+
+/* ---- АЦП ---- */
+
+typedef enum {
+    HOST_ADC_FAIL_NONE,
+    HOST_ADC_FAIL_NEW_HANDLE,
+    HOST_ADC_FAIL_CONFIG,
+    HOST_ADC_FAIL_START,
+} host_adc_fail_point_t;
+
+void host_adc_reset(void);
+
+// Код, який повертають oneshot-читання та DMA-кадри для каналу
+void host_adc_set_raw(adc_channel_t channel, int raw);
+
+// Помилка err на вказаному кроці запуску безперервного режиму (один раз)
+void host_adc_fail_continuous(host_adc_fail_point_t point, esp_err_t err);
+
+// Кількість активних дескрипторів безперервного режиму та oneshot-юнітів (перевірка витоків)
+int host_adc_open_continuous_handles(void);
+int host_adc_open_oneshot_units(void);
+
+// Характеристика калібрування: напруга на вході за кодом, мВ (лінійна апроксимація ESP32 при 12 дБ)
+int host_adc_raw_to_mv(int raw);
@@ -0,0 +1,6 @@
+#pragma once
+
+// Мінімальна конфігурація для хостових тестів: ціль ESP32, FreeRTOS на 100 Гц
+#define CONFIG_IDF_TARGET_ESP32 1
+#define CONFIG_FREERTOS_HZ 100
+#define CONFIG_FREERTOS_NUMBER_OF_CORES 1
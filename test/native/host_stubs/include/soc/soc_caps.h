@@ -0,0 +1,9 @@
+#pragma once
+
+// Можливості АЦП ESP32
+#define SOC_ADC_DIGI_RESULT_BYTES       2
+#define SOC_ADC_SAMPLE_FREQ_THRES_LOW   20000
+#define SOC_ADC_SAMPLE_FREQ_THRES_HIGH  2000000
+#define SOC_ADC_PATT_LEN_MAX            16
+#define SOC_ADC_DIGI_MAX_BITWIDTH       12
+#define SOC_ADC_MAX_CHANNEL_NUM         10
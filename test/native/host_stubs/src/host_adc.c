@@ -0,0 +1,204 @@
+/**
+ * АЦП на хості: oneshot повертає задані коди, безперервний режим заповнює кадри
+ * за таблицею сканування так само, як DMA (формат TYPE1 для ESP32).
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "esp_adc/adc_oneshot.h"
+#include "esp_adc/adc_continuous.h"
+#include "esp_adc/adc_cali_scheme.h"
+#include "host_stubs.h"
+
+struct adc_oneshot_unit_ctx_t {
+    adc_unit_t unit;
+};
+
+struct adc_continuous_ctx_t {
+    uint32_t frame_size;
+    adc_digi_pattern_config_t pattern[SOC_ADC_PATT_LEN_MAX];
+    uint32_t pattern_num;
+    uint32_t next;          // Позиція у таблиці сканування для наступної вибірки
+    bool configured;
+    bool started;
+};
+
+struct adc_cali_scheme_t {
+    adc_atten_t atten;
+};
+
+static int s_raw[SOC_ADC_MAX_CHANNEL_NUM];
+static host_adc_fail_point_t s_fail_point = HOST_ADC_FAIL_NONE;
+static esp_err_t s_fail_err = ESP_OK;
+static int s_open_continuous = 0;
+static int s_open_oneshot = 0;
+
+void host_adc_reset(void) {
+    memset(s_raw, 0, sizeof(s_raw));
+    s_fail_point = HOST_ADC_FAIL_NONE;
+    s_fail_err = ESP_OK;
+}
+
+void host_adc_set_raw(adc_channel_t channel, int raw) {
+    if ((int)channel >= 0 && channel < SOC_ADC_MAX_CHANNEL_NUM) s_raw[channel] = raw;
+}
+
+void host_adc_fail_continuous(host_adc_fail_point_t point, esp_err_t err) {
+    s_fail_point = point;
+    s_fail_err = err;
+}
+
+int host_adc_open_continuous_handles(void) {
+    return s_open_continuous;
+}
+
+int host_adc_open_oneshot_units(void) {
+    return s_open_oneshot;
+}
+
+static esp_err_t take_failure(host_adc_fail_point_t point) {
+    if (s_fail_point != point) return ESP_OK;
+    s_fail_point = HOST_ADC_FAIL_NONE;
+    return s_fail_err;
+}
+
+/* ---- Oneshot ---- */
+
+esp_err_t adc_oneshot_new_unit(const adc_oneshot_unit_init_cfg_t *init_config, adc_oneshot_unit_handle_t *ret_unit) {
+    if (init_config == NULL || ret_unit == NULL) return ESP_ERR_INVALID_ARG;
+    // Як і драйвер IDF: юніт не можна взяти двічі
+    if (s_open_oneshot > 0 || s_open_continuous > 0) return ESP_ERR_NOT_FOUND;
+    struct adc_oneshot_unit_ctx_t *u = calloc(1, sizeof(*u));
+    if (u == NULL) return ESP_ERR_NO_MEM;
+    u->unit = init_config->unit_id;
+    s_open_oneshot++;
+    *ret_unit = u;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_config_channel(adc_oneshot_unit_handle_t handle, adc_channel_t channel, const adc_oneshot_chan_cfg_t *config) {
+    if (handle == NULL || config == NULL || channel >= SOC_ADC_MAX_CHANNEL_NUM) return ESP_ERR_INVALID_ARG;
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_read(adc_oneshot_unit_handle_t handle, adc_channel_t chan, int *out_raw) {
+    if (handle == NULL || out_raw == NULL || chan >= SOC_ADC_MAX_CHANNEL_NUM) return ESP_ERR_INVALID_ARG;
+    *out_raw = s_raw[chan];
+    return ESP_OK;
+}
+
+esp_err_t adc_oneshot_del_unit(adc_oneshot_unit_handle_t handle) {
+    if (handle == NULL) return ESP_ERR_INVALID_ARG;
+    free(handle);
+    s_open_oneshot--;
+    return ESP_OK;
+}
+
+/* ---- Безперервний режим ---- */
+
+esp_err_t adc_continuous_new_handle(const adc_continuous_handle_cfg_t *hdl_config, adc_continuous_handle_t *ret_handle) {
+    if (hdl_config == NULL || ret_handle == NULL) return ESP_ERR_INVALID_ARG;
+    if (hdl_config->conv_frame_size % SOC_ADC_DIGI_RESULT_BYTES != 0) return ESP_ERR_INVALID_SIZE;
+    esp_err_t err = take_failure(HOST_ADC_FAIL_NEW_HANDLE);
+    if (err != ESP_OK) return err;
+    if (s_open_oneshot > 0 || s_open_continuous > 0) return ESP_ERR_NOT_FOUND;
+
+    struct adc_continuous_ctx_t *h = calloc(1, sizeof(*h));
+    if (h == NULL) return ESP_ERR_NO_MEM;
+    h->frame_size = hdl_config->conv_frame_size;
+    s_open_continuous++;
+    *ret_handle = h;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_config(adc_continuous_handle_t handle, const adc_continuous_config_t *config) {
+    if (handle == NULL || config == NULL) return ESP_ERR_INVALID_ARG;
+    if (handle->started) return ESP_ERR_INVALID_STATE;
+    if (config->pattern_num == 0 || config->pattern_num > SOC_ADC_PATT_LEN_MAX) return ESP_ERR_INVALID_ARG;
+    if (config->sample_freq_hz < SOC_ADC_SAMPLE_FREQ_THRES_LOW || config->sample_freq_hz > SOC_ADC_SAMPLE_FREQ_THRES_HIGH) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (config->format != ADC_DIGI_OUTPUT_FORMAT_TYPE1) return ESP_ERR_INVALID_ARG;
+    esp_err_t err = take_failure(HOST_ADC_FAIL_CONFIG);
+    if (err != ESP_OK) return err;
+
+    memcpy(handle->pattern, config->adc_pattern, config->pattern_num * sizeof(adc_digi_pattern_config_t));
+    handle->pattern_num = config->pattern_num;
+    handle->next = 0;
+    handle->configured = true;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_start(adc_continuous_handle_t handle) {
+    if (handle == NULL) return ESP_ERR_INVALID_ARG;
+    if (!handle->configured || handle->started) return ESP_ERR_INVALID_STATE;
+    esp_err_t err = take_failure(HOST_ADC_FAIL_START);
+    if (err != ESP_OK) return err;
+    handle->started = true;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_stop(adc_continuous_handle_t handle) {
+    if (handle == NULL) return ESP_ERR_INVALID_ARG;
+    if (!handle->started) return ESP_ERR_INVALID_STATE;
+    handle->started = false;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_flush_pool(adc_continuous_handle_t handle) {
+    if (handle == NULL) return ESP_ERR_INVALID_ARG;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_read(adc_continuous_handle_t handle, uint8_t *buf, uint32_t length_max,
+                              uint32_t *out_length, uint32_t timeout_ms) {
+    (void)timeout_ms;
+    if (handle == NULL || buf == NULL || out_length == NULL) return ESP_ERR_INVALID_ARG;
+    if (!handle->started) return ESP_ERR_TIMEOUT;
+
+    // Кадр DMA: вибірки йдуть по колу таблиці сканування, у каналі - 3 біти, як у шаблоні
+    uint32_t len = length_max < handle->frame_size ? length_max : handle->frame_size;
+    len -= len % SOC_ADC_DIGI_RESULT_BYTES;
+    for (uint32_t i = 0; i < len; i += SOC_ADC_DIGI_RESULT_BYTES) {
+        const adc_digi_pattern_config_t *p = &handle->pattern[handle->next];
+        handle->next = (handle->next + 1) % handle->pattern_num;
+        adc_digi_output_data_t d = { .type1 = { .data = (uint16_t)(s_raw[p->channel] & 0xFFF), .channel = p->channel } };
+        memcpy(&buf[i], &d, SOC_ADC_DIGI_RESULT_BYTES);
+    }
+    *out_length = len;
+    return ESP_OK;
+}
+
+esp_err_t adc_continuous_deinit(adc_continuous_handle_t handle) {
+    if (handle == NULL) return ESP_ERR_INVALID_ARG;
+    if (handle->started) return ESP_ERR_INVALID_STATE;
+    free(handle);
+    s_open_continuous--;
+    return ESP_OK;
+}
+
+/* ---- Калібрування ---- */
+
+int host_adc_raw_to_mv(int raw) {
+    // Лінійна характеристика ESP32 при 12 дБ: 142..3139 мВ на 0..4095
+    return 142 + (raw * (3139 - 142) + 2047) / 4095;
+}
+
+esp_err_t adc_cali_create_scheme_line_fitting(const adc_cali_line_fitting_config_t *config, adc_cali_handle_t *ret_handle) {
+    if (config == NULL || ret_handle == NULL) return ESP_ERR_INVALID_ARG;
+    struct adc_cali_scheme_t *c = calloc(1, sizeof(*c));
+    if (c == NULL) return ESP_ERR_NO_MEM;
+    c->atten = config->atten;
+    *ret_handle = c;
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_delete_scheme_line_fitting(adc_cali_handle_t handle) {
+    free(handle);
+    return ESP_OK;
+}
+
+esp_err_t adc_cali_raw_to_voltage(adc_cali_handle_t handle, int raw, int *voltage) {
+    if (handle == NULL || voltage == NULL || raw < 0) return ESP_ERR_INVALID_ARG;
+    *voltage = host_adc_raw_to_mv(raw);
+    return ESP_OK;
+}
@@ -0,0 +1,124 @@
+// Віртуальний час і таймери esp_timer
+#include <stdlib.h>
+#include <time.h>
+#include "esp_timer.h"
+#include "host_stubs.h"
+
+#define HOST_MAX_TIMERS 32
+
+struct esp_timer {
+    esp_timer_cb_t callback;
+    void *arg;
+    int64_t due_us;     // -1 - не запущений
+    uint64_t period_us; // 0 - одноразовий
+    bool used;
+};
+
+static struct esp_timer s_timers[HOST_MAX_TIMERS];
+static int64_t s_now_us = 0;
+static time_t s_epoch = 0;
+
+void host_clock_reset(time_t epoch) {
+    s_now_us = 0;
+    s_epoch = epoch;
+}
+
+void host_clock_set_us(int64_t now_us) {
+    s_now_us = now_us;
+}
+
+int64_t esp_timer_get_time(void) {
+    return s_now_us;
+}
+
+// Заміщує time() з libc, щоб розклад і календар бачили віртуальний час
+time_t time(time_t *out) {
+    time_t now = s_epoch + (time_t)(s_now_us / 1000000);
+    if (out) *out = now;
+    return now;
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle) {
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) return ESP_ERR_INVALID_ARG;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        if (!s_timers[i].used) {
+            s_timers[i] = (struct esp_timer){
+                .callback = create_args->callback,
+                .arg = create_args->arg,
+                .due_us = -1,
+                .used = true,
+            };
+            *out_handle = &s_timers[i];
+            return ESP_OK;
+        }
+    }
+    return ESP_ERR_NO_MEM;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us) {
+    if (timer == NULL) return ESP_ERR_INVALID_ARG;
+    if (timer->due_us >= 0) return ESP_ERR_INVALID_STATE;
+    timer->due_us = s_now_us + (int64_t)timeout_us;
+    timer->period_us = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t period) {
+    if (timer == NULL || period == 0) return ESP_ERR_INVALID_ARG;
+    if (timer->due_us >= 0) return ESP_ERR_INVALID_STATE;
+    timer->due_us = s_now_us + (int64_t)period;
+    timer->period_us = period;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+    if (timer == NULL) return ESP_ERR_INVALID_ARG;
+    if (timer->due_us < 0) return ESP_ERR_INVALID_STATE;
+    timer->due_us = -1;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+    if (timer == NULL) return ESP_ERR_INVALID_ARG;
+    if (timer->due_us >= 0) return ESP_ERR_INVALID_STATE;
+    timer->used = false;
+    return ESP_OK;
+}
+
+bool esp_timer_is_active(esp_timer_handle_t timer) {
+    return timer != NULL && timer->due_us >= 0;
+}
+
+static struct esp_timer *next_timer(void) {
+    struct esp_timer *next = NULL;
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        struct esp_timer *t = &s_timers[i];
+        if (t->used && t->due_us >= 0 && (next == NULL || t->due_us < next->due_us)) next = t;
+    }
+    return next;
+}
+
+int64_t host_timer_next_due_us(void) {
+    struct esp_timer *t = next_timer();
+    return t ? t->due_us : -1;
+}
+
+void host_run_until(int64_t until_us) {
+    for (;;) {
+        struct esp_timer *t = next_timer();
+        if (t == NULL || t->due_us > until_us) break;
+
+        if (t->due_us > s_now_us) s_now_us = t->due_us;
+        // Колбек може перезапустити свій таймер, тому стан змінюється до виклику
+        t->due_us = t->period_us ? t->due_us + (int64_t)t->period_us : -1;
+        t->callback(t->arg);
+    }
+    if (until_us > s_now_us) s_now_us = until_us;
+}
+
+void host_timers_reset(void) {
+    for (int i = 0; i < HOST_MAX_TIMERS; i++) {
+        s_timers[i].used = false;
+        s_timers[i].due_us = -1;
+    }
+}
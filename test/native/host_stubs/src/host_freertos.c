@@ -0,0 +1,340 @@
+// FreeRTOS на хості: завдання-співпрограми, сповіщення, семафори та критичні секції
+#include <errno.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <ucontext.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
+#include "host_stubs.h"
+
+#define HOST_MAX_TASKS       8
+#define HOST_TASK_STACK_SIZE (256 * 1024)
+#define HOST_TICK_US         (1000000LL / configTICK_RATE_HZ)
+#define HOST_WAKE_NEVER      INT64_MAX
+
+struct tskTaskControlBlock {
+    ucontext_t ctx;
+    void *stack;
+    TaskFunction_t fn;
+    void *arg;
+    char name[16];
+    bool alive;
+    int64_t wake_us;        // З цього моменту завдання можна відновити
+    bool waiting_notify;
+    bool notify_pending;
+    uint32_t notify_value;
+};
+
+static struct tskTaskControlBlock s_tasks[HOST_MAX_TASKS];
+// Дескриптор для коду тесту поза завданнями: на нього можна підписатись і його можна сповістити
+static struct tskTaskControlBlock s_main_task = { .name = "main", .alive = true };
+static __thread struct tskTaskControlBlock *s_current = NULL;
+static ucontext_t s_main_ctx;
+// Сповіщення можуть надходити з потоків стрес-тестів
+static pthread_mutex_t s_notify_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/* ---- Критичні секції ---- */
+
+void vPortEnterCritical(portMUX_TYPE *mux) {
+    while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) {
+        while (__atomic_load_n(&mux->locked, __ATOMIC_RELAXED)) sched_yield();
+    }
+}
+
+void vPortExitCritical(portMUX_TYPE *mux) {
+    __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+}
+
+/* ---- Завдання ---- */
+
+static void task_trampoline(int index) {
+    struct tskTaskControlBlock *t = &s_tasks[index];
+    t->fn(t->arg);
+    // Завдання FreeRTOS не повертаються; на хості повернення рівнозначне vTaskDelete(NULL)
+    vTaskDelete(NULL);
+}
+
+static void task_free(struct tskTaskControlBlock *t) {
+    free(t->stack);
+    t->stack = NULL;
+}
+
+// Повертає керування тесту; завдання продовжиться, коли настане wake_us
+static void task_block(int64_t wake_us) {
+    struct tskTaskControlBlock *t = s_current;
+    t->wake_us = wake_us;
+    swapcontext(&t->ctx, &s_main_ctx);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth,
+                                   void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask,
+                                   BaseType_t xCoreID) {
+    (void)usStackDepth;
+    (void)uxPriority;
+    (void)xCoreID;
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        struct tskTaskControlBlock *t = &s_tasks[i];
+        if (t->alive || t->stack != NULL) continue;
+
+        memset(t, 0, sizeof(*t));
+        t->stack = malloc(HOST_TASK_STACK_SIZE);
+        if (t->stack == NULL) return pdFAIL;
+        t->fn = pvTaskCode;
+        t->arg = pvParameters;
+        strncpy(t->name, pcName ? pcName : "", sizeof(t->name) - 1);
+        t->alive = true;
+        t->wake_us = esp_timer_get_time();
+
+        getcontext(&t->ctx);
+        t->ctx.uc_stack.ss_sp = t->stack;
+        t->ctx.uc_stack.ss_size = HOST_TASK_STACK_SIZE;
+        t->ctx.uc_link = NULL;
+        makecontext(&t->ctx, (void (*)(void))task_trampoline, 1, i);
+
+        if (pvCreatedTask) *pvCreatedTask = t;
+        return pdPASS;
+    }
+    return pdFAIL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t pvTaskCode, const char *pcName, uint32_t usStackDepth,
+                       void *pvParameters, UBaseType_t uxPriority, TaskHandle_t *pvCreatedTask) {
+    return xTaskCreatePinnedToCore(pvTaskCode, pcName, usStackDepth, pvParameters, uxPriority,
+                                   pvCreatedTask, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t xTaskToDelete) {
+    struct tskTaskControlBlock *t = xTaskToDelete ? xTaskToDelete : s_current;
+    if (t == NULL || t == &s_main_task) abort();
+
+    t->alive = false;
+    if (t == s_current) {
+        // Стек звільнить host_tasks_run(), коли виконання повернеться з нього
+        swapcontext(&t->ctx, &s_main_ctx);
+        abort();
+    }
+    task_free(t);
+}
+
+void vTaskDelay(TickType_t xTicksToDelay) {
+    int64_t wake_us = esp_timer_get_time() + (int64_t)xTicksToDelay * HOST_TICK_US;
+    if (s_current != NULL) {
+        task_block(wake_us);
+        return;
+    }
+    // Затримка в коді тесту: час іде, завдання і таймери виконуються
+    host_run_until(wake_us);
+    host_tasks_run();
+}
+
+BaseType_t xTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement) {
+    *pxPreviousWakeTime += xTimeIncrement;
+    int64_t wake_us = (int64_t)*pxPreviousWakeTime * HOST_TICK_US;
+    if (wake_us <= esp_timer_get_time()) return pdFALSE;
+
+    if (s_current != NULL) {
+        task_block(wake_us);
+    } else {
+        host_run_until(wake_us);
+        host_tasks_run();
+    }
+    return pdTRUE;
+}
+
+void vTaskDelayUntil(TickType_t *pxPreviousWakeTime, TickType_t xTimeIncrement) {
+    (void)xTaskDelayUntil(pxPreviousWakeTime, xTimeIncrement);
+}
+
+TickType_t xTaskGetTickCount(void) {
+    return (TickType_t)(esp_timer_get_time() / HOST_TICK_US);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+    return s_current ? s_current : &s_main_task;
+}
+
+const char *pcTaskGetName(TaskHandle_t xTaskToQuery) {
+    struct tskTaskControlBlock *t = xTaskToQuery ? xTaskToQuery : xTaskGetCurrentTaskHandle();
+    return t->name;
+}
+
+void host_tasks_run(void) {
+    int64_t now = esp_timer_get_time();
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        struct tskTaskControlBlock *t = &s_tasks[i];
+        if (!t->alive || t->wake_us > now) continue;
+
+        s_current = t;
+        swapcontext(&s_main_ctx, &t->ctx);
+        s_current = NULL;
+        if (!t->alive) task_free(t);
+    }
+}
+
+void host_tasks_reset(void) {
+    for (int i = 0; i < HOST_MAX_TASKS; i++) {
+        s_tasks[i].alive = false;
+        task_free(&s_tasks[i]);
+    }
+    pthread_mutex_lock(&s_notify_lock);
+    s_main_task.notify_pending = false;
+    s_main_task.notify_value = 0;
+    pthread_mutex_unlock(&s_notify_lock);
+}
+
+/* ---- Сповіщення ---- */
+
+BaseType_t xTaskNotify(TaskHandle_t xTaskToNotify, uint32_t ulValue, eNotifyAction eAction) {
+    struct tskTaskControlBlock *t = xTaskToNotify;
+    BaseType_t ret = pdPASS;
+
+    pthread_mutex_lock(&s_notify_lock);
+    switch (eAction) {
+    case eSetBits:                  t->notify_value |= ulValue; break;
+    case eIncrement:                t->notify_value++; break;
+    case eSetValueWithOverwrite:    t->notify_value = ulValue; break;
+    case eSetValueWithoutOverwrite:
+        if (t->notify_pending) ret = pdFAIL;
+        else t->notify_value = ulValue;
+        break;
+    default: break;
+    }
+    t->notify_pending = true;
+    if (t->waiting_notify) t->wake_us = esp_timer_get_time();
+    pthread_mutex_unlock(&s_notify_lock);
+    return ret;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t xTaskToNotify) {
+    return xTaskNotify(xTaskToNotify, 0, eIncrement);
+}
+
+// Чекає сповіщення; код тесту поза завданнями не блокується
+static bool notify_wait(struct tskTaskControlBlock *t, TickType_t xTicksToWait) {
+    pthread_mutex_lock(&s_notify_lock);
+    bool pending = t->notify_pending;
+    if (!pending && xTicksToWait > 0 && t == s_current) {
+        t->waiting_notify = true;
+        pthread_mutex_unlock(&s_notify_lock);
+        task_block(xTicksToWait == portMAX_DELAY ? HOST_WAKE_NEVER
+                                                 : esp_timer_get_time() + (int64_t)xTicksToWait * HOST_TICK_US);
+        pthread_mutex_lock(&s_notify_lock);
+        t->waiting_notify = false;
+        pending = t->notify_pending;
+    }
+    pthread_mutex_unlock(&s_notify_lock);
+    return pending;
+}
+
+BaseType_t xTaskNotifyWait(uint32_t ulBitsToClearOnEntry, uint32_t ulBitsToClearOnExit,
+                           uint32_t *pulNotificationValue, TickType_t xTicksToWait) {
+    struct tskTaskControlBlock *t = xTaskGetCurrentTaskHandle();
+
+    pthread_mutex_lock(&s_notify_lock);
+    if (!t->notify_pending) t->notify_value &= ~ulBitsToClearOnEntry;
+    pthread_mutex_unlock(&s_notify_lock);
+
+    bool got = notify_wait(t, xTicksToWait);
+
+    pthread_mutex_lock(&s_notify_lock);
+    if (pulNotificationValue) *pulNotificationValue = t->notify_value;
+    if (got) {
+        t->notify_pending = false;
+        t->notify_value &= ~ulBitsToClearOnExit;
+    }
+    pthread_mutex_unlock(&s_notify_lock);
+    return got ? pdTRUE : pdFALSE;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t xClearCountOnExit, TickType_t xTicksToWait) {
+    struct tskTaskControlBlock *t = xTaskGetCurrentTaskHandle();
+    if (t->notify_value == 0) notify_wait(t, xTicksToWait);
+
+    pthread_mutex_lock(&s_notify_lock);
+    uint32_t value = t->notify_value;
+    if (value != 0) t->notify_value = xClearCountOnExit ? 0 : value - 1;
+    t->notify_pending = t->notify_value != 0;
+    pthread_mutex_unlock(&s_notify_lock);
+    return value;
+}
+
+/* ---- Семафори ---- */
+
+struct QueueDefinition {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    UBaseType_t count;
+    UBaseType_t max_count;
+};
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t uxMaxCount, UBaseType_t uxInitialCount) {
+    struct QueueDefinition *s = calloc(1, sizeof(*s));
+    if (s == NULL) return NULL;
+    pthread_mutex_init(&s->lock, NULL);
+    pthread_cond_init(&s->cond, NULL);
+    s->count = uxInitialCount;
+    s->max_count = uxMaxCount;
+    return s;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+    return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+    return xSemaphoreCreateCounting(1, 0);
+}
+
+/**
+ * Очікування - у реальному часі: віртуальний час стоїть, поки тест чекає.
+ * Завдання-співпрограми не перемикаються, утримуючи семафор, тож у межах
+ * одного потоку очікування завжди завершується одразу.
+ */
+BaseType_t xSemaphoreTake(SemaphoreHandle_t xSemaphore, TickType_t xBlockTime) {
+    struct QueueDefinition *s = xSemaphore;
+    struct timespec deadline;
+    if (xBlockTime != portMAX_DELAY) {
+        clock_gettime(CLOCK_REALTIME, &deadline);
+        int64_t ns = deadline.tv_nsec + (int64_t)xBlockTime * HOST_TICK_US * 1000;
+        deadline.tv_sec += ns / 1000000000;
+        deadline.tv_nsec = ns % 1000000000;
+    }
+
+    pthread_mutex_lock(&s->lock);
+    while (s->count == 0) {
+        if (xBlockTime == portMAX_DELAY) {
+            pthread_cond_wait(&s->cond, &s->lock);
+        } else if (pthread_cond_timedwait(&s->cond, &s->lock, &deadline) == ETIMEDOUT) {
+            break;
+        }
+    }
+    bool taken = s->count > 0;
+    if (taken) s->count--;
+    pthread_mutex_unlock(&s->lock);
+    return taken ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t xSemaphore) {
+    struct QueueDefinition *s = xSemaphore;
+    pthread_mutex_lock(&s->lock);
+    bool given = s->count < s->max_count;
+    if (given) {
+        s->count++;
+        pthread_cond_signal(&s->cond);
+    }
+    pthread_mutex_unlock(&s->lock);
+    return given ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t xSemaphore) {
+    struct QueueDefinition *s = xSemaphore;
+    if (s == NULL) return;
+    pthread_cond_destroy(&s->cond);
+    pthread_mutex_destroy(&s->lock);
+    free(s);
+}
@@ -0,0 +1,42 @@
+// GPIO на хості: запам'ятовує рівні виходів і рахує фронти для перевірки реле
+#include <string.h>
+#include "driver/gpio.h"
+#include "host_stubs.h"
+
+static uint8_t s_level[GPIO_NUM_MAX];
+static uint32_t s_rising[GPIO_NUM_MAX];
+
+void host_gpio_reset(void) {
+    memset(s_level, 0, sizeof(s_level));
+    memset(s_rising, 0, sizeof(s_rising));
+}
+
+uint32_t host_gpio_rising_edges(gpio_num_t gpio_num) {
+    return GPIO_IS_VALID_GPIO(gpio_num) ? s_rising[gpio_num] : 0;
+}
+
+esp_err_t gpio_reset_pin(gpio_num_t gpio_num) {
+    if (!GPIO_IS_VALID_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+    s_level[gpio_num] = 0;
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_direction(gpio_num_t gpio_num, gpio_mode_t mode) {
+    if (!GPIO_IS_VALID_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+    if ((mode == GPIO_MODE_OUTPUT || mode == GPIO_MODE_INPUT_OUTPUT) && !GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    return ESP_OK;
+}
+
+esp_err_t gpio_set_level(gpio_num_t gpio_num, uint32_t level) {
+    if (!GPIO_IS_VALID_OUTPUT_GPIO(gpio_num)) return ESP_ERR_INVALID_ARG;
+    uint8_t v = level ? 1 : 0;
+    if (v && !s_level[gpio_num]) s_rising[gpio_num]++;
+    s_level[gpio_num] = v;
+    return ESP_OK;
+}
+
+int gpio_get_level(gpio_num_t gpio_num) {
+    return GPIO_IS_VALID_GPIO(gpio_num) ? s_level[gpio_num] : 0;
+}
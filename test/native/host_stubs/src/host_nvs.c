@@ -0,0 +1,161 @@
+// NVS у пам'яті: простори імен і ключі без обмежень сторінок флешу
+#include <stdlib.h>
+#include <string.h>
+#include "nvs.h"
+#include "nvs_flash.h"
+#include "host_stubs.h"
+
+#define HOST_NVS_MAX_NAMESPACES 16
+#define HOST_NVS_MAX_ENTRIES    128
+#define HOST_NVS_KEY_MAX        16
+
+typedef struct {
+    int ns;
+    char key[HOST_NVS_KEY_MAX];
+    void *data;
+    size_t size;
+} nvs_entry_t;
+
+static char s_namespaces[HOST_NVS_MAX_NAMESPACES][HOST_NVS_KEY_MAX];
+static int s_namespace_count = 0;
+static nvs_entry_t s_entries[HOST_NVS_MAX_ENTRIES];
+static int s_entry_count = 0;
+
+// Дескриптор: індекс простору + 1, старший біт - лише читання
+#define HANDLE_READONLY 0x80000000u
+
+void host_nvs_reset(void) {
+    for (int i = 0; i < s_entry_count; i++) free(s_entries[i].data);
+    s_entry_count = 0;
+    s_namespace_count = 0;
+}
+
+esp_err_t nvs_flash_init(void) { return ESP_OK; }
+
+esp_err_t nvs_flash_erase(void) {
+    host_nvs_reset();
+    return ESP_OK;
+}
+
+esp_err_t nvs_open(const char *namespace_name, nvs_open_mode_t open_mode, nvs_handle_t *out_handle) {
+    if (namespace_name == NULL || out_handle == NULL || strlen(namespace_name) >= HOST_NVS_KEY_MAX) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    int ns = -1;
+    for (int i = 0; i < s_namespace_count; i++) {
+        if (strcmp(s_namespaces[i], namespace_name) == 0) ns = i;
+    }
+    if (ns < 0) {
+        // Як і на пристрої, простір створюється лише відкриттям на запис
+        if (open_mode == NVS_READONLY) return ESP_ERR_NVS_NOT_FOUND;
+        if (s_namespace_count >= HOST_NVS_MAX_NAMESPACES) return ESP_ERR_NVS_NO_FREE_PAGES;
+        ns = s_namespace_count++;
+        strcpy(s_namespaces[ns], namespace_name);
+    }
+    *out_handle = (nvs_handle_t)(ns + 1) | (open_mode == NVS_READONLY ? HANDLE_READONLY : 0);
+    return ESP_OK;
+}
+
+void nvs_close(nvs_handle_t handle) { (void)handle; }
+
+esp_err_t nvs_commit(nvs_handle_t handle) {
+    return (handle & ~HANDLE_READONLY) ? ESP_OK : ESP_ERR_NVS_INVALID_HANDLE;
+}
+
+static nvs_entry_t *find_entry(int ns, const char *key) {
+    for (int i = 0; i < s_entry_count; i++) {
+        if (s_entries[i].ns == ns && strcmp(s_entries[i].key, key) == 0) return &s_entries[i];
+    }
+    return NULL;
+}
+
+static esp_err_t set_value(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+    int ns = (int)(handle & ~HANDLE_READONLY) - 1;
+    if (ns < 0 || ns >= s_namespace_count) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (handle & HANDLE_READONLY) return ESP_ERR_NVS_READ_ONLY;
+    if (key == NULL || strlen(key) >= HOST_NVS_KEY_MAX) return ESP_ERR_INVALID_ARG;
+
+    nvs_entry_t *e = find_entry(ns, key);
+    if (e == NULL) {
+        if (s_entry_count >= HOST_NVS_MAX_ENTRIES) return ESP_ERR_NVS_NO_FREE_PAGES;
+        e = &s_entries[s_entry_count++];
+        e->ns = ns;
+        strcpy(e->key, key);
+        e->data = NULL;
+    }
+    void *copy = malloc(length ? length : 1);
+    if (copy == NULL) return ESP_ERR_NO_MEM;
+    memcpy(copy, value, length);
+    free(e->data);
+    e->data = copy;
+    e->size = length;
+    return ESP_OK;
+}
+
+static esp_err_t get_value(nvs_handle_t handle, const char *key, void *out_value, size_t *length, bool exact) {
+    int ns = (int)(handle & ~HANDLE_READONLY) - 1;
+    if (ns < 0 || ns >= s_namespace_count) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (key == NULL || length == NULL) return ESP_ERR_INVALID_ARG;
+
+    nvs_entry_t *e = find_entry(ns, key);
+    if (e == NULL) return ESP_ERR_NVS_NOT_FOUND;
+    if (out_value == NULL) {
+        *length = e->size;
+        return ESP_OK;
+    }
+    if (exact ? *length != e->size : *length < e->size) {
+        *length = e->size;
+        return ESP_ERR_NVS_INVALID_LENGTH;
+    }
+    memcpy(out_value, e->data, e->size);
+    *length = e->size;
+    return ESP_OK;
+}
+
+esp_err_t nvs_set_blob(nvs_handle_t handle, const char *key, const void *value, size_t length) {
+    return set_value(handle, key, value, length);
+}
+
+esp_err_t nvs_get_blob(nvs_handle_t handle, const char *key, void *out_value, size_t *length) {
+    return get_value(handle, key, out_value, length, false);
+}
+
+#define HOST_NVS_SCALAR(suffix, type)                                                   \
+    esp_err_t nvs_set_##suffix(nvs_handle_t handle, const char *key, type value) {      \
+        return set_value(handle, key, &value, sizeof(value));                           \
+    }                                                                                   \
+    esp_err_t nvs_get_##suffix(nvs_handle_t handle, const char *key, type *out_value) { \
+        size_t length = sizeof(*out_value);                                             \
+        if (out_value == NULL) return ESP_ERR_INVALID_ARG;                              \
+        return get_value(handle, key, out_value, &length, true);                        \
+    }
+
+HOST_NVS_SCALAR(u8, uint8_t)
+HOST_NVS_SCALAR(u32, uint32_t)
+HOST_NVS_SCALAR(i64, int64_t)
+
+esp_err_t nvs_erase_key(nvs_handle_t handle, const char *key) {
+    int ns = (int)(handle & ~HANDLE_READONLY) - 1;
+    if (ns < 0 || ns >= s_namespace_count) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (handle & HANDLE_READONLY) return ESP_ERR_NVS_READ_ONLY;
+
+    nvs_entry_t *e = find_entry(ns, key);
+    if (e == NULL) return ESP_ERR_NVS_NOT_FOUND;
+    free(e->data);
+    *e = s_entries[--s_entry_count];
+    return ESP_OK;
+}
+
+esp_err_t nvs_erase_all(nvs_handle_t handle) {
+    int ns = (int)(handle & ~HANDLE_READONLY) - 1;
+    if (ns < 0 || ns >= s_namespace_count) return ESP_ERR_NVS_INVALID_HANDLE;
+    if (handle & HANDLE_READONLY) return ESP_ERR_NVS_READ_ONLY;
+
+    for (int i = s_entry_count - 1; i >= 0; i--) {
+        if (s_entries[i].ns == ns) {
+            free(s_entries[i].data);
+            s_entries[i] = s_entries[--s_entry_count];
+        }
+    }
+    return ESP_OK;
+}
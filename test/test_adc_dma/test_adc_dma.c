@@ -0,0 +1,150 @@
+/**
+ * @brief Безперервний режим АЦП на хості: розбір DMA-блоків з явною відповідністю
+ * каналів слотам, кадри від підставного DMA та повернення в oneshot після збою запуску.
+ */
+#include <string.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "drivers/sensor/temp_sensor_driver.h"
+
+static const ntc_thermistor_config_t s_ntc = {
+    .nominal_resistance = 10000.0f,
+    .nominal_temperature_c = 25.0f,
+    .b_value = 3950.0f,
+    .fixed_resistor_ohms = 10000.0f,
+};
+
+static ntc_sensor_handle_t s_room;
+static ntc_sensor_handle_t s_radiator;
+
+// Вибірка у форматі TYPE1 (ESP32): 12 біт даних і 4 біти каналу
+static void put_sample(uint8_t *buf, int index, int channel, int raw) {
+    adc_digi_output_data_t d = { .type1 = { .data = (uint16_t)raw, .channel = (uint16_t)channel } };
+    memcpy(&buf[index * SOC_ADC_DIGI_RESULT_BYTES], &d, SOC_ADC_DIGI_RESULT_BYTES);
+}
+
+static void frame_clear(ntc_adc_frame_t *frame) {
+    memset(frame, 0, sizeof(*frame));
+    memset(frame->raw_min, 0xFF, sizeof(frame->raw_min));
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_parse_block_uses_given_slot_map(void) {
+    const adc_channel_t channels[] = { ADC_CHANNEL_6, ADC_CHANNEL_7, ADC_CHANNEL_3 };
+    ntc_adc_slot_map_t map;
+    temp_sensor_driver_slot_map_init(&map, channels, 3);
+    TEST_ASSERT_EQUAL_UINT8(0, map.slot[ADC_CHANNEL_6]);
+    TEST_ASSERT_EQUAL_UINT8(1, map.slot[ADC_CHANNEL_7]);
+    TEST_ASSERT_EQUAL_UINT8(2, map.slot[ADC_CHANNEL_3]);
+    TEST_ASSERT_EQUAL_UINT8(NTC_ADC_NO_SLOT, map.slot[ADC_CHANNEL_0]);
+
+    uint8_t buf[8 * SOC_ADC_DIGI_RESULT_BYTES];
+    put_sample(buf, 0, 6, 1000);
+    put_sample(buf, 1, 7, 2000);
+    put_sample(buf, 2, 3, 3000);
+    put_sample(buf, 3, 6, 1010);
+    put_sample(buf, 4, 5, 4000);   // Канал без датчика
+    put_sample(buf, 5, 15, 4000);  // Канал поза ADC1
+    put_sample(buf, 6, 7, 1990);
+    put_sample(buf, 7, 6, 990);
+
+    ntc_adc_frame_t frame;
+    frame_clear(&frame);
+    // Неповна остання вибірка відкидається
+    temp_sensor_driver_parse_block(buf, sizeof(buf) - 1, &map, &frame);
+
+    TEST_ASSERT_EQUAL_UINT16(2, frame.samples[0]);
+    TEST_ASSERT_EQUAL_UINT32(2010, frame.raw_sum[0]);
+    TEST_ASSERT_EQUAL_UINT16(2, frame.samples[1]);
+    TEST_ASSERT_EQUAL_UINT32(3990, frame.raw_sum[1]);
+    TEST_ASSERT_EQUAL_UINT16(1990, frame.raw_min[1]);
+    TEST_ASSERT_EQUAL_UINT16(2000, frame.raw_max[1]);
+    TEST_ASSERT_EQUAL_UINT16(1, frame.samples[2]);
+    TEST_ASSERT_EQUAL_UINT16(0, frame.samples[3]);
+
+    // Блоки накопичуються у тому самому кадрі
+    temp_sensor_driver_parse_block(buf, sizeof(buf), &map, &frame);
+    TEST_ASSERT_EQUAL_UINT16(5, frame.samples[0]);
+    TEST_ASSERT_EQUAL_UINT16(990, frame.raw_min[0]);
+    TEST_ASSERT_EQUAL_UINT16(1010, frame.raw_max[0]);
+}
+
+static void check_start_failure_falls_back(host_adc_fail_point_t point, esp_err_t injected) {
+    host_adc_fail_continuous(point, injected);
+    TEST_ASSERT_EQUAL(injected, temp_sensor_driver_continuous_start(20000, 16));
+
+    // Дескриптор звільнено, АЦП знову в oneshot з налаштованими каналами
+    TEST_ASSERT_FALSE(temp_sensor_driver_continuous_is_running());
+    TEST_ASSERT_EQUAL(0, host_adc_open_continuous_handles());
+    TEST_ASSERT_EQUAL(1, host_adc_open_oneshot_units());
+
+    int raw = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_read_raw(s_room, &raw));
+    TEST_ASSERT_EQUAL(1800, raw);
+    ntc_adc_frame_t frame;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, temp_sensor_driver_read_frame(&frame, 100));
+}
+
+static void test_new_handle_failure_falls_back_to_oneshot(void) {
+    check_start_failure_falls_back(HOST_ADC_FAIL_NEW_HANDLE, ESP_ERR_NO_MEM);
+}
+
+static void test_config_failure_falls_back_to_oneshot(void) {
+    check_start_failure_falls_back(HOST_ADC_FAIL_CONFIG, ESP_ERR_INVALID_ARG);
+}
+
+static void test_start_failure_falls_back_to_oneshot(void) {
+    check_start_failure_falls_back(HOST_ADC_FAIL_START, ESP_ERR_INVALID_STATE);
+}
+
+static void test_continuous_frames_from_dma(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_continuous_start(20000, 16));
+    TEST_ASSERT_TRUE(temp_sensor_driver_continuous_is_running());
+    TEST_ASSERT_EQUAL(0, host_adc_open_oneshot_units());
+
+    ntc_adc_frame_t frame;
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_read_frame(&frame, 100));
+    float avg = 0.0f;
+    uint32_t sum = 0, samples = 0;
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_frame_average(&frame, s_room, &avg));
+    TEST_ASSERT_EQUAL_FLOAT(1800.0f, avg);
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_frame_sum(&frame, s_radiator, &sum, &samples));
+    TEST_ASSERT_EQUAL_UINT32(16, samples);
+    TEST_ASSERT_EQUAL_UINT32(16 * 1200, sum);
+
+    // Стробування: АЦП зупиняється між кадрами, але кадр усе одно читається
+    host_adc_set_raw(ADC_CHANNEL_6, 1900);
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_continuous_set_gated(true));
+    TEST_ASSERT_FALSE(temp_sensor_driver_continuous_is_running());
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_read_frame(&frame, 100));
+    TEST_ASSERT_FALSE(temp_sensor_driver_continuous_is_running());
+    TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_frame_average(&frame, s_room, &avg));
+    TEST_ASSERT_EQUAL_FLOAT(1900.0f, avg);
+
+    // Другий запуск не дозволений
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, temp_sensor_driver_continuous_start(20000, 16));
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    esp_log_level_set("*", ESP_LOG_NONE);
+    host_adc_set_raw(ADC_CHANNEL_6, 1800);
+    host_adc_set_raw(ADC_CHANNEL_7, 1200);
+    // Стан драйвера статичний: датчики реєструються один раз, поки АЦП в oneshot
+    s_room = temp_sensor_driver_init_ntc(ADC_CHANNEL_6, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &s_ntc);
+    s_radiator = temp_sensor_driver_init_ntc(ADC_CHANNEL_7, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &s_ntc);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_block_uses_given_slot_map);
+    RUN_TEST(test_new_handle_failure_falls_back_to_oneshot);
+    RUN_TEST(test_config_failure_falls_back_to_oneshot);
+    RUN_TEST(test_start_failure_falls_back_to_oneshot);
+    RUN_TEST(test_continuous_frames_from_dma);
+    return UNITY_END();
+}
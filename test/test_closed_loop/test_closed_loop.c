@@ -0,0 +1,410 @@
+/**
+ * @brief Замкнений контур на хості: справжні pid_controller, heating_curve, pwm_manager,
+ * relay_controller, adaptive_algorythm (з thermal_model і mpc_planner), schedule_manager
+ * та settings_manager проти двовузлової RC-моделі кімнати з радіатором.
+ *
+ * Кожен прогін - 14 діб віртуального часу з кроком 1 с; оцінюються останні 7 діб.
+ * Окремо - стрибок зовнішньої температури з прямим зв'язком і без нього, а також
+ * вимкнення прямого зв'язку, коли погода перестає оновлюватись.
+ * Модулі мають статичний стан, тому кожен прогін виконується в окремому процесі.
+ * Таблицю результатів видно у `pio test -e native -f test_closed_loop -v`.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "hw_config.h"
+#include "model/settings_manager.h"
+#include "controller/actuator/pid_controller.h"
+#include "controller/actuator/pid_autotune.h"
+#include "controller/actuator/pwm_manager.h"
+#include "controller/actuator/relay_controller.h"
+#include "controller/heating_curve.h"
+#include "controller/adaptive_algorythm.h"
+#include "controller/schedule_manager.h"
+
+#define SIM_DAYS            14
+#define SIM_SCORE_FROM_DAY  7
+#define SIM_HEATER_KW       2.0
+#define SIM_COMFORT_C       20.5   // Нижня межа комфорту в години присутності
+// Релейний тест цієї ж кімнати (test_pid_controller): Ku, %/C, і Pu, с
+#define SIM_RELAY_KU        346.6f
+#define SIM_RELAY_PU_S      5538.0f
+
+typedef enum { CTRL_MANUAL, CTRL_PROGRAMMED, CTRL_ADAPTIVE } ctrl_mode_t;
+
+typedef struct {
+    const char *name;
+    ctrl_mode_t mode;
+    bool mpc;
+    bool ff;
+    bool tuned;       // ПІ за Тіреусом-Люйбеном з релейного тесту замість заводських коефіцієнтів
+} controller_t;
+
+typedef struct {
+    const char *name;
+    bool cold_snap;          // Похолодання до -12 C з 9.5 доби
+    double step_day;         // Стрибок 6 -> -6 C за сталої погоди і без теплонадходжень від
+                             // людей, щоб збуренням був лише він (0 - без стрибка)
+    double weather_stop_day; // Погода перестає оновлюватись (0 - оновлюється весь час)
+} scenario_t;
+
+typedef struct {
+    double kwh_per_day;
+    double discomfort_kh_per_day;  // Недогрів нижче SIM_COMFORT_C у години присутності, K*год/добу
+    double cycles_per_day;         // Увімкнення реле за добу
+    double cycles_limit;           // Один цикл ШІМ за раз: 86400 / період ШІМ
+    double overshoot_c;            // Перевищення уставки після її підйому
+    double room_peak_c;            // Найвища температура кімнати
+    double room_limit_c;           // Верхня межа адаптивного режиму: room_max + передпрогрів
+    double step_err_c;             // Найбільший недогрів після стрибка погоди (середнє за 10 хв)
+    double step_recovery_h;        // Від стрибка до кінця останніх 10 хв з відхиленням > 0.05 C
+    double ff_expired_h;           // Від останнього оновлення погоди до вимкнення прямого зв'язку
+    double ff_after_expiry;        // Найбільший прямий зв'язок після вимкнення
+    double speed;                  // Віртуальний час / реальний
+    bool done;
+} result_t;
+
+static const controller_t s_controllers[] = {
+    { "MANUAL 21 C, no ff", CTRL_MANUAL,     false, false },
+    { "MANUAL 21 C",        CTRL_MANUAL,     false, true  },
+    { "PROGRAMMED, no ff",  CTRL_PROGRAMMED, false, false },
+    { "PROGRAMMED",         CTRL_PROGRAMMED, false, true  },
+    { "ADAPTIVE (PID)",     CTRL_ADAPTIVE,   false, true  },
+    { "ADAPTIVE (MPC)",     CTRL_ADAPTIVE,   true,  true  },
+};
+#define CONTROLLER_COUNT (sizeof(s_controllers) / sizeof(s_controllers[0]))
+
+static const scenario_t s_mild = { "mild", false, 0.0, 0.0 };
+static const scenario_t s_cold = { "cold snap", true, 0.0, 0.0 };
+// Стрибок о 10 добі; погода зникає за добу до нього, тож стрибок ПІД відпрацьовує сам
+static const scenario_t s_step = { "step", false, 10.0, 0.0 };
+static const scenario_t s_step_stale = { "stale", false, 10.0, 9.0 };
+
+/* ---- Приміщення та погода ---- */
+
+static double outside_at(const scenario_t *s, double t) {
+    double day = t / 86400.0;
+    if (s->step_day > 0.0) return day < s->step_day ? 6.0 : -6.0;
+
+    double base = 6.0 + 4.0 * sin(2.0 * M_PI * (t / 3600.0 - 9.0) / 24.0);
+    if (!s->cold_snap || day < 9.5) return base;
+
+    double k = fmin(1.0, (day - 9.5) * 4.0);  // Фронт проходить за 6 год
+    double cold = -12.0 + 2.0 * sin(2.0 * M_PI * (t / 3600.0 - 9.0) / 24.0);
+    return base * (1.0 - k) + cold * k;
+}
+
+static bool occupied(int wday, int minute_of_day) {
+    if (wday == 0 || wday == 6) return minute_of_day >= 8 * 60 && minute_of_day < 23 * 60 + 30;
+    return (minute_of_day >= 6 * 60 + 30 && minute_of_day < 8 * 60 + 30) ||
+           (minute_of_day >= 17 * 60 + 30 && minute_of_day < 23 * 60 + 30);
+}
+
+static double gauss(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+typedef struct {
+    double room;
+    double radiator;
+} plant_t;
+
+// Радіатор 2 кВт з постійною ~25 хв, кімната з постійною ~20 год до вулиці
+static void plant_step(plant_t *p, bool heater_on, double outside, bool occ, double dt) {
+    double d_rad = 0.025 * (heater_on ? 1.0 : 0.0) - (p->radiator - p->room) / 1500.0;
+    double d_room = 2.1e-5 * (p->radiator - p->room) - 1.4e-5 * (p->room - outside) + (occ ? 8e-6 : 0.0);
+    p->radiator += d_rad * dt;
+    p->room += d_room * dt;
+}
+
+/* ---- Прогін ---- */
+
+static void run(const controller_t *c, const scenario_t *s, result_t *res) {
+    srand(11);
+    setenv("TZ", "UTC", 1);
+    tzset();
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    struct tm tm0 = { .tm_year = 2026 - 1900, .tm_mon = 0, .tm_mday = 5 };
+    host_clock_reset(timegm(&tm0));
+
+    settings_init();
+    app_settings_t *cfg = settings_get_writeable();
+    cfg->control.mpc_enabled = c->mpc;
+    cfg->control.ff.enabled = c->ff;
+    if (c->tuned) {
+        TEST_ASSERT_EQUAL_INT(ESP_OK, pid_autotune_compute_gains(SIM_RELAY_KU, SIM_RELAY_PU_S, PID_TUNE_RULE_TYREUS_LUYBEN,
+                                                                 &cfg->control.pid.kp, &cfg->control.pid.ki,
+                                                                 &cfg->control.pid.kd));
+        cfg->control.pid.kd = 0.0f;  // Диференціальна складова з таким Td лише підсилює шум датчика
+    }
+
+    relay_controller_init(GPIO_RELAY, 1);
+    schedule_manager_init();
+    pwm_manager_init();
+    adaptive_thermo_init();
+
+    pid_controller_t pid;
+    pid_init(&pid, cfg->control.pid.kp, cfg->control.pid.ki, cfg->control.pid.kd, 0.0f, 100.0f);
+    pid_set_weighting(&pid, cfg->control.pid.setpoint_weight, cfg->control.pid.d_filter_n);
+    heating_curve_t hc;
+    heating_curve_init(&hc, cfg->control.ff.slope, cfg->control.ff.offset);
+    // Кеш погоди опитується раз на interval_min і тримає останнє значення безстроково
+    heating_curve_outside_t ff_outside;
+    heating_curve_outside_init(&ff_outside);
+    const int64_t weather_period = cfg->geo.interval_min * 60LL;
+    const int64_t weather_stop = (int64_t)(s->weather_stop_day * 86400.0);
+    const int64_t step_at = (int64_t)(s->step_day * 86400.0);
+    float weather_temp = -999.0f;
+    time_t weather_stamp = 0;
+    int64_t weather_last = -1, ff_lost = -1;
+    // Відхилення після стрибка оцінюється по 10-хвилинних середніх, що згладжують пульсації ШІМ
+    double step_err = 0.0, step_sum = 0.0, ff_after = 0.0;
+    int64_t step_last_off = -1;
+
+    plant_t plant = { .room = 19.0, .radiator = 19.0 };
+    double sensed = 19.0;
+    double hist[600];  // Відфільтрована температура за 10 хв для оцінки швидкості
+    int hist_idx = 0;
+    for (int i = 0; i < 600; i++) hist[i] = sensed;
+
+    const int64_t score_from = SIM_SCORE_FROM_DAY * 86400LL;
+    const int64_t t_end = SIM_DAYS * 86400LL;
+    float last_sp = 0.0f;
+    bool rising = false, crossed = false;
+    double on_s = 0.0, discomfort = 0.0, overshoot = 0.0, peak = 0.0;
+    uint32_t cycles_at_score = 0;
+
+    struct timeval w0, w1;
+    gettimeofday(&w0, NULL);
+    for (int64_t t = 0; t < t_end; t++) {
+        double outside = outside_at(s, (double)t);
+        time_t now = time(NULL);
+        struct tm lt;
+        gmtime_r(&now, &lt);
+        bool occ = occupied(lt.tm_wday, lt.tm_hour * 60 + lt.tm_min);
+
+        // Приміщення інтегрується між фронтами ШІМ, які виставляють таймери esp_timer
+        const int64_t seg_end = (t + 1) * 1000000LL;
+        while (esp_timer_get_time() < seg_end) {
+            int64_t due = host_timer_next_due_us();
+            int64_t stop = (due >= 0 && due < seg_end) ? due : seg_end;
+            double dt = (double)(stop - esp_timer_get_time()) / 1e6;
+            bool on = relay_controller_get_heater_state();
+            plant_step(&plant, on, outside, occ && s->step_day == 0.0, dt);
+            if (t >= score_from && on) on_s += dt;
+            host_run_until(stop);
+        }
+
+        double measured = plant.room + 0.03 * gauss();
+        sensed += 0.3 * (measured - sensed);
+        double rate = (sensed - hist[hist_idx]) * 6.0;  // C/год
+        hist[hist_idx] = sensed;
+        hist_idx = (hist_idx + 1) % 600;
+
+        if (t % weather_period == 0 && (weather_stop == 0 || t < weather_stop)) {
+            weather_temp = (float)outside;
+            weather_stamp = now;
+            weather_last = t;
+        }
+        float ff_temp = heating_curve_outside_update(&ff_outside, weather_temp, weather_stamp,
+                                                          cfg->geo.interval_min, esp_timer_get_time());
+        if (ff_lost < 0 && weather_last >= 0 && isnan(ff_temp)) ff_lost = t;
+
+        adaptive_thermo_notify_sensor(sensed, outside, occ, lt.tm_wday, lt.tm_hour, lt.tm_min);
+        adaptive_thermo_notify_heating(plant.radiator, relay_controller_get_heater_state());
+        host_tasks_run();
+
+        float sp;
+        switch (c->mode) {
+        case CTRL_MANUAL:     sp = 21.0f; break;
+        case CTRL_PROGRAMMED: sp = schedule_manager_get_current_setpoint(); break;
+        default:              sp = adaptive_thermo_get_setpoint(); break;
+        }
+
+        // Та сама послідовність, що й у main.c: MPC або ПІД з прямою подачею і безударним слідуванням
+        float duty;
+        float ff = cfg->control.ff.enabled ? heating_curve_feedforward(&hc, sp, ff_temp) : 0.0f;
+        pid_set_output_limits(&pid, -ff, 100.0f - ff);
+        if (c->mode == CTRL_ADAPTIVE && adaptive_thermo_get_mpc_duty(&duty)) {
+            pid_track(&pid, sp, (float)sensed, duty - ff);
+        } else {
+            duty = ff + pid_compute(&pid, sp, (float)sensed);
+            bool steady = fabs(sp - sensed) < 0.3 && fabs(rate) < 0.3;
+            if (cfg->control.ff.enabled && cfg->control.ff.learn &&
+                heating_curve_add_sample(&hc, steady, sp, ff_temp, duty)) {
+                ff = heating_curve_feedforward(&hc, sp, ff_temp);
+                pid_set_output_limits(&pid, -ff, 100.0f - ff);
+                pid_track(&pid, sp, (float)sensed, duty - ff);
+            }
+        }
+        pwm_manager_update(duty, (float)plant.radiator);
+
+        if (ff_lost >= 0 && ff > ff_after) ff_after = ff;
+        if (step_at > 0 && t >= step_at) {
+            step_sum += sp - plant.room;
+            if ((t - step_at + 1) % 600 == 0) {
+                double mean = step_sum / 600.0;
+                if (mean > step_err) step_err = mean;
+                if (fabs(mean) > 0.05) step_last_off = t + 1;
+                step_sum = 0.0;
+            }
+        }
+
+        if (t == score_from) cycles_at_score = host_gpio_rising_edges(GPIO_RELAY);
+        if (t >= score_from) {
+            if (occ && plant.room < SIM_COMFORT_C) discomfort += (SIM_COMFORT_C - plant.room) / 3600.0;
+            // Перерегулювання: після підйому уставки і досягнення її, до наступної зміни
+            if (sp > last_sp + 0.001f) {
+                if (!rising) crossed = false;
+                rising = true;
+            } else if (sp < last_sp - 0.001f) {
+                rising = false;
+            }
+            if (rising && plant.room >= sp) crossed = true;
+            if (rising && crossed && plant.room - sp > overshoot) overshoot = plant.room - sp;
+            if (plant.room > peak) peak = plant.room;
+        }
+        last_sp = sp;
+    }
+    gettimeofday(&w1, NULL);
+
+    double wall = (w1.tv_sec - w0.tv_sec) + (w1.tv_usec - w0.tv_usec) / 1e6;
+    double days = SIM_DAYS - SIM_SCORE_FROM_DAY;
+    res->kwh_per_day = on_s / 3600.0 * SIM_HEATER_KW / days;
+    res->discomfort_kh_per_day = discomfort / days;
+    res->cycles_per_day = (host_gpio_rising_edges(GPIO_RELAY) - cycles_at_score) / days;
+    res->cycles_limit = 86400.0 / cfg->control.pwm_cycle_s;
+    res->overshoot_c = overshoot;
+    res->room_peak_c = peak;
+    res->room_limit_c = cfg->control.limits.room_max + 0.5;
+    res->step_err_c = step_err;
+    res->step_recovery_h = step_last_off >= 0 ? (step_last_off - step_at) / 3600.0 : 0.0;
+    res->ff_expired_h = ff_lost >= 0 && weather_stop > 0 ? (ff_lost - weather_last) / 3600.0 : -1.0;
+    res->ff_after_expiry = ff_after;
+    res->speed = (double)t_end / wall;
+    res->done = true;
+}
+
+static void run_forked(const controller_t *c, const scenario_t *s, result_t *res) {
+    pid_t pid = fork();
+    TEST_ASSERT_TRUE(pid >= 0);
+    if (pid == 0) {
+        run(c, s, res);
+        _exit(0);
+    }
+    int status = 0;
+    waitpid(pid, &status, 0);
+    TEST_ASSERT_TRUE_MESSAGE(WIFEXITED(status) && WEXITSTATUS(status) == 0 && res->done, c->name);
+}
+
+static void run_scenario(const scenario_t *s, result_t *results) {
+    TEST_MESSAGE("| scenario  | controller             | kWh/d  | K*h/d   | cyc/d  | ovr C | max C | speed    |");
+    TEST_MESSAGE("|-----------|------------------------|--------|---------|--------|-------|-------|----------|");
+    for (size_t i = 0; i < CONTROLLER_COUNT; i++) {
+        run_forked(&s_controllers[i], s, &results[i]);
+
+        char row[160];
+        snprintf(row, sizeof(row), "| %-9s | %-22s | %6.1f | %7.2f | %6.1f | %5.2f | %5.2f | %7.0fx |",
+                 s->name, s_controllers[i].name, results[i].kwh_per_day, results[i].discomfort_kh_per_day,
+                 results[i].cycles_per_day, results[i].overshoot_c, results[i].room_peak_c, results[i].speed);
+        TEST_MESSAGE(row);
+    }
+}
+
+static result_t *s_results;
+
+void setUp(void) {
+    memset(s_results, 0, CONTROLLER_COUNT * sizeof(result_t));
+}
+
+void tearDown(void) {}
+
+static void check_common(const result_t *r) {
+    for (size_t i = 0; i < CONTROLLER_COUNT; i++) {
+        // Реле вмикається не частіше одного разу за цикл ШІМ
+        TEST_ASSERT_LESS_OR_EQUAL_FLOAT((float)r[i].cycles_limit, (float)r[i].cycles_per_day);
+        TEST_ASSERT_GREATER_THAN_FLOAT(0.0f, (float)r[i].kwh_per_day);
+    }
+    // Постійна уставка: ПІД не перерегулює
+    TEST_ASSERT_LESS_THAN_FLOAT(0.3f, (float)r[0].overshoot_c);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.3f, (float)r[1].overshoot_c);
+    // MPC передбачає нагрів і не програє ПІД за комфортом
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT((float)r[4].discomfort_kh_per_day, (float)r[5].discomfort_kh_per_day);
+    // MPC тримає кімнату не вище верхньої межі плану (допуск - похибка навченої моделі)
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT((float)r[5].room_limit_c + 0.1f, (float)r[5].room_peak_c);
+}
+
+static void test_mild(void) {
+    run_scenario(&s_mild, s_results);
+    check_common(s_results);
+    // Постійна уставка 21 C тримає комфорт майже без недогріву
+    TEST_ASSERT_LESS_THAN_FLOAT(0.1f, (float)s_results[1].discomfort_kh_per_day);
+}
+
+static void test_cold_snap(void) {
+    run_scenario(&s_cold, s_results);
+    check_common(s_results);
+    // Похолодання: пряма подача не гірша за чистий ПІД
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT((float)s_results[0].discomfort_kh_per_day + 0.05f,
+                                    (float)s_results[1].discomfort_kh_per_day);
+}
+
+static void test_outside_step(void) {
+    // Заводські коефіцієнти тримають кімнату в граничному циклі ШІМ, який ховає стрибок
+    static const controller_t pid_only = { "MANUAL 21 C, tuned, no ff", CTRL_MANUAL, false, false, true };
+    static const controller_t pid_ff = { "MANUAL 21 C, tuned", CTRL_MANUAL, false, true, true };
+    run_forked(&pid_only, &s_step, &s_results[0]);
+    run_forked(&pid_ff, &s_step, &s_results[1]);
+    run_forked(&pid_ff, &s_step_stale, &s_results[2]);
+
+    static const char *const names[] = { "PID only", "PID + ff", "PID + ff, stale weather" };
+    TEST_MESSAGE("| outside step -12 C      | max err C | recovery h | ff off after h | ff after off |");
+    TEST_MESSAGE("|-------------------------|-----------|------------|----------------|--------------|");
+    for (int i = 0; i < 3; i++) {
+        char row[160];
+        snprintf(row, sizeof(row), "| %-23s | %9.2f | %10.1f | %14.2f | %12.1f |", names[i],
+                 s_results[i].step_err_c, s_results[i].step_recovery_h, s_results[i].ff_expired_h,
+                 s_results[i].ff_after_expiry);
+        TEST_MESSAGE(row);
+    }
+
+    // Крива одразу додає заповнення під нову погоду: менший недогрів і швидше повернення
+    // (провал не зникає повністю: радіатор прогрівається ~25 хв)
+    TEST_ASSERT_LESS_THAN_FLOAT(0.7f * (float)s_results[0].step_err_c, (float)s_results[1].step_err_c);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.7f * (float)s_results[0].step_recovery_h, (float)s_results[1].step_recovery_h);
+
+    // Без оновлень погоди прямий зв'язок вимикається після двох періодів опитування
+    // (за замовчуванням 15 хв) і більше не вмикається
+    TEST_ASSERT_FLOAT_WITHIN(1.0f / 3600.0f, 0.5f, (float)s_results[2].ff_expired_h);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, (float)s_results[2].ff_after_expiry);
+    // Далі стрибок відпрацьовує чистий ПІД: як без прямого зв'язку, гірше ніж з ним
+    TEST_ASSERT_FLOAT_WITHIN(0.1f * (float)s_results[0].step_err_c, (float)s_results[0].step_err_c,
+                             (float)s_results[2].step_err_c);
+    TEST_ASSERT_GREATER_THAN_FLOAT((float)s_results[1].step_err_c, (float)s_results[2].step_err_c);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    s_results = mmap(NULL, CONTROLLER_COUNT * sizeof(result_t), PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_mild);
+    RUN_TEST(test_cold_snap);
+    RUN_TEST(test_outside_step);
+    return UNITY_END();
+}
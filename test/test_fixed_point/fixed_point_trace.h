@@ -0,0 +1,49 @@
+#ifndef FIXED_POINT_TRACE_H
+#define FIXED_POINT_TRACE_H
+
+#include <stdint.h>
+
+/**
+ * @brief Спільний вхід для обох шляхів: кімната з шумом у кілька кодів, ступінчасті
+ * зміни температури та поодинокі викиди, одна вибірка на секунду.
+ */
+
+#define TRACE_LEN          20000
+#define TRACE_STEP_MS      1000
+#define TRACE_SETPOINT_C   21.0f
+
+#define TRACE_PID_KP 10.0f
+#define TRACE_PID_KI 0.1f
+#define TRACE_PID_KD 0.5f
+
+#define TRACE_FILTER_CONFIG {                \
+    .median_window = 3,                      \
+    .hampel_window = 7,                      \
+    .hampel_k = 3.0f,                        \
+    .smooth = TEMP_FILTER_SMOOTH_EMA,        \
+    .ema_alpha = 0.3f,                       \
+    .cutoff_hz = 0.0f,                       \
+    .sample_rate_hz = 1000.0f / TRACE_STEP_MS, \
+}
+
+static inline void trace_generate(int32_t *centi, int count) {
+    uint32_t lcg = 7;
+    for (int i = 0; i < count; i++) {
+        lcg = lcg * 1664525u + 1013904223u;
+        int32_t noise = (int32_t)((lcg >> 16) % 7) - 3;
+        // Ступені 20.0 / 20.5 / 21.0 C кожні 500 с, викид +8 C кожні 97 с
+        centi[i] = 2000 + (i / 500) % 3 * 50 + noise;
+        if (i % 97 == 0) centi[i] += 800;
+    }
+}
+
+// Повний крок циклу для заміру швидкодії: стільки читань АЦП на канал, як у temp_controller
+#define BENCH_OVERSAMPLING 32
+#define BENCH_STEPS        20000
+
+// Код АЦП кімнати: ступені 20.7 / 21.0 / 21.2 C навколо уставки з шумом у кілька кодів
+static inline int bench_raw(int step, int sample) {
+    return 1840 + (step / 1000) % 3 * 15 + (step * 7 + sample * 13) % 9 - 4;
+}
+
+#endif // FIXED_POINT_TRACE_H
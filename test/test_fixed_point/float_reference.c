@@ -0,0 +1,67 @@
+/**
+ * @brief Шлях з float поруч із цілочисельним: вихідні файли фільтра та ПІД
+ * включаються напряму з TEMP_FIXED_POINT = 0 і перейменованими символами.
+ */
+#undef TEMP_FIXED_POINT
+#define TEMP_FIXED_POINT 0
+
+#define temp_filter_init            float_ref_temp_filter_init
+#define temp_filter_reset           float_ref_temp_filter_reset
+#define temp_filter_set_sample_rate float_ref_temp_filter_set_sample_rate
+#define temp_filter_process         float_ref_temp_filter_process
+#define pid_init                    float_ref_pid_init
+#define pid_reset                   float_ref_pid_reset
+#define pid_set_tuning              float_ref_pid_set_tuning
+#define pid_set_weighting           float_ref_pid_set_weighting
+#define pid_set_output_limits       float_ref_pid_set_output_limits
+#define pid_compute                 float_ref_pid_compute
+#define pid_track                   float_ref_pid_track
+
+#include "controller/sensor/temp_filter.c"
+#include "controller/actuator/pid_controller.c"
+
+#include "host_stubs.h"
+#include "fixed_point_trace.h"
+#include "float_reference.h"
+
+void float_reference_run(const int32_t *input_centi, int count, float setpoint_c,
+                         float *filtered_c, float *output_pct) {
+    temp_filter_t filter;
+    temp_filter_config_t cfg = TRACE_FILTER_CONFIG;
+    temp_filter_init(&filter, &cfg);
+
+    host_clock_set_us(0);
+    pid_controller_t pid;
+    pid_init(&pid, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+
+    for (int i = 0; i < count; i++) {
+        host_clock_set_us((int64_t)(i + 1) * TRACE_STEP_MS * 1000);
+        filtered_c[i] = temp_filter_process(&filter, (float)input_centi[i] / 100.0f);
+        output_pct[i] = pid_compute(&pid, setpoint_c, filtered_c[i]);
+    }
+}
+
+float float_reference_step_loop(ntc_sensor_handle_t ntc, adc_channel_t channel) {
+    temp_filter_t filter;
+    temp_filter_config_t cfg = TRACE_FILTER_CONFIG;
+    temp_filter_init(&filter, &cfg);
+
+    host_clock_set_us(0);
+    pid_controller_t pid;
+    pid_init(&pid, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+
+    float out_sum = 0.0f;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        host_clock_set_us((int64_t)(i + 1) * TRACE_STEP_MS * 1000);
+        uint32_t sum = 0;
+        for (int k = 0; k < BENCH_OVERSAMPLING; k++) {
+            int raw = 0;
+            host_adc_set_raw(channel, bench_raw(i, k));
+            if (temp_sensor_driver_read_raw(ntc, &raw) == ESP_OK) sum += (uint32_t)raw;
+        }
+        float temp_c;
+        if (temp_sensor_driver_raw_to_temp(ntc, (float)sum / BENCH_OVERSAMPLING, &temp_c) != ESP_OK) continue;
+        out_sum += pid_compute(&pid, TRACE_SETPOINT_C, temp_filter_process(&filter, temp_c));
+    }
+    return out_sum;
+}
@@ -0,0 +1,32 @@
+#ifndef FLOAT_REFERENCE_H
+#define FLOAT_REFERENCE_H
+
+#include <stdint.h>
+#include "drivers/sensor/temp_sensor_driver.h"
+
+/**
+ * @brief Той самий конвеєр (фільтр -> ПІД) у шляху з float для порівняння з цілочисельним.
+ *
+ * Збирається з тих самих вихідних файлів, що й прошивка, з TEMP_FIXED_POINT = 0
+ * та перейменованими символами, тож обидва шляхи живуть в одному тестовому бінарнику.
+ *
+ * @param input_centi Вхідна температура, соті частки градуса, одна вибірка на секунду.
+ * @param count Кількість вибірок.
+ * @param setpoint_c Уставка ПІД, C.
+ * @param filtered_c Вихід фільтра, C.
+ * @param output_pct Вихід ПІД, %.
+ */
+void float_reference_run(const int32_t *input_centi, int count, float setpoint_c,
+                         float *filtered_c, float *output_pct);
+
+/**
+ * @brief Повний крок циклу у шляху з float BENCH_STEPS разів: BENCH_OVERSAMPLING читань АЦП,
+ * середнє пакета, перетворення в температуру, фільтр і ПІД.
+ *
+ * @param ntc Датчик, код якого задає host_adc_set_raw(channel, ...).
+ * @param channel Канал АЦП датчика.
+ * @return Сума виходів ПІД, %, щоб цикл не викинув компілятор.
+ */
+float float_reference_step_loop(ntc_sensor_handle_t ntc, adc_channel_t channel);
+
+#endif // FLOAT_REFERENCE_H
@@ -0,0 +1,200 @@
+/**
+ * @brief Цілочисельний шлях (TEMP_FIXED_POINT): фільтр і ПІД дають побітово однаковий
+ * результат між запусками, а відхилення від шляху з float обмежене.
+ * Наприкінці - швидкодія повного кроку циклу (АЦП -> пакет -> температура -> фільтр -> ПІД)
+ * обох шляхів в одному бінарнику. Запускається в середовищі native_fixed.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "drivers/sensor/temp_sensor_driver.h"
+#include "controller/sensor/temp_filter.h"
+#include "controller/actuator/pid_controller.h"
+#include "fixed_point_trace.h"
+#include "float_reference.h"
+
+#if !TEMP_FIXED_POINT
+#error "test_fixed_point needs -DTEMP_FIXED_POINT=1 (pio test -e native_fixed)"
+#endif
+
+// Межі відхилення від float: фільтр округлює до 0.01 C на кожному кроці,
+// ПІД отримує відфільтровану температуру кожного шляху
+#define MAX_FILTER_DIFF_C   0.01f
+#define MAX_OUTPUT_DIFF_PCT 0.2f
+// У повному кроці шляхи ще й перетворюють код по-різному (float і соті частки),
+// а інтеграл накопичує цю різницю, тож середні виходи порівнюються грубіше
+#define BENCH_MEAN_DIFF_PCT 1.0f
+
+// Хеш виходів фільтра та ПІД на трасі. Обчислення лише цілочисельні, тому значення
+// не залежить від компілятора, оптимізації та FPU; зміна означає зміну арифметики шляху
+#define TRACE_GOLDEN_HASH 0xec4a1176u
+
+static int32_t s_input[TRACE_LEN];
+static int32_t s_filtered[2][TRACE_LEN];
+static int32_t s_output_q16[2][TRACE_LEN];
+static float s_ref_filtered[TRACE_LEN];
+static float s_ref_output[TRACE_LEN];
+
+static void run_fixed(int32_t *filtered, int32_t *output_q16) {
+    temp_filter_t filter;
+    temp_filter_config_t cfg = TRACE_FILTER_CONFIG;
+    temp_filter_init(&filter, &cfg);
+
+    pid_controller_t pid;
+    pid_init(&pid, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+    int32_t setpoint_centi = (int32_t)lroundf(TRACE_SETPOINT_C * 100.0f);
+
+    for (int i = 0; i < TRACE_LEN; i++) {
+        filtered[i] = temp_filter_process(&filter, s_input[i]);
+        output_q16[i] = pid_compute_centi(&pid, setpoint_centi, filtered[i], TRACE_STEP_MS);
+    }
+}
+
+static const ntc_thermistor_config_t s_ntc_config = {
+    .nominal_resistance = 10000.0f,
+    .nominal_temperature_c = 25.0f,
+    .b_value = 3950.0f,
+    .fixed_resistor_ohms = 10000.0f,
+};
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+// Цілочисельний повний крок: сума кодів -> середнє Q8 -> соті частки градуса -> фільтр -> ПІД Q16
+static int64_t fixed_step_loop(ntc_sensor_handle_t ntc, adc_channel_t channel) {
+    temp_filter_t filter;
+    temp_filter_config_t cfg = TRACE_FILTER_CONFIG;
+    temp_filter_init(&filter, &cfg);
+
+    pid_controller_t pid;
+    pid_init(&pid, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+    int32_t setpoint_centi = (int32_t)lroundf(TRACE_SETPOINT_C * 100.0f);
+
+    int64_t out_sum_q16 = 0;
+    for (int i = 0; i < BENCH_STEPS; i++) {
+        uint32_t sum = 0;
+        for (int k = 0; k < BENCH_OVERSAMPLING; k++) {
+            int raw = 0;
+            host_adc_set_raw(channel, bench_raw(i, k));
+            if (temp_sensor_driver_read_raw(ntc, &raw) == ESP_OK) sum += (uint32_t)raw;
+        }
+        uint32_t avg_q8 = (uint32_t)((((uint64_t)sum << NTC_RAW_Q8_SHIFT) + BENCH_OVERSAMPLING / 2) / BENCH_OVERSAMPLING);
+        int32_t centi;
+        if (temp_sensor_driver_raw_q8_to_centi(ntc, avg_q8, &centi) != ESP_OK) continue;
+        out_sum_q16 += pid_compute_centi(&pid, setpoint_centi, temp_filter_process(&filter, centi), TRACE_STEP_MS);
+    }
+    return out_sum_q16;
+}
+
+static uint32_t fnv1a(const void *data, size_t len, uint32_t h) {
+    const uint8_t *p = data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void setUp(void) {
+    host_clock_reset(0);
+}
+
+void tearDown(void) {}
+
+static void test_fixed_path_is_bit_exact_across_runs(void) {
+    run_fixed(s_filtered[0], s_output_q16[0]);
+    run_fixed(s_filtered[1], s_output_q16[1]);
+
+    TEST_ASSERT_EQUAL_MEMORY(s_filtered[0], s_filtered[1], sizeof(s_filtered[0]));
+    TEST_ASSERT_EQUAL_MEMORY(s_output_q16[0], s_output_q16[1], sizeof(s_output_q16[0]));
+
+    uint32_t h = fnv1a(s_filtered[0], sizeof(s_filtered[0]), 2166136261u);
+    h = fnv1a(s_output_q16[0], sizeof(s_output_q16[0]), h);
+    char msg[64];
+    snprintf(msg, sizeof(msg), "trace hash %08x", (unsigned)h);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_EQUAL_HEX32(TRACE_GOLDEN_HASH, h);
+}
+
+static void test_fixed_path_stays_close_to_float(void) {
+    run_fixed(s_filtered[0], s_output_q16[0]);
+    float_reference_run(s_input, TRACE_LEN, TRACE_SETPOINT_C, s_ref_filtered, s_ref_output);
+
+    float max_filter = 0.0f;
+    float max_output = 0.0f;
+    for (int i = 0; i < TRACE_LEN; i++) {
+        float filtered_c = (float)s_filtered[0][i] / 100.0f;
+        float output_pct = (float)s_output_q16[0][i] / (float)(1 << PID_OUTPUT_Q16_SHIFT);
+        max_filter = fmaxf(max_filter, fabsf(filtered_c - s_ref_filtered[i]));
+        max_output = fmaxf(max_output, fabsf(output_pct - s_ref_output[i]));
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "max |fixed - float|: filter %.4f C, PID %.4f %%", max_filter, max_output);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_FILTER_DIFF_C, max_filter);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(MAX_OUTPUT_DIFF_PCT, max_output);
+}
+
+static void test_float_wrapper_matches_centi_path(void) {
+    // pid_compute у цілочисельній збірці лише переводить аргументи в соті частки
+    pid_controller_t a;
+    pid_controller_t b;
+    pid_init(&a, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+    pid_init(&b, TRACE_PID_KP, TRACE_PID_KI, TRACE_PID_KD, 0.0f, 100.0f);
+    int32_t setpoint_centi = (int32_t)lroundf(TRACE_SETPOINT_C * 100.0f);
+
+    for (int i = 0; i < 2000; i++) {
+        host_clock_set_us((int64_t)(i + 1) * TRACE_STEP_MS * 1000);
+        float out = pid_compute(&a, TRACE_SETPOINT_C, (float)s_input[i] / 100.0f);
+        int32_t out_q16 = pid_compute_centi(&b, setpoint_centi, s_input[i], TRACE_STEP_MS);
+        TEST_ASSERT_EQUAL_FLOAT((float)out_q16 / (float)(1 << PID_OUTPUT_Q16_SHIFT), out);
+    }
+}
+
+static void test_full_step_benchmark(void) {
+    ntc_sensor_handle_t ntc = temp_sensor_driver_init_ntc(ADC_CHANNEL_6, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &s_ntc_config);
+    TEST_ASSERT_NOT_NULL(ntc);
+
+    // Прогрів кешів і таблиці, потім по черзі кожен шлях
+    float_reference_step_loop(ntc, ADC_CHANNEL_6);
+    fixed_step_loop(ntc, ADC_CHANNEL_6);
+    int64_t t0 = now_ns();
+    float float_sum = float_reference_step_loop(ntc, ADC_CHANNEL_6);
+    int64_t t1 = now_ns();
+    int64_t fixed_sum_q16 = fixed_step_loop(ntc, ADC_CHANNEL_6);
+    int64_t t2 = now_ns();
+
+    double float_ns = (double)(t1 - t0) / BENCH_STEPS;
+    double fixed_ns = (double)(t2 - t1) / BENCH_STEPS;
+    float float_mean = float_sum / BENCH_STEPS;
+    float fixed_mean = (float)((double)fixed_sum_q16 / (1 << PID_OUTPUT_Q16_SHIFT) / BENCH_STEPS);
+    char msg[160];
+    snprintf(msg, sizeof(msg), "ns/step (%d ADC reads): float %.1f, fixed %.1f (host); mean PID %.3f / %.3f %%",
+             BENCH_OVERSAMPLING, float_ns, fixed_ns, float_mean, fixed_mean);
+    TEST_MESSAGE(msg);
+
+    // Обидва цикли виконали ту саму роботу: ПІД не в насиченні, а середні виходи близькі
+    TEST_ASSERT_TRUE(float_mean > 5.0f && float_mean < 95.0f);
+    TEST_ASSERT_FLOAT_WITHIN(BENCH_MEAN_DIFF_PCT, float_mean, fixed_mean);
+}
+
+int main(int argc, char **argv) {
+    esp_log_level_set("*", ESP_LOG_NONE);
+    trace_generate(s_input, TRACE_LEN);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_fixed_path_is_bit_exact_across_runs);
+    RUN_TEST(test_fixed_path_stays_close_to_float);
+    RUN_TEST(test_float_wrapper_matches_centi_path);
+    RUN_TEST(test_full_step_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,193 @@
+/**
+ * @brief Кільцевий буфер історії: один записувач і читачі в окремих потоках.
+ * Перевіряє перехід через кінець буфера під час копіювання та відкидання
+ * записів, які записувач встиг перезаписати, після перевірки head.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "controller/sensor/temp_history.h"
+
+// Маленький буфер, щоб записувач обганяв читача якомога частіше
+#define STRESS_CAPACITY    8
+#define STRESS_READERS     3
+#define STRESS_DURATION_MS 1500
+#define TS_STEP_US         1000
+
+static temp_history_t s_history;
+
+// Усі поля запису виводяться з його порядкового номера: розірваний запис не збігся б
+static void make_entry(uint32_t seq, temp_history_entry_t *e) {
+    e->timestamp_us = (int64_t)(seq + 1) * TS_STEP_US;
+    for (int k = 0; k < NUM_TEMP_SENSORS; k++) {
+        e->raw[k] = (uint16_t)(seq * 7 + (uint32_t)k);
+        e->filtered[k] = (float)(seq % 100000) + (float)k * 0.25f;
+    }
+}
+
+static bool entry_consistent(const temp_history_entry_t *e) {
+    if (e->timestamp_us <= 0 || e->timestamp_us % TS_STEP_US != 0) return false;
+    temp_history_entry_t expect;
+    make_entry((uint32_t)(e->timestamp_us / TS_STEP_US - 1), &expect);
+    for (int k = 0; k < NUM_TEMP_SENSORS; k++) {
+        if (e->raw[k] != expect.raw[k] || e->filtered[k] != expect.filtered[k]) return false;
+    }
+    return true;
+}
+
+static void push_seq(uint32_t from, uint32_t to) {
+    temp_history_entry_t e;
+    memset(&e, 0, sizeof(e));
+    for (uint32_t seq = from; seq < to; seq++) {
+        make_entry(seq, &e);
+        temp_history_push(&s_history, &e);
+    }
+}
+
+void setUp(void) {
+    TEST_ASSERT_EQUAL(ESP_OK, temp_history_init(&s_history, STRESS_CAPACITY * sizeof(temp_history_entry_t)));
+}
+
+void tearDown(void) {
+    temp_history_deinit(&s_history);
+}
+
+static void test_init_rejects_budget_below_one_entry(void) {
+    temp_history_t h;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_SIZE, temp_history_init(&h, sizeof(temp_history_entry_t) - 1));
+    TEST_ASSERT_NULL(h.slots);
+    temp_history_entry_t out[2];
+    TEST_ASSERT_EQUAL_size_t(0, temp_history_read(&h, 0, INT64_MAX, out, 2));
+    TEST_ASSERT_EQUAL_size_t(STRESS_CAPACITY, s_history.capacity);
+}
+
+static void test_read_selects_interval_and_newest(void) {
+    temp_history_entry_t out[STRESS_CAPACITY];
+    TEST_ASSERT_EQUAL_size_t(0, temp_history_read(&s_history, 0, INT64_MAX, out, STRESS_CAPACITY));
+
+    push_seq(0, 5);
+    TEST_ASSERT_EQUAL_size_t(5, temp_history_read(&s_history, 0, INT64_MAX, out, STRESS_CAPACITY));
+    TEST_ASSERT_EQUAL_INT64(1 * TS_STEP_US, out[0].timestamp_us);
+
+    // Інтервал [2, 4] мс
+    size_t n = temp_history_read(&s_history, 2 * TS_STEP_US, 4 * TS_STEP_US, out, STRESS_CAPACITY);
+    TEST_ASSERT_EQUAL_size_t(3, n);
+    TEST_ASSERT_EQUAL_INT64(2 * TS_STEP_US, out[0].timestamp_us);
+    TEST_ASSERT_EQUAL_INT64(4 * TS_STEP_US, out[2].timestamp_us);
+
+    // Обмеження місткості: повертаються найновіші
+    n = temp_history_read(&s_history, 0, INT64_MAX, out, 2);
+    TEST_ASSERT_EQUAL_size_t(2, n);
+    TEST_ASSERT_EQUAL_INT64(4 * TS_STEP_US, out[0].timestamp_us);
+    TEST_ASSERT_EQUAL_INT64(5 * TS_STEP_US, out[1].timestamp_us);
+}
+
+static void test_wraparound_keeps_capacity_minus_one(void) {
+    temp_history_entry_t out[STRESS_CAPACITY];
+    // Два з половиною оберти: найстаріший слот - наступний для запису, тому не повертається
+    uint32_t total = STRESS_CAPACITY * 5 / 2;
+    push_seq(0, total);
+    size_t n = temp_history_read(&s_history, 0, INT64_MAX, out, STRESS_CAPACITY);
+    TEST_ASSERT_EQUAL_size_t(STRESS_CAPACITY - 1, n);
+    for (size_t i = 0; i < n; i++) {
+        TEST_ASSERT_TRUE(entry_consistent(&out[i]));
+        TEST_ASSERT_EQUAL_INT64((int64_t)(total - n + i + 1) * TS_STEP_US, out[i].timestamp_us);
+    }
+}
+
+typedef struct {
+    uint64_t reads;
+    uint64_t entries;
+    uint64_t short_reads;   // Повернуто менше за capacity - 1: спрацювала перевірка після копіювання
+    uint64_t torn;
+    uint64_t out_of_order;
+} reader_stats_t;
+
+static atomic_bool s_stop;
+
+static void *writer_thread(void *arg) {
+    (void)arg;
+    temp_history_entry_t e;
+    memset(&e, 0, sizeof(e));
+    uint32_t seq = 0;
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed)) {
+        make_entry(seq++, &e);
+        temp_history_push(&s_history, &e);
+    }
+    return NULL;
+}
+
+static void *reader_thread(void *arg) {
+    reader_stats_t *st = arg;
+    temp_history_entry_t out[STRESS_CAPACITY];
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed)) {
+        uint32_t head = atomic_load_explicit(&s_history.head, memory_order_relaxed);
+        size_t n = temp_history_read(&s_history, 0, INT64_MAX, out, STRESS_CAPACITY);
+        st->reads++;
+        st->entries += n;
+        if (head > STRESS_CAPACITY && n < STRESS_CAPACITY - 1) st->short_reads++;
+        for (size_t i = 0; i < n; i++) {
+            if (!entry_consistent(&out[i])) st->torn++;
+            // Записи йдуть поспіль, без пропусків і повторів
+            if (i > 0 && out[i].timestamp_us != out[i - 1].timestamp_us + TS_STEP_US) st->out_of_order++;
+        }
+    }
+    return NULL;
+}
+
+static void test_concurrent_readers_never_see_overwritten_entries(void) {
+    pthread_t writer;
+    pthread_t readers[STRESS_READERS];
+    reader_stats_t stats[STRESS_READERS];
+    memset(stats, 0, sizeof(stats));
+    atomic_store(&s_stop, false);
+
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, reader_thread, &stats[i]));
+    }
+    TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, writer_thread, NULL));
+    usleep(STRESS_DURATION_MS * 1000);
+    atomic_store(&s_stop, true);
+    pthread_join(writer, NULL);
+    for (int i = 0; i < STRESS_READERS; i++) pthread_join(readers[i], NULL);
+
+    reader_stats_t sum = {0};
+    for (int i = 0; i < STRESS_READERS; i++) {
+        sum.reads += stats[i].reads;
+        sum.entries += stats[i].entries;
+        sum.short_reads += stats[i].short_reads;
+        sum.torn += stats[i].torn;
+        sum.out_of_order += stats[i].out_of_order;
+    }
+    uint32_t pushed = atomic_load(&s_history.head);
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "pushed %u, reads %llu, entries %llu, discarded by head check %llu",
+             (unsigned)pushed, (unsigned long long)sum.reads, (unsigned long long)sum.entries,
+             (unsigned long long)sum.short_reads);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT64(0, sum.torn);
+    TEST_ASSERT_EQUAL_UINT64(0, sum.out_of_order);
+    TEST_ASSERT_GREATER_THAN_UINT32(STRESS_CAPACITY * 100, pushed);
+    TEST_ASSERT_GREATER_THAN_UINT64(0, sum.entries);
+    // На одному ядрі записувач рідко витісняє читача посеред копіювання
+    if (sysconf(_SC_NPROCESSORS_ONLN) > 1) {
+        TEST_ASSERT_GREATER_THAN_UINT64(0, sum.short_reads);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_init_rejects_budget_below_one_entry);
+    RUN_TEST(test_read_selects_interval_and_newest);
+    RUN_TEST(test_wraparound_keeps_capacity_minus_one);
+    RUN_TEST(test_concurrent_readers_never_see_overwritten_entries);
+    return UNITY_END();
+}
@@ -0,0 +1,419 @@
+/**
+ * @brief Машина станів main_control: таблиця переходів за причинами, пріоритет аварії,
+ * захист BOOT, скидання ПІД, тайм-аут меню вибору, журнал і автоналаштування.
+ * Стан модуля статичний і не скидається, тому перший тест виконується ще з BOOT,
+ * а решта починає з OFF через внутрішній перехід. Наприкінці - вартість переходу.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "hw_config.h"
+#include "model/main_control.h"
+#include "model/settings_manager.h"
+#include "model/system_state.h"
+#include "controller/actuator/relay_controller.h"
+
+#define TRANSITION_STEP_US  1000000LL   // Крок годинника між переходами, щоб журнал мав різні часи
+#define BENCH_TRANSITIONS   200000
+
+static int64_t s_now_us;
+
+static int64_t now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+// Модулі мають статичний стан, тому ініціалізуються один раз на процес
+static void init_once(void) {
+    static bool done = false;
+    if (done) return;
+    done = true;
+
+    esp_log_level_set("*", ESP_LOG_NONE);
+    host_nvs_reset();
+    host_gpio_reset();
+    host_clock_reset(0);
+    host_timers_reset();
+    system_state_init();
+    TEST_ASSERT_EQUAL(ESP_OK, settings_init());
+    TEST_ASSERT_EQUAL(ESP_OK, relay_controller_init(GPIO_RELAY, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_init());
+}
+
+static void advance_us(int64_t dt_us) {
+    s_now_us += dt_us;
+    host_clock_set_us(s_now_us);
+}
+
+static esp_err_t change(system_state_t to, main_control_cause_t cause) {
+    advance_us(TRANSITION_STEP_US);
+    return main_control_change_state(to, cause);
+}
+
+static uint32_t journal_length(void) {
+    main_control_transition_t j[MAIN_CONTROL_JOURNAL_SIZE];
+    return (uint32_t)main_control_get_journal(j, MAIN_CONTROL_JOURNAL_SIZE);
+}
+
+static main_control_transition_t journal_newest(void) {
+    main_control_transition_t e;
+    memset(&e, 0, sizeof(e));
+    TEST_ASSERT_EQUAL_INT(1, main_control_get_journal(&e, 1));
+    return e;
+}
+
+// Переводить систему в стан state найкоротшим дозволеним шляхом з OFF
+static void go_to(system_state_t state) {
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_OFF, MAIN_CONTROL_CAUSE_INTERNAL));
+    switch (state) {
+        case STATE_OFF:
+            break;
+        case STATE_EMERGENCY:
+            TEST_ASSERT_EQUAL(ESP_OK, change(state, MAIN_CONTROL_CAUSE_SAFETY));
+            break;
+        case STATE_MODE_SELECT:
+            TEST_ASSERT_EQUAL(ESP_OK, change(state, MAIN_CONTROL_CAUSE_BUTTON));
+            break;
+        case STATE_AUTOTUNE:
+            TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+            break;
+        default:
+            TEST_ASSERT_EQUAL(ESP_OK, change(state, MAIN_CONTROL_CAUSE_WEB));
+            break;
+    }
+    TEST_ASSERT_EQUAL(state, main_control_get_state());
+    // Прапорці попередніх переходів не мають впливати на перевірки тесту
+    main_control_take_pid_reset();
+    pid_autotune_config_t cfg;
+    system_state_t ret;
+    main_control_take_autotune(&cfg, &ret);
+}
+
+void setUp(void) {
+    init_once();
+}
+
+void tearDown(void) {}
+
+static void test_boot_accepts_only_boot_and_service_causes(void) {
+    // Виконується першим: модуль ще в BOOT
+    TEST_ASSERT_EQUAL(STATE_BOOT, main_control_get_state());
+    TEST_ASSERT_EQUAL_STRING("UNKNOWN", state_to_string(STATE_BOOT));
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_BUTTON));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_OFF, MAIN_CONTROL_CAUSE_TIMEOUT));
+    TEST_ASSERT_EQUAL(STATE_BOOT, main_control_get_state());
+    TEST_ASSERT_EQUAL_UINT32(0, journal_length());
+
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_OFF, MAIN_CONTROL_CAUSE_BOOT));
+    TEST_ASSERT_EQUAL(STATE_OFF, main_control_get_state());
+    main_control_transition_t e = journal_newest();
+    TEST_ASSERT_EQUAL(STATE_BOOT, e.from);
+    TEST_ASSERT_EQUAL(STATE_OFF, e.to);
+    TEST_ASSERT_EQUAL(MAIN_CONTROL_CAUSE_BOOT, e.cause);
+
+    // Повернутися в BOOT не можна ні за якої причини
+    for (int c = 0; c < MAIN_CONTROL_CAUSE_COUNT; c++) {
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_BOOT, (main_control_cause_t)c));
+    }
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_BOOT));
+}
+
+typedef struct {
+    system_state_t from;
+    system_state_t to;
+    main_control_cause_t cause;
+    esp_err_t expected;
+} transition_case_t;
+
+static void test_transitions_follow_table_per_cause(void) {
+    static const transition_case_t cases[] = {
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_WEB,      ESP_OK },
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_BUTTON,   ESP_OK },
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_TIMEOUT,  ESP_ERR_INVALID_STATE },
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_SAFETY,   ESP_ERR_INVALID_STATE },
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_AUTOTUNE, ESP_ERR_INVALID_STATE },
+        { STATE_OFF,         STATE_MANUAL,      MAIN_CONTROL_CAUSE_INTERNAL, ESP_ERR_INVALID_STATE },
+        { STATE_MANUAL,      STATE_ADAPTIVE,    MAIN_CONTROL_CAUSE_WEB,      ESP_OK },
+        { STATE_MANUAL,      STATE_OFF,         MAIN_CONTROL_CAUSE_INTERNAL, ESP_OK },
+        { STATE_OFF,         STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON,   ESP_OK },
+        { STATE_OFF,         STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_WEB,      ESP_ERR_INVALID_STATE },
+        { STATE_OFF,         STATE_AUTOTUNE,    MAIN_CONTROL_CAUSE_WEB,      ESP_ERR_INVALID_STATE },
+        { STATE_OFF,         STATE_EMERGENCY,   MAIN_CONTROL_CAUSE_WEB,      ESP_ERR_INVALID_STATE },
+        { STATE_MODE_SELECT, STATE_ADAPTIVE,    MAIN_CONTROL_CAUSE_TIMEOUT,  ESP_OK },
+        { STATE_MODE_SELECT, STATE_OFF,         MAIN_CONTROL_CAUSE_BUTTON,   ESP_OK },
+        { STATE_MODE_SELECT, STATE_AUTOTUNE,    MAIN_CONTROL_CAUSE_TIMEOUT,  ESP_ERR_INVALID_STATE },
+        { STATE_MANUAL,      STATE_PROGRAMMED,  MAIN_CONTROL_CAUSE_TIMEOUT,  ESP_ERR_INVALID_STATE },
+        { STATE_EMERGENCY,   STATE_OFF,         MAIN_CONTROL_CAUSE_WEB,      ESP_OK },
+        { STATE_EMERGENCY,   STATE_MANUAL,      MAIN_CONTROL_CAUSE_BUTTON,   ESP_OK },
+        { STATE_EMERGENCY,   STATE_AUTOTUNE,    MAIN_CONTROL_CAUSE_AUTOTUNE, ESP_ERR_INVALID_STATE },
+        { STATE_EMERGENCY,   STATE_MANUAL,      MAIN_CONTROL_CAUSE_TIMEOUT,  ESP_ERR_INVALID_STATE },
+        { STATE_AUTOTUNE,    STATE_MANUAL,      MAIN_CONTROL_CAUSE_AUTOTUNE, ESP_OK },
+        { STATE_AUTOTUNE,    STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_AUTOTUNE, ESP_ERR_INVALID_STATE },
+        { STATE_AUTOTUNE,    STATE_OFF,         MAIN_CONTROL_CAUSE_WEB,      ESP_OK },
+        { STATE_ANTI_FREEZE, STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON,   ESP_OK },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const transition_case_t *c = &cases[i];
+        char msg[96];
+        snprintf(msg, sizeof(msg), "%s -> %s (%s)", state_to_string(c->from), state_to_string(c->to),
+                 main_control_cause_to_string(c->cause));
+
+        go_to(c->from);
+        uint32_t before = journal_length();
+        main_control_transition_t last = journal_newest();
+        TEST_ASSERT_EQUAL_MESSAGE(c->expected, change(c->to, c->cause), msg);
+
+        main_control_transition_t e = journal_newest();
+        if (c->expected == ESP_OK) {
+            TEST_ASSERT_EQUAL_MESSAGE(c->to, main_control_get_state(), msg);
+            TEST_ASSERT_EQUAL_MESSAGE(c->from, e.from, msg);
+            TEST_ASSERT_EQUAL_MESSAGE(c->to, e.to, msg);
+            TEST_ASSERT_EQUAL_MESSAGE(c->cause, e.cause, msg);
+            TEST_ASSERT_EQUAL_INT64_MESSAGE(s_now_us, e.uptime_us, msg);
+        } else {
+            // Відхилений перехід не змінює стан і не потрапляє в журнал
+            TEST_ASSERT_EQUAL_MESSAGE(c->from, main_control_get_state(), msg);
+            TEST_ASSERT_EQUAL_UINT32_MESSAGE(before, journal_length(), msg);
+            TEST_ASSERT_EQUAL_INT64_MESSAGE(last.uptime_us, e.uptime_us, msg);
+        }
+    }
+
+    // Перехід у поточний стан успішний, але нічого не записує
+    go_to(STATE_MANUAL);
+    main_control_transition_t last = journal_newest();
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_TIMEOUT));
+    TEST_ASSERT_EQUAL_INT64(last.uptime_us, journal_newest().uptime_us);
+
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, change(STATE_COUNT, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, change(STATE_OFF, MAIN_CONTROL_CAUSE_COUNT));
+    TEST_ASSERT_EQUAL(STATE_MANUAL, main_control_get_state());
+}
+
+static void test_safety_has_priority_from_any_state(void) {
+    for (int s = STATE_OFF; s < STATE_COUNT; s++) {
+        if (s == STATE_EMERGENCY) continue;
+        go_to((system_state_t)s);
+        relay_controller_set_heater_state(true);
+        system_state_set_error_code(3, 1);
+
+        TEST_ASSERT_EQUAL_MESSAGE(ESP_OK, change(STATE_EMERGENCY, MAIN_CONTROL_CAUSE_SAFETY),
+                                  state_to_string((system_state_t)s));
+        TEST_ASSERT_EQUAL(STATE_EMERGENCY, main_control_get_state());
+        TEST_ASSERT_FALSE_MESSAGE(relay_controller_get_heater_state(), state_to_string((system_state_t)s));
+
+        sensors_state_t st;
+        system_state_get(&st);
+        TEST_ASSERT_EQUAL(STATE_EMERGENCY, st.system_state);
+
+        // Безпека не має інших переходів, а з аварії виводить лише користувач
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_OFF, MAIN_CONTROL_CAUSE_SAFETY));
+        TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_TIMEOUT));
+        TEST_ASSERT_EQUAL(ESP_OK, change(STATE_OFF, MAIN_CONTROL_CAUSE_WEB));
+        system_state_get(&st);
+        TEST_ASSERT_EQUAL_INT(0, st.error_code);
+        TEST_ASSERT_EQUAL(UI_STATE_MAIN_SCREEN, st.ui_state);
+    }
+}
+
+static void test_pid_reset_only_when_entering_heating(void) {
+    go_to(STATE_OFF);
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_MANUAL, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_TRUE(main_control_take_pid_reset());
+    TEST_ASSERT_FALSE(main_control_take_pid_reset());
+
+    // Між режимами з ПІД інтеграл зберігається
+    static const system_state_t heating[] = { STATE_ADAPTIVE, STATE_PROGRAMMED, STATE_ANTI_FREEZE, STATE_MANUAL };
+    for (size_t i = 0; i < sizeof(heating) / sizeof(heating[0]); i++) {
+        TEST_ASSERT_EQUAL(ESP_OK, change(heating[i], MAIN_CONTROL_CAUSE_BUTTON));
+        TEST_ASSERT_FALSE_MESSAGE(main_control_take_pid_reset(), state_to_string(heating[i]));
+    }
+
+    // Меню, аварія й автоналаштування не мають ПІД: повернення з них скидає регулятор
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON));
+    TEST_ASSERT_FALSE(main_control_take_pid_reset());
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_ADAPTIVE, MAIN_CONTROL_CAUSE_TIMEOUT));
+    TEST_ASSERT_TRUE(main_control_take_pid_reset());
+
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_EMERGENCY, MAIN_CONTROL_CAUSE_SAFETY));
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_PROGRAMMED, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_TRUE(main_control_take_pid_reset());
+
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_ZN_PI, 20.0f));
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_PROGRAMMED, MAIN_CONTROL_CAUSE_AUTOTUNE));
+    TEST_ASSERT_TRUE(main_control_take_pid_reset());
+
+    // Вихід з обігріву прапорця не ставить
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_OFF, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_FALSE(main_control_take_pid_reset());
+}
+
+static void test_mode_select_times_out_into_preview(void) {
+    go_to(STATE_OFF);
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_MODE_SELECT, MAIN_CONTROL_CAUSE_BUTTON));
+    sensors_state_t st;
+    system_state_get(&st);
+    TEST_ASSERT_EQUAL(UI_STATE_SELECT_MENU, st.ui_state);
+    TEST_ASSERT_EQUAL(STATE_MANUAL, main_control_get_preview_state());
+
+    // Меню перебирає лише режими з ПІД і замикається по колу
+    main_control_cycle_preview_mode(false);
+    TEST_ASSERT_EQUAL(STATE_ANTI_FREEZE, main_control_get_preview_state());
+    main_control_cycle_preview_mode(true);
+    main_control_cycle_preview_mode(true);
+    main_control_cycle_preview_mode(true);
+    TEST_ASSERT_EQUAL(STATE_PROGRAMMED, main_control_get_preview_state());
+
+    // Кожне натискання перезапускає тайм-аут
+    advance_us(4900000LL);
+    main_control_update();
+    TEST_ASSERT_EQUAL(STATE_MODE_SELECT, main_control_get_state());
+    main_control_cycle_preview_mode(true);
+    TEST_ASSERT_EQUAL(STATE_ANTI_FREEZE, main_control_get_preview_state());
+    advance_us(4900000LL);
+    main_control_update();
+    TEST_ASSERT_EQUAL(STATE_MODE_SELECT, main_control_get_state());
+    main_control_cycle_preview_mode(false);
+
+    advance_us(5100000LL);
+    main_control_update();
+    TEST_ASSERT_EQUAL(STATE_PROGRAMMED, main_control_get_state());
+    main_control_transition_t e = journal_newest();
+    TEST_ASSERT_EQUAL(STATE_MODE_SELECT, e.from);
+    TEST_ASSERT_EQUAL(MAIN_CONTROL_CAUSE_TIMEOUT, e.cause);
+    system_state_get(&st);
+    TEST_ASSERT_EQUAL(UI_STATE_MAIN_SCREEN, st.ui_state);
+
+    // Поза меню перебір і тайм-аут нічого не роблять
+    main_control_cycle_preview_mode(true);
+    TEST_ASSERT_EQUAL(STATE_PROGRAMMED, main_control_get_preview_state());
+    advance_us(60000000LL);
+    main_control_update();
+    TEST_ASSERT_EQUAL(STATE_PROGRAMMED, main_control_get_state());
+}
+
+static void test_journal_wraps_newest_first(void) {
+    go_to(STATE_MANUAL);
+    const int transitions = MAIN_CONTROL_JOURNAL_SIZE + 6;
+    for (int i = 0; i < transitions; i++) {
+        system_state_t to = (i % 2 == 0) ? STATE_ADAPTIVE : STATE_MANUAL;
+        TEST_ASSERT_EQUAL(ESP_OK, change(to, MAIN_CONTROL_CAUSE_WEB));
+    }
+
+    main_control_transition_t j[MAIN_CONTROL_JOURNAL_SIZE + 4];
+    int n = main_control_get_journal(j, MAIN_CONTROL_JOURNAL_SIZE + 4);
+    TEST_ASSERT_EQUAL_INT(MAIN_CONTROL_JOURNAL_SIZE, n);
+
+    // Останній перехід (i = transitions - 1, непарний) - у MANUAL
+    TEST_ASSERT_EQUAL(STATE_MANUAL, j[0].to);
+    TEST_ASSERT_EQUAL_INT64(s_now_us, j[0].uptime_us);
+    for (int i = 0; i < n; i++) {
+        TEST_ASSERT_EQUAL_INT64(s_now_us - (int64_t)i * TRANSITION_STEP_US, j[i].uptime_us);
+        TEST_ASSERT_EQUAL(MAIN_CONTROL_CAUSE_WEB, j[i].cause);
+        if (i + 1 < n) TEST_ASSERT_EQUAL(j[i].from, j[i + 1].to);
+    }
+
+    // Менший буфер отримує найновіші записи
+    main_control_transition_t head[3];
+    TEST_ASSERT_EQUAL_INT(3, main_control_get_journal(head, 3));
+    TEST_ASSERT_EQUAL_MEMORY(j, head, sizeof(head));
+}
+
+static void test_autotune_pending_and_cancel(void) {
+    const app_settings_t *cfg = settings_get();
+
+    // Уставка поза межами кімнати відхиляється без зміни стану
+    go_to(STATE_MANUAL);
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, NAN));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_ARG,
+                      main_control_start_autotune(PID_TUNE_RULE_ZN_PID, cfg->control.limits.room_max + 0.5f));
+    TEST_ASSERT_EQUAL(STATE_MANUAL, main_control_get_state());
+
+    // Запуск очікує циклу керування вже в момент входу і забирається один раз
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_TYREUS_LUYBEN, 21.0f));
+    TEST_ASSERT_EQUAL(STATE_AUTOTUNE, main_control_get_state());
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+    pid_autotune_config_t at;
+    system_state_t ret = STATE_BOOT;
+    TEST_ASSERT_TRUE(main_control_take_autotune(&at, &ret));
+    TEST_ASSERT_EQUAL(STATE_MANUAL, ret);
+    TEST_ASSERT_EQUAL_FLOAT(21.0f, at.setpoint);
+    TEST_ASSERT_EQUAL(PID_TUNE_RULE_TYREUS_LUYBEN, at.rule);
+    TEST_ASSERT_TRUE(at.hysteresis > 0.0f && at.timeout_us > 0);
+    TEST_ASSERT_FALSE(main_control_take_autotune(&at, &ret));
+    TEST_ASSERT_EQUAL(ESP_OK, change(ret, MAIN_CONTROL_CAUSE_AUTOTUNE));
+
+    // Вихід до того, як цикл забрав запуск, скасовує його
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_OFF, MAIN_CONTROL_CAUSE_WEB));
+    TEST_ASSERT_FALSE(main_control_take_autotune(&at, &ret));
+
+    // Аварія під час очікування теж скасовує запуск
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+    TEST_ASSERT_EQUAL(ESP_OK, change(STATE_EMERGENCY, MAIN_CONTROL_CAUSE_SAFETY));
+    TEST_ASSERT_FALSE(main_control_take_autotune(&at, &ret));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, main_control_start_autotune(PID_TUNE_RULE_ZN_PID, 20.0f));
+    TEST_ASSERT_FALSE(main_control_take_autotune(&at, &ret));
+    TEST_ASSERT_EQUAL(STATE_EMERGENCY, main_control_get_state());
+
+    // З меню вибору повертатися нікуди, тож після експерименту - OFF
+    go_to(STATE_MODE_SELECT);
+    TEST_ASSERT_EQUAL(ESP_OK, main_control_start_autotune(PID_TUNE_RULE_NO_OVERSHOOT, 19.0f));
+    TEST_ASSERT_TRUE(main_control_take_autotune(&at, &ret));
+    TEST_ASSERT_EQUAL(STATE_OFF, ret);
+}
+
+static void test_dispatch_cost(void) {
+    go_to(STATE_MANUAL);
+
+    int64_t t0 = now_ns();
+    for (int i = 0; i < BENCH_TRANSITIONS; i++) {
+        main_control_change_state((i % 2 == 0) ? STATE_ADAPTIVE : STATE_MANUAL, MAIN_CONTROL_CAUSE_WEB);
+    }
+    int64_t accepted_ns = now_ns() - t0;
+    TEST_ASSERT_EQUAL(STATE_MANUAL, main_control_get_state());
+
+    // Відхилений перехід проходить усю таблицю
+    t0 = now_ns();
+    for (int i = 0; i < BENCH_TRANSITIONS; i++) {
+        main_control_change_state(STATE_PROGRAMMED, MAIN_CONTROL_CAUSE_TIMEOUT);
+    }
+    int64_t rejected_ns = now_ns() - t0;
+    TEST_ASSERT_EQUAL(STATE_MANUAL, main_control_get_state());
+    TEST_ASSERT_EQUAL_UINT32(MAIN_CONTROL_JOURNAL_SIZE, journal_length());
+
+    t0 = now_ns();
+    volatile system_state_t sink = STATE_BOOT;
+    for (int i = 0; i < BENCH_TRANSITIONS; i++) sink = main_control_get_state();
+    int64_t read_ns = now_ns() - t0;
+    (void)sink;
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "transition: accepted %.0f ns, rejected %.0f ns, get_state %.0f ns",
+             (double)accepted_ns / BENCH_TRANSITIONS, (double)rejected_ns / BENCH_TRANSITIONS,
+             (double)read_ns / BENCH_TRANSITIONS);
+    TEST_MESSAGE(msg);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_boot_accepts_only_boot_and_service_causes);
+    RUN_TEST(test_transitions_follow_table_per_cause);
+    RUN_TEST(test_safety_has_priority_from_any_state);
+    RUN_TEST(test_pid_reset_only_when_entering_heating);
+    RUN_TEST(test_mode_select_times_out_into_preview);
+    RUN_TEST(test_journal_wraps_newest_first);
+    RUN_TEST(test_autotune_pending_and_cancel);
+    RUN_TEST(test_dispatch_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,186 @@
+/**
+ * @brief Таблиця перетворення NTC: похибка відносно B-рівняння та Стейнгарта–Гарта
+ * на всіх 4096 кодах і швидкодія табличного шляху проти прямого обчислення у float.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <time.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "drivers/sensor/temp_sensor_driver.h"
+
+#define LUT_CHECK_MIN_C   (-40.0)
+#define LUT_CHECK_MAX_C   (125.0)
+#define LUT_CORE_MIN_C    0.0       // Діапазон кімнати та радіатора
+#define LUT_CORE_MAX_C    60.0
+#define LUT_CORE_ERROR_C  0.045
+#define LUT_EDGE_ERROR_C  0.3       // На краях крива найкрутіша, а вузли ті самі
+#define BENCH_ROUNDS      200
+
+static const ntc_thermistor_config_t s_b_config = {
+    .nominal_resistance = 10000.0f,
+    .nominal_temperature_c = 25.0f,
+    .b_value = 3950.0f,
+    .fixed_resistor_ohms = 10000.0f,
+};
+
+// Типові коефіцієнти Стейнгарта–Гарта для 10 кОм NTC
+static const ntc_thermistor_config_t s_sh_config = {
+    .nominal_resistance = 10000.0f,
+    .nominal_temperature_c = 25.0f,
+    .b_value = 3950.0f,
+    .fixed_resistor_ohms = 10000.0f,
+    .use_steinhart_hart = true,
+    .sh_a = 1.009249522e-3f,
+    .sh_b = 2.378405444e-4f,
+    .sh_c = 2.019202697e-7f,
+};
+
+static ntc_sensor_handle_t s_b_sensor;
+static ntc_sensor_handle_t s_sh_sensor;
+
+// Опір термістора за кодом через ту саму характеристику калібрування, що й у драйвера
+static double resistance_at(const ntc_thermistor_config_t *cfg, int raw) {
+    double v = host_adc_raw_to_mv(raw) / 1000.0;
+    if (v <= 0.001 || v >= 3.3) return NAN;
+    return cfg->fixed_resistor_ohms * (3.3 / v - 1.0);
+}
+
+// Еталон у double
+static double reference_temp(const ntc_thermistor_config_t *cfg, int raw) {
+    double r = resistance_at(cfg, raw);
+    if (isnan(r)) return NAN;
+    double inv_t;
+    if (cfg->use_steinhart_hart) {
+        double ln_r = log(r);
+        inv_t = cfg->sh_a + cfg->sh_b * ln_r + cfg->sh_c * ln_r * ln_r * ln_r;
+    } else {
+        inv_t = 1.0 / (cfg->nominal_temperature_c + 273.15) + log(r / cfg->nominal_resistance) / cfg->b_value;
+    }
+    return 1.0 / inv_t - 273.15;
+}
+
+// Прямий шлях у float, як у драйвері до таблиці: калібрування і логарифм на кожну вибірку
+static float float_path_temp(const ntc_thermistor_config_t *cfg, int raw) {
+    float v = (float)host_adc_raw_to_mv(raw) / 1000.0f;
+    if (v <= 0.001f || v >= 3.3f) return NAN;
+    float r = cfg->fixed_resistor_ohms * ((3.3f / v) - 1.0f);
+    float t_kelvin = 1.0f / ((1.0f / (cfg->nominal_temperature_c + 273.15f)) +
+                             (1.0f / cfg->b_value) * logf(r / cfg->nominal_resistance));
+    return t_kelvin - 273.15f;
+}
+
+static int64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void check_lut_error(ntc_sensor_handle_t sensor, const ntc_thermistor_config_t *cfg, const char *name) {
+    double max_err = 0.0, core_err = 0.0, max_err_centi = 0.0;
+    int checked = 0;
+    for (int raw = 0; raw <= NTC_ADC_RAW_MAX; raw++) {
+        double exact = reference_temp(cfg, raw);
+        if (isnan(exact) || exact < LUT_CHECK_MIN_C || exact > LUT_CHECK_MAX_C) continue;
+
+        float approx;
+        TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_raw_to_temp(sensor, (float)raw, &approx));
+        int32_t centi;
+        TEST_ASSERT_EQUAL(ESP_OK, temp_sensor_driver_raw_q8_to_centi(sensor, (uint32_t)raw << NTC_RAW_Q8_SHIFT, &centi));
+
+        double err = fabs(approx - exact);
+        max_err = fmax(max_err, err);
+        if (exact >= LUT_CORE_MIN_C && exact <= LUT_CORE_MAX_C) core_err = fmax(core_err, err);
+        max_err_centi = fmax(max_err_centi, fabs(centi / 100.0 - exact));
+        checked++;
+    }
+
+    char msg[160];
+    snprintf(msg, sizeof(msg), "%s: %d codes, max error %.4f C in %.0f..%.0f C, %.4f C in %.0f..%.0f C, %.4f C centi",
+             name, checked, core_err, LUT_CORE_MIN_C, LUT_CORE_MAX_C, max_err, LUT_CHECK_MIN_C, LUT_CHECK_MAX_C,
+             max_err_centi);
+    TEST_MESSAGE(msg);
+
+    // Майже весь діапазон кодів потрапляє в -40..125 C
+    TEST_ASSERT_GREATER_THAN(3500, checked);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_CORE_ERROR_C, core_err);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_EDGE_ERROR_C, max_err);
+    // Цілочисельний шлях додає не більше половини сотої на округленні
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(LUT_EDGE_ERROR_C + 0.005, max_err_centi);
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_lut_matches_b_equation(void) {
+    check_lut_error(s_b_sensor, &s_b_config, "B-equation");
+}
+
+static void test_lut_matches_steinhart_hart(void) {
+    check_lut_error(s_sh_sensor, &s_sh_config, "Steinhart-Hart");
+}
+
+static void test_lut_outside_range_is_rejected(void) {
+    float t;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, temp_sensor_driver_raw_to_temp(s_b_sensor, -1.0f, &t));
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE, temp_sensor_driver_raw_to_temp(s_b_sensor, NTC_ADC_RAW_MAX + 1.0f, &t));
+    int32_t centi;
+    TEST_ASSERT_EQUAL(ESP_ERR_INVALID_STATE,
+                      temp_sensor_driver_raw_q8_to_centi(s_b_sensor, (uint32_t)(NTC_ADC_RAW_MAX + 1) << NTC_RAW_Q8_SHIFT, &centi));
+}
+
+static void test_benchmark_float_vs_table(void) {
+    volatile float sink = 0.0f;
+    const int samples = BENCH_ROUNDS * (NTC_ADC_RAW_MAX + 1);
+
+    int64_t t0 = now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int raw = 0; raw <= NTC_ADC_RAW_MAX; raw++) sink += float_path_temp(&s_b_config, raw);
+    }
+    int64_t t1 = now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int raw = 0; raw <= NTC_ADC_RAW_MAX; raw++) {
+            float t;
+            temp_sensor_driver_raw_to_temp(s_b_sensor, (float)raw, &t);
+            sink += t;
+        }
+    }
+    int64_t t2 = now_ns();
+    for (int r = 0; r < BENCH_ROUNDS; r++) {
+        for (int raw = 0; raw <= NTC_ADC_RAW_MAX; raw++) {
+            int32_t centi;
+            temp_sensor_driver_raw_q8_to_centi(s_b_sensor, (uint32_t)raw << NTC_RAW_Q8_SHIFT, &centi);
+            sink += (float)centi;
+        }
+    }
+    int64_t t3 = now_ns();
+    (void)sink;
+
+    double float_ns = (double)(t1 - t0) / samples;
+    double table_ns = (double)(t2 - t1) / samples;
+    double centi_ns = (double)(t3 - t2) / samples;
+    char msg[128];
+    snprintf(msg, sizeof(msg), "ns/sample: float %.1f, table %.1f, table centi %.1f (host)", float_ns, table_ns, centi_ns);
+    TEST_MESSAGE(msg);
+
+    // Таблиця не повинна бути повільнішою за обчислення логарифма навіть на ПК з FPU
+    TEST_ASSERT_LESS_THAN_FLOAT(float_ns, table_ns);
+}
+
+int main(int argc, char **argv) {
+    (void)argc;
+    (void)argv;
+    esp_log_level_set("*", ESP_LOG_NONE);
+    s_b_sensor = temp_sensor_driver_init_ntc(ADC_CHANNEL_6, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &s_b_config);
+    s_sh_sensor = temp_sensor_driver_init_ntc(ADC_CHANNEL_7, ADC_ATTEN_DB_12, ADC_BITWIDTH_12, &s_sh_config);
+
+    UNITY_BEGIN();
+    RUN_TEST(test_lut_matches_b_equation);
+    RUN_TEST(test_lut_matches_steinhart_hart);
+    RUN_TEST(test_lut_outside_range_is_rejected);
+    RUN_TEST(test_benchmark_float_vs_table);
+    return UNITY_END();
+}
@@ -0,0 +1,246 @@
+/**
+ * @brief Релейний автотюнінг на об'єкті першого порядку з запізненням (FOPDT): Ku за
+ * описувальною функцією реле з гістерезисом і період проти аналітичного граничного циклу,
+ * коефіцієнти кожного правила, тайм-аут і неусталені коливання.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "controller/actuator/pid_autotune.h"
+#include "esp_log.h"
+
+// Об'єкт: T = T_amb + K * u(t - theta) через ланку з tau; 50 % тримає кімнату на уставці
+#define PLANT_K        0.1f      // C на %
+#define PLANT_TAU_S    600.0f
+#define PLANT_DELAY_S  120
+#define PLANT_AMB_C    15.0f
+#define SETPOINT_C     20.0f
+#define HYST_C         0.3f
+#define STEP_S         1
+#define MAX_STEPS      (6 * 3600)
+#define RESULT_TOL     0.02f     // Відносна похибка Ku та Pu
+
+typedef struct {
+    float t;
+    float u_hist[PLANT_DELAY_S];
+    int pos;
+} fopdt_t;
+
+static fopdt_t s_plant;
+static pid_autotune_t s_at;
+
+static void plant_init(float t, float u) {
+    s_plant.t = t;
+    s_plant.pos = 0;
+    for (int i = 0; i < PLANT_DELAY_S; i++) s_plant.u_hist[i] = u;
+}
+
+// Точна дискретизація першого порядку при сталому за крок вході
+static float plant_step(float u) {
+    float delayed = s_plant.u_hist[s_plant.pos];
+    s_plant.u_hist[s_plant.pos] = u;
+    s_plant.pos = (s_plant.pos + 1) % PLANT_DELAY_S;
+    float target = PLANT_AMB_C + PLANT_K * delayed;
+    s_plant.t = target + (s_plant.t - target) * expf(-(float)STEP_S / PLANT_TAU_S);
+    return s_plant.t;
+}
+
+static pid_autotune_config_t config(pid_tune_rule_t rule, int64_t timeout_s) {
+    pid_autotune_config_t cfg = {
+        .setpoint = SETPOINT_C,
+        .hysteresis = HYST_C,
+        .output_high = 100.0f,
+        .output_low = 0.0f,
+        .timeout_us = timeout_s * 1000000LL,
+        .rule = rule,
+    };
+    return cfg;
+}
+
+static int run_relay_test(const pid_autotune_config_t *cfg) {
+    plant_init(SETPOINT_C - 1.0f, 50.0f);
+    int64_t now_us = 0;
+    pid_autotune_init(&s_at, cfg, s_plant.t, now_us);
+    float out = s_at.heating ? cfg->output_high : cfg->output_low;
+    int step = 0;
+    while (s_at.status == PID_AUTOTUNE_RUNNING && step < MAX_STEPS) {
+        float t = plant_step(out);
+        now_us += STEP_S * 1000000LL;
+        out = pid_autotune_update(&s_at, t, now_us);
+        step++;
+    }
+    TEST_ASSERT_EQUAL_FLOAT(cfg->output_low, out);
+    return step;
+}
+
+static void expect_within_pct(float expected, float actual, const char *name) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%s: %.2f vs %.2f (%+.1f %%)", name, actual, expected,
+             100.0f * (actual - expected) / expected);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(fabsf(expected) * RESULT_TOL, expected, actual, msg);
+}
+
+void setUp(void) {
+    memset(&s_at, 0, sizeof(s_at));
+}
+
+void tearDown(void) {}
+
+static void test_relay_matches_fopdt_limit_cycle(void) {
+    // Граничний цикл FOPDT під реле +-d з гістерезисом eps: після перемикання на рівні eps
+    // вихід ще theta росте до a = Kd - (Kd - eps) e^(-theta/tau), далі спадає до -eps за
+    // t1 = tau ln((a + Kd) / (Kd - eps)); період 2 (theta + t1)
+    const float kd = PLANT_K * 50.0f;
+    float a = kd - (kd - HYST_C) * expf(-(float)PLANT_DELAY_S / PLANT_TAU_S);
+    float t1 = PLANT_TAU_S * logf((a + kd) / (kd - HYST_C));
+    float expected_pu = 2.0f * ((float)PLANT_DELAY_S + t1);
+    float expected_ku = 4.0f * 50.0f / ((float)M_PI * sqrtf(a * a - HYST_C * HYST_C));
+
+    pid_autotune_config_t cfg = config(PID_TUNE_RULE_ZN_PID, 4 * 3600);
+    int steps = run_relay_test(&cfg);
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_DONE, s_at.status);
+    expect_within_pct(expected_ku, s_at.ku, "Ku, %/C");
+    expect_within_pct(expected_pu, s_at.pu_s, "Pu, s");
+
+    // Класичні Ku / Tu з перетину фази -180: arctan(w tau) + w theta = pi (лише довідково -
+    // для FOPDT перша гармоніка наближена, тож релейна оцінка відрізняється)
+    float lo = 0.0f, hi = (float)M_PI / PLANT_DELAY_S;
+    for (int i = 0; i < 60; i++) {
+        float w = 0.5f * (lo + hi);
+        if (atanf(w * PLANT_TAU_S) + w * PLANT_DELAY_S < (float)M_PI) lo = w; else hi = w;
+    }
+    float wu = 0.5f * (lo + hi);
+    char msg[128];
+    snprintf(msg, sizeof(msg), "done in %d s; phase crossover Ku %.1f %%/C, Tu %.0f s",
+             steps, sqrtf(1.0f + wu * wu * PLANT_TAU_S * PLANT_TAU_S) / PLANT_K, 2.0f * (float)M_PI / wu);
+    TEST_MESSAGE(msg);
+
+    float kp, ki, kd_gain;
+    TEST_ASSERT_EQUAL_INT(ESP_OK, pid_autotune_compute_gains(s_at.ku, s_at.pu_s, cfg.rule, &kp, &ki, &kd_gain));
+    TEST_ASSERT_EQUAL_FLOAT(kp, s_at.kp);
+    TEST_ASSERT_EQUAL_FLOAT(ki, s_at.ki);
+    TEST_ASSERT_EQUAL_FLOAT(kd_gain, s_at.kd);
+
+    // Після завершення вихід лишається вимкненим
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid_autotune_update(&s_at, SETPOINT_C - 5.0f, 100000000000LL));
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_DONE, s_at.status);
+}
+
+static void test_rule_gains(void) {
+    const float ku = 40.0f, pu = 600.0f;
+    // Kp, Ti, Td кожного правила; ki = Kp / Ti, kd = Kp * Td
+    const struct {
+        pid_tune_rule_t rule;
+        const char *name;
+        float kp, ti, td;
+    } rules[] = {
+        { PID_TUNE_RULE_ZN_PID, "zn_pid", 0.6f * ku, 0.5f * pu, 0.125f * pu },
+        { PID_TUNE_RULE_ZN_PI, "zn_pi", 0.45f * ku, pu / 1.2f, 0.0f },
+        { PID_TUNE_RULE_TYREUS_LUYBEN, "tyreus_luyben", ku / 2.2f, 2.2f * pu, pu / 6.3f },
+        { PID_TUNE_RULE_NO_OVERSHOOT, "no_overshoot", 0.2f * ku, 0.5f * pu, pu / 3.0f },
+    };
+
+    for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++) {
+        float kp, ki, kd;
+        TEST_ASSERT_EQUAL_INT(ESP_OK, pid_autotune_compute_gains(ku, pu, rules[i].rule, &kp, &ki, &kd));
+        TEST_ASSERT_FLOAT_WITHIN(1e-4f, rules[i].kp, kp);
+        TEST_ASSERT_FLOAT_WITHIN(1e-6f, rules[i].kp / rules[i].ti, ki);
+        TEST_ASSERT_FLOAT_WITHIN(1e-2f, rules[i].kp * rules[i].td, kd);
+        TEST_ASSERT_EQUAL_STRING(rules[i].name, pid_autotune_rule_to_string(rules[i].rule));
+    }
+    // Тюреус–Люйбен м'якший за Циглера–Нікольса за всіма трьома складовими
+    float zn_kp, zn_ki, zn_kd, tl_kp, tl_ki, tl_kd;
+    pid_autotune_compute_gains(ku, pu, PID_TUNE_RULE_ZN_PID, &zn_kp, &zn_ki, &zn_kd);
+    pid_autotune_compute_gains(ku, pu, PID_TUNE_RULE_TYREUS_LUYBEN, &tl_kp, &tl_ki, &tl_kd);
+    TEST_ASSERT_LESS_THAN_FLOAT(zn_kp, tl_kp);
+    TEST_ASSERT_LESS_THAN_FLOAT(zn_ki, tl_ki);
+    TEST_ASSERT_LESS_THAN_FLOAT(zn_kd, tl_kd);
+
+    float kp, ki, kd;
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, pid_autotune_compute_gains(0.0f, pu, PID_TUNE_RULE_ZN_PID, &kp, &ki, &kd));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, pid_autotune_compute_gains(ku, -1.0f, PID_TUNE_RULE_ZN_PID, &kp, &ki, &kd));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, pid_autotune_compute_gains(NAN, pu, PID_TUNE_RULE_ZN_PID, &kp, &ki, &kd));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, pid_autotune_compute_gains(ku, pu, (pid_tune_rule_t)17, &kp, &ki, &kd));
+    TEST_ASSERT_EQUAL_INT(ESP_ERR_INVALID_ARG, pid_autotune_compute_gains(ku, pu, PID_TUNE_RULE_ZN_PID, NULL, &ki, &kd));
+    TEST_ASSERT_EQUAL_STRING("unknown", pid_autotune_rule_to_string((pid_tune_rule_t)17));
+}
+
+static void test_every_rule_from_relay_test(void) {
+    const pid_tune_rule_t rules[] = {
+        PID_TUNE_RULE_ZN_PID, PID_TUNE_RULE_ZN_PI, PID_TUNE_RULE_TYREUS_LUYBEN, PID_TUNE_RULE_NO_OVERSHOOT,
+    };
+    float ku = 0.0f, pu = 0.0f;
+    for (size_t i = 0; i < sizeof(rules) / sizeof(rules[0]); i++) {
+        pid_autotune_config_t cfg = config(rules[i], 4 * 3600);
+        run_relay_test(&cfg);
+        TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_DONE, s_at.status);
+        // Правило не впливає на експеримент, лише на перерахунок
+        if (i > 0) {
+            TEST_ASSERT_EQUAL_FLOAT(ku, s_at.ku);
+            TEST_ASSERT_EQUAL_FLOAT(pu, s_at.pu_s);
+        }
+        ku = s_at.ku;
+        pu = s_at.pu_s;
+
+        float kp, ki, kd;
+        pid_autotune_compute_gains(ku, pu, rules[i], &kp, &ki, &kd);
+        TEST_ASSERT_EQUAL_FLOAT(kp, s_at.kp);
+        TEST_ASSERT_EQUAL_FLOAT(ki, s_at.ki);
+        TEST_ASSERT_EQUAL_FLOAT(kd, s_at.kd);
+    }
+}
+
+static void test_timeout_fails(void) {
+    // 20 хвилин не вистачає на перший підігрів і три повні періоди
+    pid_autotune_config_t cfg = config(PID_TUNE_RULE_ZN_PID, 1200);
+    int steps = run_relay_test(&cfg);
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_FAILED, s_at.status);
+    TEST_ASSERT_EQUAL_INT(1201, steps);
+    TEST_ASSERT_LESS_THAN_INT(PID_AUTOTUNE_CYCLES, s_at.cycles);
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, pid_autotune_update(&s_at, SETPOINT_C - 5.0f, 1201 * 1000000LL));
+}
+
+// Вимірювання перемикає реле на кожному кроці: мінімум -amp, максимум +amp
+static void run_scripted(const float *amp, int n_amp, int steps) {
+    int64_t now_us = 0;
+    for (int i = 0; i < steps && s_at.status == PID_AUTOTUNE_RUNNING; i++) {
+        float a = amp[(i / 2) % n_amp];
+        now_us += 60 * 1000000LL;
+        pid_autotune_update(&s_at, SETPOINT_C + (i % 2 ? a : -a), now_us);
+    }
+}
+
+static void test_unsettled_oscillation_fails(void) {
+    pid_autotune_config_t cfg = config(PID_TUNE_RULE_ZN_PID, 24 * 3600);
+    pid_autotune_init(&s_at, &cfg, SETPOINT_C, 0);
+    const float amp[] = { 0.5f, 1.5f };
+    run_scripted(amp, 2, 1000);
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_FAILED, s_at.status);
+    TEST_ASSERT_EQUAL_INT(10, s_at.cycles);
+}
+
+static void test_zero_relay_amplitude_fails(void) {
+    // Однакові вихідні рівні: коливання усталені, але d = 0 - Ku не визначений
+    pid_autotune_config_t cfg = config(PID_TUNE_RULE_ZN_PID, 24 * 3600);
+    cfg.output_high = cfg.output_low = 40.0f;
+    pid_autotune_init(&s_at, &cfg, SETPOINT_C, 0);
+    const float amp[] = { 0.5f };
+    run_scripted(amp, 1, 1000);
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_FAILED, s_at.status);
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_CYCLES, s_at.cycles);
+}
+
+int main(int argc, char **argv) {
+    esp_log_level_set("*", ESP_LOG_NONE);
+    UNITY_BEGIN();
+    RUN_TEST(test_relay_matches_fopdt_limit_cycle);
+    RUN_TEST(test_rule_gains);
+    RUN_TEST(test_every_rule_from_relay_test);
+    RUN_TEST(test_timeout_fails);
+    RUN_TEST(test_unsettled_oscillation_fails);
+    RUN_TEST(test_zero_relay_amplitude_fails);
+    return UNITY_END();
+}
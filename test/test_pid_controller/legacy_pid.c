@@ -0,0 +1,44 @@
+/**
+ * @brief Старий pid_compute (до антинасичення і похідної вимірювання) без зміни логіки.
+ */
+#include "legacy_pid.h"
+
+void legacy_pid_init(legacy_pid_t *pid, float kp, float ki, float kd, float out_min, float out_max) {
+    pid->kp = kp;
+    pid->ki = ki;
+    pid->kd = kd;
+    pid->out_min = out_min;
+    pid->out_max = out_max;
+    pid->integral = 0.0f;
+    pid->pre_error = 0.0f;
+}
+
+float legacy_pid_compute(legacy_pid_t *pid, float setpoint, float measured_value, float dt) {
+    if (dt <= 0.0f || dt > 100.0f) {
+        dt = 1.0f;
+    }
+
+    float error = setpoint - measured_value;
+    float p_out = pid->kp * error;
+
+    pid->integral += error * dt;
+    if (pid->integral > pid->out_max) {
+        pid->integral = pid->out_max;
+    } else if (pid->integral < pid->out_min) {
+        pid->integral = pid->out_min;
+    }
+    float i_out = pid->ki * pid->integral;
+
+    float derivative = (error - pid->pre_error) / dt;
+    float d_out = pid->kd * derivative;
+
+    float output = p_out + i_out + d_out;
+    if (output > pid->out_max) {
+        output = pid->out_max;
+    } else if (output < pid->out_min) {
+        output = pid->out_min;
+    }
+
+    pid->pre_error = error;
+    return output;
+}
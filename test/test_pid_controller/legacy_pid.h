@@ -0,0 +1,27 @@
+#ifndef LEGACY_PID_H
+#define LEGACY_PID_H
+
+/**
+ * @brief ПІД до переробки (шлях з float) для порівняння з поточним pid_controller.
+ *
+ * Обмежується сума помилки (а не внесок інтегралу), похідна береться від помилки без
+ * фільтра, коефіцієнти змінюються записом у поля.
+ */
+typedef struct {
+    float kp;
+    float ki;
+    float kd;
+    float out_min;
+    float out_max;
+    float integral;   // Сума помилки, C*с, обмежена [out_min, out_max]
+    float pre_error;
+} legacy_pid_t;
+
+void legacy_pid_init(legacy_pid_t *pid, float kp, float ki, float kd, float out_min, float out_max);
+
+/**
+ * @brief Крок старого алгоритму з явним інтервалом dt, с.
+ */
+float legacy_pid_compute(legacy_pid_t *pid, float setpoint, float measured_value, float dt);
+
+#endif // LEGACY_PID_H
@@ -0,0 +1,357 @@
+/**
+ * @brief ПІД у замкненому контурі, старий проти поточного, на двовузловій моделі кімнати з
+ * радіатором: IAE, перерегулювання і усталення після стрибка уставки; відсутність накопичення
+ * інтегралу в насиченні, імпульсу похідної на стрибку уставки та удару виходу при pid_track
+ * і pid_set_tuning.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "controller/actuator/pid_autotune.h"
+#include "controller/actuator/pid_controller.h"
+#include "esp_log.h"
+#include "legacy_pid.h"
+
+// Кімната й радіатор з test_closed_loop; вихід ПІД - середня потужність, без ШІМ
+#define OUTSIDE_C      5.0f
+#define SENSOR_NOISE_C 0.03f
+#define STEP_AT_S      (3 * 3600)
+#define RUN_S          (12 * 3600)
+#define SP_LOW_C       19.0f
+#define SP_HIGH_C      21.0f
+#define SETTLE_BAND_C  0.2f
+
+typedef struct {
+    const char *name;
+    float kp, ki, kd;
+} gains_t;
+
+typedef struct {
+    double iae_kh;        // Інтеграл |e| після стрибка, K*год
+    double overshoot_c;
+    double settle_h;      // Від стрибка до останнього виходу за SETTLE_BAND_C, год (-1 - не усталився)
+    double du_noise;      // Середній |du| за останню годину, % (шум виходу)
+} loop_result_t;
+
+typedef struct {
+    double room;
+    double rad;
+} plant_t;
+
+typedef struct {
+    plant_t plant;
+    double sensed;
+    double noise_c;
+    bool legacy;
+    legacy_pid_t old;
+} loop_t;
+
+enum { GAINS_DEFAULT = 0, GAINS_ZN, GAINS_TL, GAINS_COUNT };
+
+// Налаштування за замовчуванням; решта - з релейного автотюнінгу на цій же кімнаті
+static gains_t s_gains[GAINS_COUNT] = {
+    [GAINS_DEFAULT] = { "defaults", 10.0f, 0.1f, 0.5f },
+    [GAINS_ZN] = { "ZN-PID" },
+    [GAINS_TL] = { "Tyreus-L." },
+};
+
+static pid_controller_t s_pid;
+static int64_t s_now_us;
+
+static double gauss(void) {
+    double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+    double v = (rand() + 1.0) / (RAND_MAX + 2.0);
+    return sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v);
+}
+
+static void plant_step(plant_t *p, double duty_pct) {
+    double d_rad = 0.025 * duty_pct / 100.0 - (p->rad - p->room) / 1500.0;
+    double d_room = 2.1e-5 * (p->rad - p->room) - 1.4e-5 * (p->room - OUTSIDE_C);
+    p->rad += d_rad;
+    p->room += d_room;
+}
+
+// Рівновага при заданій температурі кімнати: потрібне заповнення, %
+static double equilibrium(plant_t *p, double room) {
+    double rad_excess = 1.4e-5 * (room - OUTSIDE_C) / 2.1e-5;
+    p->room = room;
+    p->rad = room + rad_excess;
+    return rad_excess / 1500.0 / 0.025 * 100.0;
+}
+
+static void tick(void) {
+    s_now_us += 1000000;
+    host_clock_set_us(s_now_us);
+}
+
+/**
+ * Кімната в рівновазі при sp; обидва регулятори підхоплюють потрібне заповнення
+ * (старий - через суму помилки, наскільки дозволяє її обмеження).
+ */
+static double loop_start(loop_t *l, const gains_t *g, bool legacy, float sp) {
+    srand(3);
+    double duty = equilibrium(&l->plant, sp);
+    l->sensed = l->plant.room;
+    l->noise_c = SENSOR_NOISE_C;
+    l->legacy = legacy;
+
+    legacy_pid_init(&l->old, g->kp, g->ki, g->kd, 0.0f, 100.0f);
+    l->old.integral = fminf(100.0f, (float)duty / g->ki);
+    host_clock_set_us(s_now_us = 0);
+    pid_init(&s_pid, g->kp, g->ki, g->kd, 0.0f, 100.0f);
+    pid_track(&s_pid, sp, (float)l->sensed, (float)duty);
+    return duty;
+}
+
+static double loop_step(loop_t *l, float sp) {
+    tick();
+    l->sensed += 0.3 * (l->plant.room + l->noise_c * gauss() - l->sensed);
+    double out = l->legacy ? legacy_pid_compute(&l->old, sp, (float)l->sensed, 1.0f)
+                           : pid_compute(&s_pid, sp, (float)l->sensed);
+    plant_step(&l->plant, out);
+    return out;
+}
+
+// Релейний експеримент навколо 20 C на моделі з шумом датчика, як у прошивці
+static void autotune_gains(void) {
+    plant_t plant;
+    equilibrium(&plant, 20.0);
+    double sensed = plant.room;
+    pid_autotune_config_t cfg = {
+        .setpoint = 20.0f,
+        .hysteresis = 0.1f,
+        .output_high = 100.0f,
+        .output_low = 0.0f,
+        .timeout_us = 24 * 3600 * 1000000LL,
+        .rule = PID_TUNE_RULE_ZN_PID,
+    };
+    pid_autotune_t at;
+    srand(5);
+    pid_autotune_init(&at, &cfg, (float)sensed, 0);
+    float out = at.heating ? cfg.output_high : cfg.output_low;
+    for (int t = 1; at.status == PID_AUTOTUNE_RUNNING; t++) {
+        plant_step(&plant, out);
+        sensed += 0.3 * (plant.room + SENSOR_NOISE_C * gauss() - sensed);
+        out = pid_autotune_update(&at, (float)sensed, (int64_t)t * 1000000);
+    }
+    TEST_ASSERT_EQUAL_INT(PID_AUTOTUNE_DONE, at.status);
+
+    gains_t *zn = &s_gains[GAINS_ZN], *tl = &s_gains[GAINS_TL];
+    TEST_ASSERT_EQUAL_INT(ESP_OK, pid_autotune_compute_gains(at.ku, at.pu_s, PID_TUNE_RULE_ZN_PID, &zn->kp, &zn->ki, &zn->kd));
+    TEST_ASSERT_EQUAL_INT(ESP_OK, pid_autotune_compute_gains(at.ku, at.pu_s, PID_TUNE_RULE_TYREUS_LUYBEN, &tl->kp, &tl->ki, &tl->kd));
+    char msg[96];
+    snprintf(msg, sizeof(msg), "relay test: Ku %.1f %%/C, Pu %.0f s", at.ku, at.pu_s);
+    TEST_MESSAGE(msg);
+}
+
+static loop_result_t run_step_response(const gains_t *g, bool legacy) {
+    loop_t l;
+    double prev = loop_start(&l, g, legacy, SP_LOW_C);
+
+    loop_result_t r = { .settle_h = -1.0 };
+    double last_out_of_band = STEP_AT_S, du_sum = 0.0;
+    int du_n = 0;
+    for (int t = 0; t < RUN_S; t++) {
+        float sp = t < STEP_AT_S ? SP_LOW_C : SP_HIGH_C;
+        double out = loop_step(&l, sp);
+        if (t >= STEP_AT_S) {
+            double e = l.plant.room - sp;
+            r.iae_kh += fabs(e) / 3600.0;
+            if (e > r.overshoot_c) r.overshoot_c = e;
+            if (fabs(e) > SETTLE_BAND_C) last_out_of_band = t;
+        }
+        if (t >= RUN_S - 3600) {
+            du_sum += fabs(out - prev);
+            du_n++;
+        }
+        prev = out;
+    }
+    // Усталеним вважається контур, що останню годину тримається в смузі
+    if (last_out_of_band < RUN_S - 3600) r.settle_h = (last_out_of_band - STEP_AT_S) / 3600.0;
+    r.du_noise = du_sum / du_n;
+    return r;
+}
+
+static void format_settle(char *buf, size_t size, double h) {
+    if (h < 0.0) snprintf(buf, size, "never");
+    else snprintf(buf, size, "%.1f h", h);
+}
+
+void setUp(void) {
+    host_clock_reset(0);
+    s_now_us = 0;
+}
+
+void tearDown(void) {}
+
+static void test_closed_loop_old_vs_new(void) {
+    autotune_gains();
+    TEST_MESSAGE("| gains     | IAE Kh old -> new | overshoot C    | settle 0.2 C     | |du| %         |");
+    TEST_MESSAGE("|-----------|-------------------|----------------|------------------|----------------|");
+    for (int i = 0; i < GAINS_COUNT; i++) {
+        loop_result_t o = run_step_response(&s_gains[i], true);
+        loop_result_t n = run_step_response(&s_gains[i], false);
+        char so[16], sn[16], row[160];
+        format_settle(so, sizeof(so), o.settle_h);
+        format_settle(sn, sizeof(sn), n.settle_h);
+        snprintf(row, sizeof(row), "| %-9s | %6.2f -> %6.2f  | %5.2f -> %5.2f | %6s -> %6s | %5.2f -> %5.2f |",
+                 s_gains[i].name, o.iae_kh, n.iae_kh, o.overshoot_c, n.overshoot_c, so, sn,
+                 o.du_noise, n.du_noise);
+        TEST_MESSAGE(row);
+
+        // Обмежена сума помилки не дає старому інтегралу втримати потрібне заповнення
+        TEST_ASSERT_LESS_THAN_FLOAT((float)o.iae_kh, (float)n.iae_kh);
+        if (i != GAINS_DEFAULT) {
+            // Налаштований регулятор усталюється; похідна з фільтром менше шумить на виході
+            TEST_ASSERT_TRUE(n.settle_h >= 0.0);
+            TEST_ASSERT_LESS_THAN_FLOAT(0.5f, (float)n.overshoot_c);
+            TEST_ASSERT_LESS_THAN_FLOAT(0.5f * (float)o.du_noise, (float)n.du_noise);
+        }
+    }
+}
+
+static void test_no_integral_windup_after_saturation(void) {
+    // Стрибок 19 -> 23 C: нагрівач годинами на 100 %, поки кімната доганяє уставку
+    const gains_t *g = &s_gains[GAINS_TL];
+    const float sp = 23.0f;
+    plant_t eq;
+    const double hold_duty = equilibrium(&eq, sp);
+    loop_t l;
+    loop_start(&l, g, false, SP_LOW_C);
+    l.noise_c = 0.0;
+
+    double i_at_release = NAN, overshoot = 0.0;
+    int saturated_s = 0;
+    for (int t = 0; t < 24 * 3600; t++) {
+        double out = loop_step(&l, sp);
+        if (out >= 100.0) {
+            saturated_s++;
+        } else if (isnan(i_at_release)) {
+            i_at_release = s_pid._i_term;
+        }
+        overshoot = fmax(overshoot, l.plant.room - sp);
+    }
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "saturated %.1f h, integral %.1f %% at release (hold %.1f %%), overshoot %.3f C",
+             saturated_s / 3600.0, i_at_release, hold_duty, overshoot);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_GREATER_THAN_INT(3600, saturated_s);
+    // Зворотний розрахунок не дає інтегралу набрати помилку часу насичення: на виході з
+    // нього інтеграл не більший за заповнення, що тримає нову уставку
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT((float)hold_duty + 5.0f, (float)i_at_release);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.3f, (float)overshoot);
+}
+
+static void test_no_derivative_kick_on_setpoint_step(void) {
+    // Td = 300 с: старий регулятор диференціює помилку і на стрибку уставки насичується
+    const float kp = 2.0f, ki = 0.001f, kd = 600.0f, dr = 0.5f;
+    legacy_pid_t old;
+    legacy_pid_init(&old, kp, ki, kd, 0.0f, 100.0f);
+    old.integral = 40.0f / ki > 100.0f ? 100.0f : 40.0f / ki;
+    pid_init(&s_pid, kp, ki, kd, 0.0f, 100.0f);
+    pid_track(&s_pid, 20.0f, 20.0f, 40.0f);
+
+    float u_old = 0.0f, u_new = 0.0f;
+    for (int i = 0; i < 10; i++) {
+        tick();
+        u_old = legacy_pid_compute(&old, 20.0f, 20.0f, 1.0f);
+        u_new = pid_compute(&s_pid, 20.0f, 20.0f);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 40.0f, u_new);
+
+    tick();
+    float du_old = legacy_pid_compute(&old, 20.0f + dr, 20.0f, 1.0f) - u_old;
+    float step = pid_compute(&s_pid, 20.0f + dr, 20.0f);
+    float du_new = step - u_new;
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "output step on +%.1f C: old %+.1f %%, new %+.2f %% (kp*dr %.2f %%)", dr, du_old, du_new, kp * dr);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_GREATER_THAN_FLOAT(10.0f * kp * dr, du_old);
+    // Лише пропорційна складова та крок інтегралу, без імпульсу похідної
+    TEST_ASSERT_FLOAT_WITHIN(ki * dr + 1e-4f, kp * dr, du_new);
+    for (int i = 0; i < 60; i++) {
+        tick();
+        float u = pid_compute(&s_pid, 20.0f + dr, 20.0f);
+        TEST_ASSERT_FLOAT_WITHIN(ki * dr + 1e-4f, step, u);
+        step = u;
+    }
+
+    // Вага уставки b = 0.5 вдвічі зменшує і пропорційну реакцію
+    pid_set_weighting(&s_pid, 0.5f, PID_DEFAULT_D_FILTER_N);
+    pid_track(&s_pid, 20.0f, 20.0f, 40.0f);
+    tick();
+    TEST_ASSERT_FLOAT_WITHIN(1e-4f, 40.0f, pid_compute(&s_pid, 20.0f, 20.0f));
+    tick();
+    TEST_ASSERT_FLOAT_WITHIN(ki * dr + 1e-4f, 40.0f + 0.5f * kp * dr, pid_compute(&s_pid, 20.0f + dr, 20.0f));
+}
+
+static void test_track_is_bumpless(void) {
+    // Виходом годину керує інший режим (MPC, автоналаштування), кімната дрейфує
+    const gains_t *g = &s_gains[GAINS_TL];
+    loop_t l;
+    const double external = loop_start(&l, g, false, SP_LOW_C) + 5.0;
+    l.noise_c = 0.0;
+    for (int t = 0; t < 3600; t++) {
+        tick();
+        l.sensed += 0.3 * (l.plant.room - l.sensed);
+        pid_track(&s_pid, SP_LOW_C, (float)l.sensed, (float)external);
+        plant_step(&l.plant, external);
+    }
+    // Перший крок ПІД продовжує застосований вихід
+    double first = loop_step(&l, SP_LOW_C);
+    char msg[96];
+    snprintf(msg, sizeof(msg), "handover: %.2f %% -> %.2f %%", external, first);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, (float)external, (float)first);
+
+    // Вихід поза межами обмежується, інтеграл не набирає запасу понад межу
+    pid_track(&s_pid, SP_LOW_C, (float)l.sensed, 150.0f);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(100.0f, s_pid._i_term);
+    tick();
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(100.0f, (float)pid_compute(&s_pid, SP_LOW_C, (float)l.sensed));
+}
+
+static void test_set_tuning_is_bumpless(void) {
+    // Контур усталений на Тюреусі–Люйбені, автоналаштування підставляє Циглера–Нікольса
+    const gains_t *from = &s_gains[GAINS_TL], *to = &s_gains[GAINS_ZN];
+    double jump[2];
+    for (int legacy = 0; legacy < 2; legacy++) {
+        loop_t l;
+        loop_start(&l, from, legacy, SP_HIGH_C);
+        l.noise_c = 0.0;
+        double prev = 0.0;
+        for (int t = 0; t < 6 * 3600; t++) prev = loop_step(&l, SP_HIGH_C);
+        if (legacy) {
+            l.old.kp = to->kp;
+            l.old.ki = to->ki;
+            l.old.kd = to->kd;
+        } else {
+            pid_set_tuning(&s_pid, to->kp, to->ki, to->kd);
+        }
+        jump[legacy] = loop_step(&l, SP_HIGH_C) - prev;
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "output jump on retune: old %+.2f %%, new %+.3f %%", jump[1], jump[0]);
+    TEST_MESSAGE(msg);
+    // Старий інтеграл - сума помилки, тож новий ki перемасштабовує накопичене
+    TEST_ASSERT_GREATER_THAN_FLOAT(1.0f, (float)fabs(jump[1]));
+    TEST_ASSERT_LESS_THAN_FLOAT(0.05f, (float)fabs(jump[0]));
+}
+
+int main(int argc, char **argv) {
+    esp_log_level_set("*", ESP_LOG_NONE);
+    UNITY_BEGIN();
+    RUN_TEST(test_closed_loop_old_vs_new);
+    RUN_TEST(test_no_integral_windup_after_saturation);
+    RUN_TEST(test_no_derivative_kick_on_setpoint_step);
+    RUN_TEST(test_track_is_bumpless);
+    RUN_TEST(test_set_tuning_is_bumpless);
+    return UNITY_END();
+}
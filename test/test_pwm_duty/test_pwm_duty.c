@@ -0,0 +1,544 @@
+/**
+ * @brief ШІМ реле на віртуальному годиннику: справжні pwm_manager і relay_controller.
+ * Перевіряє, що злиття коротких імпульсів (quantize_on_ms / start_cycle з перенесенням
+ * боргу) зберігає середнє заповнення, а імпульси й паузи не коротші за мінімальні -
+ * зокрема через pwm_manager_reset і відсічку за перегрівом радіатора.
+ * Окремо - точні моменти фронтів: сітка періодів без дрейфу, мілісекундне заповнення
+ * на періоді SSR коротшому за секунду, обрив імпульсу при зменшенні завдання і фазові зсуви зон.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "hw_config.h"
+#include "model/settings_manager.h"
+#include "controller/actuator/pwm_manager.h"
+#include "controller/actuator/relay_controller.h"
+
+#define CYCLE_S        60
+#define CYCLE_US       (CYCLE_S * 1000000LL)
+#define RUN_CYCLES     200
+#define UPDATE_STEP_US 1000000LL   // Цикл керування викликає pwm_manager_update щосекунди
+#define RAD_TEMP_C     30.0f
+#define EDGE_ZONES     3
+#define EDGE_LOG_MAX   2048
+
+typedef struct {
+    int64_t on_us;           // Сумарний час увімкнення
+    int64_t shortest_on_us;  // Найкоротший завершений імпульс
+    int64_t shortest_off_us; // Найкоротша завершена пауза між імпульсами
+    uint32_t rising;         // Кількість увімкнень
+} pwm_trace_t;
+
+static app_settings_t *s_cfg;
+static app_settings_t s_defaults;
+
+// Модулі мають статичний стан і таймер, тому ініціалізуються один раз на процес
+static void init_once(void) {
+    static bool done = false;
+    if (done) return;
+    done = true;
+
+    esp_log_level_set("*", ESP_LOG_NONE);
+    host_nvs_reset();
+    host_gpio_reset();
+    host_clock_reset(0);
+    host_timers_reset();
+    TEST_ASSERT_EQUAL(ESP_OK, settings_init());
+    TEST_ASSERT_EQUAL(ESP_OK, relay_controller_init(GPIO_RELAY, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, pwm_manager_init());
+    s_cfg = settings_get_writeable();
+    s_defaults = *s_cfg;
+}
+
+// Входи циклу керування на одну секунду
+typedef struct {
+    float duty;
+    float rad_c;
+    bool reset;   // Перед оновленням - pwm_manager_reset, як при зміні режиму
+} pwm_input_t;
+
+typedef void (*input_fn_t)(int64_t t_us, void *arg, pwm_input_t *in);
+
+static void constant_duty(int64_t t_us, void *arg, pwm_input_t *in) {
+    (void)t_us;
+    in->duty = *(const float *)arg;
+}
+
+typedef struct {
+    pwm_trace_t *tr;
+    bool on;
+    int64_t edge_us;  // -1: перший інтервал неповний, він почався ще до прогону
+} edge_tracker_t;
+
+// Фронт може сформувати і таймер, і сам виклик pwm_manager_update, тому стан перевіряється після обох
+static void track_edge(edge_tracker_t *et) {
+    bool state = relay_controller_get_heater_state();
+    if (state == et->on) return;
+
+    int64_t now = esp_timer_get_time();
+    if (et->edge_us >= 0) {
+        int64_t *shortest = et->on ? &et->tr->shortest_on_us : &et->tr->shortest_off_us;
+        if (now - et->edge_us < *shortest) *shortest = now - et->edge_us;
+    }
+    et->edge_us = now;
+    et->on = state;
+}
+
+/**
+ * @brief Проганяє ШІМ протягом duration_us, оновлюючи завдання щосекунди,
+ * і збирає тривалості імпульсів і пауз між фронтами.
+ */
+static void run_pwm(input_fn_t input, void *arg, int64_t duration_us, pwm_trace_t *tr) {
+    pwm_manager_reset();
+    // Реле відпочиває довше за будь-яку мінімальну паузу, щоб попередній прогін не відкладав старт
+    host_run_until(esp_timer_get_time() + CYCLE_US);
+    uint32_t rising_before = host_gpio_rising_edges(GPIO_RELAY);
+
+    *tr = (pwm_trace_t){ .shortest_on_us = INT64_MAX, .shortest_off_us = INT64_MAX };
+    edge_tracker_t et = { .tr = tr, .on = relay_controller_get_heater_state(), .edge_us = -1 };
+    const int64_t t0 = esp_timer_get_time();
+    const int64_t t_end = t0 + duration_us;
+    int64_t next_update = t0;
+
+    while (esp_timer_get_time() < t_end) {
+        int64_t now = esp_timer_get_time();
+        if (now >= next_update) {
+            pwm_input_t in = { .duty = 0.0f, .rad_c = RAD_TEMP_C, .reset = false };
+            input(now - t0, arg, &in);
+            if (in.reset) {
+                pwm_manager_reset();
+                track_edge(&et);
+            }
+            pwm_manager_update(in.duty, in.rad_c);
+            next_update += UPDATE_STEP_US;
+            track_edge(&et);
+        }
+
+        int64_t due = host_timer_next_due_us();
+        int64_t stop = next_update < t_end ? next_update : t_end;
+        if (due >= 0 && due < stop) stop = due;
+        // Стан реле змінюється лише у фронтах, тож між ними інтегрується точно
+        if (relay_controller_get_heater_state()) tr->on_us += stop - now;
+        host_run_until(stop);
+        track_edge(&et);
+    }
+    tr->rising = host_gpio_rising_edges(GPIO_RELAY) - rising_before;
+    pwm_manager_reset();
+}
+
+void setUp(void) {
+    init_once();
+    s_cfg->control.pwm_cycle_s = CYCLE_S;
+    s_cfg->control.pwm_cycle_ms = 0;
+}
+
+void tearDown(void) {}
+
+static void test_default_minimums_are_seconds(void) {
+    // Електромеханічне реле: мінімуми в секундах і вміщуються в період ШІМ за замовчуванням
+    TEST_ASSERT_EQUAL_UINT32(CYCLE_S, s_defaults.control.pwm_cycle_s);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1000, s_defaults.control.relay.min_on_ms);
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(1000, s_defaults.control.relay.min_off_ms);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(CYCLE_S * 1000 / 2, s_defaults.control.relay.min_on_ms);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(CYCLE_S * 1000 / 2, s_defaults.control.relay.min_off_ms);
+}
+
+static void check_constant_duty(uint32_t min_on_ms, uint32_t min_off_ms) {
+    static const float duties[] = { 0.0f, 0.5f, 1.0f, 3.0f, 5.0f, 8.0f, 12.5f, 16.0f, 25.0f, 33.3f,
+                                    50.0f, 66.7f, 75.0f, 84.0f, 90.0f, 95.0f, 97.0f, 99.0f, 99.5f, 100.0f };
+    const int64_t duration = RUN_CYCLES * CYCLE_US;
+    // Ефективні мінімуми після обмеження півперіодом ШІМ
+    int64_t eff_on_us = (int64_t)(min_on_ms < CYCLE_S * 500 ? min_on_ms : CYCLE_S * 500) * 1000;
+    int64_t eff_off_us = (int64_t)(min_off_ms < CYCLE_S * 500 ? min_off_ms : CYCLE_S * 500) * 1000;
+
+    s_cfg->control.relay.min_on_ms = min_on_ms;
+    s_cfg->control.relay.min_off_ms = min_off_ms;
+
+    for (size_t i = 0; i < sizeof(duties) / sizeof(duties[0]); i++) {
+        float d = duties[i];
+        pwm_trace_t tr;
+        run_pwm(constant_duty, &d, duration, &tr);
+
+        char msg[96];
+        snprintf(msg, sizeof(msg), "duty %.1f%%, min %u/%u ms", d, (unsigned)min_on_ms, (unsigned)min_off_ms);
+
+        // Борг обмежений одним періодом: за весь прогін недодано чи передано не більше періоду
+        int64_t want_us = (int64_t)((double)d / 100.0 * (double)duration);
+        TEST_ASSERT_INT64_WITHIN_MESSAGE(CYCLE_US, want_us, tr.on_us, msg);
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(RUN_CYCLES + 1, tr.rising, msg);
+        if (tr.shortest_on_us != INT64_MAX) {
+            TEST_ASSERT_GREATER_OR_EQUAL_INT64_MESSAGE(eff_on_us, tr.shortest_on_us, msg);
+        }
+        if (tr.shortest_off_us != INT64_MAX) {
+            TEST_ASSERT_GREATER_OR_EQUAL_INT64_MESSAGE(eff_off_us, tr.shortest_off_us, msg);
+        }
+        if (d == 0.0f) TEST_ASSERT_EQUAL_UINT32_MESSAGE(0, tr.rising, msg);
+        if (d == 100.0f) TEST_ASSERT_LESS_OR_EQUAL_UINT32_MESSAGE(1, tr.rising, msg);
+    }
+}
+
+static void test_constant_duty_conserved_with_default_minimums(void) {
+    check_constant_duty(s_defaults.control.relay.min_on_ms, s_defaults.control.relay.min_off_ms);
+}
+
+static void test_constant_duty_conserved_with_asymmetric_minimums(void) {
+    check_constant_duty(15000, 4000);
+}
+
+static void test_minimums_clamped_to_half_cycle(void) {
+    // Хвилина мінімуму на хвилинному періоді: обмежується до 30 с, заповнення все одно зберігається
+    check_constant_duty(60000, 120000);
+
+    // На половинному заповненні кожен період - рівно мінімальні імпульс і пауза
+    float half = 50.0f;
+    pwm_trace_t tr;
+    run_pwm(constant_duty, &half, RUN_CYCLES * CYCLE_US, &tr);
+    TEST_ASSERT_EQUAL_INT64(CYCLE_US / 2, tr.shortest_on_us);
+    TEST_ASSERT_EQUAL_INT64(CYCLE_US / 2, tr.shortest_off_us);
+    // Фронт у самому кінці прогону відкриває ще один період
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(RUN_CYCLES, tr.rising);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(RUN_CYCLES + 1, tr.rising);
+}
+
+typedef struct {
+    float duty;
+    int64_t next_change_us;
+} random_duty_t;
+
+static void random_duty(int64_t t_us, void *arg, pwm_input_t *in) {
+    random_duty_t *r = arg;
+    if (t_us >= r->next_change_us) {
+        r->duty = (float)(rand() % 1001) / 10.0f;
+        r->next_change_us = t_us + (int64_t)(1 + rand() % 90) * 1000000LL;
+    }
+    in->duty = r->duty;
+}
+
+static void test_changing_duty_keeps_minimums(void) {
+    srand(7);
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+
+    // Зміни завдання посеред періоду: зменшення обриває імпульс раніше, але не коротшим за мінімум
+    random_duty_t r = { 0 };
+    pwm_trace_t tr;
+    run_pwm(random_duty, &r, RUN_CYCLES * CYCLE_US, &tr);
+
+    TEST_ASSERT_GREATER_THAN_UINT32(RUN_CYCLES / 4, tr.rising);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(RUN_CYCLES + 1, tr.rising);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT64(10000000LL, tr.shortest_on_us);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT64(10000000LL, tr.shortest_off_us);
+}
+
+// Крок циклу керування: оновлення завдання і хід часу до наступної секунди
+static void control_step(float duty, float rad_c) {
+    pwm_manager_update(duty, rad_c);
+    host_run_until(esp_timer_get_time() + UPDATE_STEP_US);
+}
+
+static void test_reset_keeps_minimum_pause(void) {
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    pwm_manager_reset();
+    host_run_until(esp_timer_get_time() + CYCLE_US);
+
+    control_step(50.0f, RAD_TEMP_C);
+    TEST_ASSERT_TRUE(relay_controller_get_heater_state());
+    host_run_until(esp_timer_get_time() + 3 * UPDATE_STEP_US);
+
+    // Зміна режиму посеред імпульсу: реле вимикається одразу, а повторний старт чекає мінімальну паузу
+    pwm_manager_reset();
+    int64_t off_us = esp_timer_get_time();
+    TEST_ASSERT_FALSE(relay_controller_get_heater_state());
+
+    int64_t on_us = -1;
+    while (on_us < 0 && esp_timer_get_time() < off_us + CYCLE_US) {
+        pwm_manager_update(50.0f, RAD_TEMP_C);
+        if (relay_controller_get_heater_state()) {
+            on_us = esp_timer_get_time();
+            break;
+        }
+        // Фронт ставить таймер, тож він може настати між оновленнями
+        int64_t next = esp_timer_get_time() + UPDATE_STEP_US / 3;
+        int64_t due = host_timer_next_due_us();
+        host_run_until(due >= 0 && due < next ? due : next);
+        if (relay_controller_get_heater_state()) on_us = esp_timer_get_time();
+    }
+    TEST_ASSERT_EQUAL_INT64(off_us + 10000000LL, on_us);
+    pwm_manager_reset();
+}
+
+static void toggling_mode(int64_t t_us, void *arg, pwm_input_t *in) {
+    (void)arg;
+    // MANUAL -> OFF -> MANUAL кнопкою кожні 3 с
+    in->duty = 60.0f;
+    in->reset = (t_us / UPDATE_STEP_US) % 3 == 0;
+}
+
+static void test_mode_toggling_keeps_minimum_pause(void) {
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+
+    pwm_trace_t tr;
+    run_pwm(toggling_mode, NULL, 60 * UPDATE_STEP_US * 10, &tr);
+    TEST_ASSERT_GREATER_THAN_UINT32(0, tr.rising);
+    TEST_ASSERT_GREATER_OR_EQUAL_INT64(10000000LL, tr.shortest_off_us);
+    // Не частіше, ніж дозволяє пауза між увімкненнями
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(60 * 10 / 10, tr.rising);
+}
+
+static void hovering_radiator(int64_t t_us, void *arg, pwm_input_t *in) {
+    (void)arg;
+    int64_t s = t_us / UPDATE_STEP_US;
+    in->duty = 50.0f;
+    // 10 хв радіатор коливається біля межі 60 C, потім 5 хв у смузі гістерезису
+    in->rad_c = s < 600 ? ((s % 2) ? 60.2f : 59.8f) : 58.5f;
+}
+
+static void test_overheat_cutoff_waits_for_hysteresis(void) {
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    s_cfg->control.limits.rad_max = 60.0f;
+
+    pwm_trace_t tr;
+    run_pwm(hovering_radiator, NULL, 900 * UPDATE_STEP_US, &tr);
+    // Одне увімкнення на старті (59.8 C), далі відсічка тримає реле до охолодження на 2 C
+    TEST_ASSERT_EQUAL_UINT32(1, tr.rising);
+    TEST_ASSERT_FALSE(relay_controller_get_heater_state());
+}
+
+static void test_overheat_resumes_below_hysteresis(void) {
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    s_cfg->control.limits.rad_max = 60.0f;
+    pwm_manager_reset();
+    host_run_until(esp_timer_get_time() + CYCLE_US);
+
+    control_step(50.0f, 60.5f);
+    TEST_ASSERT_FALSE(relay_controller_get_heater_state());
+    for (int i = 0; i < 30; i++) {
+        control_step(50.0f, 58.5f);
+        TEST_ASSERT_FALSE(relay_controller_get_heater_state());
+    }
+    control_step(50.0f, 57.9f);
+    TEST_ASSERT_TRUE(relay_controller_get_heater_state());
+    pwm_manager_reset();
+}
+
+// Фронт реле зони з точним моментом віртуального годинника
+typedef struct {
+    int64_t t_us;
+    uint8_t zone;
+    bool on;
+} relay_edge_t;
+
+typedef struct {
+    relay_edge_t e[EDGE_LOG_MAX];
+    int n;
+    int zones;
+    bool state[EDGE_ZONES];
+} edge_log_t;
+
+static edge_log_t s_log;
+
+static void edge_log_start(edge_log_t *log, int zones) {
+    log->n = 0;
+    log->zones = zones;
+    for (int z = 0; z < zones; z++) log->state[z] = relay_controller_get_zone_state(z);
+}
+
+static void edge_log_poll(edge_log_t *log) {
+    for (int z = 0; z < log->zones; z++) {
+        bool state = relay_controller_get_zone_state(z);
+        if (state == log->state[z]) continue;
+        TEST_ASSERT_LESS_THAN_INT(EDGE_LOG_MAX, log->n);
+        log->e[log->n++] = (relay_edge_t){ .t_us = esp_timer_get_time(), .zone = (uint8_t)z, .on = state };
+        log->state[z] = state;
+    }
+}
+
+// Час іде від таймера до таймера, тож кожен фронт записується в момент свого спрацювання
+static void edge_log_run_until(edge_log_t *log, int64_t until_us) {
+    for (;;) {
+        int64_t due = host_timer_next_due_us();
+        if (due < 0 || due > until_us) break;
+        host_run_until(due);
+        edge_log_poll(log);
+    }
+    host_run_until(until_us);
+    edge_log_poll(log);
+}
+
+// Момент k-го фронту зони в заданому напрямку, -1 - такого немає
+static int64_t edge_at(const edge_log_t *log, int zone, bool on, int k) {
+    for (int i = 0; i < log->n; i++) {
+        if (log->e[i].zone != zone || log->e[i].on != on) continue;
+        if (k-- == 0) return log->e[i].t_us;
+    }
+    return -1;
+}
+
+// Оновлює завдання всіх зон журналу і веде час до наступного оновлення
+static void edge_log_step(edge_log_t *log, float duty, int64_t step_us) {
+    int64_t now = esp_timer_get_time();
+    for (int z = 0; z < log->zones; z++) pwm_manager_update_zone((uint8_t)z, duty, RAD_TEMP_C);
+    edge_log_poll(log);
+    edge_log_run_until(log, now + step_us);
+}
+
+static void rest_relays(void) {
+    pwm_manager_reset();
+    host_run_until(esp_timer_get_time() + CYCLE_US);
+}
+
+static void test_edges_locked_to_cycle_grid(void) {
+    const int cycles = 100;
+    // Крок циклу керування не ділить період: фронти задає лише таймер, а не момент оновлення
+    const int64_t step_us = 700000;
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    rest_relays();
+
+    edge_log_start(&s_log, 1);
+    const int64_t t0 = esp_timer_get_time();
+    while (esp_timer_get_time() < t0 + cycles * CYCLE_US) edge_log_step(&s_log, 25.0f, step_us);
+    pwm_manager_reset();
+
+    for (int k = 0; k < cycles; k++) {
+        int64_t start = t0 + k * CYCLE_US;
+        TEST_ASSERT_EQUAL_INT64(start, edge_at(&s_log, 0, true, k));
+        TEST_ASSERT_EQUAL_INT64(start + CYCLE_US / 4, edge_at(&s_log, 0, false, k));
+    }
+}
+
+typedef struct {
+    int cfg_cycle_ms;     // control.pwm_cycle_ms
+    float duty;
+    int64_t cycle_us;     // Очікуваний період після обмеження
+    int64_t on_us;        // Очікуваний імпульс
+} ssr_case_t;
+
+static void test_sub_second_cycle_has_ms_resolution(void) {
+    // SSR: мінімуми - один період мережі. Сусідні завдання відрізняються на 1 мс імпульсу
+    static const ssr_case_t cases[] = {
+        { 250, 37.3f, 250000, 93000 },
+        { 250, 37.7f, 250000, 94000 },
+        { 500, 10.1f, 500000, 51000 },
+        { 50,  50.0f, 200000, 100000 },   // Коротший за нижню межу період обмежується
+    };
+    const int cycles = 40;
+    s_cfg->control.relay.min_on_ms = 20;
+    s_cfg->control.relay.min_off_ms = 20;
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        const ssr_case_t *c = &cases[i];
+        char msg[64];
+        snprintf(msg, sizeof(msg), "cycle %d ms, duty %.1f%%", c->cfg_cycle_ms, c->duty);
+        s_cfg->control.pwm_cycle_ms = c->cfg_cycle_ms;
+        rest_relays();
+
+        edge_log_start(&s_log, 1);
+        const int64_t t0 = esp_timer_get_time();
+        while (esp_timer_get_time() < t0 + cycles * c->cycle_us) edge_log_step(&s_log, c->duty, UPDATE_STEP_US);
+        pwm_manager_reset();
+
+        for (int k = 0; k < cycles; k++) {
+            int64_t start = t0 + k * c->cycle_us;
+            TEST_ASSERT_EQUAL_INT64_MESSAGE(start, edge_at(&s_log, 0, true, k), msg);
+            TEST_ASSERT_EQUAL_INT64_MESSAGE(start + c->on_us, edge_at(&s_log, 0, false, k), msg);
+        }
+    }
+}
+
+// Оновлення завдання в заданий момент з записом фронтів до нього
+static void update_at(int64_t t_us, float duty) {
+    edge_log_run_until(&s_log, t_us);
+    pwm_manager_update(duty, RAD_TEMP_C);
+    edge_log_poll(&s_log);
+}
+
+static void test_decrease_mid_pulse_timing(void) {
+    const int64_t s = 1000000LL;
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    rest_relays();
+
+    edge_log_start(&s_log, 1);
+    const int64_t t0 = esp_timer_get_time();
+    update_at(t0, 50.0f);
+    // Збільшення посеред імпульсу чекає наступного періоду, зменшення до 15 с обриває імпульс у t0 + 15 с
+    update_at(t0 + 5300000, 75.0f);
+    update_at(t0 + 12300000, 25.0f);
+    // Період 1 (15 с): зменшення до 6 с, коли минуло вже 13.7 с, вимикає реле в момент оновлення,
+    // а 7.7 с надлишку віднімаються від наступного періоду
+    update_at(t0 + 73700000, 10.0f);
+    update_at(t0 + 80 * s, 50.0f);
+    // Період 3 (30 с): зменшення до 0.6 с обриває імпульс не раніше мінімальних 10 с
+    update_at(t0 + 182 * s, 1.0f);
+    edge_log_run_until(&s_log, t0 + 200 * s);
+    pwm_manager_reset();
+
+    static const int64_t rising[] = { 0, 60, 120, 180 };
+    static const int64_t falling[] = { 15000000, 73700000, 142300000, 190000000 };
+    for (int k = 0; k < 4; k++) {
+        TEST_ASSERT_EQUAL_INT64(t0 + rising[k] * s, edge_at(&s_log, 0, true, k));
+        TEST_ASSERT_EQUAL_INT64(t0 + falling[k], edge_at(&s_log, 0, false, k));
+    }
+    TEST_ASSERT_EQUAL_INT(8, s_log.n);
+}
+
+static void test_staggered_zones_start_at_rank_over_n(void) {
+    const int cycles = 20;
+    s_cfg->control.relay.min_on_ms = 10000;
+    s_cfg->control.relay.min_off_ms = 10000;
+    // Як у zone_manager: зона з рангом rank із N отримує фазу rank/N
+    TEST_ASSERT_EQUAL(ESP_OK, relay_controller_init_zone(1, GPIO_NUM_25, 1));
+    TEST_ASSERT_EQUAL(ESP_OK, relay_controller_init_zone(2, GPIO_NUM_26, 1));
+    for (int z = 1; z < EDGE_ZONES; z++) {
+        TEST_ASSERT_EQUAL(ESP_OK, pwm_manager_add_zone((uint8_t)z, (float)z / (float)EDGE_ZONES));
+    }
+    rest_relays();
+
+    edge_log_start(&s_log, EDGE_ZONES);
+    const int64_t t0 = esp_timer_get_time();
+    while (esp_timer_get_time() < t0 + cycles * CYCLE_US) edge_log_step(&s_log, 20.0f, UPDATE_STEP_US);
+    pwm_manager_reset();
+
+    for (int z = 0; z < EDGE_ZONES; z++) {
+        for (int k = 0; k < cycles - 1; k++) {
+            int64_t start = t0 + z * CYCLE_US / EDGE_ZONES + k * CYCLE_US;
+            TEST_ASSERT_EQUAL_INT64(start, edge_at(&s_log, z, true, k));
+            TEST_ASSERT_EQUAL_INT64(start + CYCLE_US / 5, edge_at(&s_log, z, false, k));
+        }
+    }
+
+    // 20% на зону при зсуві в третину періоду: увімкнено не більше одного реле водночас
+    int on = 0;
+    for (int i = 0; i < s_log.n; i++) {
+        on += s_log.e[i].on ? 1 : -1;
+        TEST_ASSERT_LESS_OR_EQUAL_INT(1, on);
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_minimums_are_seconds);
+    RUN_TEST(test_constant_duty_conserved_with_default_minimums);
+    RUN_TEST(test_constant_duty_conserved_with_asymmetric_minimums);
+    RUN_TEST(test_minimums_clamped_to_half_cycle);
+    RUN_TEST(test_changing_duty_keeps_minimums);
+    RUN_TEST(test_reset_keeps_minimum_pause);
+    RUN_TEST(test_mode_toggling_keeps_minimum_pause);
+    RUN_TEST(test_overheat_cutoff_waits_for_hysteresis);
+    RUN_TEST(test_overheat_resumes_below_hysteresis);
+    RUN_TEST(test_edges_locked_to_cycle_grid);
+    RUN_TEST(test_sub_second_cycle_has_ms_resolution);
+    RUN_TEST(test_decrease_mid_pulse_timing);
+    // Додає зони 1 і 2, тому останній
+    RUN_TEST(test_staggered_zones_start_at_rank_over_n);
+    return UNITY_END();
+}
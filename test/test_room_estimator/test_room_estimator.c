@@ -0,0 +1,202 @@
+/**
+ * @brief Оцінювач кімнати проти EMA на симульованій кімнаті з радіатором і термостатним
+ * реле та шумом датчиків: запізнення і RMSE, збіжність збурення при неврахованих
+ * тепловтратах і робота без зовнішньої температури (-999).
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "controller/room_estimator.h"
+#include "controller/sensor/temp_filter.h"
+#include "host_stubs.h"
+
+// Кімната з налаштувань за замовчуванням, радіатор ~25 хв; одиниці 1/с та C/с
+#define PLANT_K_RAD   2.1e-5f
+#define PLANT_K_LOSS  1.4e-5f
+#define PLANT_G_HEAT  (90.0f / 3600.0f)
+#define PLANT_K_RR    (2.4f / 3600.0f)
+#define OUTSIDE_C     0.0f
+
+#define ROOM_NOISE_C  0.05f
+#define RAD_NOISE_C   0.1f
+#define ON_BELOW_C    20.0f     // Термостат на справжній температурі
+#define OFF_ABOVE_C   21.0f
+#define WARMUP_S      3600      // Оцінювач і EMA встигають усталитися
+#define RUN_S         (8 * 3600)
+
+typedef struct {
+    float room;
+    float rad;
+    bool relay;
+    float extra_c_per_h;        // Збурення, якого немає в моделі оцінювача
+} plant_t;
+
+typedef struct {
+    double err2;
+    double err_rate;            // Сума e * dT/dt і (dT/dt)^2 для МНК-оцінки запізнення
+    double rate2;
+    int n;
+} track_t;
+
+static room_estimator_t s_est;
+static temp_filter_t s_ema_fast;
+static temp_filter_t s_ema_slow;
+static uint32_t s_rng;
+static int64_t s_now_us;
+
+static float gauss(float sd) {
+    float acc = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        s_rng = s_rng * 1664525u + 1013904223u;
+        acc += (float)(s_rng >> 8) / 16777216.0f;
+    }
+    return sd * (acc - 6.0f);
+}
+
+static float plant_step(plant_t *p) {
+    if (p->room < ON_BELOW_C) p->relay = true;
+    if (p->room > OFF_ABOVE_C) p->relay = false;
+    float d_room = PLANT_K_RAD * (p->rad - p->room) - PLANT_K_LOSS * (p->room - OUTSIDE_C)
+                 + p->extra_c_per_h / 3600.0f;
+    float d_rad = (p->relay ? PLANT_G_HEAT : 0.0f) - PLANT_K_RR * (p->rad - p->room);
+    p->room += d_room;
+    p->rad += d_rad;
+    return d_room;
+}
+
+static void ema_init(temp_filter_t *f, float alpha) {
+    temp_filter_config_t cfg = {
+        .median_window = 0,
+        .hampel_window = 0,
+        .smooth = TEMP_FILTER_SMOOTH_EMA,
+        .ema_alpha = alpha,
+        .sample_rate_hz = 1.0f,
+    };
+    temp_filter_init(f, &cfg);
+}
+
+static void track(track_t *t, float estimate, float truth, float rate) {
+    double e = truth - estimate;
+    t->err2 += e * e;
+    t->err_rate += e * rate;
+    t->rate2 += (double)rate * rate;
+    t->n++;
+}
+
+static float rmse(const track_t *t) { return (float)sqrt(t->err2 / t->n); }
+
+// Зсув у часі, що найкраще пояснює похибку: e ~ lag * dT/dt
+static float lag_s(const track_t *t) { return (float)(t->err_rate / t->rate2); }
+
+static void report(const char *name, const track_t *t) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%-14s RMSE %.4f C, lag %6.1f s", name, rmse(t), lag_s(t));
+    TEST_MESSAGE(msg);
+}
+
+/**
+ * Прогін: секундні вибірки у оцінювач і обидва EMA. Зовнішня температура для оцінювача -
+ * outside_for_est (справжня або -999).
+ */
+static void run(plant_t *p, int seconds, float outside_for_est, track_t *est, track_t *fast, track_t *slow) {
+    for (int s = 0; s < seconds; s++) {
+        float rate = plant_step(p);
+        s_now_us += 1000000;
+        host_clock_set_us(s_now_us);
+
+        float room_meas = p->room + gauss(ROOM_NOISE_C);
+        float rad_meas = p->rad + gauss(RAD_NOISE_C);
+        float e = room_estimator_update(&s_est, room_meas, rad_meas, p->relay, outside_for_est);
+        float f = TEMP_VALUE_TO_C(temp_filter_process(&s_ema_fast, TEMP_VALUE_FROM_C(room_meas)));
+        float sl = TEMP_VALUE_TO_C(temp_filter_process(&s_ema_slow, TEMP_VALUE_FROM_C(room_meas)));
+        if (est) track(est, e, p->room, rate);
+        if (fast) track(fast, f, p->room, rate);
+        if (slow) track(slow, sl, p->room, rate);
+    }
+}
+
+static void start(plant_t *p, float extra_c_per_h, float outside_for_est) {
+    *p = (plant_t){ .room = 20.5f, .rad = 20.5f, .relay = false, .extra_c_per_h = extra_c_per_h };
+    s_now_us = 0;
+    host_clock_set_us(s_now_us);
+    room_estimator_config_t cfg = {
+        .k_rad = PLANT_K_RAD,
+        .k_loss = PLANT_K_LOSS,
+        .k_relay = 0.0f,
+        .meas_noise = ROOM_NOISE_C * ROOM_NOISE_C,
+    };
+    room_estimator_init(&s_est, &cfg);
+    ema_init(&s_ema_fast, 0.3f);
+    ema_init(&s_ema_slow, 0.05f);
+    run(p, WARMUP_S, outside_for_est, NULL, NULL, NULL);
+}
+
+void setUp(void) {
+    host_clock_reset(0);
+    s_rng = 7u;
+}
+
+void tearDown(void) {}
+
+static void test_beats_ema_on_lag_and_rmse(void) {
+    plant_t p;
+    track_t est = { 0 }, fast = { 0 }, slow = { 0 };
+    start(&p, 0.0f, OUTSIDE_C);
+    run(&p, RUN_S, OUTSIDE_C, &est, &fast, &slow);
+    report("estimator", &est);
+    report("EMA 0.3", &fast);
+    report("EMA 0.05", &slow);
+
+    // EMA 0.3 майже без запізнення, але з шумом; EMA 0.05 тихий, але відстає на (1 - a) / a с
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f * rmse(&fast), rmse(&est));
+    TEST_ASSERT_LESS_THAN_FLOAT(rmse(&slow), rmse(&est));
+    TEST_ASSERT_FLOAT_WITHIN(3.0f, 19.0f, lag_s(&slow));
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f * lag_s(&slow), fabsf(lag_s(&est)));
+    TEST_ASSERT_FLOAT_WITHIN(0.1f / 3600.0f, 0.0f, s_est.bias);
+}
+
+static void test_bias_converges_under_unmodelled_loss(void) {
+    // Відчинена кватирка: -1 C/год поза моделлю
+    const float extra = -1.0f;
+    plant_t p;
+    start(&p, extra, OUTSIDE_C);
+    track_t est = { 0 }, slow = { 0 };
+    run(&p, RUN_S, OUTSIDE_C, &est, NULL, &slow);
+    report("estimator", &est);
+    report("EMA 0.05", &slow);
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "bias %.3f C/h (true %.3f C/h)", s_est.bias * 3600.0f, extra);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, extra, s_est.bias * 3600.0f);
+    TEST_ASSERT_LESS_THAN_FLOAT(rmse(&slow), rmse(&est));
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f * lag_s(&slow), fabsf(lag_s(&est)));
+}
+
+static void test_missing_outside_temperature(void) {
+    // Без зовнішньої температури модель лишає лише k_rad, а тепловтрати назовні
+    // (-k_loss (T - T_out)) бере на себе збурення
+    plant_t p;
+    start(&p, 0.0f, -999.0f);
+    track_t est = { 0 }, slow = { 0 };
+    run(&p, RUN_S, -999.0f, &est, NULL, &slow);
+    report("estimator", &est);
+
+    float expected = -PLANT_K_LOSS * (20.5f - OUTSIDE_C) * 3600.0f;
+    char msg[96];
+    snprintf(msg, sizeof(msg), "bias %.3f C/h (lost k_loss term %.3f C/h)", s_est.bias * 3600.0f, expected);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN(0.15f, expected, s_est.bias * 3600.0f);
+    TEST_ASSERT_LESS_THAN_FLOAT(rmse(&slow), rmse(&est));
+    TEST_ASSERT_LESS_THAN_FLOAT(5.0f, fabsf(room_estimator_get_rate_per_hour(&s_est)));
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_beats_ema_on_lag_and_rmse);
+    RUN_TEST(test_bias_converges_under_unmodelled_loss);
+    RUN_TEST(test_missing_outside_temperature);
+    return UNITY_END();
+}
@@ -0,0 +1,311 @@
+/**
+ * @brief Seqlock стану системи: записувачі й читачі в окремих потоках.
+ * Кожен пакет записувача виводить усі поля з одного числа, тож розірвана копія
+ * (частина полів з одного пакета, частина з іншого) не пройде перевірки узгодженості.
+ * Наприкінці - затримка читання проти копіювання під м'ютексом за того ж навантаження.
+ */
+#include <math.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <unity.h>
+
+#include "host_stubs.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "model/system_state.h"
+#include "model/state_bus.h"
+
+#define STRESS_WRITERS     2
+#define STRESS_READERS     3
+#define STRESS_DURATION_MS 1500
+#define BENCH_DURATION_MS  500
+#define BENCH_SAMPLES      200000   // Затримок на читача для перцентилів
+
+static atomic_bool s_stop;
+static state_bus_handle_t s_sub;
+
+// Значення з точним представленням у float: тоді порівняння полів без допусків
+static float writer_value(uint32_t n, int writer) {
+    return (float)((n * STRESS_WRITERS + (uint32_t)writer) % (1u << 20));
+}
+
+static void stage_all(system_state_txn_t *txn, float v) {
+    system_state_txn_begin(txn);
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        system_state_txn_set_temp(txn, i, v + (float)i, v + (float)i + 0.5f);
+        system_state_txn_set_sensor_health(txn, i, (uint8_t)((uint32_t)v + (uint32_t)i));
+    }
+    system_state_txn_set_room_estimate(txn, v, -v);
+    system_state_txn_set_temp_outside(txn, v - 30.0f);
+    system_state_txn_set_current_setpoint(txn, v + 0.25f);
+    system_state_txn_set_error_code(txn, (int)v, (int)v + 1);
+}
+
+// Усі поля копії виведені з того самого значення, що й room_temp_estimate
+static bool state_consistent(const sensors_state_t *st) {
+    float v = st->room_temp_estimate;
+    for (int i = 0; i < MAX_TEMP_SENSORS; i++) {
+        if (st->temperature_c[i] != v + (float)i) return false;
+        if (st->temperature_fast_c[i] != v + (float)i + 0.5f) return false;
+        if (st->sensor_health[i] != (uint8_t)((uint32_t)v + (uint32_t)i)) return false;
+    }
+    return st->room_temp_rate == -v && st->temperature_c_outside == v - 30.0f &&
+           st->current_setpoint == v + 0.25f && st->error_code == (int)v && st->error_sensor == (int)v + 1;
+}
+
+static int64_t now_ns(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000LL + t.tv_nsec;
+}
+
+void setUp(void) {
+    system_state_init();
+    host_tasks_reset();
+}
+
+void tearDown(void) {}
+
+static void test_commit_bumps_version_once_per_change(void) {
+    if (s_sub == NULL) {
+        s_sub = state_bus_subscribe("test", xTaskGetCurrentTaskHandle(), SYSTEM_STATE_FIELD_ALL);
+    }
+    TEST_ASSERT_NOT_NULL(s_sub);
+    state_bus_wait(s_sub, 0);
+
+    uint32_t version = system_state_get_version();
+    system_state_txn_t txn;
+    stage_all(&txn, 7.0f);
+    uint32_t changed = system_state_txn_commit(&txn);
+    TEST_ASSERT_EQUAL_HEX32(SYSTEM_STATE_FIELD_TEMPERATURE | SYSTEM_STATE_FIELD_SENSOR_HEALTH |
+                            SYSTEM_STATE_FIELD_ROOM_ESTIMATE | SYSTEM_STATE_FIELD_TEMP_OUTSIDE |
+                            SYSTEM_STATE_FIELD_SETPOINT | SYSTEM_STATE_FIELD_ERROR,
+                            changed & SYSTEM_STATE_FIELD_ALL);
+    TEST_ASSERT_EQUAL_UINT32(version + 1, system_state_get_version());
+    // Біти окремих каналів лежать поза SYSTEM_STATE_FIELD_ALL, на які підписано тест
+    TEST_ASSERT_EQUAL_HEX32(changed & SYSTEM_STATE_FIELD_ALL, state_bus_wait(s_sub, 0));
+
+    sensors_state_t st;
+    TEST_ASSERT_TRUE(system_state_get_if_changed(&version, &st));
+    TEST_ASSERT_TRUE(state_consistent(&st));
+    TEST_ASSERT_EQUAL_UINT32(st.version, version);
+
+    // Той самий пакет нічого не змінює: ні версії, ні сповіщень
+    stage_all(&txn, 7.0f);
+    TEST_ASSERT_EQUAL_HEX32(0, system_state_txn_commit(&txn));
+    TEST_ASSERT_EQUAL_UINT32(version, system_state_get_version());
+    TEST_ASSERT_FALSE(system_state_get_if_changed(&version, &st));
+    TEST_ASSERT_EQUAL_HEX32(0, state_bus_wait(s_sub, 0));
+}
+
+typedef struct {
+    int writer;
+    uint64_t commits;
+} writer_stats_t;
+
+typedef struct {
+    uint64_t reads;
+    uint64_t torn;
+    uint64_t version_back;   // Версія копії менша за попередню
+} reader_stats_t;
+
+static void *writer_thread(void *arg) {
+    writer_stats_t *ws = arg;
+    system_state_txn_t txn;
+    uint32_t n = 0;
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed)) {
+        stage_all(&txn, writer_value(n++, ws->writer));
+        system_state_txn_commit(&txn);
+        ws->commits++;
+    }
+    return NULL;
+}
+
+static void *reader_thread(void *arg) {
+    reader_stats_t *st = arg;
+    sensors_state_t copy;
+    uint32_t last_version = 0;
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed)) {
+        system_state_get(&copy);
+        st->reads++;
+        if (!state_consistent(&copy)) st->torn++;
+        if (copy.version < last_version) st->version_back++;
+        last_version = copy.version;
+    }
+    return NULL;
+}
+
+static void test_concurrent_readers_never_see_torn_state(void) {
+    pthread_t writers[STRESS_WRITERS];
+    pthread_t readers[STRESS_READERS];
+    writer_stats_t wstats[STRESS_WRITERS];
+    reader_stats_t rstats[STRESS_READERS];
+    memset(wstats, 0, sizeof(wstats));
+    memset(rstats, 0, sizeof(rstats));
+
+    // Початковий стан теж узгоджений, щоб читачі не бачили значень system_state_init
+    system_state_txn_t txn;
+    stage_all(&txn, 1.0f);
+    system_state_txn_commit(&txn);
+    // Лічильник seqlock не скидається system_state_init, версія продовжується з попередніх тестів
+    uint32_t version_before = system_state_get_version();
+    atomic_store(&s_stop, false);
+
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, reader_thread, &rstats[i]));
+    }
+    for (int i = 0; i < STRESS_WRITERS; i++) {
+        wstats[i].writer = i;
+        TEST_ASSERT_EQUAL(0, pthread_create(&writers[i], NULL, writer_thread, &wstats[i]));
+    }
+    usleep(STRESS_DURATION_MS * 1000);
+    atomic_store(&s_stop, true);
+    for (int i = 0; i < STRESS_WRITERS; i++) pthread_join(writers[i], NULL);
+    for (int i = 0; i < STRESS_READERS; i++) pthread_join(readers[i], NULL);
+
+    uint64_t commits = 0;
+    for (int i = 0; i < STRESS_WRITERS; i++) commits += wstats[i].commits;
+    reader_stats_t sum = {0};
+    for (int i = 0; i < STRESS_READERS; i++) {
+        sum.reads += rstats[i].reads;
+        sum.torn += rstats[i].torn;
+        sum.version_back += rstats[i].version_back;
+    }
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "commits %llu, reads %llu, version %u",
+             (unsigned long long)commits, (unsigned long long)sum.reads, (unsigned)system_state_get_version());
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_EQUAL_UINT64(0, sum.torn);
+    TEST_ASSERT_EQUAL_UINT64(0, sum.version_back);
+    TEST_ASSERT_GREATER_THAN_UINT64(1000, commits);
+    TEST_ASSERT_GREATER_THAN_UINT64(1000, sum.reads);
+    // Кожен пакет змінює поля, тож версія зростає рівно на кількість пакетів
+    TEST_ASSERT_EQUAL_UINT64(version_before + commits, system_state_get_version());
+}
+
+/* ---- Затримка читання: seqlock проти м'ютекса ---- */
+
+// Те саме копіювання стану, але під м'ютексом, як до seqlock
+static sensors_state_t s_mutex_state;
+static pthread_mutex_t s_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct {
+    bool use_mutex;
+    int64_t *lat_ns;
+    size_t count;
+} bench_reader_t;
+
+static void *bench_writer(void *arg) {
+    bool use_mutex = *(const bool *)arg;
+    system_state_txn_t txn;
+    uint32_t n = 0;
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed)) {
+        stage_all(&txn, writer_value(n++, 0));
+        if (use_mutex) {
+            pthread_mutex_lock(&s_mutex);
+            s_mutex_state = txn.staged;
+            s_mutex_state.version = n;
+            pthread_mutex_unlock(&s_mutex);
+        } else {
+            system_state_txn_commit(&txn);
+        }
+    }
+    return NULL;
+}
+
+static void *bench_reader(void *arg) {
+    bench_reader_t *r = arg;
+    sensors_state_t copy;
+    while (!atomic_load_explicit(&s_stop, memory_order_relaxed) && r->count < BENCH_SAMPLES) {
+        int64_t t0 = now_ns();
+        if (r->use_mutex) {
+            pthread_mutex_lock(&s_mutex);
+            copy = s_mutex_state;
+            pthread_mutex_unlock(&s_mutex);
+        } else {
+            system_state_get(&copy);
+        }
+        r->lat_ns[r->count++] = now_ns() - t0;
+    }
+    return NULL;
+}
+
+static int cmp_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t *)a, y = *(const int64_t *)b;
+    return (x > y) - (x < y);
+}
+
+typedef struct {
+    int64_t p50, p99, max;
+    size_t samples;
+} latency_t;
+
+static void bench_run(bool use_mutex, latency_t *out) {
+    pthread_t writer;
+    pthread_t readers[STRESS_READERS];
+    bench_reader_t r[STRESS_READERS];
+
+    atomic_store(&s_stop, false);
+    for (int i = 0; i < STRESS_READERS; i++) {
+        r[i] = (bench_reader_t){ .use_mutex = use_mutex, .lat_ns = malloc(BENCH_SAMPLES * sizeof(int64_t)) };
+        TEST_ASSERT_NOT_NULL(r[i].lat_ns);
+    }
+    TEST_ASSERT_EQUAL(0, pthread_create(&writer, NULL, bench_writer, &use_mutex));
+    for (int i = 0; i < STRESS_READERS; i++) {
+        TEST_ASSERT_EQUAL(0, pthread_create(&readers[i], NULL, bench_reader, &r[i]));
+    }
+    usleep(BENCH_DURATION_MS * 1000);
+    atomic_store(&s_stop, true);
+    pthread_join(writer, NULL);
+    for (int i = 0; i < STRESS_READERS; i++) pthread_join(readers[i], NULL);
+
+    size_t total = 0;
+    for (int i = 0; i < STRESS_READERS; i++) total += r[i].count;
+    int64_t *all = malloc((total ? total : 1) * sizeof(int64_t));
+    TEST_ASSERT_NOT_NULL(all);
+    size_t n = 0;
+    for (int i = 0; i < STRESS_READERS; i++) {
+        memcpy(all + n, r[i].lat_ns, r[i].count * sizeof(int64_t));
+        n += r[i].count;
+        free(r[i].lat_ns);
+    }
+    qsort(all, n, sizeof(int64_t), cmp_i64);
+    *out = (latency_t){ .samples = n };
+    if (n > 0) {
+        out->p50 = all[n / 2];
+        out->p99 = all[n * 99 / 100];
+        out->max = all[n - 1];
+    }
+    free(all);
+}
+
+static void test_read_latency_against_mutex(void) {
+    latency_t seq, mtx;
+    bench_run(false, &seq);
+    bench_run(true, &mtx);
+
+    char msg[200];
+    snprintf(msg, sizeof(msg),
+             "read ns under a busy writer (host): seqlock p50 %lld p99 %lld max %lld; mutex p50 %lld p99 %lld max %lld",
+             (long long)seq.p50, (long long)seq.p99, (long long)seq.max,
+             (long long)mtx.p50, (long long)mtx.p99, (long long)mtx.max);
+    TEST_MESSAGE(msg);
+
+    TEST_ASSERT_GREATER_THAN_UINT64(1000, seq.samples);
+    TEST_ASSERT_GREATER_THAN_UINT64(1000, mtx.samples);
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_commit_bumps_version_once_per_change);
+    RUN_TEST(test_concurrent_readers_never_see_torn_state);
+    RUN_TEST(test_read_latency_against_mutex);
+    return UNITY_END();
+}
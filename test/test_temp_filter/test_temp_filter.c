@@ -0,0 +1,283 @@
+/**
+ * @brief Конвеєр фільтрації при зміні частоти вибірок: стала часу EMA та частота
+ * зрізу біквада задані в секундах/герцах і не залежать від періоду опитування каналу,
+ * а перерахунок не скидає накопичений стан.
+ * Наприкінці - прогін зашумленої траси з викидами через каскади медіана -> Хампель ->
+ * EMA / біквад: запізнення на сходинці, зменшення дисперсії шуму і залишок викидів.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <unity.h>
+
+#include "controller/sensor/temp_filter.h"
+
+#define STEP_FROM_C 20.0f
+#define STEP_TO_C   30.0f
+
+// Траса: рівень 20 / 21 C змінюється кожні TRACE_HALF вибірок (1 Гц), шум TRACE_NOISE_C,
+// на сталій ділянці поодинокий викид +4 C і подвійний -3 C
+#define TRACE_HALF        100
+#define TRACE_PERIODS     100
+#define TRACE_LEN         (2 * TRACE_HALF * TRACE_PERIODS)
+#define TRACE_NOISE_C     0.1f
+#define TRACE_STEADY_FROM 40     // Початок сталої ділянки після сходинки, вибірок
+#define SPIKE_SINGLE_AT   50
+#define SPIKE_DOUBLE_AT   70
+
+static temp_filter_t s_filter;
+static float s_clean[TRACE_LEN];
+static float s_noisy[TRACE_LEN];
+static float s_spiky[TRACE_LEN];
+
+static void init_smooth(temp_filter_smooth_t smooth, float alpha, float cutoff_hz, float rate_hz) {
+    temp_filter_config_t cfg = {
+        .median_window = 0,
+        .hampel_window = 0,
+        .smooth = smooth,
+        .ema_alpha = alpha,
+        .cutoff_hz = cutoff_hz,
+        .sample_rate_hz = rate_hz,
+    };
+    temp_filter_init(&s_filter, &cfg);
+}
+
+static float process_c(float x) {
+    return TEMP_VALUE_TO_C(temp_filter_process(&s_filter, TEMP_VALUE_FROM_C(x)));
+}
+
+/**
+ * @brief Час (с), за який вихід проходить частку level сходинки STEP_FROM_C -> STEP_TO_C.
+ */
+static float step_time_s(float rate_hz, float level) {
+    for (int i = 0; i < 10; i++) process_c(STEP_FROM_C);
+    float target = STEP_FROM_C + level * (STEP_TO_C - STEP_FROM_C);
+    for (int n = 1; n < 100000; n++) {
+        if (process_c(STEP_TO_C) >= target) return (float)n / rate_hz;
+    }
+    return INFINITY;
+}
+
+void setUp(void) {}
+
+void tearDown(void) {}
+
+static void test_ema_time_constant_kept_across_rates(void) {
+    // alpha 0.1 на 1 Гц: tau = 9.5 с
+    init_smooth(TEMP_FILTER_SMOOTH_EMA, 0.1f, 0.0f, 1.0f);
+    float t_nominal = step_time_s(1.0f, 0.632f);
+
+    const float rates[] = { 4.0f, 0.5f, 2.0f };
+    for (int i = 0; i < 3; i++) {
+        init_smooth(TEMP_FILTER_SMOOTH_EMA, 0.1f, 0.0f, 1.0f);
+        temp_filter_set_sample_rate(&s_filter, rates[i]);
+        float t = step_time_s(rates[i], 0.632f);
+        // Похибка - не більше періоду повільнішої з двох частот
+        TEST_ASSERT_FLOAT_WITHIN(1.0f / fminf(rates[i], 1.0f) + 0.01f, t_nominal, t);
+    }
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 9.5f, t_nominal);
+}
+
+static void test_ema_state_survives_rate_change(void) {
+    init_smooth(TEMP_FILTER_SMOOTH_EMA, 0.2f, 0.0f, 1.0f);
+    for (int i = 0; i < 10; i++) process_c(STEP_FROM_C);
+    float y = 0.0f;
+    for (int i = 0; i < 3; i++) y = process_c(STEP_TO_C);
+
+    temp_filter_set_sample_rate(&s_filter, 4.0f);
+    // Наступна вибірка продовжує перехідний процес, а не починає з нуля чи з входу
+    float next = process_c(STEP_TO_C);
+    TEST_ASSERT_GREATER_THAN_FLOAT(y, next);
+    TEST_ASSERT_LESS_THAN_FLOAT(y + 0.1f * (STEP_TO_C - y), next);
+}
+
+static void test_unknown_rate_keeps_alpha(void) {
+    init_smooth(TEMP_FILTER_SMOOTH_EMA, 0.5f, 0.0f, 0.0f);
+    temp_filter_set_sample_rate(&s_filter, 4.0f);
+    TEST_ASSERT_EQUAL_FLOAT(0.5f, s_filter.cfg.ema_alpha);
+
+    init_smooth(TEMP_FILTER_SMOOTH_EMA, 1.0f, 0.0f, 1.0f);
+    temp_filter_set_sample_rate(&s_filter, 4.0f);
+    TEST_ASSERT_EQUAL_FLOAT(1.0f, s_filter.cfg.ema_alpha);
+}
+
+#if !TEMP_FIXED_POINT
+static void test_biquad_cutoff_kept_across_rates(void) {
+    init_smooth(TEMP_FILTER_SMOOTH_BIQUAD, 0.0f, 0.02f, 1.0f);
+    TEST_ASSERT_EQUAL(TEMP_FILTER_SMOOTH_BIQUAD, s_filter.cfg.smooth);
+    float t_nominal = step_time_s(1.0f, 0.5f);
+
+    init_smooth(TEMP_FILTER_SMOOTH_BIQUAD, 0.0f, 0.02f, 1.0f);
+    temp_filter_set_sample_rate(&s_filter, 4.0f);
+    float t_fast = step_time_s(4.0f, 0.5f);
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, t_nominal, t_fast);
+}
+
+static void test_biquad_retune_is_continuous_and_clamped(void) {
+    init_smooth(TEMP_FILTER_SMOOTH_BIQUAD, 0.0f, 0.2f, 1.0f);
+    for (int i = 0; i < 10; i++) process_c(STEP_FROM_C);
+    float y = 0.0f;
+    for (int i = 0; i < 2; i++) y = process_c(STEP_TO_C);
+
+    // 0.25 Гц: зріз 0.2 Гц вище Найквіста, обмежується до 0.45 частоти вибірок
+    temp_filter_set_sample_rate(&s_filter, 0.25f);
+    float next = process_c(STEP_TO_C);
+    TEST_ASSERT_FALSE(isnan(next));
+    TEST_ASSERT_GREATER_OR_EQUAL_FLOAT(y, next);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(STEP_TO_C + 0.5f, next);
+
+    // Сталий вхід після перерахунку: вихід сходиться без коливань через стрибок стану
+    for (int i = 0; i < 50; i++) next = process_c(STEP_TO_C);
+    TEST_ASSERT_FLOAT_WITHIN(0.01f, STEP_TO_C, next);
+}
+#endif
+
+static uint32_t s_rng;
+
+static float gauss(float sd) {
+    // Сума 12 рівномірних - наближення нормального розподілу без log/cos
+    float acc = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        s_rng = s_rng * 1664525u + 1013904223u;
+        acc += (float)(s_rng >> 8) / 16777216.0f;
+    }
+    return sd * (acc - 6.0f);
+}
+
+static void trace_generate(void) {
+    s_rng = 12345u;
+    for (int i = 0; i < TRACE_LEN; i++) {
+        int offset = i % TRACE_HALF;
+        s_clean[i] = STEP_FROM_C + (float)((i / TRACE_HALF) % 2);
+        s_noisy[i] = s_clean[i] + gauss(TRACE_NOISE_C);
+        s_spiky[i] = s_noisy[i];
+        if (offset == SPIKE_SINGLE_AT) s_spiky[i] += 4.0f;
+        if (offset == SPIKE_DOUBLE_AT || offset == SPIKE_DOUBLE_AT + 1) s_spiky[i] -= 3.0f;
+    }
+}
+
+typedef struct {
+    const char *name;
+    uint8_t median_window;
+    uint8_t hampel_window;
+    temp_filter_smooth_t smooth;
+} stage_t;
+
+typedef struct {
+    int lag;              // Вибірок до 50% сходинки (середнє по всіх сходинках угору)
+    float noise_ratio;    // Дисперсія помилки на сталих ділянках / дисперсія шуму входу
+    float spike_err_c;    // Найбільша помилка на сталих ділянках траси з викидами
+} stage_result_t;
+
+static void run_stage(const stage_t *st, const float *in, float *out) {
+    temp_filter_config_t cfg = {
+        .median_window = st->median_window,
+        .hampel_window = st->hampel_window,
+        .hampel_k = 3.0f,
+        .smooth = st->smooth,
+        .ema_alpha = 0.3f,
+        .cutoff_hz = 0.05f,
+        .sample_rate_hz = 1.0f,
+    };
+    temp_filter_init(&s_filter, &cfg);
+    for (int i = 0; i < TRACE_LEN; i++) out[i] = process_c(in[i]);
+}
+
+static stage_result_t measure_stage(const stage_t *st) {
+    static float out[TRACE_LEN];
+    static float step_avg[TRACE_HALF];
+    stage_result_t r = { .lag = -1 };
+
+    // Запізнення: відгук, усереднений по всіх сходинках угору, проти шуму однієї реалізації
+    run_stage(st, s_noisy, out);
+    for (int k = 0; k < TRACE_HALF; k++) step_avg[k] = 0.0f;
+    for (int p = 1; p < TRACE_PERIODS; p++) {
+        int step_at = (2 * p + 1) * TRACE_HALF;
+        for (int k = 0; k < TRACE_HALF; k++) step_avg[k] += out[step_at + k] - STEP_FROM_C;
+    }
+    for (int k = 0; k < TRACE_HALF && r.lag < 0; k++) {
+        if (step_avg[k] / (TRACE_PERIODS - 1) >= 0.5f) r.lag = k;
+    }
+
+    double err2 = 0.0;
+    int n = 0;
+    for (int i = 2 * TRACE_HALF; i < TRACE_LEN; i++) {
+        if (i % TRACE_HALF < TRACE_STEADY_FROM) continue;
+        double e = out[i] - s_clean[i];
+        err2 += e * e;
+        n++;
+    }
+    r.noise_ratio = (float)(err2 / n / (TRACE_NOISE_C * TRACE_NOISE_C));
+
+    run_stage(st, s_spiky, out);
+    for (int i = 2 * TRACE_HALF; i < TRACE_LEN; i++) {
+        if (i % TRACE_HALF < TRACE_STEADY_FROM) continue;
+        r.spike_err_c = fmaxf(r.spike_err_c, fabsf(out[i] - s_clean[i]));
+    }
+
+    char msg[128];
+    snprintf(msg, sizeof(msg), "%-22s lag %2d samples, noise var x%.3f, spike residual %.2f C",
+             st->name, r.lag, r.noise_ratio, r.spike_err_c);
+    TEST_MESSAGE(msg);
+    return r;
+}
+
+static void test_trace_bench_per_stage(void) {
+    trace_generate();
+    const stage_t raw_st = { "raw", 0, 0, TEMP_FILTER_SMOOTH_NONE };
+    const stage_t median_st = { "median 3", 3, 0, TEMP_FILTER_SMOOTH_NONE };
+    const stage_t hampel_st = { "median 3 + Hampel 7", 3, 7, TEMP_FILTER_SMOOTH_NONE };
+    const stage_t ema_st = { "... + EMA 0.3", 3, 7, TEMP_FILTER_SMOOTH_EMA };
+    const stage_t ema_only_st = { "EMA 0.3 alone", 0, 0, TEMP_FILTER_SMOOTH_EMA };
+
+    stage_result_t raw = measure_stage(&raw_st);
+    stage_result_t median = measure_stage(&median_st);
+    stage_result_t hampel = measure_stage(&hampel_st);
+    stage_result_t ema = measure_stage(&ema_st);
+    stage_result_t ema_only = measure_stage(&ema_only_st);
+
+    TEST_ASSERT_EQUAL_INT(0, raw.lag);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 1.0f, raw.noise_ratio);
+    TEST_ASSERT_GREATER_THAN_FLOAT(3.5f, raw.spike_err_c);
+
+    // Медіана з 3: запізнення на вибірку, дисперсія білого шуму ~0.45, поодинокий викид зникає,
+    // а подвійний проходить
+    TEST_ASSERT_LESS_OR_EQUAL_INT(1, median.lag);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.7f, median.noise_ratio);
+    TEST_ASSERT_GREATER_THAN_FLOAT(2.5f, median.spike_err_c);
+
+    // Хампель прибирає подвійний викид; сходинку перші вибірки теж вважає викидом,
+    // доки медіана вікна не перейде на новий рівень
+    TEST_ASSERT_LESS_OR_EQUAL_INT(median.lag + 7 / 2 + 1, hampel.lag);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(median.noise_ratio * 1.1f, hampel.noise_ratio);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.5f, hampel.spike_err_c);
+
+    // EMA: дисперсія падає ще вдвічі ціною кількох вибірок запізнення (шум після медіани
+    // вже скорельований, тому менше, ніж 0.3 / (2 - 0.3) для білого)
+    TEST_ASSERT_LESS_OR_EQUAL_INT(hampel.lag + 3, ema.lag);
+    TEST_ASSERT_LESS_THAN_FLOAT(hampel.noise_ratio * 0.5f, ema.noise_ratio);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.4f, ema.spike_err_c);
+
+    // Без медіани й Хампеля викид просочується в згладжений сигнал
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.8f, ema_only.spike_err_c);
+
+#if !TEMP_FIXED_POINT
+    const stage_t biquad_st = { "... + biquad 0.05 Hz", 3, 7, TEMP_FILTER_SMOOTH_BIQUAD };
+    stage_result_t biquad = measure_stage(&biquad_st);
+    TEST_ASSERT_LESS_OR_EQUAL_INT(hampel.lag + 12, biquad.lag);
+    TEST_ASSERT_LESS_THAN_FLOAT(hampel.noise_ratio * 0.5f, biquad.noise_ratio);
+    TEST_ASSERT_LESS_THAN_FLOAT(0.4f, biquad.spike_err_c);
+#endif
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_ema_time_constant_kept_across_rates);
+    RUN_TEST(test_ema_state_survives_rate_change);
+    RUN_TEST(test_unknown_rate_keeps_alpha);
+#if !TEMP_FIXED_POINT
+    RUN_TEST(test_biquad_cutoff_kept_across_rates);
+    RUN_TEST(test_biquad_retune_is_continuous_and_clamped);
+#endif
+    RUN_TEST(test_trace_bench_per_stage);
+    return UNITY_END();
+}
@@ -0,0 +1,259 @@
+/**
+ * @brief Монітор справності каналу термістора на синтетичних пакетах передискретизації:
+ * коди обриву і замикання, заморожене показання, шум між циклами і в пакеті, відсутність
+ * даних, усунення брязкоту (3 цикли на несправність, 10 на відновлення) і здорові сигнали,
+ * що не мають спрацьовувати.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "controller/sensor/temp_health.h"
+
+#define SCAN_US          1000000LL   // Цикл опитування датчиків
+#define SAMPLES_PER_SCAN 64
+#define STUCK_SCANS      120         // Тайм-аут замороженого показання в циклах по 1 с
+#define FAULT_SCANS      3
+#define RECOVER_SCANS    10
+
+static uint32_t s_rng;
+static temp_health_monitor_t s_mon;
+static int64_t s_now_us;
+
+static uint32_t rng_next(void) {
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// Нормальний шум з нульовим середнім (Бокс-Мюллер)
+static double gauss(double sd) {
+    double u1 = ((double)rng_next() + 1.0) / 4294967297.0;
+    double u2 = (double)rng_next() / 4294967296.0;
+    return sd * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+}
+
+// Пакет з SAMPLES_PER_SCAN кодів навколо mean з шумом sd, як після АЦП
+static temp_health_sample_t make_sample(double mean, double sd) {
+    uint32_t sum = 0;
+    uint16_t lo = UINT16_MAX, hi = 0;
+    for (int i = 0; i < SAMPLES_PER_SCAN; i++) {
+        long code = lround(mean + gauss(sd));
+        if (code < 0) code = 0;
+        if (code > 4095) code = 4095;
+        sum += (uint32_t)code;
+        if (code < lo) lo = (uint16_t)code;
+        if (code > hi) hi = (uint16_t)code;
+    }
+    return (temp_health_sample_t){
+        .valid = true,
+        .avg_raw_q8 = (uint32_t)(((uint64_t)sum * 256 + SAMPLES_PER_SCAN / 2) / SAMPLES_PER_SCAN),
+        .raw_min = lo,
+        .raw_max = hi
+    };
+}
+
+// Пакет із заданими середнім і розкидом без випадковості
+static temp_health_sample_t exact_sample(uint32_t avg, uint16_t spread) {
+    return (temp_health_sample_t){
+        .valid = true,
+        .avg_raw_q8 = avg << 8,
+        .raw_min = (uint16_t)(avg - spread / 2),
+        .raw_max = (uint16_t)(avg - spread / 2 + spread)
+    };
+}
+
+static temp_health_t scan(temp_health_sample_t s) {
+    s_now_us += SCAN_US;
+    return temp_health_update(&s_mon, &s, s_now_us);
+}
+
+static void restart(void) {
+    s_now_us = 0;
+    temp_health_init(&s_mon, s_now_us);
+}
+
+void setUp(void) {
+    s_rng = 0x12345678u;
+    restart();
+}
+
+void tearDown(void) {}
+
+// Статус лишається OK FAULT_SCANS - 1 циклів, потім фіксується expected
+static void expect_latch(temp_health_sample_t s, temp_health_t expected, const char *msg) {
+    for (int i = 1; i < FAULT_SCANS; i++) TEST_ASSERT_EQUAL_MESSAGE(TEMP_HEALTH_OK, scan(s), msg);
+    TEST_ASSERT_EQUAL_MESSAGE(expected, scan(s), msg);
+}
+
+static void test_open_and_short_codes(void) {
+    static const struct { uint32_t code; temp_health_t expected; } cases[] = {
+        { 0,    TEMP_HEALTH_OPEN },
+        { 16,   TEMP_HEALTH_OPEN },
+        { 4079, TEMP_HEALTH_SHORT },
+        { 4095, TEMP_HEALTH_SHORT },
+    };
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        char msg[32];
+        snprintf(msg, sizeof(msg), "code %u", (unsigned)cases[i].code);
+        restart();
+        expect_latch(exact_sample(cases[i].code, 0), cases[i].expected, msg);
+        TEST_ASSERT_EQUAL_STRING(cases[i].expected == TEMP_HEALTH_OPEN ? "OPEN" : "SHORT",
+                                 temp_health_to_string(scan(exact_sample(cases[i].code, 0))));
+    }
+
+    // Сусідні коди всередині шкали - робочі
+    static const uint32_t valid[] = { 17, 4078 };
+    for (size_t i = 0; i < sizeof(valid) / sizeof(valid[0]); i++) {
+        restart();
+        for (int k = 0; k < 20; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(valid[i], 4)));
+    }
+
+    // Межа за округленим середнім Q8: 16.49 -> 16, 16.5 -> 17
+    restart();
+    temp_health_sample_t s = exact_sample(16, 4);
+    s.avg_raw_q8 = 16 * 256 + 127;
+    expect_latch(s, TEMP_HEALTH_OPEN, "16.49");
+    restart();
+    s.avg_raw_q8 = 16 * 256 + 128;
+    for (int k = 0; k < 20; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(s));
+}
+
+static void test_stuck_after_two_minutes(void) {
+    // Перший пакет задає момент останньої зміни: STUCK спостерігається через STUCK_SCANS
+    // циклів після нього і фіксується ще через FAULT_SCANS - 1
+    const temp_health_sample_t frozen = exact_sample(2000, 1);
+    for (int k = 1; k < STUCK_SCANS + FAULT_SCANS; k++) {
+        TEST_ASSERT_EQUAL_MESSAGE(TEMP_HEALTH_OK, scan(frozen), "before timeout");
+    }
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_STUCK, scan(frozen));
+
+    // Живий шум знімає стан лише після RECOVER_SCANS добрих циклів поспіль
+    for (int k = 1; k < RECOVER_SCANS; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_STUCK, scan(make_sample(2000, 3.0)));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(make_sample(2000, 3.0)));
+
+    // Розкид у 2 коди - вже живий канал, навіть якщо середнє стоїть
+    restart();
+    for (int k = 0; k < 3 * STUCK_SCANS; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(2000, 2)));
+
+    // Зміна середнього на пів коду перезапускає тайм-аут
+    restart();
+    for (int k = 0; k < 3 * STUCK_SCANS; k++) {
+        temp_health_sample_t s = exact_sample(2000, 0);
+        if ((k / (STUCK_SCANS / 2)) % 2) s.avg_raw_q8 += 128;
+        TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(s));
+    }
+}
+
+static void test_noisy_by_diff_variance(void) {
+    // Середнє скаче на ±40 кодів (СКВ різниці 80 > 25): дисперсія перетинає поріг
+    // з першої різниці, тобто на 2-му циклі, і фіксується на FAULT_SCANS + 1
+    for (int k = 0; k < FAULT_SCANS; k++) {
+        TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(k % 2 ? 2040 : 1960, 6)));
+    }
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_NOISY, scan(exact_sample(2040, 6)));
+
+    // Дисперсія забуває шум через EMA: після кількох спокійних циклів відновлення
+    int k = 0;
+    while (scan(make_sample(2000, 3.0)) != TEMP_HEALTH_OK) {
+        TEST_ASSERT_LESS_THAN_INT(RECOVER_SCANS + 40, ++k);
+    }
+
+    // Стрибки на ±20 кодів (СКВ різниці 40) теж шум, на ±10 (20 < 25) - ні
+    restart();
+    for (int i = 0; i < 50; i++) scan(exact_sample(i % 2 ? 2020 : 1980, 6));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_NOISY, s_mon.status);
+    restart();
+    for (int i = 0; i < 200; i++) TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(i % 2 ? 2010 : 1990, 6)));
+}
+
+static void test_noisy_by_spread(void) {
+    // Розкид пакета понад 400 кодів при стабільному середньому (поганий контакт, наводки)
+    expect_latch(exact_sample(2000, 401), TEMP_HEALTH_NOISY, "spread 401");
+    restart();
+    for (int k = 0; k < 50; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(2000, 400)));
+
+    // Поодинокий пакет з наводкою від реле не фіксується
+    restart();
+    for (int k = 0; k < 200; k++) {
+        temp_health_sample_t s = make_sample(2000, 3.0);
+        if (k % 20 == 10) s.raw_max += 500;
+        TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(s));
+    }
+}
+
+static void test_no_data_and_debounce(void) {
+    const temp_health_sample_t missing = { .valid = false };
+    expect_latch(missing, TEMP_HEALTH_NO_DATA, "no data");
+
+    // Відновлення: 9 добрих пакетів мало, переривання починає відлік заново
+    for (int k = 1; k < RECOVER_SCANS; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_NO_DATA, scan(make_sample(2000, 3.0)));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_NO_DATA, scan(missing));
+    for (int k = 1; k < RECOVER_SCANS; k++) TEST_ASSERT_EQUAL(TEMP_HEALTH_NO_DATA, scan(make_sample(2000, 3.0)));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(make_sample(2000, 3.0)));
+
+    // Дві втрачені вибірки поспіль, перемежовані добрими, ніколи не фіксуються
+    for (int k = 0; k < 100; k++) {
+        temp_health_sample_t s = (k % 3 == 2) ? make_sample(2000, 3.0) : missing;
+        TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(s));
+    }
+
+    // Зміна виду несправності перезапускає підтвердження
+    restart();
+    scan(missing);
+    scan(missing);
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(4095, 0)));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_OK, scan(exact_sample(4095, 0)));
+    TEST_ASSERT_EQUAL(TEMP_HEALTH_SHORT, scan(exact_sample(4095, 0)));
+}
+
+typedef struct {
+    const char *name;
+    double base;        // Середній код
+    double amplitude;   // Повільний дрейф, коди
+    double period_s;
+    double ramp_per_s;  // Лінійний тренд, коди/с
+    double sd;          // Шум окремої вибірки, коди
+} healthy_trace_t;
+
+static void test_healthy_traces_do_not_trip(void) {
+    static const healthy_trace_t traces[] = {
+        { "room drift",        2050.0, 150.0, 4.0 * 3600.0, 0.0,  3.0 },
+        { "radiator warm-up",  1500.0, 0.0,   1.0,          3.3,  5.0 },
+        { "quiet live input",  2400.0, 0.5,   600.0,        0.0,  0.8 },
+        { "cold end of scale", 40.0,   10.0,  1800.0,       0.0,  2.0 },
+        { "hot end of scale",  4040.0, 10.0,  1800.0,       0.0,  2.0 },
+        { "noisy but usable",  2000.0, 50.0,  3600.0,       0.0,  25.0 },
+    };
+    const int scans = 3 * 3600;
+
+    for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); i++) {
+        const healthy_trace_t *t = &traces[i];
+        restart();
+        for (int k = 0; k < scans; k++) {
+            double sec = (double)k;
+            double mean = t->base + t->amplitude * sin(2.0 * M_PI * sec / t->period_s);
+            // Розігрів радіатора триває 10 хв, далі код стоїть на новому рівні
+            mean += t->ramp_per_s * (sec < 600.0 ? sec : 600.0);
+            temp_health_t h = scan(make_sample(mean, t->sd));
+            if (h != TEMP_HEALTH_OK) {
+                char msg[96];
+                snprintf(msg, sizeof(msg), "%s tripped %s at scan %d", t->name, temp_health_to_string(h), k);
+                TEST_FAIL_MESSAGE(msg);
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_open_and_short_codes);
+    RUN_TEST(test_stuck_after_two_minutes);
+    RUN_TEST(test_noisy_by_diff_variance);
+    RUN_TEST(test_noisy_by_spread);
+    RUN_TEST(test_no_data_and_debounce);
+    RUN_TEST(test_healthy_traces_do_not_trip);
+    return UNITY_END();
+}
@@ -0,0 +1,189 @@
+/**
+ * @brief Ідентифікація RC-моделі: секундні вибірки симульованої кімнати з радіатором через
+ * thermal_model_add_sample, збіжність оцінок до справжніх k_rad / k_loss / g_heat / k_rad_room
+ * і обмеження сліду коваріації, коли збудження немає.
+ */
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <unity.h>
+
+#include "controller/thermal_model.h"
+
+// Справжня кімната: tau ~8 год, радіатор ~25 хв, внутрішні надходження 0.05 C/год
+#define PLANT_K_RAD   0.0756f
+#define PLANT_K_LOSS  0.0504f
+#define PLANT_Q_INT   0.05f
+#define PLANT_G_HEAT  90.0f
+#define PLANT_K_RR    2.4f
+
+#define SEC_PER_H     3600.0f
+#define PWM_CYCLE_SEC 600
+#define DUTY_HOLD_SEC 5400      // Скважність змінюється кожні 1.5 год
+#define IDENT_DAYS    5
+#define PARAM_TOL     0.05f     // Відносна похибка оцінок
+
+#define WINDOW_SEC    300       // THERMAL_MODEL_WINDOW_SEC
+#define MIN_SAMPLES   144       // THERMAL_MODEL_MIN_SAMPLES
+#define TRACE_MAX     1000.0f   // THERMAL_RLS_TRACE_MAX
+
+typedef struct {
+    float room;
+    float rad;
+} plant_t;
+
+static thermal_model_ident_t s_ident;
+static uint32_t s_rng;
+
+static float noise(float sd) {
+    s_rng = s_rng * 1664525u + 1013904223u;
+    return sd * ((float)(s_rng >> 8) / 8388608.0f - 1.0f);
+}
+
+static float outside_at(int sec) {
+    // Добовий хід -3 +- 4 C
+    return -3.0f + 4.0f * sinf(2.0f * (float)M_PI * (float)sec / (24.0f * SEC_PER_H));
+}
+
+static float duty_at(int sec) {
+    // Псевдовипадкова скважність 0..90 % з кроком 15 % - збуджує обидва вузли
+    static const float levels[] = { 0.6f, 0.15f, 0.9f, 0.3f, 0.0f, 0.75f, 0.45f, 0.9f, 0.15f, 0.6f, 0.3f };
+    return levels[(sec / DUTY_HOLD_SEC) % (int)(sizeof(levels) / sizeof(levels[0]))];
+}
+
+static void plant_step(plant_t *p, bool on, float outside) {
+    const float dt = 1.0f / SEC_PER_H;
+    float d_room = PLANT_K_RAD * (p->rad - p->room) - PLANT_K_LOSS * (p->room - outside) + PLANT_Q_INT;
+    float d_rad = PLANT_G_HEAT * (on ? 1.0f : 0.0f) - PLANT_K_RR * (p->rad - p->room);
+    p->room += d_room * dt;
+    p->rad += d_rad * dt;
+}
+
+static float trace_of(const thermal_rls_t *rls) {
+    float t = 0.0f;
+    for (int i = 0; i < rls->n; i++) t += rls->p[i][i];
+    return t;
+}
+
+static void expect_within_pct(float expected, float actual, const char *name) {
+    char msg[96];
+    snprintf(msg, sizeof(msg), "%s: %.4f vs %.4f (%+.1f %%)", name, actual, expected,
+             100.0f * (actual - expected) / expected);
+    TEST_MESSAGE(msg);
+    TEST_ASSERT_FLOAT_WITHIN_MESSAGE(fabsf(expected) * PARAM_TOL, expected, actual, msg);
+}
+
+// Реле з ШІМ-циклом, шум датчиків 0.05 C у кімнаті та 0.2 C на радіаторі
+static void run_plant(plant_t *p, int from_sec, int to_sec) {
+    for (int sec = from_sec; sec < to_sec; sec++) {
+        float duty = duty_at(sec);
+        bool on = (float)(sec % PWM_CYCLE_SEC) < duty * PWM_CYCLE_SEC;
+        float outside = outside_at(sec);
+        plant_step(p, on, outside);
+        thermal_model_add_sample(&s_ident, p->room + noise(0.05f), p->rad + noise(0.2f), outside,
+                                 on ? 1.0f : 0.0f);
+    }
+}
+
+void setUp(void) {
+    memset(&s_ident, 0, sizeof(s_ident));
+    thermal_model_init(&s_ident.model, 3.0f);
+    thermal_model_ident_reset(&s_ident);
+    s_rng = 1u;
+}
+
+void tearDown(void) {}
+
+static void test_fallback_until_converged(void) {
+    plant_t p = { .room = 18.0f, .rad = 18.0f };
+    // Перше вікно лише запам'ятовує середні, оновлення - з другого
+    run_plant(&p, 0, WINDOW_SEC * MIN_SAMPLES);
+    TEST_ASSERT_EQUAL_UINT32(MIN_SAMPLES - 1, s_ident.model.samples);
+    TEST_ASSERT_FALSE(thermal_model_is_converged(&s_ident.model));
+    TEST_ASSERT_EQUAL_FLOAT(3.0f, thermal_model_heat_rate(&s_ident.model, 20.0f, 0.0f));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, thermal_model_loss_coeff(&s_ident.model));
+    TEST_ASSERT_EQUAL_FLOAT(0.0f, thermal_model_time_constant_h(&s_ident.model));
+
+    run_plant(&p, WINDOW_SEC * MIN_SAMPLES, WINDOW_SEC * (MIN_SAMPLES + 1));
+    TEST_ASSERT_TRUE(thermal_model_is_converged(&s_ident.model));
+}
+
+static void test_window_update_cadence_and_gap(void) {
+    plant_t p = { .room = 18.0f, .rad = 18.0f };
+    int updated_at[3] = { -1, -1, -1 };
+    int updates = 0;
+    for (int sec = 0; sec < 3 * WINDOW_SEC; sec++) {
+        plant_step(&p, false, 0.0f);
+        if (thermal_model_add_sample(&s_ident, p.room, p.rad, 0.0f, 0.0f) && updates < 3) {
+            updated_at[updates++] = sec;
+        }
+    }
+    // Оновлення - на останній секунді кожного вікна, крім першого
+    TEST_ASSERT_EQUAL_INT(2, updates);
+    TEST_ASSERT_EQUAL_INT(2 * WINDOW_SEC - 1, updated_at[0]);
+    TEST_ASSERT_EQUAL_INT(3 * WINDOW_SEC - 1, updated_at[1]);
+
+    // Зовнішня температура недоступна: вікно і попередні середні відкидаються
+    TEST_ASSERT_FALSE(thermal_model_add_sample(&s_ident, p.room, p.rad, -999.0f, 0.0f));
+    TEST_ASSERT_FALSE(s_ident.has_prev);
+    TEST_ASSERT_EQUAL_UINT32(0, s_ident.window_count);
+    for (int sec = 0; sec < 2 * WINDOW_SEC - 1; sec++) {
+        TEST_ASSERT_FALSE(thermal_model_add_sample(&s_ident, p.room, p.rad, 0.0f, 0.0f));
+    }
+    TEST_ASSERT_TRUE(thermal_model_add_sample(&s_ident, p.room, p.rad, 0.0f, 0.0f));
+    TEST_ASSERT_EQUAL_UINT32(3, s_ident.model.samples);
+}
+
+static void test_identifies_plant_parameters(void) {
+    plant_t p = { .room = 18.0f, .rad = 18.0f };
+    run_plant(&p, 0, IDENT_DAYS * 24 * (int)SEC_PER_H);
+
+    const thermal_model_t *m = &s_ident.model;
+    TEST_ASSERT_TRUE(thermal_model_is_converged(m));
+    expect_within_pct(PLANT_K_RAD, m->room.theta[0], "k_rad");
+    expect_within_pct(PLANT_K_LOSS, m->room.theta[1], "k_loss");
+    expect_within_pct(PLANT_G_HEAT, m->radiator.theta[0], "g_heat");
+    expect_within_pct(PLANT_K_RR, m->radiator.theta[1], "k_rad_room");
+    TEST_ASSERT_FLOAT_WITHIN(0.05f, PLANT_Q_INT, m->room.theta[2]);
+
+    expect_within_pct(1.0f / (PLANT_K_RAD + PLANT_K_LOSS), thermal_model_time_constant_h(m), "tau_h");
+    float true_rate = PLANT_K_RAD * PLANT_G_HEAT / PLANT_K_RR - PLANT_K_LOSS * (20.0f + 3.0f) + PLANT_Q_INT;
+    expect_within_pct(true_rate, thermal_model_heat_rate(m, 20.0f, -3.0f), "heat_rate");
+}
+
+static void test_covariance_trace_capped_without_excitation(void) {
+    // Нагрівач вимкнений, усе в рівновазі з вулицею: регресори радіатора нульові, кімнати -
+    // лише константа. Без обмеження забування роздуло б P як 1/lambda^N
+    const int windows = 60 * 24 * 12;   // 60 діб
+    float worst_room = 0.0f, worst_rad = 0.0f;
+    for (int w = 0; w < windows; w++) {
+        for (int sec = 0; sec < WINDOW_SEC; sec++) thermal_model_add_sample(&s_ident, 5.0f, 5.0f, 5.0f, 0.0f);
+        worst_room = fmaxf(worst_room, trace_of(&s_ident.model.room));
+        worst_rad = fmaxf(worst_rad, trace_of(&s_ident.model.radiator));
+    }
+
+    char msg[96];
+    snprintf(msg, sizeof(msg), "trace after 60 idle days: room %.1f, radiator %.1f", worst_room, worst_rad);
+    TEST_MESSAGE(msg);
+    // Останнє оновлення з забуванням може переступити межу не більше ніж у 1/lambda разів
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(TRACE_MAX / 0.999f, worst_room);
+    TEST_ASSERT_LESS_OR_EQUAL_FLOAT(TRACE_MAX / 0.999f, worst_rad);
+    TEST_ASSERT_GREATER_THAN_FLOAT(0.9f * TRACE_MAX, worst_rad);
+    for (int i = 0; i < 3; i++) TEST_ASSERT_TRUE(isfinite(s_ident.model.room.theta[i]));
+    for (int i = 0; i < 2; i++) TEST_ASSERT_TRUE(isfinite(s_ident.model.radiator.theta[i]));
+
+    // Після простою модель знову вчиться на збудженні
+    plant_t p = { .room = 5.0f, .rad = 5.0f };
+    run_plant(&p, 0, IDENT_DAYS * 24 * (int)SEC_PER_H);
+    expect_within_pct(PLANT_G_HEAT, s_ident.model.radiator.theta[0], "g_heat after idle");
+    expect_within_pct(PLANT_K_LOSS, s_ident.model.room.theta[1], "k_loss after idle");
+}
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fallback_until_converged);
+    RUN_TEST(test_window_update_cadence_and_gap);
+    RUN_TEST(test_identifies_plant_parameters);
+    RUN_TEST(test_covariance_trace_capped_without_excitation);
+    return UNITY_END();
+}